@@ -0,0 +1,164 @@
+#include "alloc_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+namespace {
+    // Fixed storage: the counters are updated from operator new, so they must never allocate
+    AllocStats::Totals threadTotals[AllocStats::MAX_THREADS];
+    std::atomic<int> threadsSeen(0);
+
+    thread_local int threadSlot = -1;
+    thread_local int currentTag = 0;
+    thread_local int currentStreet = 0;
+
+    AllocStats::Totals& localTotals() {
+        if (threadSlot < 0) {
+            int slot = threadsSeen.fetch_add(1, std::memory_order_relaxed);
+            threadSlot = slot < AllocStats::MAX_THREADS ? slot : AllocStats::MAX_THREADS - 1;
+        }
+        return threadTotals[threadSlot];
+    }
+
+    const char* streetName(int street) {
+        static const char* names[AllocStats::STREETS] = {"pre-hand", "pre-flop", "flop", "turn", "river", "showdown"};
+        return names[street];
+    }
+}
+
+namespace AllocStats {
+    void recordAllocation(size_t bytes) {
+        Totals& totals = localTotals();
+        totals.allocations[currentTag][currentStreet]++;
+        totals.bytes[currentTag][currentStreet] += bytes;
+    }
+
+    AllocTag setTag(AllocTag tag) {
+        AllocTag previous = static_cast<AllocTag>(currentTag);
+        currentTag = static_cast<int>(tag);
+        return previous;
+    }
+
+    void setStreet(int street) {
+        currentStreet = (street >= 0 && street < STREETS) ? street : 0;
+    }
+
+    Totals collect() {
+        Totals merged;
+        std::memset(&merged, 0, sizeof(merged));
+        int threads = std::min(threadsSeen.load(std::memory_order_relaxed), MAX_THREADS);
+        for (int t = 0; t < threads; t++) {
+            for (int tag = 0; tag < TAGS; tag++) {
+                for (int street = 0; street < STREETS; street++) {
+                    merged.allocations[tag][street] += threadTotals[t].allocations[tag][street];
+                    merged.bytes[tag][street] += threadTotals[t].bytes[tag][street];
+                }
+            }
+        }
+        return merged;
+    }
+
+    void reset() {
+        std::memset(threadTotals, 0, sizeof(threadTotals));
+    }
+
+    void report(std::ostream& out, long long hands) {
+        Totals totals = collect();
+        double perHand = hands > 0 ? 1.0 / static_cast<double>(hands) : 0.0;
+        uint64_t allAllocations = 0;
+        uint64_t allBytes = 0;
+        uint64_t streetAllocations[STREETS] = {};
+
+        out << "Allocations per hand over " << hands << " hands:" << std::endl;
+        out << std::fixed << std::setprecision(1);
+        for (int tag = 0; tag < TAGS; tag++) {
+            uint64_t allocations = 0;
+            uint64_t bytes = 0;
+            for (int street = 0; street < STREETS; street++) {
+                allocations += totals.allocations[tag][street];
+                bytes += totals.bytes[tag][street];
+                streetAllocations[street] += totals.allocations[tag][street];
+            }
+            allAllocations += allocations;
+            allBytes += bytes;
+            if (allocations == 0) continue;
+            out << "  " << std::left << std::setw(14) << tagName(static_cast<AllocTag>(tag)) << std::right
+                << std::setw(10) << allocations * perHand << " allocs" << std::setw(12) << bytes * perHand
+                << " bytes" << std::endl;
+        }
+        out << "  " << std::left << std::setw(14) << "total" << std::right << std::setw(10)
+            << allAllocations * perHand << " allocs" << std::setw(12) << allBytes * perHand << " bytes" << std::endl;
+        out << "  by street:";
+        for (int street = 0; street < STREETS; street++) {
+            out << " " << streetName(street) << " " << streetAllocations[street] * perHand;
+        }
+        out << std::endl;
+        out.unsetf(std::ios::floatfield);
+        out << std::setprecision(6);
+    }
+
+    const char* tagName(AllocTag tag) {
+        switch (tag) {
+            case AllocTag::OTHER: return "other";
+            case AllocTag::DEALING: return "dealing";
+            case AllocTag::BETTING: return "betting";
+            case AllocTag::DECISION: return "decision";
+            case AllocTag::HAND_HISTORY: return "hand history";
+            case AllocTag::POTS: return "pots";
+            case AllocTag::EVALUATION: return "evaluation";
+            case AllocTag::RENDERING: return "rendering";
+        }
+        return "?";
+    }
+}
+
+#ifdef ALLOC_STATS
+// Counting replacements for the global allocation functions (the nothrow
+// and array forms included); storage still comes from malloc
+void* operator new(std::size_t size) {
+    AllocStats::recordAllocation(size);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    AllocStats::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+#endif
@@ -0,0 +1,68 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+// Heap allocation accounting, compiled in with -DALLOC_STATS (make
+// ALLOC_STATS=1). That build replaces the global operator new so every
+// allocation is counted, with its bytes, against the calling thread's
+// current tag (innermost ALLOC_SCOPE) and hand street (last ALLOC_STREET).
+// Otherwise the macros expand to nothing and the default allocator is used.
+enum class AllocTag {
+    OTHER,        // No scope open: table setup, game flow bookkeeping
+    DEALING,      // Shuffles, hole cards, streets, runouts
+    BETTING,      // Applying decisions
+    DECISION,     // Player::makeDecision
+    HAND_HISTORY, // Recording players, actions and the resolution
+    POTS,         // Collecting bets, building and awarding pots
+    EVALUATION,   // Hand ranking, winners, all-in equity
+    RENDERING     // Table display while logging is on
+};
+
+namespace AllocStats {
+    const int TAGS = 8;
+    const int STREETS = 6;       // HandHistoryRound values, PRE_HAND through SHOWDOWN
+    const int MAX_THREADS = 128; // Later threads share the last slot (counts may race)
+
+    struct Totals {
+        uint64_t allocations[TAGS][STREETS];
+        uint64_t bytes[TAGS][STREETS];
+    };
+
+    void recordAllocation(size_t bytes); // Called by the replaced operator new
+    AllocTag setTag(AllocTag tag);       // Returns the previous tag
+    void setStreet(int street);
+
+    // Every thread merged. Reads other threads' counters without locking:
+    // call while they are idle.
+    Totals collect();
+    void reset();
+    // Allocations and bytes per hand, by tag and by street
+    void report(std::ostream& out, long long hands);
+    const char* tagName(AllocTag tag);
+}
+
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag) : previous(AllocStats::setTag(tag)) {}
+    ~AllocScope() { AllocStats::setTag(previous); }
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    AllocTag previous;
+};
+
+#ifdef ALLOC_STATS
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+#define ALLOC_SCOPE(tag) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(tag)
+#define ALLOC_STREET(round) AllocStats::setStreet(static_cast<int>(round))
+#else
+#define ALLOC_SCOPE(tag) ((void)0)
+#define ALLOC_STREET(round) ((void)0)
+#endif
+
+#endif
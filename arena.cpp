@@ -0,0 +1,72 @@
+#include "arena.h"
+#include <algorithm>
+#include <cstdlib>
+
+MonotonicArena::MonotonicArena(size_t initialBytes)
+    : chunks(nullptr), cursor(nullptr), limit(nullptr), usedInFullChunks(0), capacity(0),
+      nextChunkBytes(std::max<size_t>(initialBytes, 256)), chunkAllocations(0) {
+}
+
+MonotonicArena::~MonotonicArena() {
+    releaseChunks();
+}
+
+void* MonotonicArena::allocateSlow(size_t bytes, size_t alignment) {
+    if (chunks) {
+        usedInFullChunks += static_cast<size_t>(cursor - reinterpret_cast<char*>(chunks + 1));
+    }
+    addChunk(bytes + alignment);
+    return allocate(bytes, alignment);
+}
+
+void MonotonicArena::addChunk(size_t minimumBytes) {
+    size_t size = std::max(nextChunkBytes, minimumBytes);
+    Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+    chunk->next = chunks;
+    chunk->size = size;
+    chunks = chunk;
+    cursor = reinterpret_cast<char*>(chunk + 1);
+    limit = cursor + size;
+    capacity += size;
+    nextChunkBytes = size * 2; // Geometric growth keeps a big hand to a few chunks
+    chunkAllocations++;
+}
+
+void MonotonicArena::releaseChunks() {
+    while (chunks) {
+        Chunk* next = chunks->next;
+        ::operator delete(chunks);
+        chunks = next;
+    }
+    cursor = nullptr;
+    limit = nullptr;
+    capacity = 0;
+}
+
+void MonotonicArena::reset() {
+    usedInFullChunks = 0;
+    if (!chunks) return;
+    if (!chunks->next) {
+        cursor = reinterpret_cast<char*>(chunks + 1); // Common case: one chunk, just rewind
+        return;
+    }
+    // The last hand overflowed: replace its chunks with one that would have held it
+    size_t total = capacity;
+    releaseChunks();
+    nextChunkBytes = total;
+    addChunk(total);
+}
+
+size_t MonotonicArena::getBytesUsed() const {
+    if (!chunks) return 0;
+    return usedInFullChunks + static_cast<size_t>(cursor - reinterpret_cast<char*>(chunks + 1));
+}
+
+MonotonicArena*& MonotonicArena::currentSlot() {
+    static thread_local MonotonicArena* arena = nullptr;
+    return arena;
+}
+
+MonotonicArena* MonotonicArena::current() {
+    return currentSlot();
+}
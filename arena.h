@@ -0,0 +1,144 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <map>
+#include <new>
+#include <set>
+#include <type_traits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Monotonic (bump) arena for memory that lives exactly one hand. allocate()
+// moves a cursor; nothing is freed until reset(), which releases the whole
+// hand at once. Chunks come from the heap as needed, and reset() folds them
+// into one chunk as large as the hand needed, so after the first few hands
+// a table runs each hand out of a single block with no heap traffic.
+class MonotonicArena {
+public:
+    static const size_t DEFAULT_CHUNK_BYTES = 16 * 1024;
+
+    explicit MonotonicArena(size_t initialBytes = DEFAULT_CHUNK_BYTES);
+    ~MonotonicArena();
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment) {
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+        if (cursor && aligned + bytes <= reinterpret_cast<uintptr_t>(limit)) {
+            cursor = reinterpret_cast<char*>(aligned + bytes);
+            return reinterpret_cast<void*>(aligned);
+        }
+        return allocateSlow(bytes, alignment);
+    }
+
+    // Every allocation becomes invalid; containers using the arena must be
+    // destroyed or emptied first
+    void reset();
+
+    size_t getBytesUsed() const;
+    size_t getCapacity() const { return capacity; }
+    uint64_t getChunkAllocations() const { return chunkAllocations; }
+
+    // Arena for the calling thread's scratch buffers (see ArenaScope);
+    // nullptr means scratch comes from the heap
+    static MonotonicArena* current();
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size; // Usable bytes after the header
+    };
+
+    Chunk* chunks; // Newest first; the cursor is in the newest
+    char* cursor;
+    char* limit;
+    size_t usedInFullChunks;
+    size_t capacity;
+    size_t nextChunkBytes;
+    uint64_t chunkAllocations;
+
+    void* allocateSlow(size_t bytes, size_t alignment);
+    void addChunk(size_t minimumBytes);
+    void releaseChunks();
+
+    friend class ArenaScope;
+    static MonotonicArena*& currentSlot();
+};
+
+// Points the calling thread's scratch allocations at an arena until the
+// scope closes (scopes nest)
+class ArenaScope {
+public:
+    explicit ArenaScope(MonotonicArena* arena) : previous(MonotonicArena::currentSlot()) {
+        MonotonicArena::currentSlot() = arena;
+    }
+    ~ArenaScope() { MonotonicArena::currentSlot() = previous; }
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    MonotonicArena* previous;
+};
+
+// Standard allocator over a MonotonicArena, in the manner of
+// std::pmr::polymorphic_allocator: a null arena means the global heap, so a
+// container type can hold either. Deallocation into an arena is a no-op.
+// Copy-constructed containers go to the heap, so copies taken out of a
+// hand outlive its reset; moves keep the source's arena.
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator() noexcept : arena(nullptr) {}
+    explicit ArenaAllocator(MonotonicArena* source) noexcept : arena(source) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.getArena()) {}
+
+    T* allocate(size_t count) {
+        if (!arena) return static_cast<T*>(::operator new(count * sizeof(T)));
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* memory, size_t) noexcept {
+        if (!arena) ::operator delete(memory);
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+    MonotonicArena* getArena() const { return arena; }
+
+private:
+    MonotonicArena* arena;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() == b.getArena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.getArena() != b.getArena();
+}
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+template <class T>
+using ArenaSet = std::set<T, std::less<T>, ArenaAllocator<T>>;
+template <class K, class V>
+using ArenaMap = std::map<K, V, std::less<K>, ArenaAllocator<std::pair<const K, V>>>;
+
+// Scratch vector on the calling thread's current arena
+template <class T>
+ArenaVector<T> scratchVector() {
+    return ArenaVector<T>(ArenaAllocator<T>(MonotonicArena::current()));
+}
+
+template <class K, class V>
+ArenaMap<K, V> scratchMap() {
+    return ArenaMap<K, V>(ArenaAllocator<std::pair<const K, V>>(MonotonicArena::current()));
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "strategy_backtest.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+// Asks the built-in AI what it would have done at every decision of an archive.
+// Usage: backtest <archive> [variant: 1=Hold'em, 2=Stud, 3=Omaha Hi-Lo] [personality 1-4] [threads]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: backtest <archive> [variant: 1=Hold'em, 2=Stud, 3=Omaha Hi-Lo] [personality 1-4] [threads]"
+                  << std::endl;
+        return 1;
+    }
+    int choice = argc > 2 ? std::atoi(argv[2]) : 1;
+    int personality = argc > 3 ? std::atoi(argv[3]) : 1;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    VariantInfo variant = choice == 2 ? PokerVariants::SEVEN_CARD_STUD
+                        : choice == 3 ? PokerVariants::OMAHA_HI_LO : PokerVariants::TEXAS_HOLDEM;
+    if (personality < 1 || personality > 4) {
+        std::cerr << "Personality must be 1-4" << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    StrategyBacktest backtest(variant, pool);
+    PlayerCandidate candidate(static_cast<PlayerPersonality>(personality - 1));
+    BacktestReport report;
+    if (!backtest.runArchive(argv[1], candidate, report)) {
+        std::cerr << "Cannot read archive " << argv[1] << std::endl;
+        return 1;
+    }
+
+    BacktestStreet total = report.total();
+    std::cout << "Backtested " << total.decisions << " decisions from " << report.hands << " hands ("
+              << report.skippedHands << " skipped) in " << report.seconds << "s on " << pool.getThreadCount()
+              << " threads" << std::endl;
+    const char* streetNames[BacktestReport::STREETS] = {"Preflop", "Flop", "Turn", "River", "Seventh"};
+    std::cout << std::fixed << std::setprecision(1);
+    for (int s = 0; s <= BacktestReport::STREETS; s++) {
+        const BacktestStreet& street = s < BacktestReport::STREETS ? report.streets[s] : total;
+        if (street.decisions == 0) continue;
+        std::cout << std::setw(8) << (s < BacktestReport::STREETS ? streetNames[s] : "Total") << ": "
+                  << street.decisions << " decisions, " << (100.0 * street.agreed / street.decisions) << "% agree";
+        if (street.evDecisions > 0) {
+            std::cout << ", EV proxy per decision " << (street.recordedEv / street.evDecisions) << " recorded vs "
+                      << (street.candidateEv / street.evDecisions) << " candidate (" << street.evDecisions
+                      << " priced)";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "hand_bucketing.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+// Builds the bucket map for one Hold'em street; rerun after an interruption to resume.
+// Usage: bucket_gen [directory] [round 1-3, default 1] [buckets, default 50] [threads] [limit]
+int main(int argc, char* argv[]) {
+    BucketingConfig config;
+    config.directory = argc > 1 ? argv[1] : ".";
+    config.round = argc > 2 ? std::atoi(argv[2]) : 1;
+    config.buckets = argc > 3 ? std::atoi(argv[3]) : 50;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    config.limit = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 0;
+    if (config.round < 1 || config.round > 3 || config.buckets < 1 || config.buckets > 65535) {
+        std::cerr << "Round must be 1-3 and buckets 1-65535" << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    HandBucketing bucketing(config, pool);
+    std::cout << "Bucketing round " << config.round << ": " << bucketing.getSituations() << " situations into "
+              << config.buckets << " buckets, " << pool.getThreadCount() << " threads" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    if (!bucketing.run(&std::cout)) {
+        std::cerr << "Bucketing failed; files in " << config.directory << " are kept for a rerun" << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wrote " << bucketing.bucketPath() << " in " << seconds << "s" << std::endl;
+    return 0;
+}
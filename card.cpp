@@ -1,4 +1,5 @@
 #include "card.h"
+#include <cctype>
 
 Card::Card(Suit s, Rank r) : suit(s), rank(r) {}
 
@@ -14,6 +15,40 @@ int Card::getValue() const {
     return static_cast<int>(rank);
 }
 
+int Card::getIndex() const {
+    return static_cast<int>(suit) * 13 + (static_cast<int>(rank) - 2);
+}
+
+Card Card::fromIndex(int index) {
+    return Card(static_cast<Suit>(index / 13), static_cast<Rank>(index % 13 + 2));
+}
+
+bool Card::parseRank(char symbol, Rank& rank) {
+    static const std::string RANK_SYMBOLS = "23456789TJQKA";
+    size_t position = RANK_SYMBOLS.find(static_cast<char>(std::toupper(static_cast<unsigned char>(symbol))));
+    if (position == std::string::npos) return false;
+    rank = static_cast<Rank>(position + 2);
+    return true;
+}
+
+bool Card::parseSuit(char symbol, Suit& suit) {
+    static const std::string SUIT_SYMBOLS = "cdhs";
+    size_t position = SUIT_SYMBOLS.find(static_cast<char>(std::tolower(static_cast<unsigned char>(symbol))));
+    if (position == std::string::npos) return false;
+    suit = static_cast<Suit>(position);
+    return true;
+}
+
+bool Card::parse(const std::string& text, Card& card) {
+    Rank rank;
+    Suit suit;
+    if (text.size() != 2 || !parseRank(text[0], rank) || !parseSuit(text[1], suit)) {
+        return false;
+    }
+    card = Card(suit, rank);
+    return true;
+}
+
 std::string Card::toString() const {
     std::string rankStr;
     switch (rank) {
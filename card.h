@@ -37,8 +37,14 @@ public:
     Suit getSuit() const;
     Rank getRank() const;
     int getValue() const;
+    int getIndex() const; // Dense 0-51 index: suit * 13 + (rank - 2)
     std::string toString() const;
     
+    static Card fromIndex(int index);
+    static bool parseRank(char symbol, Rank& rank); // "23456789TJQKA"
+    static bool parseSuit(char symbol, Suit& suit); // "cdhs"
+    static bool parse(const std::string& text, Card& card); // Two characters, e.g. "Ah", "Td"
+    
     bool operator<(const Card& other) const;
     bool operator>(const Card& other) const;
     bool operator==(const Card& other) const;
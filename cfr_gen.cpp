@@ -0,0 +1,46 @@
+#include "limit_cfr.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+// Solves heads-up Limit Hold'em with CFR+ and writes the strategy read by LimitStrategy.
+// Usage: cfr_gen [output] [iterations, default 200000] [buckets per street] [threads]
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : LimitStrategy::DEFAULT_PATH;
+    long long iterations = argc > 2 ? std::atoll(argv[2]) : 200000;
+    int buckets = argc > 3 ? std::atoi(argv[3]) : LimitCfrSolver::DEFAULT_BUCKETS;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    
+    ThreadPool pool(threads);
+    LimitCfrSolver solver(PokerVariants::LIMIT_HOLDEM, buckets);
+    std::cout << "Solving " << PokerVariants::LIMIT_HOLDEM.variantName << ": " << solver.getTree().getDecisionCount()
+              << " decision nodes x " << buckets << " buckets, " << pool.getThreadCount() << " threads" << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    const long long REPORT_EVERY = 50000;
+    for (long long done = 0; done < iterations; done += REPORT_EVERY) {
+        solver.train(std::min(REPORT_EVERY, iterations - done), &pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << solver.getIterations() << " iterations, " << seconds << "s" << std::endl;
+    }
+    
+    if (!solver.save(path)) {
+        std::cerr << "Could not write " << path << std::endl;
+        return 1;
+    }
+    
+    // Small blind's opening strategy with the weakest and strongest hands
+    const char* names[] = {"fold", "call", "raise"};
+    for (int bucket : {0, buckets - 1}) {
+        double probabilities[LimitBettingTree::NUM_ACTIONS];
+        solver.averageStrategy(0, bucket, probabilities);
+        std::cout << "Opening, bucket " << bucket << ":";
+        for (int a = 0; a < LimitBettingTree::NUM_ACTIONS; a++) {
+            std::cout << " " << names[a] << " " << probabilities[a];
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "Wrote " << path << std::endl;
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "decision_provider.h"
+#include "poker_game.h"
+
+bool PlayerAIDecisionProvider::requestDecision(PokerGame& game, const DecisionRequest& request, Decision& decision) {
+    Player* player = game.getTable()->getPlayer(request.seat);
+    if (!player) return false;
+    
+    decision.action = player->makeDecision(game.getHandHistory(), request.callAmount, request.canCheck,
+                                           &game.getVariantInfo(), request.betCount);
+    decision.raiseAmount = 0;
+    return true;
+}
+
+RemoteSeatDecisionProvider::RemoteSeatDecisionProvider(std::function<void(const DecisionRequest&)> requestCallback)
+    : onRequest(std::move(requestCallback)) {
+}
+
+void RemoteSeatDecisionProvider::setRemoteSeat(int seat, bool remote) {
+    if (remote) {
+        remoteSeats.insert(seat);
+    } else {
+        remoteSeats.erase(seat);
+    }
+}
+
+bool RemoteSeatDecisionProvider::isRemoteSeat(int seat) const {
+    return remoteSeats.count(seat) > 0;
+}
+
+bool RemoteSeatDecisionProvider::requestDecision(PokerGame& game, const DecisionRequest& request, Decision& decision) {
+    if (!isRemoteSeat(request.seat)) {
+        return builtInAI.requestDecision(game, request, decision);
+    }
+    
+    if (onRequest) {
+        onRequest(request);
+    }
+    return false; // Suspend until the answer is submitted
+}
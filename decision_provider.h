@@ -0,0 +1,74 @@
+#ifndef DECISION_PROVIDER_H
+#define DECISION_PROVIDER_H
+
+#include "player.h"
+#include "variants.h"
+#include "hand_history.h"
+#include <functional>
+#include <set>
+
+class PokerGame; // Forward declaration
+
+// Where the resumable hand flow currently stands
+enum class HandFlowState {
+    STREET_START,       // Next street needs dealing (or the hand is over)
+    BETTING,            // Betting round in progress, engine can keep going
+    AWAITING_DECISION,  // Suspended until submitDecision() is called
+    COMPLETE            // No more betting; showdown or uncontested award remains
+};
+
+enum class GameStepResult {
+    AWAITING_DECISION,
+    HAND_COMPLETE
+};
+
+// Everything a decision maker needs to know about the pending action
+struct DecisionRequest {
+    int tableId;
+    int seat;
+    int playerId;
+    int callAmount;
+    bool canCheck;
+    int currentBet;
+    int betCount;
+    UnifiedBettingRound round;
+    HandHistoryRound historyRound;
+    long long sequence; // Changes with every applied decision, so late answers can be told apart
+};
+
+struct Decision {
+    PlayerAction action;
+    int raiseAmount; // Total bet to raise to; 0 lets the player's sizing logic decide
+};
+
+// Answers decision points for a PokerGame. Returning true answers immediately;
+// returning false suspends the hand until PokerGame::submitDecision is called.
+class DecisionProvider {
+public:
+    virtual ~DecisionProvider() = default;
+    virtual bool requestDecision(PokerGame& game, const DecisionRequest& request, Decision& decision) = 0;
+};
+
+// Built-in AI: asks Player::makeDecision synchronously
+class PlayerAIDecisionProvider : public DecisionProvider {
+public:
+    bool requestDecision(PokerGame& game, const DecisionRequest& request, Decision& decision) override;
+};
+
+// Seats marked remote suspend the hand and forward the request to a callback
+// (human client, network peer); every other seat keeps the built-in AI.
+class RemoteSeatDecisionProvider : public DecisionProvider {
+private:
+    std::set<int> remoteSeats;
+    std::function<void(const DecisionRequest&)> onRequest;
+    PlayerAIDecisionProvider builtInAI;
+
+public:
+    explicit RemoteSeatDecisionProvider(std::function<void(const DecisionRequest&)> requestCallback);
+    
+    void setRemoteSeat(int seat, bool remote);
+    bool isRemoteSeat(int seat) const;
+    bool requestDecision(PokerGame& game, const DecisionRequest& request, Decision& decision) override;
+};
+
+#endif
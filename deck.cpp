@@ -24,6 +24,23 @@ void Deck::shuffle() {
     std::shuffle(cards.begin(), cards.end(), generator);
 }
 
+void Deck::shuffle(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::shuffle(cards.begin(), cards.end(), generator);
+}
+
+void Deck::stack(const std::vector<Card>& dealOrder) {
+    // Pull the stacked cards out, then put them back on top; dealing pops from the back
+    std::vector<bool> stacked(52, false);
+    for (const Card& card : dealOrder) {
+        stacked[card.getIndex()] = true;
+    }
+    cards.erase(std::remove_if(cards.begin(), cards.end(),
+                               [&](const Card& card) { return stacked[card.getIndex()]; }),
+                cards.end());
+    cards.insert(cards.end(), dealOrder.rbegin(), dealOrder.rend());
+}
+
 Card Deck::dealCard() {
     if (isEmpty()) {
         throw std::runtime_error("Cannot deal from empty deck");
@@ -38,6 +55,10 @@ int Deck::size() const {
     return cards.size();
 }
 
+const std::vector<Card>& Deck::getRemainingCards() const {
+    return cards;
+}
+
 bool Deck::isEmpty() const {
     return cards.empty();
 }
@@ -7,13 +7,18 @@
 class Deck {
 private:
     std::vector<Card> cards;
+    
+    friend class TableCheckpoint;
 
 public:
     Deck();
     void shuffle();
+    void shuffle(unsigned seed); // Reproducible order (simulations run many decks per clock tick)
+    void stack(const std::vector<Card>& dealOrder); // These cards come off first, in order (replays)
     Card dealCard();
     void reset();
     int size() const;
+    const std::vector<Card>& getRemainingCards() const; // Undealt cards, next card last
     bool isEmpty() const;
 };
 
@@ -0,0 +1,248 @@
+#include "equity.h"
+#include "fast_evaluator.h"
+#include <set>
+#include <algorithm>
+
+namespace {
+    double choose(int n, int k) {
+        if (k < 0 || k > n) return 0.0;
+        double result = 1.0;
+        for (int i = 1; i <= k; i++) {
+            result = result * (n - k + i) / i;
+        }
+        return result;
+    }
+
+    // Seats that can still win something: eligible for a pot and holding cards
+    // (pot eligibility is not revoked when a player folds later in the hand)
+    std::vector<int> collectLiveSeats(const std::vector<std::vector<Card>>& seatCards,
+                                      const std::vector<SidePot>& pots) {
+        std::set<int> live;
+        for (const SidePot& pot : pots) {
+            for (int seat : pot.eligiblePlayers) {
+                if (seat < static_cast<int>(seatCards.size()) && !seatCards[seat].empty()) {
+                    live.insert(seat);
+                }
+            }
+        }
+        return std::vector<int>(live.begin(), live.end());
+    }
+
+    // Cards still to come for one recipient: a seat, or the board when seat == -1
+    struct Slot {
+        int seat;
+        int need;
+    };
+
+    std::vector<Slot> buildSlots(const std::vector<std::vector<Card>>& seatCards,
+                                 const std::vector<Card>& board,
+                                 const std::vector<int>& liveSeats,
+                                 const VariantInfo& variant) {
+        std::vector<Slot> slots;
+        if (variant.gameStruct == GAMESTRUCTURE_BOARD) {
+            int need = 5 - static_cast<int>(board.size());
+            if (need > 0) slots.push_back({-1, need});
+        } else {
+            for (int seat : liveSeats) {
+                int need = 7 - static_cast<int>(seatCards[seat].size());
+                if (need > 0) slots.push_back({seat, need});
+            }
+        }
+        return slots;
+    }
+
+    class Enumerator {
+    public:
+        Enumerator(const std::vector<std::vector<Card>>& seatCards, const std::vector<Card>& board,
+                   const std::vector<Card>& remainingDeck, const std::vector<SidePot>& pots,
+                   const VariantInfo& variant)
+            : twoPlusThree(variant.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE),
+              hiLo(isHiLoSplit(variant)),
+              liveSeats(collectLiveSeats(seatCards, pots)),
+              seatMasks(seatCards.size(), 0), drawnMasks(seatCards.size(), 0),
+              holeMasks(seatCards.size()), hiValues(seatCards.size(), 0),
+              loValues(seatCards.size(), FAST_LOW_UNQUALIFIED), totals(seatCards.size(), 0.0),
+              boardMask(0), boardCount(0), completions(0) {
+            slots = buildSlots(seatCards, board, liveSeats, variant);
+            for (const Card& card : remainingDeck) {
+                deck.push_back(FastEvaluator::cardMask(card));
+            }
+            for (int seat : liveSeats) {
+                seatMasks[seat] = FastEvaluator::handMask(seatCards[seat]);
+                for (const Card& card : seatCards[seat]) {
+                    holeMasks[seat].push_back(FastEvaluator::cardMask(card));
+                }
+            }
+            for (const Card& card : board) {
+                boardCards[boardCount++] = FastEvaluator::cardMask(card);
+                boardMask |= boardCards[boardCount - 1];
+            }
+            for (const SidePot& pot : pots) {
+                std::vector<int> eligible;
+                for (int seat : pot.eligiblePlayers) {
+                    if (std::binary_search(liveSeats.begin(), liveSeats.end(), seat)) {
+                        eligible.push_back(seat);
+                    }
+                }
+                potAmounts.push_back(pot.amount);
+                potEligible.push_back(eligible);
+            }
+        }
+
+        std::vector<double> run() {
+            if (slots.empty()) {
+                scoreLeaf();
+            } else {
+                fillSlot(0, 0, slots[0].need, 0);
+            }
+            std::vector<double> result(totals.size(), 0.0);
+            if (completions > 0) {
+                for (size_t i = 0; i < totals.size(); i++) {
+                    result[i] = totals[i] / static_cast<double>(completions);
+                }
+            }
+            return result;
+        }
+
+    private:
+        bool twoPlusThree;
+        bool hiLo;
+        std::vector<int> liveSeats;
+        std::vector<Slot> slots;
+        std::vector<CardMask> deck;
+        std::vector<CardMask> seatMasks;
+        std::vector<CardMask> drawnMasks;
+        std::vector<std::vector<CardMask>> holeMasks;
+        std::vector<int> hiValues;
+        std::vector<int> loValues;
+        std::vector<double> totals;
+        std::vector<int> potAmounts;
+        std::vector<std::vector<int>> potEligible;
+        CardMask boardCards[5];
+        CardMask boardMask;
+        int boardCount;
+        long long completions;
+
+        void fillSlot(size_t slotIndex, size_t start, int remaining, CardMask used) {
+            if (remaining == 0) {
+                if (slotIndex + 1 < slots.size()) {
+                    fillSlot(slotIndex + 1, 0, slots[slotIndex + 1].need, used);
+                } else {
+                    scoreLeaf();
+                }
+                return;
+            }
+
+            const Slot& slot = slots[slotIndex];
+            for (size_t i = start; i + remaining <= deck.size(); i++) {
+                CardMask card = deck[i];
+                if (card & used) continue;
+
+                if (slot.seat < 0) {
+                    boardCards[boardCount++] = card;
+                    boardMask |= card;
+                } else {
+                    drawnMasks[slot.seat] |= card;
+                }
+
+                fillSlot(slotIndex, i + 1, remaining - 1, used | card);
+
+                if (slot.seat < 0) {
+                    boardCount--;
+                    boardMask &= ~card;
+                } else {
+                    drawnMasks[slot.seat] &= ~card;
+                }
+            }
+        }
+
+        void scoreLeaf() {
+            completions++;
+
+            for (int seat : liveSeats) {
+                if (twoPlusThree) {
+                    const std::vector<CardMask>& hole = holeMasks[seat];
+                    int holeCount = static_cast<int>(hole.size());
+                    hiValues[seat] = FastEvaluator::evaluateOmaha(hole.data(), holeCount, boardCards, boardCount);
+                    if (hiLo) {
+                        loValues[seat] = FastEvaluator::evaluateOmahaLowA5(hole.data(), holeCount, boardCards, boardCount);
+                    }
+                } else {
+                    CardMask cards = seatMasks[seat] | drawnMasks[seat] | boardMask;
+                    hiValues[seat] = FastEvaluator::evaluate(cards);
+                    if (hiLo) {
+                        loValues[seat] = FastEvaluator::evaluateLowA5(cards);
+                    }
+                }
+            }
+
+            for (size_t p = 0; p < potAmounts.size(); p++) {
+                const std::vector<int>& eligible = potEligible[p];
+                if (eligible.empty()) continue;
+
+                int bestHi = -1;
+                int hiCount = 0;
+                int bestLo = FAST_LOW_UNQUALIFIED;
+                int loCount = 0;
+                for (int seat : eligible) {
+                    if (hiValues[seat] > bestHi) {
+                        bestHi = hiValues[seat];
+                        hiCount = 1;
+                    } else if (hiValues[seat] == bestHi) {
+                        hiCount++;
+                    }
+                    if (hiLo && loValues[seat] != FAST_LOW_UNQUALIFIED) {
+                        if (loValues[seat] < bestLo) {
+                            bestLo = loValues[seat];
+                            loCount = 1;
+                        } else if (loValues[seat] == bestLo) {
+                            loCount++;
+                        }
+                    }
+                }
+
+                double amount = potAmounts[p];
+                double hiShare = (loCount > 0) ? amount / 2.0 : amount;
+                for (int seat : eligible) {
+                    if (hiValues[seat] == bestHi) {
+                        totals[seat] += hiShare / hiCount;
+                    }
+                    if (loCount > 0 && loValues[seat] == bestLo) {
+                        totals[seat] += (amount - hiShare) / loCount;
+                    }
+                }
+            }
+        }
+    };
+}
+
+double EquityCalculator::countCompletions(const std::vector<std::vector<Card>>& seatCards,
+                                          const std::vector<Card>& board,
+                                          const std::vector<SidePot>& pots,
+                                          int deckSize,
+                                          const VariantInfo& variant) {
+    std::vector<Slot> slots = buildSlots(seatCards, board, collectLiveSeats(seatCards, pots), variant);
+    double total = 1.0;
+    int available = deckSize;
+    for (const Slot& slot : slots) {
+        total *= choose(available, slot.need);
+        available -= slot.need;
+    }
+    return total;
+}
+
+std::vector<double> EquityCalculator::expectedPotShares(const std::vector<std::vector<Card>>& seatCards,
+                                                        const std::vector<Card>& board,
+                                                        const std::vector<Card>& remainingDeck,
+                                                        const std::vector<SidePot>& pots,
+                                                        const VariantInfo& variant,
+                                                        long long maxCompletions) {
+    double completions = countCompletions(seatCards, board, pots,
+                                          static_cast<int>(remainingDeck.size()), variant);
+    if (completions > static_cast<double>(maxCompletions)) {
+        return {};
+    }
+
+    Enumerator enumerator(seatCards, board, remainingDeck, pots, variant);
+    return enumerator.run();
+}
@@ -0,0 +1,35 @@
+#ifndef EQUITY_H
+#define EQUITY_H
+
+#include "card.h"
+#include "variants.h"
+#include "side_pot.h"
+#include <vector>
+
+// Exact all-in equity by enumerating every way the remaining cards can fall.
+// Board games share the missing community cards; Stud deals each live seat
+// its own missing cards from the same remaining deck.
+class EquityCalculator {
+public:
+    static const long long DEFAULT_MAX_COMPLETIONS = 2000000;
+
+    // Expected chips each seat collects from the pots (indexed by seat).
+    // seatCards holds each seat's known cards; seats that are out of the hand
+    // must not appear in any pot's eligible set. Returns an empty vector if the
+    // enumeration would exceed maxCompletions.
+    static std::vector<double> expectedPotShares(const std::vector<std::vector<Card>>& seatCards,
+                                                 const std::vector<Card>& board,
+                                                 const std::vector<Card>& remainingDeck,
+                                                 const std::vector<SidePot>& pots,
+                                                 const VariantInfo& variant,
+                                                 long long maxCompletions = DEFAULT_MAX_COMPLETIONS);
+
+    // Number of distinct completions the enumeration above would visit
+    static double countCompletions(const std::vector<std::vector<Card>>& seatCards,
+                                   const std::vector<Card>& board,
+                                   const std::vector<SidePot>& pots,
+                                   int deckSize,
+                                   const VariantInfo& variant);
+};
+
+#endif
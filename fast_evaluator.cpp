@@ -0,0 +1,239 @@
+#include "fast_evaluator.h"
+#include "metrics.h"
+#include <algorithm>
+
+namespace {
+    const int RANK_BITS = 0x1FFF; // Thirteen ranks per suit lane
+    
+    // Table lookup beats __builtin_popcount when the target has no popcnt instruction
+    struct RankCounts {
+        unsigned char count[RANK_BITS + 1];
+        RankCounts() {
+            for (int bits = 0; bits <= RANK_BITS; bits++) {
+                count[bits] = static_cast<unsigned char>(__builtin_popcount(static_cast<unsigned>(bits)));
+            }
+        }
+    };
+    const RankCounts rankCounts;
+    
+    inline int bitCount(int rankBits) {
+        return rankCounts.count[rankBits];
+    }
+
+    inline int suitBits(CardMask cards, int suit) {
+        return static_cast<int>((cards >> (16 * suit)) & RANK_BITS);
+    }
+}
+
+CardMask FastEvaluator::cardMask(const Card& card) {
+    int suit = static_cast<int>(card.getSuit());
+    int rankBit = static_cast<int>(card.getRank()) - 2;
+    return CardMask(1) << (16 * suit + rankBit);
+}
+
+CardMask FastEvaluator::handMask(const std::vector<Card>& cards) {
+    CardMask mask = 0;
+    for (const Card& card : cards) {
+        mask |= cardMask(card);
+    }
+    return mask;
+}
+
+int FastEvaluator::countCards(CardMask cards) {
+    return __builtin_popcountll(cards);
+}
+
+int FastEvaluator::highestBit(int rankBits) {
+    return 31 - __builtin_clz(static_cast<unsigned>(rankBits));
+}
+
+int FastEvaluator::keepHighestBits(int rankBits, int count) {
+    while (bitCount(rankBits) > count) {
+        rankBits &= rankBits - 1; // Drop the lowest rank
+    }
+    return rankBits;
+}
+
+int FastEvaluator::straightHigh(int rankBits) {
+    // Shift up one place and copy the ace into bit 0 so the wheel is found too
+    int m = (rankBits << 1) | ((rankBits >> 12) & 1);
+    int runs = m & (m >> 1) & (m >> 2) & (m >> 3) & (m >> 4);
+    if (runs == 0) return 0;
+    return highestBit(runs) + 5; // Rank value of the top card (5 for the wheel)
+}
+
+int FastEvaluator::packKickers(int rankBits, int count) {
+    // Highest ranks first, one nibble each, holding the rank value (2-14)
+    int packed = 0;
+    for (int i = 0; i < count && rankBits != 0; i++) {
+        int bit = highestBit(rankBits);
+        packed = (packed << 4) | (bit + 2);
+        rankBits &= ~(1 << bit);
+    }
+    return packed;
+}
+
+int FastEvaluator::evaluate(CardMask cards) {
+    Metrics::countEvaluation(countCards(cards) > 5 ? EvaluatorKind::SEVEN_CARD : EvaluatorKind::FIVE_CARD);
+    return evaluateUncounted(cards);
+}
+
+int FastEvaluator::evaluateUncounted(CardMask cards) {
+    int s0 = suitBits(cards, 0);
+    int s1 = suitBits(cards, 1);
+    int s2 = suitBits(cards, 2);
+    int s3 = suitBits(cards, 3);
+    int all = s0 | s1 | s2 | s3;
+
+    // Flushes (and straight flushes) are decided within a single suit lane
+    int flushBits = 0;
+    const int lanes[4] = {s0, s1, s2, s3};
+    for (int lane : lanes) {
+        if (bitCount(lane) >= 5) {
+            flushBits = lane;
+            break;
+        }
+    }
+    if (flushBits) {
+        int high = straightHigh(flushBits);
+        if (high == 14) {
+            return (static_cast<int>(HandRank::ROYAL_FLUSH) << 20) | (high << 16);
+        }
+        if (high) {
+            return (static_cast<int>(HandRank::STRAIGHT_FLUSH) << 20) | (high << 16);
+        }
+    }
+
+    int quads = s0 & s1 & s2 & s3;
+    int threePlus = (s0 & s1 & s2) | (s0 & s1 & s3) | (s0 & s2 & s3) | (s1 & s2 & s3);
+    int twoPlus = (s0 & s1) | (s0 & s2) | (s0 & s3) | (s1 & s2) | (s1 & s3) | (s2 & s3);
+    int trips = threePlus & ~quads;
+    int pairs = twoPlus & ~threePlus;
+
+    if (quads) {
+        int q = highestBit(quads);
+        return (static_cast<int>(HandRank::FOUR_OF_A_KIND) << 20) | ((q + 2) << 16) |
+               (packKickers(all & ~(1 << q), 1) << 12);
+    }
+
+    if (trips) {
+        int t = highestBit(trips);
+        int pairCandidates = (trips & ~(1 << t)) | pairs;
+        if (pairCandidates) {
+            int p = highestBit(pairCandidates);
+            return (static_cast<int>(HandRank::FULL_HOUSE) << 20) | ((t + 2) << 16) | ((p + 2) << 12);
+        }
+    }
+
+    if (flushBits) {
+        return (static_cast<int>(HandRank::FLUSH) << 20) | packKickers(flushBits, 5);
+    }
+
+    int high = straightHigh(all);
+    if (high) {
+        return (static_cast<int>(HandRank::STRAIGHT) << 20) | (high << 16);
+    }
+
+    if (trips) {
+        int t = highestBit(trips);
+        return (static_cast<int>(HandRank::THREE_OF_A_KIND) << 20) | ((t + 2) << 16) |
+               (packKickers(all & ~(1 << t), 2) << 8);
+    }
+
+    if (bitCount(pairs) >= 2) {
+        int p1 = highestBit(pairs);
+        int p2 = highestBit(pairs & ~(1 << p1));
+        return (static_cast<int>(HandRank::TWO_PAIR) << 20) | ((p1 + 2) << 16) | ((p2 + 2) << 12) |
+               (packKickers(all & ~(1 << p1) & ~(1 << p2), 1) << 8);
+    }
+
+    if (pairs) {
+        int p = highestBit(pairs);
+        return (static_cast<int>(HandRank::ONE_PAIR) << 20) | ((p + 2) << 16) |
+               (packKickers(all & ~(1 << p), 3) << 4);
+    }
+
+    return (static_cast<int>(HandRank::HIGH_CARD) << 20) | packKickers(keepHighestBits(all, 5), 5);
+}
+
+int FastEvaluator::evaluateLowA5(CardMask cards) {
+    Metrics::countEvaluation(EvaluatorKind::LOW);
+    return evaluateLowA5Uncounted(cards);
+}
+
+int FastEvaluator::evaluateLowA5Uncounted(CardMask cards) {
+    int all = suitBits(cards, 0) | suitBits(cards, 1) | suitBits(cards, 2) | suitBits(cards, 3);
+
+    // Re-map so bit 0 is the ace and bit 7 is the eight; anything higher can't play
+    int lowBits = ((all & 0x7F) << 1) | ((all >> 12) & 1);
+    if (bitCount(lowBits) < 5) {
+        return FAST_LOW_UNQUALIFIED;
+    }
+    while (bitCount(lowBits) > 5) {
+        lowBits &= ~(1 << highestBit(lowBits)); // Drop the highest low card
+    }
+    // For equal-sized rank sets the integer order is the low-hand order
+    return lowBits;
+}
+
+int FastEvaluator::evaluateOmaha(const std::vector<Card>& holeCards, const std::vector<Card>& board) {
+    CardMask hole[4];
+    CardMask community[5];
+    int holeCount = static_cast<int>(std::min<size_t>(holeCards.size(), 4));
+    int boardCount = static_cast<int>(std::min<size_t>(board.size(), 5));
+    for (int i = 0; i < holeCount; i++) hole[i] = cardMask(holeCards[i]);
+    for (int i = 0; i < boardCount; i++) community[i] = cardMask(board[i]);
+    return evaluateOmaha(hole, holeCount, community, boardCount);
+}
+
+int FastEvaluator::evaluateOmahaLowA5(const std::vector<Card>& holeCards, const std::vector<Card>& board) {
+    CardMask hole[4];
+    CardMask community[5];
+    int holeCount = static_cast<int>(std::min<size_t>(holeCards.size(), 4));
+    int boardCount = static_cast<int>(std::min<size_t>(board.size(), 5));
+    for (int i = 0; i < holeCount; i++) hole[i] = cardMask(holeCards[i]);
+    for (int i = 0; i < boardCount; i++) community[i] = cardMask(board[i]);
+    return evaluateOmahaLowA5(hole, holeCount, community, boardCount);
+}
+
+int FastEvaluator::evaluateOmaha(const CardMask* hole, int holeCount, const CardMask* board, int boardCount) {
+    Metrics::countEvaluation(EvaluatorKind::OMAHA_HI);
+    int best = 0;
+    for (int h1 = 0; h1 < holeCount; h1++) {
+        for (int h2 = h1 + 1; h2 < holeCount; h2++) {
+            CardMask two = hole[h1] | hole[h2];
+            for (int c1 = 0; c1 < boardCount; c1++) {
+                for (int c2 = c1 + 1; c2 < boardCount; c2++) {
+                    for (int c3 = c2 + 1; c3 < boardCount; c3++) {
+                        int value = evaluateUncounted(two | board[c1] | board[c2] | board[c3]);
+                        if (value > best) best = value;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+int FastEvaluator::evaluateOmahaLowA5(const CardMask* hole, int holeCount, const CardMask* board, int boardCount) {
+    Metrics::countEvaluation(EvaluatorKind::LOW);
+    int best = FAST_LOW_UNQUALIFIED;
+    for (int h1 = 0; h1 < holeCount; h1++) {
+        for (int h2 = h1 + 1; h2 < holeCount; h2++) {
+            CardMask two = hole[h1] | hole[h2];
+            for (int c1 = 0; c1 < boardCount; c1++) {
+                for (int c2 = c1 + 1; c2 < boardCount; c2++) {
+                    for (int c3 = c2 + 1; c3 < boardCount; c3++) {
+                        int value = evaluateLowA5Uncounted(two | board[c1] | board[c2] | board[c3]);
+                        if (value < best) best = value;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+HandRank FastEvaluator::getHandRank(int value) {
+    return static_cast<HandRank>(value >> 20);
+}
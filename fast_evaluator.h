@@ -0,0 +1,49 @@
+#ifndef FAST_EVALUATOR_H
+#define FAST_EVALUATOR_H
+
+#include "card.h"
+#include "hand_evaluator.h"
+#include <vector>
+#include <cstdint>
+
+// Bit-mask card set: each suit owns a 16-bit lane, bit (rank - 2) within the lane
+typedef uint64_t CardMask;
+
+// Value returned for a hand that does not make a qualifying A-5 low
+const int FAST_LOW_UNQUALIFIED = 0x7FFFFFFF;
+
+// Allocation-free hand evaluator for simulation paths (equity, runouts).
+// Produces a single comparable integer per hand instead of a HandResult;
+// the ordering matches HandEvaluator, but no descriptions are built.
+class FastEvaluator {
+public:
+    static CardMask cardMask(const Card& card);
+    static CardMask handMask(const std::vector<Card>& cards);
+    static int countCards(CardMask cards);
+
+    // Best five-card high hand from any 5-7 cards (higher is better)
+    static int evaluate(CardMask cards);
+    // Best A-5 low, 8-or-better (lower is better, FAST_LOW_UNQUALIFIED if none)
+    static int evaluateLowA5(CardMask cards);
+    // Same values without a Metrics count, for evaluations made inside another
+    // entry point (Omaha combinations, hand-strength tables)
+    static int evaluateUncounted(CardMask cards);
+    static int evaluateLowA5Uncounted(CardMask cards);
+
+    // Omaha: exactly two hole cards plus three board cards
+    static int evaluateOmaha(const std::vector<Card>& holeCards, const std::vector<Card>& board);
+    static int evaluateOmahaLowA5(const std::vector<Card>& holeCards, const std::vector<Card>& board);
+    // Same as above over arrays of single-card masks (no vectors built per call)
+    static int evaluateOmaha(const CardMask* hole, int holeCount, const CardMask* board, int boardCount);
+    static int evaluateOmahaLowA5(const CardMask* hole, int holeCount, const CardMask* board, int boardCount);
+
+    static HandRank getHandRank(int value);
+
+private:
+    static int keepHighestBits(int rankBits, int count);
+    static int highestBit(int rankBits);
+    static int straightHigh(int rankBits);
+    static int packKickers(int rankBits, int count);
+};
+
+#endif
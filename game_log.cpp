@@ -0,0 +1,19 @@
+#include "game_log.h"
+#include <iostream>
+
+namespace {
+    thread_local bool outputEnabled = true;
+    thread_local std::ostream nullStream(nullptr); // No buffer: every write is a no-op
+}
+
+std::ostream& GameLog::out() {
+    return outputEnabled ? std::cout : nullStream;
+}
+
+void GameLog::setEnabled(bool enabled) {
+    outputEnabled = enabled;
+}
+
+bool GameLog::isEnabled() {
+    return outputEnabled;
+}
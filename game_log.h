@@ -0,0 +1,15 @@
+#ifndef GAME_LOG_H
+#define GAME_LOG_H
+
+#include <ostream>
+
+// Console output for the engine (table display, action log, debug dumps).
+// Output is enabled by default; simulation and scheduler threads running many
+// tables silence it for their own thread without affecting the others.
+namespace GameLog {
+    std::ostream& out();
+    void setEnabled(bool enabled);
+    bool isEnabled();
+}
+
+#endif
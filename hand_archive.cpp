@@ -0,0 +1,308 @@
+#include "hand_archive.h"
+#include "trace_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'H', 'A', 'N', 'D', 'A', 'R', 'C', 'H'};
+    const uint32_t FILE_VERSION = 1;
+    const int MAX_IOVECS = 512;                 // Comfortably under IOV_MAX
+    const auto IDLE_WAIT = std::chrono::milliseconds(1);
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+    };
+
+    bool writeFully(int fd, iovec* iov, int count) {
+        while (count > 0) {
+            ssize_t written = writev(fd, iov, count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            // Skip what went out; a short write leaves the rest for another call
+            size_t remaining = static_cast<size_t>(written);
+            while (count > 0 && remaining >= iov->iov_len) {
+                remaining -= iov->iov_len;
+                iov++;
+                count--;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+                iov->iov_len -= remaining;
+            }
+        }
+        return true;
+    }
+}
+
+ArchiveRing::ArchiveRing(size_t requested)
+    : capacity(1), tail(0), handTail(0), cachedHead(0), handsStarted(0), ringIndex(0), stalls(0),
+      head(0) {
+    while (capacity < requested) capacity <<= 1;
+    mask = capacity - 1;
+    slots.reset(new ArchiveRecord[capacity]);
+}
+
+void ArchiveRing::pushSlow(const ArchiveRecord& record) {
+    // Only this producer writes the counter, so no read-modify-write is needed
+    stalls.store(stalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    while (!tryPush(record)) {
+        std::this_thread::yield();
+    }
+}
+
+HandArchive::HandArchive()
+    : fd(-1), stopping(false), flushWaiters(0), recordsWritten(0), batches(0), writeErrors(0), nextRing(0) {
+}
+
+HandArchive::~HandArchive() {
+    close();
+}
+
+bool HandArchive::open(const std::string& path) {
+    close();
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (file < 0) return false;
+
+    // A matching header means appending; anything else starts the file over
+    FileHeader header;
+    bool matches = pread(file, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                   std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == FILE_VERSION &&
+                   header.recordSize == sizeof(ArchiveRecord);
+    if (!matches) {
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FILE_VERSION;
+        header.recordSize = sizeof(ArchiveRecord);
+        if (ftruncate(file, 0) != 0 || write(file, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+            ::close(file);
+            return false;
+        }
+    } else {
+        // Drop a torn record left by a crash so appends stay aligned
+        struct stat info;
+        if (fstat(file, &info) == 0) {
+            off_t body = info.st_size - static_cast<off_t>(sizeof(header));
+            off_t whole = body - body % static_cast<off_t>(sizeof(ArchiveRecord));
+            if (whole != body && ftruncate(file, static_cast<off_t>(sizeof(header)) + whole) != 0) {
+                ::close(file);
+                return false;
+            }
+        }
+    }
+
+    fd = file;
+    stopping.store(false);
+    writer = std::thread(&HandArchive::writerLoop, this);
+    return true;
+}
+
+void HandArchive::close() {
+    if (fd < 0) return;
+    stopping.store(true, std::memory_order_release);
+    writerWake.notify_one();
+    writer.join();
+    ::close(fd);
+    fd = -1;
+}
+
+ArchiveRing* HandArchive::addRing(size_t capacity) {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    rings.emplace_back(new ArchiveRing(capacity));
+    rings.back()->ringIndex = rings.size() - 1;
+    return rings.back().get();
+}
+
+uint64_t HandArchive::getProducerStalls() const {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    uint64_t total = 0;
+    for (const auto& ring : rings) total += ring->getStalls();
+    return total;
+}
+
+bool HandArchive::drainOnce(bool everything) {
+    std::vector<ArchiveRing*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringMutex);
+        for (const auto& ring : rings) snapshot.push_back(ring.get());
+    }
+
+    iovec iov[MAX_IOVECS];
+    int iovCount = 0;
+    std::vector<std::pair<ArchiveRing*, uint64_t>> advanced;
+    uint64_t records = 0;
+    size_t ringCount = snapshot.size();
+    for (size_t r = 0; r < ringCount; r++) {
+        if (iovCount + 2 > MAX_IOVECS) break; // The rest go in the next batch
+        ArchiveRing* ring = snapshot[(nextRing + r) % ringCount];
+        uint64_t start = ring->head.load(std::memory_order_relaxed);
+        uint64_t published = ring->tail.load(std::memory_order_acquire);
+        // Whole hands only, unless the ring is half full or someone is waiting on a flush
+        uint64_t end = everything || published - start >= ring->capacity / 2
+                     ? published : ring->handTail.load(std::memory_order_acquire);
+        if (end <= start) continue;
+
+        size_t first = static_cast<size_t>(start & ring->mask);
+        size_t count = static_cast<size_t>(end - start);
+        size_t firstPart = std::min(count, ring->capacity - first);
+        iov[iovCount++] = {&ring->slots[first], firstPart * sizeof(ArchiveRecord)};
+        if (count > firstPart) {
+            iov[iovCount++] = {&ring->slots[0], (count - firstPart) * sizeof(ArchiveRecord)};
+        }
+        advanced.push_back({ring, end});
+        records += count;
+    }
+    if (iovCount == 0) return false;
+    nextRing = ringCount > 0 ? (nextRing + 1) % ringCount : 0;
+
+    TraceSpan span("archive write", -1);
+    if (!writeFully(fd, iov, iovCount)) {
+        writeErrors.fetch_add(1, std::memory_order_relaxed); // Records are dropped rather than stalling tables
+    }
+    for (const auto& entry : advanced) {
+        entry.first->head.store(entry.second, std::memory_order_release);
+    }
+    recordsWritten.fetch_add(records, std::memory_order_relaxed);
+    batches.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void HandArchive::writerLoop() {
+    Trace::nameThread("archive writer");
+    while (true) {
+        bool stop = stopping.load(std::memory_order_acquire);
+        bool wrote = drainOnce(stop || flushWaiters.load(std::memory_order_acquire) > 0);
+        if (wrote) {
+            std::lock_guard<std::mutex> lock(flushMutex);
+            flushProgress.notify_all();
+            continue;
+        }
+        if (stop) break;
+
+        std::unique_lock<std::mutex> lock(flushMutex);
+        flushProgress.notify_all();
+        writerWake.wait_for(lock, IDLE_WAIT);
+    }
+}
+
+void HandArchive::flush() {
+    if (fd < 0) return;
+    std::vector<std::pair<ArchiveRing*, uint64_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(ringMutex);
+        for (const auto& ring : rings) targets.push_back({ring.get(), ring->tail.load(std::memory_order_acquire)});
+    }
+
+    std::unique_lock<std::mutex> lock(flushMutex);
+    flushWaiters.fetch_add(1, std::memory_order_acq_rel);
+    writerWake.notify_one();
+    flushProgress.wait(lock, [&] {
+        for (const auto& target : targets) {
+            if (target.first->head.load(std::memory_order_acquire) < target.second) return false;
+        }
+        return true;
+    });
+    flushWaiters.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool HandArchive::readHands(const std::string& path,
+                            const std::function<void(int tableId, const HandHistory& hand)>& visit) {
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(file);
+        return false;
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (base == MAP_FAILED) return false;
+
+    const FileHeader* header = static_cast<const FileHeader*>(base);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != FILE_VERSION ||
+        header->recordSize != sizeof(ArchiveRecord)) {
+        munmap(base, length);
+        return false;
+    }
+    madvise(base, length, MADV_SEQUENTIAL);
+
+    const ArchiveRecord* records = reinterpret_cast<const ArchiveRecord*>(static_cast<const char*>(base) + sizeof(FileHeader));
+    size_t count = (length - sizeof(FileHeader)) / sizeof(ArchiveRecord);
+
+    // Hands in progress by (table, hand id); records of one hand arrive in order
+    struct OpenHand {
+        HandHistory history;
+        std::vector<int> winners;
+        std::vector<int> amounts;
+    };
+    std::map<std::pair<int, uint64_t>, OpenHand> open;
+    for (size_t i = 0; i < count; i++) {
+        const ArchiveRecord& record = records[i];
+        std::pair<int, uint64_t> key(record.tableId, record.handId);
+        if (record.kind == ArchiveRecordKind::HAND_START) {
+            OpenHand hand = {HandHistory(static_cast<PokerVariant>(record.amount), record.pot), {}, {}};
+            open.erase(key);
+            open.emplace(key, std::move(hand));
+            continue;
+        }
+        auto found = open.find(key);
+        if (found == open.end()) continue; // Its start was lost
+
+        OpenHand& hand = found->second;
+        switch (record.kind) {
+            case ArchiveRecordKind::PLAYER:
+                hand.history.addPlayer(record.playerId,
+                                       std::string(reinterpret_cast<const char*>(record.data), record.count),
+                                       record.pot, record.amount, record.flags != 0);
+                break;
+            case ArchiveRecordKind::ACTION: {
+                GameAction action;
+                action.round = static_cast<HandHistoryRound>(record.round);
+                action.playerId = record.playerId;
+                action.actionType = static_cast<ActionType>(record.actionType);
+                action.amount = record.amount;
+                action.potAfterAction = record.pot;
+                for (int c = 0; c < record.count; c++) {
+                    action.cardsDealt.push_back(Card::fromIndex(record.data[c]));
+                }
+                hand.history.appendAction(action);
+                break;
+            }
+            case ArchiveRecordKind::AWARD:
+                hand.winners.push_back(record.playerId);
+                hand.amounts.push_back(record.amount);
+                break;
+            case ArchiveRecordKind::HAND_END: {
+                std::string description;
+                for (size_t w = 0; w < hand.winners.size(); w++) {
+                    std::string name = "Player " + std::to_string(hand.winners[w]);
+                    for (const PlayerInfo& player : hand.history.getPlayers()) {
+                        if (player.playerId == hand.winners[w]) name = player.name;
+                    }
+                    if (!description.empty()) description += ", ";
+                    description += name + " wins $" + std::to_string(hand.amounts[w]);
+                }
+                hand.history.recordResolution(hand.winners, hand.amounts, description);
+                visit(record.tableId, hand.history);
+                open.erase(found);
+                break;
+            }
+            case ArchiveRecordKind::HAND_START:
+                break;
+        }
+    }
+
+    munmap(base, length);
+    return true;
+}
@@ -0,0 +1,147 @@
+#ifndef HAND_ARCHIVE_H
+#define HAND_ARCHIVE_H
+
+#include "hand_history.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+enum class ArchiveRecordKind : uint8_t {
+    HAND_START, // amount = PokerVariant, pot = HandHistory hand number
+    PLAYER,     // amount = starting chips, pot = seat, flags = dealer, data = name
+    ACTION,     // One GameAction; data = dealt cards as Card::getIndex()
+    AWARD,      // amount = chips won by playerId
+    HAND_END    // The resolution is complete
+};
+
+// Fixed-size archive record. Every record carries its table and hand, so
+// records from different rings may interleave in the file.
+struct ArchiveRecord {
+    static const int DATA_SIZE = 11;
+
+    uint64_t handId;  // Ring index in the top bits, then the ring's own hand sequence
+    int32_t tableId;
+    int32_t playerId;
+    int32_t amount;
+    int32_t pot;
+    ArchiveRecordKind kind;
+    uint8_t round;      // HandHistoryRound
+    uint8_t actionType; // ActionType
+    uint8_t count;      // Cards or name characters in data
+    uint8_t flags;
+    uint8_t data[DATA_SIZE];
+};
+
+// Single-producer/single-consumer ring of records from one table thread to
+// the archive writer. The producer only touches the tail and the writer
+// only the head, each on its own cache line, so a push is a slot copy and
+// one release store. The writer reads published slots in place and hands
+// them straight to writev.
+class ArchiveRing {
+public:
+    explicit ArchiveRing(size_t capacity); // Rounded up to a power of two
+
+    // Producer side. push spins while the ring is full, counting the stall.
+    bool tryPush(const ArchiveRecord& record) {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead >= capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead >= capacity) return false;
+        }
+        slots[position & mask] = record;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    void push(const ArchiveRecord& record) {
+        if (!tryPush(record)) pushSlow(record);
+    }
+    void markHandComplete() { handTail.store(tail.load(std::memory_order_relaxed), std::memory_order_release); }
+    uint64_t nextHandId() { return (ringIndex << 40) | ++handsStarted; }
+
+    uint64_t getStalls() const { return stalls.load(std::memory_order_relaxed); }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    friend class HandArchive;
+
+    static const int CACHE_LINE = 64;
+
+    std::unique_ptr<ArchiveRecord[]> slots;
+    size_t capacity;
+    size_t mask;
+    char producerPad[CACHE_LINE];
+    std::atomic<uint64_t> tail;     // Published records
+    std::atomic<uint64_t> handTail; // End of the last complete hand
+    uint64_t cachedHead;            // Producer's view of head
+    uint64_t handsStarted;
+    uint64_t ringIndex; // Keeps hand ids apart when rings share a table id
+    std::atomic<uint64_t> stalls;
+    char writerPad[CACHE_LINE];
+    std::atomic<uint64_t> head;     // Written records
+    char tailPad[CACHE_LINE];
+
+    void pushSlow(const ArchiveRecord& record);
+};
+
+// Binary hand-history archive. Table threads write records into their own
+// rings; one writer thread drains every ring in large writev batches, so
+// game threads never block on the file. The writer commits whole hands:
+// a ring is drained up to its last HAND_END (written by
+// HandHistory::recordResolution) unless it is filling up or a flush is
+// waiting, so the archive only ends mid-hand after a crash.
+class HandArchive {
+public:
+    static const size_t DEFAULT_RING_CAPACITY = 1 << 14;
+
+    HandArchive();
+    ~HandArchive(); // close()
+    HandArchive(const HandArchive&) = delete;
+    HandArchive& operator=(const HandArchive&) = delete;
+
+    // Appends to an existing archive, otherwise starts a new one; false on a file error
+    bool open(const std::string& path);
+    void close(); // Drains every ring and stops the writer
+    bool isOpen() const { return fd >= 0; }
+
+    // One ring per producing thread or table; stays valid until the archive is destroyed
+    ArchiveRing* addRing(size_t capacity = DEFAULT_RING_CAPACITY);
+
+    // Barrier: returns once every record pushed before the call is written
+    void flush();
+
+    uint64_t getRecordsWritten() const { return recordsWritten.load(std::memory_order_relaxed); }
+    uint64_t getBatches() const { return batches.load(std::memory_order_relaxed); }
+    uint64_t getWriteErrors() const { return writeErrors.load(std::memory_order_relaxed); }
+    uint64_t getProducerStalls() const; // Pushes that found their ring full
+
+    // Rebuilds every complete hand in an archive, in file order. The callback
+    // gets the table id and the hand; false if the file is not an archive.
+    static bool readHands(const std::string& path,
+                          const std::function<void(int tableId, const HandHistory& hand)>& visit);
+
+private:
+    int fd;
+    std::vector<std::unique_ptr<ArchiveRing>> rings;
+    mutable std::mutex ringMutex; // Guards rings while the writer snapshots them
+    std::thread writer;
+    std::atomic<bool> stopping;
+    std::atomic<int> flushWaiters;
+    std::mutex flushMutex;
+    std::condition_variable flushProgress;
+    std::condition_variable writerWake;
+    std::atomic<uint64_t> recordsWritten;
+    std::atomic<uint64_t> batches;
+    std::atomic<uint64_t> writeErrors;
+    size_t nextRing; // Where the next batch starts, so no ring waits behind the others
+
+    void writerLoop();
+    bool drainOnce(bool everything);
+};
+
+#endif
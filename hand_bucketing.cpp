@@ -0,0 +1,477 @@
+#include "hand_bucketing.h"
+#include "hand_indexer.h"
+#include "fast_evaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char HISTOGRAM_MAGIC[8] = {'E', 'Q', 'H', 'I', 'S', 'T', 'O', 'G'};
+    const char CENTROID_MAGIC[8] = {'C', 'E', 'N', 'T', 'R', 'O', 'I', 'D'};
+    const char BUCKET_MAGIC[8] = {'B', 'U', 'C', 'K', 'E', 'T', 'S', ' '};
+    const uint32_t FILE_VERSION = 1;
+    const int BINS = HandBucketing::HISTOGRAM_BINS;
+    const int DECK_SIZE = 52;
+    const int SEED_SAMPLE = 50000; // Situations k-means++ picks its starting centroids from
+    const double CONVERGED = 1e-6; // Largest centroid move that ends clustering early
+
+    struct HistogramHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t round;
+        uint32_t bins;
+        uint32_t runouts;
+        uint32_t opponents;
+        uint32_t seed;
+        uint64_t situations;
+    };
+
+    struct CentroidHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t round;
+        uint32_t buckets;
+        uint32_t bins;
+        uint32_t earthMover;
+        uint32_t passesDone;
+    };
+
+    struct BucketHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t round;
+        uint32_t buckets;
+        uint32_t reserved;
+        uint64_t situations;
+    };
+
+    inline CardMask toCardMask(int cardIndex) {
+        return FastEvaluator::cardMask(Card::fromIndex(cardIndex));
+    }
+
+    long long fileSize(const std::string& path) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 ? static_cast<long long>(info.st_size) : -1;
+    }
+
+    // Whole records already in a resumable file whose header matches; the
+    // file is cut back to the last whole chunk so the next append lines up
+    template <typename Header>
+    uint64_t resumePoint(const std::string& path, const Header& expected, size_t recordSize, uint64_t total) {
+        std::ifstream file(path, std::ios::binary);
+        Header found;
+        if (!file || !file.read(reinterpret_cast<char*>(&found), sizeof(found)) ||
+            std::memcmp(&found, &expected, sizeof(found)) != 0) {
+            return UINT64_MAX;
+        }
+        file.close();
+        uint64_t records = static_cast<uint64_t>(fileSize(path) - sizeof(Header)) / recordSize;
+        if (records >= total) return total;
+        records -= records % HandBucketing::CHUNK;
+        if (truncate(path.c_str(), static_cast<off_t>(sizeof(Header) + records * recordSize)) != 0) {
+            return UINT64_MAX;
+        }
+        return records;
+    }
+
+    // Streams fixed-size records out to a resumable file, one chunk at a time
+    template <typename Header, typename Fill>
+    bool streamRecords(const std::string& path, const Header& header, size_t recordSize, uint64_t total,
+                       std::ostream* progress, const char* label, Fill fill) {
+        uint64_t done = resumePoint(path, header, recordSize, total);
+        std::ofstream file;
+        if (done == UINT64_MAX) {
+            done = 0;
+            file.open(path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        } else {
+            file.open(path, std::ios::binary | std::ios::app);
+        }
+        if (!file) return false;
+        if (progress && done > 0 && done < total) {
+            *progress << label << ": resuming at " << done << " of " << total << std::endl;
+        }
+
+        std::vector<uint8_t> buffer;
+        for (uint64_t start = done; start < total; start += HandBucketing::CHUNK) {
+            int count = static_cast<int>(std::min<uint64_t>(HandBucketing::CHUNK, total - start));
+            buffer.resize(static_cast<size_t>(count) * recordSize);
+            fill(start, count, buffer.data());
+            file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            file.flush();
+            if (!file) return false;
+            if (progress && ((start / HandBucketing::CHUNK) % 16 == 15 || start + count == total)) {
+                *progress << label << ": " << (start + count) << " of " << total << std::endl;
+            }
+        }
+        return true;
+    }
+}
+
+HandBucketing::HandBucketing(const BucketingConfig& bucketingConfig, ThreadPool& threadPool)
+    : config(bucketingConfig), pool(threadPool) {
+    situations = HandIndexer::holdem().getSize(config.round);
+    if (config.limit > 0) situations = std::min(situations, config.limit);
+}
+
+std::string HandBucketing::histogramPath() const {
+    return config.directory + "/histograms_r" + std::to_string(config.round) + ".bin";
+}
+
+std::string HandBucketing::centroidPath() const {
+    return config.directory + "/centroids_r" + std::to_string(config.round) + ".bin";
+}
+
+std::string HandBucketing::bucketPath() const {
+    return config.directory + "/buckets_r" + std::to_string(config.round) + ".bin";
+}
+
+bool HandBucketing::run(std::ostream* progress) {
+    mkdir(config.directory.c_str(), 0755); // Fine if it already exists
+    return computeHistograms(progress) && cluster(progress) && assignBuckets(progress);
+}
+
+void HandBucketing::histogram(uint64_t situation, uint8_t* bins) const {
+    std::vector<Card> cards = HandIndexer::holdem().unindex(config.round, situation);
+    CardMask hole = toCardMask(cards[0].getIndex()) | toCardMask(cards[1].getIndex());
+    CardMask known = 0;
+    for (const Card& card : cards) known |= toCardMask(card.getIndex());
+    std::vector<CardMask> deck;
+    for (int card = 0; card < DECK_SIZE; card++) {
+        if (!(toCardMask(card) & known)) deck.push_back(toCardMask(card));
+    }
+    int missing = 5 - (static_cast<int>(cards.size()) - 2);
+    CardMask board = known & ~hole;
+    std::mt19937_64 rng(config.seed * 0x9E3779B97F4A7C15ull + situation);
+
+    double counts[BINS] = {0.0};
+    auto scoreRiver = [&](CardMask runout) {
+        CardMask fullBoard = board | runout;
+        int value = FastEvaluator::evaluate(hole | fullBoard);
+        std::vector<CardMask> rest;
+        for (CardMask card : deck) {
+            if (!(card & runout)) rest.push_back(card);
+        }
+        int n = static_cast<int>(rest.size());
+        double ahead = 0.0;
+        int seen = 0;
+        auto against = [&](CardMask opponent) {
+            int opponentValue = FastEvaluator::evaluate(opponent | fullBoard);
+            ahead += value > opponentValue ? 1.0 : (value == opponentValue ? 0.5 : 0.0);
+            seen++;
+        };
+        if (config.opponents <= 0) {
+            for (int a = 0; a < n; a++)
+                for (int b = a + 1; b < n; b++) against(rest[a] | rest[b]);
+        } else {
+            for (int s = 0; s < config.opponents; s++) {
+                int a = static_cast<int>(rng() % n);
+                int b = static_cast<int>(rng() % (n - 1));
+                if (b >= a) b++;
+                against(rest[a] | rest[b]);
+            }
+        }
+        double strength = ahead / seen;
+        counts[std::min(BINS - 1, static_cast<int>(strength * BINS))] += 1.0;
+    };
+
+    int n = static_cast<int>(deck.size());
+    if (missing == 0) {
+        scoreRiver(0);
+    } else if (config.runouts <= 0) {
+        for (int a = 0; a < n; a++) {
+            if (missing == 1) {
+                scoreRiver(deck[a]);
+                continue;
+            }
+            for (int b = a + 1; b < n; b++) scoreRiver(deck[a] | deck[b]);
+        }
+    } else {
+        for (int s = 0; s < config.runouts; s++) {
+            CardMask runout = 0;
+            for (int dealt = 0; dealt < missing;) {
+                CardMask card = deck[rng() % n];
+                if (card & runout) continue;
+                runout |= card;
+                dealt++;
+            }
+            scoreRiver(runout);
+        }
+    }
+
+    double total = 0.0;
+    for (double count : counts) total += count;
+    for (int b = 0; b < BINS; b++) {
+        bins[b] = static_cast<uint8_t>(std::lround(255.0 * counts[b] / total));
+    }
+}
+
+bool HandBucketing::computeHistograms(std::ostream* progress) {
+    HistogramHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, HISTOGRAM_MAGIC, sizeof(HISTOGRAM_MAGIC));
+    header.version = FILE_VERSION;
+    header.round = static_cast<uint32_t>(config.round);
+    header.bins = BINS;
+    header.runouts = static_cast<uint32_t>(std::max(0, config.runouts));
+    header.opponents = static_cast<uint32_t>(std::max(0, config.opponents));
+    header.seed = config.seed;
+    header.situations = situations;
+
+    return streamRecords(histogramPath(), header, BINS, situations, progress, "histograms",
+                         [&](uint64_t start, int count, uint8_t* out) {
+        pool.parallelFor(count, [&](int i, int /* worker */) {
+            histogram(start + i, out + static_cast<size_t>(i) * BINS);
+        });
+    });
+}
+
+void HandBucketing::toPoint(const uint8_t* bins, float* point) const {
+    // Earth mover's distance between 1-D histograms is the L1 distance between
+    // their cumulative sums, so points are stored as cumulative mass
+    float total = 0.0f;
+    for (int b = 0; b < BINS; b++) total += bins[b];
+    float running = 0.0f;
+    for (int b = 0; b < BINS; b++) {
+        float mass = total > 0.0f ? bins[b] / total : 0.0f;
+        running += mass;
+        point[b] = config.earthMover ? running : mass;
+    }
+}
+
+float HandBucketing::distance(const float* a, const float* b) const {
+    float sum = 0.0f;
+    if (config.earthMover) {
+        for (int i = 0; i < BINS; i++) sum += std::fabs(a[i] - b[i]);
+    } else {
+        for (int i = 0; i < BINS; i++) sum += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return sum;
+}
+
+int HandBucketing::nearest(const float* point, const std::vector<float>& centroids) const {
+    int best = 0;
+    float bestDistance = distance(point, centroids.data());
+    for (int c = 1; c < config.buckets; c++) {
+        float d = distance(point, &centroids[static_cast<size_t>(c) * BINS]);
+        if (d < bestDistance) {
+            bestDistance = d;
+            best = c;
+        }
+    }
+    return best;
+}
+
+bool HandBucketing::readCentroids(std::vector<float>& centroids, int& passesDone) const {
+    std::ifstream file(centroidPath(), std::ios::binary);
+    CentroidHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, CENTROID_MAGIC, sizeof(CENTROID_MAGIC)) != 0 || header.version != FILE_VERSION ||
+        header.round != static_cast<uint32_t>(config.round) || header.buckets != static_cast<uint32_t>(config.buckets) ||
+        header.bins != static_cast<uint32_t>(BINS) || header.earthMover != (config.earthMover ? 1u : 0u)) {
+        return false;
+    }
+    centroids.resize(static_cast<size_t>(config.buckets) * BINS);
+    if (!file.read(reinterpret_cast<char*>(centroids.data()), sizeof(float) * centroids.size())) return false;
+    passesDone = static_cast<int>(header.passesDone);
+    return true;
+}
+
+bool HandBucketing::writeCentroids(const std::vector<float>& centroids, int passesDone) const {
+    CentroidHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CENTROID_MAGIC, sizeof(CENTROID_MAGIC));
+    header.version = FILE_VERSION;
+    header.round = static_cast<uint32_t>(config.round);
+    header.buckets = static_cast<uint32_t>(config.buckets);
+    header.bins = BINS;
+    header.earthMover = config.earthMover ? 1 : 0;
+    header.passesDone = static_cast<uint32_t>(passesDone);
+
+    // Write aside and rename, so an interrupted write never loses the last pass
+    std::string temporary = centroidPath() + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(centroids.data()), sizeof(float) * centroids.size());
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), centroidPath().c_str()) == 0;
+}
+
+bool HandBucketing::initialCentroids(std::vector<float>& centroids) const {
+    // k-means++ over evenly spaced situations
+    std::ifstream file(histogramPath(), std::ios::binary);
+    if (!file) return false;
+    uint64_t sampleCount = std::min<uint64_t>(situations, SEED_SAMPLE);
+    std::vector<float> sample(static_cast<size_t>(sampleCount) * BINS);
+    uint8_t bins[BINS];
+    for (uint64_t i = 0; i < sampleCount; i++) {
+        uint64_t situation = i * situations / sampleCount;
+        file.seekg(static_cast<std::streamoff>(sizeof(HistogramHeader) + situation * BINS));
+        if (!file.read(reinterpret_cast<char*>(bins), BINS)) return false;
+        toPoint(bins, &sample[static_cast<size_t>(i) * BINS]);
+    }
+
+    std::mt19937_64 rng(config.seed);
+    centroids.assign(static_cast<size_t>(config.buckets) * BINS, 0.0f);
+    std::vector<double> closest(sampleCount, 1e30);
+    uint64_t pick = rng() % sampleCount;
+    for (int c = 0; c < config.buckets; c++) {
+        std::copy_n(&sample[static_cast<size_t>(pick) * BINS], BINS, &centroids[static_cast<size_t>(c) * BINS]);
+        double total = 0.0;
+        for (uint64_t i = 0; i < sampleCount; i++) {
+            double d = distance(&sample[static_cast<size_t>(i) * BINS], &centroids[static_cast<size_t>(c) * BINS]);
+            closest[i] = std::min(closest[i], d * d);
+            total += closest[i];
+        }
+        // Next centroid drawn in proportion to squared distance from the chosen ones
+        double target = std::uniform_real_distribution<double>(0.0, total)(rng);
+        for (pick = 0; pick + 1 < sampleCount && target >= closest[pick]; pick++) {
+            target -= closest[pick];
+        }
+    }
+    return true;
+}
+
+bool HandBucketing::cluster(std::ostream* progress) {
+    if (fileSize(histogramPath()) != static_cast<long long>(sizeof(HistogramHeader) + situations * BINS)) {
+        return false; // Histograms unfinished
+    }
+
+    std::vector<float> centroids;
+    int passesDone = 0;
+    if (!readCentroids(centroids, passesDone)) {
+        if (!initialCentroids(centroids) || !writeCentroids(centroids, 0)) return false;
+        passesDone = 0;
+    } else if (progress && passesDone < config.passes) {
+        *progress << "k-means: resuming after pass " << passesDone << std::endl;
+    }
+
+    int threads = pool.getThreadCount();
+    size_t cells = static_cast<size_t>(config.buckets) * BINS;
+    std::vector<uint8_t> chunk;
+    for (int pass = passesDone; pass < config.passes; pass++) {
+        // Per-worker sums, merged after the pass
+        std::vector<double> sums(static_cast<size_t>(threads) * cells, 0.0);
+        std::vector<uint64_t> members(static_cast<size_t>(threads) * config.buckets, 0);
+        std::ifstream file(histogramPath(), std::ios::binary);
+        file.seekg(sizeof(HistogramHeader));
+        for (uint64_t start = 0; start < situations; start += CHUNK) {
+            int count = static_cast<int>(std::min<uint64_t>(CHUNK, situations - start));
+            chunk.resize(static_cast<size_t>(count) * BINS);
+            if (!file.read(reinterpret_cast<char*>(chunk.data()), chunk.size())) return false;
+            pool.parallelFor(count, [&](int i, int worker) {
+                float point[BINS];
+                toPoint(&chunk[static_cast<size_t>(i) * BINS], point);
+                int c = nearest(point, centroids);
+                double* sum = &sums[static_cast<size_t>(worker) * cells + static_cast<size_t>(c) * BINS];
+                for (int b = 0; b < BINS; b++) sum[b] += point[b];
+                members[static_cast<size_t>(worker) * config.buckets + c]++;
+            });
+        }
+
+        double moved = 0.0;
+        for (int c = 0; c < config.buckets; c++) {
+            uint64_t size = 0;
+            for (int w = 0; w < threads; w++) size += members[static_cast<size_t>(w) * config.buckets + c];
+            if (size == 0) continue; // Empty bucket keeps its centroid
+            float updated[BINS];
+            for (int b = 0; b < BINS; b++) {
+                double sum = 0.0;
+                for (int w = 0; w < threads; w++) sum += sums[static_cast<size_t>(w) * cells + static_cast<size_t>(c) * BINS + b];
+                updated[b] = static_cast<float>(sum / size);
+            }
+            float* centroid = &centroids[static_cast<size_t>(c) * BINS];
+            moved = std::max(moved, static_cast<double>(distance(updated, centroid)));
+            std::copy_n(updated, BINS, centroid);
+        }
+
+        bool converged = moved < CONVERGED;
+        if (!writeCentroids(centroids, converged ? config.passes : pass + 1)) return false;
+        if (progress) *progress << "k-means pass " << (pass + 1) << ": largest move " << moved << std::endl;
+        if (converged) break;
+    }
+    return true;
+}
+
+bool HandBucketing::assignBuckets(std::ostream* progress) {
+    std::vector<float> centroids;
+    int passesDone = 0;
+    if (!readCentroids(centroids, passesDone)) return false;
+
+    BucketHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BUCKET_MAGIC, sizeof(BUCKET_MAGIC));
+    header.version = FILE_VERSION;
+    header.round = static_cast<uint32_t>(config.round);
+    header.buckets = static_cast<uint32_t>(config.buckets);
+    header.situations = situations;
+
+    std::ifstream histograms(histogramPath(), std::ios::binary);
+    if (!histograms) return false;
+    std::vector<uint8_t> chunk;
+    return streamRecords(bucketPath(), header, sizeof(uint16_t), situations, progress, "buckets",
+                         [&](uint64_t start, int count, uint8_t* out) {
+        chunk.resize(static_cast<size_t>(count) * BINS);
+        histograms.seekg(static_cast<std::streamoff>(sizeof(HistogramHeader) + start * BINS));
+        histograms.read(reinterpret_cast<char*>(chunk.data()), chunk.size());
+        uint16_t* buckets = reinterpret_cast<uint16_t*>(out);
+        pool.parallelFor(count, [&](int i, int /* worker */) {
+            float point[BINS];
+            toPoint(&chunk[static_cast<size_t>(i) * BINS], point);
+            buckets[i] = static_cast<uint16_t>(nearest(point, centroids));
+        });
+    });
+}
+
+BucketMap::BucketMap() : buckets(nullptr), mapped(nullptr), mappedSize(0), round(0), bucketCount(0), size(0) {
+}
+
+BucketMap::~BucketMap() {
+    unload();
+}
+
+void BucketMap::unload() {
+    if (mapped) munmap(mapped, mappedSize);
+    buckets = nullptr;
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+bool BucketMap::load(const std::string& path) {
+    unload();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(BucketHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+
+    const BucketHeader* header = static_cast<const BucketHeader*>(base);
+    if (std::memcmp(header->magic, BUCKET_MAGIC, sizeof(BUCKET_MAGIC)) != 0 || header->version != FILE_VERSION ||
+        length != sizeof(BucketHeader) + header->situations * sizeof(uint16_t)) {
+        munmap(base, length);
+        return false;
+    }
+    mapped = base;
+    mappedSize = length;
+    round = static_cast<int>(header->round);
+    bucketCount = static_cast<int>(header->buckets);
+    size = header->situations;
+    buckets = reinterpret_cast<const uint16_t*>(static_cast<const char*>(base) + sizeof(BucketHeader));
+    return true;
+}
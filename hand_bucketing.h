@@ -0,0 +1,93 @@
+#ifndef HAND_BUCKETING_H
+#define HAND_BUCKETING_H
+
+#include "thread_pool.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+
+// Offline card abstraction for Hold'em. Every canonical situation of one
+// street (HandIndexer::holdem() round 1 = flop, 2 = turn, 3 = river) gets a
+// histogram of its hand strength on the river against a random hand, and
+// k-means groups situations with similar histograms into buckets.
+//
+// All stages stream fixed-size records through files in the working
+// directory, a chunk at a time, so memory stays bounded whatever the street
+// size. Stopping and rerunning picks up where the last run left off:
+// histograms and bucket maps continue from the last whole chunk on disk,
+// and clustering from the last finished pass.
+struct BucketingConfig {
+    std::string directory = ".";
+    int round = 1;
+    int buckets = 50;
+    int runouts = 64;        // Sampled boards to the river per situation; 0 = every one
+    int opponents = 64;      // Sampled opponent hands per river board; 0 = every one
+    int passes = 20;         // k-means passes at most
+    bool earthMover = true;  // Earth mover's distance; false = L2 on the histograms
+    unsigned seed = 1;
+    uint64_t limit = 0;      // Only the first situations (smoke runs); 0 = the whole street
+};
+
+class HandBucketing {
+public:
+    static const int HISTOGRAM_BINS = 10;
+    static const int CHUNK = 1 << 16; // Situations per streamed chunk
+
+    HandBucketing(const BucketingConfig& config, ThreadPool& pool);
+
+    // Runs or resumes every stage; false on a file error
+    bool run(std::ostream* progress = nullptr);
+
+    bool computeHistograms(std::ostream* progress = nullptr);
+    bool cluster(std::ostream* progress = nullptr);
+    bool assignBuckets(std::ostream* progress = nullptr);
+
+    uint64_t getSituations() const { return situations; }
+    std::string histogramPath() const;
+    std::string centroidPath() const;
+    std::string bucketPath() const;
+
+private:
+    BucketingConfig config;
+    ThreadPool& pool;
+    uint64_t situations;
+
+    void histogram(uint64_t situation, uint8_t* bins) const;
+    void toPoint(const uint8_t* bins, float* point) const;
+    float distance(const float* a, const float* b) const;
+    int nearest(const float* point, const std::vector<float>& centroids) const;
+    bool readCentroids(std::vector<float>& centroids, int& passesDone) const;
+    bool writeCentroids(const std::vector<float>& centroids, int passesDone) const;
+    bool initialCentroids(std::vector<float>& centroids) const;
+};
+
+// Finished bucket map for one street, memory-mapped read-only
+class BucketMap {
+public:
+    BucketMap();
+    ~BucketMap();
+    BucketMap(const BucketMap&) = delete;
+    BucketMap& operator=(const BucketMap&) = delete;
+
+    bool load(const std::string& path); // False if missing, unfinished or not a bucket map
+    bool isLoaded() const { return buckets != nullptr; }
+    int getRound() const { return round; }
+    int getBucketCount() const { return bucketCount; }
+    uint64_t getSize() const { return size; }
+
+    // Bucket of a HandIndexer::holdem() index for this street
+    int bucket(uint64_t handIndex) const { return buckets[handIndex]; }
+
+private:
+    const uint16_t* buckets;
+    void* mapped;
+    size_t mappedSize;
+    int round;
+    int bucketCount;
+    uint64_t size;
+
+    void unload();
+};
+
+#endif
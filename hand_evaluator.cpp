@@ -1,4 +1,6 @@
 #include "hand_evaluator.h"
+#include "alloc_stats.h"
+#include "metrics.h"
 #include <algorithm>
 #include <map>
 #include <set>
@@ -44,6 +46,9 @@ bool LowHandResult::operator==(const LowHandResult& other) const {
 
 HandResult HandEvaluator::evaluateHand(const std::vector<Card>& playerCards, 
                                      const std::vector<Card>& communityCards) {
+    ALLOC_SCOPE(AllocTag::EVALUATION);
+    Metrics::countEvaluation(playerCards.size() + communityCards.size() > 5 ? EvaluatorKind::SEVEN_CARD
+                                                                             : EvaluatorKind::FIVE_CARD);
     std::vector<Card> allCards = playerCards;
     allCards.insert(allCards.end(), communityCards.begin(), communityCards.end());
     
@@ -70,12 +75,16 @@ std::vector<Card> HandEvaluator::getBestFiveCards(const std::vector<Card>& allCa
     HandResult bestResult;
     bestResult.rank = HandRank::HIGH_CARD;
     
-    // Use algorithm to generate combinations
-    std::vector<bool> selector(allCards.size());
+    // Use algorithm to generate combinations; the combination buffer is
+    // reused, the selector is scratch on the hand's arena
+    ArenaVector<bool> selector = scratchVector<bool>();
+    selector.resize(allCards.size());
     std::fill(selector.end() - 5, selector.end(), true);
+    std::vector<Card> combination;
+    combination.reserve(5);
     
     do {
-        std::vector<Card> combination;
+        combination.clear();
         for (size_t i = 0; i < allCards.size(); i++) {
             if (selector[i]) {
                 combination.push_back(allCards[i]);
@@ -370,7 +379,8 @@ bool HandEvaluator::isFlush(const std::vector<Card>& cards) {
 }
 
 bool HandEvaluator::isStraight(const std::vector<Card>& cards) {
-    std::vector<int> ranks;
+    ArenaVector<int> ranks = scratchVector<int>();
+    ranks.reserve(cards.size());
     for (const auto& card : cards) {
         ranks.push_back(static_cast<int>(card.getRank()));
     }
@@ -389,13 +399,13 @@ bool HandEvaluator::isStraight(const std::vector<Card>& cards) {
     return true;
 }
 
-std::vector<std::pair<int, Rank>> HandEvaluator::getCardCounts(const std::vector<Card>& cards) {
-    std::map<Rank, int> counts;
+ArenaVector<std::pair<int, Rank>> HandEvaluator::getCardCounts(const std::vector<Card>& cards) {
+    ArenaMap<Rank, int> counts = scratchMap<Rank, int>();
     for (const auto& card : cards) {
         counts[card.getRank()]++;
     }
     
-    std::vector<std::pair<int, Rank>> countPairs;
+    ArenaVector<std::pair<int, Rank>> countPairs = scratchVector<std::pair<int, Rank>>();
     for (const auto& pair : counts) {
         countPairs.emplace_back(pair.second, pair.first);
     }
@@ -440,12 +450,13 @@ std::string HandEvaluator::getSuitName(Suit suit) {
 }
 
 LowHandResult HandEvaluator::evaluate5CardsForLowA5(const std::vector<Card>& fiveCards) {
+    Metrics::countEvaluation(EvaluatorKind::LOW);
     if (fiveCards.size() != 5) {
         return LO_HAND_UNQUALIFIED;
     }
     
     // Convert all ranks to low values (A=1, 2=2, ..., K=13)
-    std::vector<int> ranks;
+    ArenaVector<int> ranks = scratchVector<int>();
     for (const auto& card : fiveCards) {
         int lowValue;
         switch (card.getRank()) {
@@ -470,7 +481,7 @@ LowHandResult HandEvaluator::evaluate5CardsForLowA5(const std::vector<Card>& fiv
     std::sort(ranks.begin(), ranks.end());
     
     // Count pairs/trips/quads - more pairs = worse for low
-    std::map<int, int> counts;
+    ArenaMap<int, int> counts = scratchMap<int, int>();
     for (int rank : ranks) {
         counts[rank]++;
     }
@@ -499,8 +510,8 @@ LowHandResult HandEvaluator::evaluate5CardsForLowA5(const std::vector<Card>& fiv
         }
     } else {
         // Has pairs - add pair ranks first (higher pairs = worse for low)
-        std::vector<int> pairRanks;
-        std::vector<int> kickers;
+        ArenaVector<int> pairRanks = scratchVector<int>();
+        ArenaVector<int> kickers = scratchVector<int>();
         
         for (const auto& count : counts) {
             if (count.second >= 2) {
@@ -550,6 +561,8 @@ LowHandResult HandEvaluator::evaluate5CardsForLowA5(const std::vector<Card>& fiv
 
 LowHandResult HandEvaluator::evaluateLowHand(const std::vector<Card>& playerCards, 
                                             const std::vector<Card>& communityCards) {
+    ALLOC_SCOPE(AllocTag::EVALUATION);
+    Metrics::countEvaluation(EvaluatorKind::LOW);
     // Combine all available cards
     std::vector<Card> allCards = playerCards;
     allCards.insert(allCards.end(), communityCards.begin(), communityCards.end());
@@ -562,11 +575,14 @@ LowHandResult HandEvaluator::evaluateLowHand(const std::vector<Card>& playerCard
     LowHandResult bestLowResult = LO_HAND_UNQUALIFIED;
     
     // Use algorithm to generate combinations  
-    std::vector<bool> selector(allCards.size());
+    ArenaVector<bool> selector = scratchVector<bool>();
+    selector.resize(allCards.size());
     std::fill(selector.end() - 5, selector.end(), true);
+    std::vector<Card> combination;
+    combination.reserve(5);
     
     do {
-        std::vector<Card> combination;
+        combination.clear();
         for (size_t i = 0; i < allCards.size(); ++i) {
             if (selector[i]) {
                 combination.push_back(allCards[i]);
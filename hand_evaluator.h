@@ -2,6 +2,7 @@
 #define HAND_EVALUATOR_H
 
 #include "card.h"
+#include "arena.h"
 #include <vector>
 #include <string>
 
@@ -58,7 +59,7 @@ private:
     static HandResult evaluateFiveCards(const std::vector<Card>& cards);
     static bool isFlush(const std::vector<Card>& cards);
     static bool isStraight(const std::vector<Card>& cards);
-    static std::vector<std::pair<int, Rank>> getCardCounts(const std::vector<Card>& cards);
+    static ArenaVector<std::pair<int, Rank>> getCardCounts(const std::vector<Card>& cards);
     static std::vector<Card> getBestFiveCards(const std::vector<Card>& allCards);
     static std::string getHandDescription(const HandResult& result);
 };
@@ -1,19 +1,78 @@
 #include "hand_history.h"
+#include "hand_archive.h"
+#include "alloc_stats.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
-HandHistory::HandHistory(PokerVariant gameVariant, int handNum) 
-    : variant(gameVariant), handNumber(handNum), isComplete(false) {
+HandHistory::HandHistory(PokerVariant gameVariant, int handNum, MonotonicArena* arena) 
+    : variant(gameVariant), handNumber(handNum), players(ArenaAllocator<PlayerInfo>(arena)),
+      actions(ArenaAllocator<GameAction>(arena)), isComplete(false), archive(nullptr), archiveTableId(-1),
+      archiveHandId(0), foldedPlayers(0), livePlayerIdSum(0), trackedRound(HandHistoryRound::PRE_HAND),
+      roundAggressor(-1), roundLargestRaise(0) {
+}
+
+void HandHistory::setArchive(ArchiveRing* ring, int tableId) {
+    archive = ring;
+    archiveTableId = tableId;
+    if (!archive) return;
+    archiveHandId = archive->nextHandId();
+    
+    ArchiveRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.handId = archiveHandId;
+    record.tableId = tableId;
+    record.playerId = -1;
+    record.kind = ArchiveRecordKind::HAND_START;
+    record.amount = static_cast<int32_t>(variant);
+    record.pot = handNumber;
+    archive->push(record);
 }
 
 void HandHistory::addPlayer(int playerId, const std::string& name, int position, 
                            int chips, bool dealer) {
+    ALLOC_SCOPE(AllocTag::HAND_HISTORY);
     PlayerInfo player = {playerId, name, position, chips, dealer};
     players.push_back(player);
+    livePlayerIdSum += playerId;
+    
+    if (archive) {
+        ArchiveRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.handId = archiveHandId;
+        record.tableId = archiveTableId;
+        record.playerId = playerId;
+        record.kind = ArchiveRecordKind::PLAYER;
+        record.amount = chips;
+        record.pot = position;
+        record.flags = dealer ? 1 : 0;
+        record.count = static_cast<uint8_t>(std::min<size_t>(name.size(), ArchiveRecord::DATA_SIZE));
+        std::memcpy(record.data, name.data(), record.count);
+        archive->push(record);
+    }
+}
+
+void HandHistory::archiveAction(const GameAction& action) const {
+    ArchiveRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.handId = archiveHandId;
+    record.tableId = archiveTableId;
+    record.playerId = action.playerId;
+    record.kind = ArchiveRecordKind::ACTION;
+    record.round = static_cast<uint8_t>(action.round);
+    record.actionType = static_cast<uint8_t>(action.actionType);
+    record.amount = action.amount;
+    record.pot = action.potAfterAction;
+    record.count = static_cast<uint8_t>(std::min<size_t>(action.cardsDealt.size(), ArchiveRecord::DATA_SIZE));
+    for (int i = 0; i < record.count; i++) {
+        record.data[i] = static_cast<uint8_t>(action.cardsDealt[i].getIndex());
+    }
+    archive->push(record);
 }
 
 void HandHistory::recordAction(HandHistoryRound round, int playerId, ActionType action, 
                               int amount, int potSize, const std::string& desc) {
+    ALLOC_SCOPE(AllocTag::HAND_HISTORY);
     GameAction gameAction;
     gameAction.round = round;
     gameAction.playerId = playerId;
@@ -22,32 +81,114 @@ void HandHistory::recordAction(HandHistoryRound round, int playerId, ActionType
     gameAction.potAfterAction = potSize;
     gameAction.description = desc.empty() ? generateActionDescription(playerId, action, amount) : desc;
     
-    actions.push_back(gameAction);
+    if (archive) archiveAction(gameAction);
+    trackAction(gameAction);
+    actions.push_back(std::move(gameAction));
 }
 
 void HandHistory::recordCardDeal(HandHistoryRound round, const std::vector<Card>& cards, 
                                 const std::string& desc) {
+    ALLOC_SCOPE(AllocTag::HAND_HISTORY);
     GameAction gameAction;
     gameAction.round = round;
     gameAction.playerId = -1; // No specific player
     gameAction.actionType = (round == HandHistoryRound::PRE_HAND) ? ActionType::DEAL_CARDS : ActionType::REVEAL_BOARD;
     gameAction.amount = 0;
     gameAction.potAfterAction = getCurrentPot();
-    gameAction.cardsDealt = cards;
+    gameAction.cardsDealt = ArenaVector<Card>(cards.begin(), cards.end(), actions.get_allocator());
+    gameAction.description = desc;
+    
+    if (archive) archiveAction(gameAction);
+    trackAction(gameAction);
+    actions.push_back(std::move(gameAction));
+}
+
+void HandHistory::recordHoleCards(HandHistoryRound round, int playerId, const std::vector<Card>& cards,
+                                  const std::string& desc) {
+    ALLOC_SCOPE(AllocTag::HAND_HISTORY);
+    GameAction gameAction;
+    gameAction.round = round;
+    gameAction.playerId = playerId;
+    gameAction.actionType = ActionType::DEAL_CARDS;
+    gameAction.amount = 0;
+    gameAction.potAfterAction = getCurrentPot();
+    gameAction.cardsDealt = ArenaVector<Card>(cards.begin(), cards.end(), actions.get_allocator());
     gameAction.description = desc;
     
-    actions.push_back(gameAction);
+    if (archive) archiveAction(gameAction);
+    trackAction(gameAction);
+    actions.push_back(std::move(gameAction));
 }
 
 void HandHistory::recordResolution(const std::vector<int>& winners, 
                                   const std::vector<int>& amounts, const std::string& desc) {
+    ALLOC_SCOPE(AllocTag::HAND_HISTORY);
     resolution.winners = winners;
     resolution.amounts = amounts;
     resolution.description = desc;
     isComplete = true;
+    
+    if (archive) {
+        ArchiveRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.handId = archiveHandId;
+        record.tableId = archiveTableId;
+        record.kind = ArchiveRecordKind::AWARD;
+        for (size_t i = 0; i < winners.size(); i++) {
+            record.playerId = winners[i];
+            record.amount = i < amounts.size() ? amounts[i] : 0;
+            archive->push(record);
+        }
+        record.playerId = -1;
+        record.amount = 0;
+        record.kind = ArchiveRecordKind::HAND_END;
+        archive->push(record);
+        archive->markHandComplete(); // Lets the writer commit the whole hand
+    }
+}
+
+void HandHistory::appendAction(const GameAction& action) {
+    ALLOC_SCOPE(AllocTag::HAND_HISTORY);
+    actions.push_back(action);
+    if (actions.back().description.empty()) {
+        if (action.actionType == ActionType::DEAL_CARDS || action.actionType == ActionType::REVEAL_BOARD) {
+            actions.back().description = generateDealDescription(action);
+        } else if (action.playerId >= 0) {
+            actions.back().description = generateActionDescription(action.playerId, action.actionType, action.amount);
+        }
+    }
+    trackAction(action);
+    if (archive) archiveAction(actions.back());
+}
+
+void HandHistory::trackAction(const GameAction& action) {
+    if (action.round != trackedRound) {
+        trackedRound = action.round;
+        roundAggressor = -1;
+        roundLargestRaise = 0;
+    }
+    if (action.actionType == ActionType::FOLD) {
+        foldedPlayers++;
+        livePlayerIdSum -= action.playerId;
+    } else if (action.actionType == ActionType::RAISE && action.amount > roundLargestRaise) {
+        roundAggressor = action.playerId;
+        roundLargestRaise = action.amount;
+    }
 }
 
-const std::vector<GameAction>& HandHistory::getActions() const {
+PokerVariant HandHistory::getVariant() const {
+    return variant;
+}
+
+int HandHistory::getHandNumber() const {
+    return handNumber;
+}
+
+const HandResolution& HandHistory::getResolution() const {
+    return resolution;
+}
+
+const ActionList& HandHistory::getActions() const {
     return actions;
 }
 
@@ -71,7 +212,7 @@ const std::vector<GameAction> HandHistory::getActionsForPlayer(int playerId) con
     return playerActions;
 }
 
-const std::vector<PlayerInfo>& HandHistory::getPlayers() const {
+const PlayerList& HandHistory::getPlayers() const {
     return players;
 }
 
@@ -80,6 +221,33 @@ int HandHistory::getCurrentPot() const {
     return actions.back().potAfterAction;
 }
 
+std::vector<Card> HandHistory::getBoard() const {
+    std::vector<Card> board;
+    for (const auto& action : actions) {
+        if (action.actionType == ActionType::REVEAL_BOARD) {
+            board.insert(board.end(), action.cardsDealt.begin(), action.cardsDealt.end());
+        }
+    }
+    return board;
+}
+
+int HandHistory::getActivePlayerCount() const {
+    return static_cast<int>(players.size()) - foldedPlayers;
+}
+
+int HandHistory::getRoundAggressor() const {
+    return roundAggressor;
+}
+
+int HandHistory::getRoundLargestRaise() const {
+    return roundLargestRaise;
+}
+
+int HandHistory::getHeadsUpOpponent(int playerId) const {
+    if (getActivePlayerCount() != 2) return -1;
+    return livePlayerIdSum - playerId;
+}
+
 int HandHistory::getLastRaiseAmount() const {
     // Look backwards through actions to find the last raise
     for (auto it = actions.rbegin(); it != actions.rend(); ++it) {
@@ -187,6 +355,38 @@ std::string HandHistory::generateActionDescription(int playerId, ActionType acti
     }
 }
 
+std::string HandHistory::generateDealDescription(const GameAction& action) {
+    // Same labels PokerGame records live
+    if (action.playerId >= 0) {
+        if (action.round == HandHistoryRound::PRE_HAND) {
+            return variant == PokerVariant::SEVEN_CARD_STUD ? "Third street" : "Hole cards";
+        }
+        return action.round == HandHistoryRound::SHOWDOWN ? "Runout" : "Dealt";
+    }
+    switch (action.round) {
+        case HandHistoryRound::FLOP: return "Flop";
+        case HandHistoryRound::TURN: return "Turn";
+        case HandHistoryRound::RIVER: return "River";
+        case HandHistoryRound::SHOWDOWN: {
+            // A single runout is "Runout"; several are numbered "Run 1", "Run 2", ...
+            // The action being described is already the last one in the list
+            GameAction* firstRun = nullptr;
+            int runs = 0;
+            for (size_t i = 0; i + 1 < actions.size(); i++) {
+                if (actions[i].round == HandHistoryRound::SHOWDOWN && actions[i].playerId < 0 &&
+                    actions[i].actionType == ActionType::REVEAL_BOARD) {
+                    if (!firstRun) firstRun = &actions[i];
+                    runs++;
+                }
+            }
+            if (runs == 0) return "Runout";
+            if (runs == 1) firstRun->description = "Run 1";
+            return "Run " + std::to_string(runs + 1);
+        }
+        default: return "Dealt";
+    }
+}
+
 std::string HandHistory::roundToString(HandHistoryRound round) const {
     switch (round) {
         case HandHistoryRound::PRE_HAND: return "PRE-HAND";
@@ -3,8 +3,12 @@
 
 #include "card.h"
 #include "poker_variant.h"
+#include "arena.h"
 #include <vector>
 #include <string>
+#include <cstdint>
+
+class ArchiveRing; // Forward declaration
 
 enum class ActionType {
     FOLD,
@@ -40,7 +44,7 @@ struct GameAction {
     ActionType actionType;
     int amount;             // Bet/raise amount, 0 for check/fold
     int potAfterAction;     // Total pot size after this action
-    std::vector<Card> cardsDealt; // For DEAL_CARDS and REVEAL_BOARD actions
+    ArenaVector<Card> cardsDealt; // For DEAL_CARDS and REVEAL_BOARD actions
     std::string description; // Human readable description
 };
 
@@ -50,17 +54,32 @@ struct HandResolution {
     std::string description;   // e.g., "Alice wins with pair of aces"
 };
 
+// A live game's history allocates from its per-hand arena; copies are on the heap
+typedef ArenaVector<PlayerInfo> PlayerList;
+typedef ArenaVector<GameAction> ActionList;
+
 class HandHistory {
 private:
     PokerVariant variant;
     int handNumber;
-    std::vector<PlayerInfo> players;
-    std::vector<GameAction> actions;
+    PlayerList players;
+    ActionList actions;
     HandResolution resolution;
     bool isComplete;
+    ArchiveRing* archive; // Receives every record as it happens; nullptr = not archived
+    int archiveTableId;
+    uint64_t archiveHandId;
+    // Kept as actions arrive, so the live queries below are O(1)
+    int foldedPlayers;
+    int livePlayerIdSum;            // Ids of players who have not folded, summed
+    HandHistoryRound trackedRound;  // Round the aggressor fields below belong to
+    int roundAggressor;             // Largest raiser this round, -1 if none
+    int roundLargestRaise;
+    
+    friend class TableCheckpoint;
 
 public:
-    HandHistory(PokerVariant gameVariant, int handNum);
+    HandHistory(PokerVariant gameVariant, int handNum, MonotonicArena* arena = nullptr);
     
     // Setup methods
     void addPlayer(int playerId, const std::string& name, int position, 
@@ -71,15 +90,29 @@ public:
                      int amount, int potSize, const std::string& desc = "");
     void recordCardDeal(HandHistoryRound round, const std::vector<Card>& cards, 
                        const std::string& desc);
+    void recordHoleCards(HandHistoryRound round, int playerId, const std::vector<Card>& cards,
+                         const std::string& desc); // DEAL_CARDS to one player
     void recordResolution(const std::vector<int>& winners, 
                          const std::vector<int>& amounts, const std::string& desc);
+    void appendAction(const GameAction& action); // Restores a stored action (archive reader); an empty description is regenerated
+    
+    // Streams the hand into an archive ring from here on; set before adding players
+    void setArchive(ArchiveRing* ring, int tableId);
     
     // Query methods
-    const std::vector<GameAction>& getActions() const;
+    PokerVariant getVariant() const;
+    int getHandNumber() const;
+    const HandResolution& getResolution() const;
+    const ActionList& getActions() const;
     const std::vector<GameAction> getActionsForRound(HandHistoryRound round) const;
     const std::vector<GameAction> getActionsForPlayer(int playerId) const;
-    const std::vector<PlayerInfo>& getPlayers() const;
+    const PlayerList& getPlayers() const;
     int getCurrentPot() const;
+    std::vector<Card> getBoard() const; // Community cards revealed so far
+    int getActivePlayerCount() const;   // Players who have not folded; O(1)
+    int getRoundAggressor() const;      // Largest raiser in the current round, -1 if none; O(1)
+    int getRoundLargestRaise() const;   // That raise's amount, 0 if none
+    int getHeadsUpOpponent(int playerId) const; // The other live player when two remain, else -1
     int getLastRaiseAmount() const;
     bool hasPlayerActedThisRound(int playerId, HandHistoryRound round) const;
     
@@ -94,7 +127,10 @@ public:
 private:
     // Helper methods
     std::string generateActionDescription(int playerId, ActionType action, int amount) const;
+    std::string generateDealDescription(const GameAction& action); // May renumber an earlier runout
     std::string roundToString(HandHistoryRound round) const;
+    void archiveAction(const GameAction& action) const;
+    void trackAction(const GameAction& action); // Updates the running counts above
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,478 @@
+#include "hand_importer.h"
+#include "hand_archive.h"
+#include "card.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char HAND_HEADER[] = "PokerStars ";
+    const char NEXT_HAND[] = "\nPokerStars ";
+    const int MAX_CARDS = 7;
+
+    template <size_t N>
+    inline bool startsWith(const char* p, const char* end, const char (&prefix)[N]) {
+        return static_cast<size_t>(end - p) >= N - 1 && std::memcmp(p, prefix, N - 1) == 0;
+    }
+
+    template <size_t N>
+    inline const char* find(const char* p, const char* end, const char (&needle)[N]) {
+        if (p >= end) return nullptr;
+        return static_cast<const char*>(memmem(p, end - p, needle, N - 1));
+    }
+
+    inline const char* lineEnd(const char* p, const char* end) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!newline) return end;
+        return newline > p && newline[-1] == '\r' ? newline - 1 : newline;
+    }
+
+    // Chip amount, skipping any currency sign in front. Cash games are read in
+    // cents; tournament chips have no fractions.
+    long long parseAmount(const char*& p, const char* end, bool cash) {
+        for (int skipped = 0; p < end && (*p < '0' || *p > '9') && skipped < 4; skipped++) p++;
+        long long whole = 0;
+        while (p < end && ((*p >= '0' && *p <= '9') || *p == ',')) {
+            if (*p != ',') whole = whole * 10 + (*p - '0');
+            p++;
+        }
+        long long cents = 0;
+        if (p + 1 < end && *p == '.' && p[1] >= '0' && p[1] <= '9') {
+            p++;
+            for (int digit = 0; digit < 2; digit++) {
+                cents *= 10;
+                if (p < end && *p >= '0' && *p <= '9') cents += *p++ - '0';
+            }
+            while (p < end && *p >= '0' && *p <= '9') p++;
+        }
+        return cash ? whole * 100 + cents : whole;
+    }
+
+    // Cards in the last [..] group of a line; returns how many were read
+    int parseCards(const char* begin, const char* end, uint8_t* cards) {
+        const char* open = nullptr;
+        for (const char* p = end; p > begin; p--) {
+            if (p[-1] == '[') {
+                open = p;
+                break;
+            }
+        }
+        if (!open) return 0;
+        int count = 0;
+        for (const char* p = open; p + 1 < end && *p != ']' && count < MAX_CARDS;) {
+            Rank rank;
+            Suit suit;
+            if (Card::parseRank(p[0], rank) && Card::parseSuit(p[1], suit)) {
+                cards[count++] = static_cast<uint8_t>(static_cast<int>(suit) * 13 + static_cast<int>(rank) - 2);
+                p += 2;
+            } else {
+                p++;
+            }
+        }
+        return count;
+    }
+}
+
+struct HandHistoryImporter::ParsedHand {
+    struct Seat {
+        const char* name;
+        int nameLength;
+        int seat;      // As printed, counting from 1
+        int chips;
+        int playerId;
+        long long returned; // Collected pots plus uncalled bets
+    };
+    struct Action {
+        HandHistoryRound round;
+        int seatIndex; // -1 for the board
+        ActionType type;
+        int amount;
+        int level;     // Street bet level after the action
+        int cardCount;
+        uint8_t cards[MAX_CARDS];
+    };
+
+    long long number;
+    PokerVariant variant;
+    const char* table;
+    int tableLength;
+    int tableId;
+    int buttonSeat;
+    std::vector<Seat> seats;
+    std::vector<Action> actions;
+
+    bool parse(const char* begin, const char* end);
+
+private:
+    int matchSeat(const char* p, const char* end, const char* suffix, size_t suffixLength) const;
+    void add(HandHistoryRound round, int seatIndex, ActionType type, long long amount, int level,
+             const uint8_t* cards = nullptr, int cardCount = 0);
+};
+
+int HandHistoryImporter::ParsedHand::matchSeat(const char* p, const char* end, const char* suffix,
+                                               size_t suffixLength) const {
+    // Longest name wins, in case one player's name starts with another's
+    int best = -1;
+    for (size_t i = 0; i < seats.size(); i++) {
+        const Seat& seat = seats[i];
+        size_t length = static_cast<size_t>(seat.nameLength);
+        if (static_cast<size_t>(end - p) < length + suffixLength) continue;
+        if (std::memcmp(p, seat.name, length) != 0 || std::memcmp(p + length, suffix, suffixLength) != 0) continue;
+        if (best < 0 || seat.nameLength > seats[best].nameLength) best = static_cast<int>(i);
+    }
+    return best;
+}
+
+void HandHistoryImporter::ParsedHand::add(HandHistoryRound round, int seatIndex, ActionType type, long long amount,
+                                          int level, const uint8_t* cards, int cardCount) {
+    Action action;
+    action.round = round;
+    action.seatIndex = seatIndex;
+    action.type = type;
+    action.amount = static_cast<int>(amount);
+    action.level = level;
+    action.cardCount = cardCount;
+    if (cardCount > 0) std::memcpy(action.cards, cards, cardCount);
+    actions.push_back(action);
+}
+
+bool HandHistoryImporter::ParsedHand::parse(const char* begin, const char* end) {
+    seats.clear();
+    actions.clear();
+    table = nullptr;
+    tableLength = 0;
+    buttonSeat = -1;
+
+    // Header: "PokerStars Hand #123: [Tournament #456, ...] Hold'em No Limit (...) - date"
+    const char* line = begin;
+    const char* stop = lineEnd(line, end);
+    const char* hash = static_cast<const char*>(std::memchr(line, '#', stop - line));
+    if (!hash) return false;
+    number = 0;
+    for (const char* p = hash + 1; p < stop && *p >= '0' && *p <= '9'; p++) number = number * 10 + (*p - '0');
+    bool cash = !find(line, stop, "Tournament #");
+    if (find(line, stop, "Hold'em")) {
+        variant = PokerVariant::TEXAS_HOLDEM;
+    } else if (find(line, stop, "Omaha Hi/Lo")) {
+        variant = PokerVariant::OMAHA_HI_LO;
+    } else if (find(line, stop, "7 Card Stud") && !find(line, stop, "Hi/Lo")) {
+        variant = PokerVariant::SEVEN_CARD_STUD;
+    } else {
+        return false; // Razz, Badugi, plain Omaha, ...
+    }
+    bool stud = variant == PokerVariant::SEVEN_CARD_STUD;
+
+    HandHistoryRound round = HandHistoryRound::PRE_HAND;
+    int level = 0;
+    uint8_t cards[MAX_CARDS];
+    for (line = stop; line < end; line = stop) {
+        if (*line == '\r' || *line == '\n') line++;
+        if (line < end && *line == '\n') line++;
+        if (line >= end) break;
+        stop = lineEnd(line, end);
+        if (stop == line) continue;
+
+        if (round == HandHistoryRound::PRE_HAND && startsWith(line, stop, "Table '")) {
+            table = line + 7;
+            const char* close = static_cast<const char*>(std::memchr(table, '\'', stop - table));
+            if (!close) return false;
+            tableLength = static_cast<int>(close - table);
+            const char* button = find(close, stop, "Seat #");
+            if (button) {
+                const char* p = button + 6;
+                buttonSeat = static_cast<int>(parseAmount(p, stop, false));
+            }
+            continue;
+        }
+        if (round == HandHistoryRound::PRE_HAND && startsWith(line, stop, "Seat ")) {
+            // "Seat 3: name ($1.50 in chips)"
+            const char* colon = static_cast<const char*>(std::memchr(line, ':', stop - line));
+            const char* chips = find(line, stop, " in chips");
+            if (!colon || !chips) continue;
+            const char* open = chips;
+            while (open > colon && *open != '(') open--;
+            if (open <= colon + 2) continue;
+            const char* p = line + 5;
+            Seat seat;
+            seat.seat = static_cast<int>(parseAmount(p, colon, false));
+            seat.name = colon + 2;
+            seat.nameLength = static_cast<int>(open - 1 - seat.name);
+            p = open + 1;
+            seat.chips = static_cast<int>(parseAmount(p, chips, cash));
+            seat.playerId = -1;
+            seat.returned = 0;
+            seats.push_back(seat);
+            continue;
+        }
+
+        if (startsWith(line, stop, "*** ")) {
+            const char* name = line + 4;
+            if (startsWith(name, stop, "SUMMARY")) break;
+            if (startsWith(name, stop, "FIRST ") || startsWith(name, stop, "SECOND ") ||
+                startsWith(name, stop, "THIRD ")) {
+                return false; // Boards run more than once
+            }
+            HandHistoryRound next = round;
+            bool board = false;
+            if (startsWith(name, stop, "HOLE CARDS") || startsWith(name, stop, "3rd STREET")) {
+                next = HandHistoryRound::PRE_FLOP;
+            } else if (startsWith(name, stop, "FLOP") || startsWith(name, stop, "4th STREET")) {
+                next = HandHistoryRound::FLOP;
+                board = !stud;
+            } else if (startsWith(name, stop, "TURN") || startsWith(name, stop, "5th STREET")) {
+                next = HandHistoryRound::TURN;
+                board = !stud;
+            } else if (startsWith(name, stop, "RIVER")) {
+                next = stud ? HandHistoryRound::SHOWDOWN : HandHistoryRound::RIVER; // Stud's seventh street
+                board = !stud;
+            } else if (startsWith(name, stop, "6th STREET")) {
+                next = HandHistoryRound::RIVER;
+            } else if (startsWith(name, stop, "SHOW DOWN")) {
+                next = HandHistoryRound::SHOWDOWN;
+            }
+            if (next != round && next != HandHistoryRound::PRE_FLOP) level = 0; // The blinds carry into preflop
+            if (stud && next == HandHistoryRound::PRE_FLOP) level = 0;
+            round = next;
+            if (board) {
+                int count = parseCards(line, stop, cards);
+                add(round, -1, ActionType::REVEAL_BOARD, 0, level, cards, count);
+            }
+            continue;
+        }
+
+        if (startsWith(line, stop, "Dealt to ")) {
+            int seatIndex = matchSeat(line + 9, stop, " [", 2);
+            if (seatIndex < 0) continue;
+            int count = parseCards(line, stop, cards);
+            add(round, seatIndex, ActionType::DEAL_CARDS, 0, level, cards, count);
+            continue;
+        }
+        if (startsWith(line, stop, "Uncalled bet (")) {
+            const char* p = line + 14;
+            long long amount = parseAmount(p, stop, cash);
+            const char* to = find(p, stop, "returned to ");
+            if (!to) continue;
+            int seatIndex = matchSeat(to + 12, stop, "", 0);
+            if (seatIndex >= 0) seats[seatIndex].returned += amount;
+            continue;
+        }
+
+        int seatIndex = matchSeat(line, stop, ": ", 2);
+        if (seatIndex < 0) {
+            // "name collected $1.20 from pot"
+            seatIndex = matchSeat(line, stop, " collected ", 11);
+            if (seatIndex >= 0) {
+                const char* p = line + seats[seatIndex].nameLength + 11;
+                seats[seatIndex].returned += parseAmount(p, stop, cash);
+            }
+            continue;
+        }
+        const char* verb = line + seats[seatIndex].nameLength + 2;
+        const char* p;
+        bool allIn = find(verb, stop, "and is all-in") != nullptr;
+        if (startsWith(verb, stop, "folds")) {
+            add(round, seatIndex, ActionType::FOLD, 0, level);
+        } else if (startsWith(verb, stop, "checks")) {
+            add(round, seatIndex, ActionType::CHECK, 0, level);
+        } else if (startsWith(verb, stop, "calls ")) {
+            p = verb + 6;
+            long long amount = parseAmount(p, stop, cash);
+            add(round, seatIndex, allIn ? ActionType::ALL_IN : ActionType::CALL, amount, level);
+        } else if (startsWith(verb, stop, "bets ")) {
+            p = verb + 5;
+            level = static_cast<int>(parseAmount(p, stop, cash));
+            add(round, seatIndex, allIn ? ActionType::ALL_IN : ActionType::RAISE, level, level);
+        } else if (startsWith(verb, stop, "raises ")) {
+            const char* to = find(verb, stop, " to ");
+            if (!to) continue;
+            p = to + 4;
+            level = static_cast<int>(parseAmount(p, stop, cash));
+            add(round, seatIndex, allIn ? ActionType::ALL_IN : ActionType::RAISE, level, level);
+        } else if (startsWith(verb, stop, "posts ")) {
+            bool ante = startsWith(verb + 6, stop, "the ante");
+            bool dead = startsWith(verb + 6, stop, "small & big");
+            const char* amountText = find(verb + 6, stop, "blind");
+            p = ante ? verb + 14 : (amountText ? amountText + 5 : verb + 6);
+            if (dead) p = amountText ? amountText + 6 : verb + 6;
+            long long amount = parseAmount(p, stop, cash);
+            if (!ante && !dead) level = std::max(level, static_cast<int>(amount));
+            add(HandHistoryRound::PRE_HAND, seatIndex, ActionType::POST_BLIND, amount, level);
+        } else if (startsWith(verb, stop, "brings in for ")) {
+            p = verb + 14;
+            level = static_cast<int>(parseAmount(p, stop, cash));
+            add(round, seatIndex, ActionType::POST_BLIND, level, level);
+        } else if (startsWith(verb, stop, "shows [")) {
+            int count = parseCards(verb, stop, cards);
+            add(round, seatIndex, ActionType::DEAL_CARDS, 0, level, cards, count);
+        }
+    }
+    return !seats.empty() && table != nullptr;
+}
+
+HandHistoryImporter::HandHistoryImporter(ThreadPool& threadPool) : pool(threadPool) {
+}
+
+int HandHistoryImporter::idFor(const char* name, int length, std::unordered_map<std::string, int>& ids,
+                               std::vector<std::string>& names) {
+    std::string key(name, length);
+    auto found = ids.find(key);
+    if (found != ids.end()) return found->second;
+    int id = static_cast<int>(names.size());
+    ids.emplace(key, id);
+    names.push_back(std::move(key));
+    return id;
+}
+
+bool HandHistoryImporter::run(const std::string& path, const std::function<void(const ParsedHand&, int worker)>& build,
+                              ImportStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        close(fd);
+        return true;
+    }
+    void* base = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return false;
+    madvise(base, length, MADV_SEQUENTIAL);
+    const char* data = static_cast<const char*>(base);
+    const char* end = data + length;
+
+    // First hand at or after a byte offset, always at the start of a line
+    auto handAt = [&](size_t offset) -> const char* {
+        if (offset == 0) {
+            const char* first = data;
+            if (startsWith(first, end, "\xEF\xBB\xBF")) first += 3; // UTF-8 byte order mark
+            if (startsWith(first, end, HAND_HEADER)) return first;
+            offset = 1;
+        }
+        if (offset >= length) return end;
+        const char* next = find(data + offset - 1, end, NEXT_HAND);
+        return next ? next + 1 : end;
+    };
+
+    size_t sliceCount = (length + SLICE_BYTES - 1) / SLICE_BYTES;
+    std::vector<std::vector<ParsedHand>> parsed(SLICES_PER_BATCH);
+    std::vector<int> parsedCount(SLICES_PER_BATCH);
+    std::vector<int> skipped(SLICES_PER_BATCH);
+    std::vector<const char*> bounds(SLICES_PER_BATCH + 1);
+    long long hands = 0;
+    long long skippedTotal = 0;
+
+    for (size_t firstSlice = 0; firstSlice < sliceCount; firstSlice += SLICES_PER_BATCH) {
+        int slices = static_cast<int>(std::min<size_t>(SLICES_PER_BATCH, sliceCount - firstSlice));
+        for (int s = 0; s <= slices; s++) {
+            bounds[s] = handAt((firstSlice + s) * SLICE_BYTES);
+        }
+
+        pool.parallelFor(slices, [&](int s, int /* worker */) {
+            std::vector<ParsedHand>& out = parsed[s];
+            int count = 0;
+            skipped[s] = 0;
+            for (const char* hand = bounds[s]; hand < bounds[s + 1];) {
+                const char* next = find(hand + 1, bounds[s + 1], NEXT_HAND);
+                const char* handEnd = next ? next + 1 : bounds[s + 1];
+                if (static_cast<size_t>(count) == out.size()) out.emplace_back(); // Reused across batches
+                if (out[count].parse(hand, handEnd)) {
+                    count++;
+                } else {
+                    skipped[s]++;
+                }
+                hand = handEnd;
+            }
+            parsedCount[s] = count;
+        });
+
+        // Ids in file order, so they do not depend on thread timing
+        for (int s = 0; s < slices; s++) {
+            for (int h = 0; h < parsedCount[s]; h++) {
+                ParsedHand& hand = parsed[s][h];
+                hand.tableId = idFor(hand.table, hand.tableLength, tableIds, tableNames);
+                for (ParsedHand::Seat& seat : hand.seats) {
+                    seat.playerId = idFor(seat.name, seat.nameLength, playerIds, playerNames);
+                }
+            }
+            hands += parsedCount[s];
+            skippedTotal += skipped[s];
+        }
+
+        pool.parallelFor(slices, [&](int s, int worker) {
+            for (int h = 0; h < parsedCount[s]; h++) {
+                build(parsed[s][h], worker);
+            }
+        });
+    }
+
+    munmap(base, length);
+    if (stats) {
+        stats->hands += hands;
+        stats->skipped += skippedTotal;
+        stats->bytes += static_cast<long long>(length);
+        stats->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
+
+namespace {
+    template <typename Hand>
+    void buildHistory(const Hand& hand, HandHistory& history, ArchiveRing* ring) {
+        if (ring) history.setArchive(ring, hand.tableId);
+        for (const auto& seat : hand.seats) {
+            history.addPlayer(seat.playerId, std::string(seat.name, seat.nameLength), seat.seat - 1, seat.chips,
+                              seat.seat == hand.buttonSeat);
+        }
+        for (const auto& parsed : hand.actions) {
+            GameAction action;
+            action.round = parsed.round;
+            action.playerId = parsed.seatIndex >= 0 ? hand.seats[parsed.seatIndex].playerId : -1;
+            action.actionType = parsed.type;
+            action.amount = parsed.amount;
+            action.potAfterAction = parsed.level;
+            for (int c = 0; c < parsed.cardCount; c++) action.cardsDealt.push_back(Card::fromIndex(parsed.cards[c]));
+            history.appendAction(action);
+        }
+
+        std::vector<int> winners;
+        std::vector<int> amounts;
+        std::string description;
+        for (const auto& seat : hand.seats) {
+            if (seat.returned <= 0) continue;
+            winners.push_back(seat.playerId);
+            amounts.push_back(static_cast<int>(seat.returned));
+            if (!description.empty()) description += ", ";
+            description += std::string(seat.name, seat.nameLength) + " wins $" + std::to_string(seat.returned);
+        }
+        history.recordResolution(winners, amounts, description);
+    }
+}
+
+bool HandHistoryImporter::importFile(const std::string& path, const HandVisitor& visit, ImportStats* stats) {
+    return run(path, [&](const ParsedHand& hand, int worker) {
+        HandHistory history(hand.variant, static_cast<int>(hand.number % 1000000000));
+        buildHistory(hand, history, nullptr);
+        visit(hand.tableId, history, worker);
+    }, stats);
+}
+
+bool HandHistoryImporter::importFile(const std::string& path, HandArchive& archive, ImportStats* stats) {
+    // A ring per pool thread: each worker is the only producer on its own
+    std::vector<ArchiveRing*> rings;
+    for (int w = 0; w < pool.getThreadCount(); w++) rings.push_back(archive.addRing());
+    bool imported = run(path, [&](const ParsedHand& hand, int worker) {
+        HandHistory history(hand.variant, static_cast<int>(hand.number % 1000000000));
+        buildHistory(hand, history, rings[worker]);
+    }, stats);
+    archive.flush();
+    return imported;
+}
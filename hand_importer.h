@@ -0,0 +1,71 @@
+#ifndef HAND_IMPORTER_H
+#define HAND_IMPORTER_H
+
+#include "hand_history.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+class HandArchive; // Forward declaration
+
+struct ImportStats {
+    long long hands = 0;
+    long long skipped = 0; // Hands in games or formats the engine has no model for
+    long long bytes = 0;
+    double seconds = 0.0;
+};
+
+// Streams PokerStars-style text hand histories into HandHistory objects.
+// The file is memory-mapped and cut into slices on hand boundaries; pool
+// threads parse the slices straight from the mapping, keeping names and
+// tables as pointers into it, so no line is ever copied into a string.
+// Player and table names then get dense ids in file order on the calling
+// thread, which makes ids stable from run to run, and the pool builds the
+// HandHistory objects.
+//
+// Amounts in cash games are in cents; tournament amounts are chips.
+// Actions follow PokerGame's conventions: bets and raises are RAISE with the
+// amount raised to, calls carry the chips added, and potAfterAction is the
+// street's bet level after the action. Hole cards a line reveals ("Dealt to",
+// "shows") are DEAL_CARDS actions of that player. The resolution lists what
+// each player got back, uncalled bets included.
+class HandHistoryImporter {
+public:
+    static const size_t SLICE_BYTES = 1 << 20; // Text per parsing task
+    static const int SLICES_PER_BATCH = 256;    // Slices parsed before ids are assigned
+
+    explicit HandHistoryImporter(ThreadPool& pool);
+
+    typedef std::function<void(int tableId, const HandHistory& hand, int worker)> HandVisitor;
+
+    // Visits every hand, on pool threads and in no particular order; false if
+    // the file cannot be mapped
+    bool importFile(const std::string& path, const HandVisitor& visit, ImportStats* stats = nullptr);
+
+    // Streams every hand into the archive, one ring per pool thread
+    bool importFile(const std::string& path, HandArchive& archive, ImportStats* stats = nullptr);
+
+    // Ids are kept across files, so a player imported twice keeps one id
+    int getPlayerCount() const { return static_cast<int>(playerNames.size()); }
+    const std::string& getPlayerName(int playerId) const { return playerNames[playerId]; }
+    const std::string& getTableName(int tableId) const { return tableNames[tableId]; }
+
+private:
+    struct ParsedHand; // Defined in the implementation
+
+    ThreadPool& pool;
+    std::unordered_map<std::string, int> playerIds;
+    std::unordered_map<std::string, int> tableIds;
+    std::vector<std::string> playerNames;
+    std::vector<std::string> tableNames;
+
+    int idFor(const char* name, int length, std::unordered_map<std::string, int>& ids,
+              std::vector<std::string>& names);
+    bool run(const std::string& path, const std::function<void(const ParsedHand&, int worker)>& build,
+             ImportStats* stats);
+};
+
+#endif
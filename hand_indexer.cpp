@@ -0,0 +1,336 @@
+#include "hand_indexer.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // Position of rank among the ranks not yet used by this suit
+    inline int compressedRank(int rank, int usedMask) {
+        return rank - __builtin_popcount(static_cast<unsigned>(usedMask & ((1 << rank) - 1)));
+    }
+    
+    // The position-th rank (0-based) not in usedMask
+    inline int nthFreeRank(int position, int usedMask) {
+        for (int rank = 0; rank < 13; rank++) {
+            if (usedMask & (1 << rank)) continue;
+            if (position-- == 0) return rank;
+        }
+        return -1;
+    }
+}
+
+HandIndexer::HandIndexer(const std::vector<int>& cardsPerRound)
+    : cardsPerRound(cardsPerRound) {
+    int total = 0;
+    int space = 1;
+    for (int cards : cardsPerRound) {
+        total += cards;
+        space *= cards + 1;
+        roundEnd.push_back(total);
+        shapeSpace.push_back(space);
+    }
+    if (cardsPerRound.empty() || total > 52) {
+        throw std::invalid_argument("HandIndexer needs between 1 and 52 cards");
+    }
+    roundSize.assign(cardsPerRound.size(), 0);
+    configurations.resize(cardsPerRound.size());
+    for (int round = 0; round < getRounds(); round++) {
+        buildRound(round);
+    }
+}
+
+const HandIndexer& HandIndexer::holdem() {
+    static const HandIndexer indexer({2, 3, 1, 1});
+    return indexer;
+}
+
+const HandIndexer& HandIndexer::omaha() {
+    static const HandIndexer indexer({4, 3, 1, 1});
+    return indexer;
+}
+
+const HandIndexer& HandIndexer::stud() {
+    // Third street counts as one round; up and down cards are not told apart
+    static const HandIndexer indexer({3, 1, 1, 1, 1});
+    return indexer;
+}
+
+const HandIndexer& HandIndexer::forVariant(const VariantInfo& variant) {
+    if (variant.gameStruct == GAMESTRUCTURE_STUD) return stud();
+    return variant.numHoleCards == NUMHOLECARDS_FOUR ? omaha() : holdem();
+}
+
+uint64_t HandIndexer::choose(uint64_t n, int k) {
+    if (k < 0 || static_cast<uint64_t>(k) > n) return 0;
+    uint64_t result = 1;
+    for (int i = 1; i <= k; i++) {
+        result = result * (n - k + i) / i;
+    }
+    return result;
+}
+
+// k values in any order -> combination-with-repetition rank
+uint64_t HandIndexer::multisetIndex(std::vector<uint64_t> values) {
+    std::sort(values.begin(), values.end(), std::greater<uint64_t>());
+    int count = static_cast<int>(values.size());
+    uint64_t index = 0;
+    for (int i = 0; i < count; i++) {
+        // Spread equal values apart so the sequence is strictly decreasing
+        index += choose(values[i] + (count - 1 - i), count - i);
+    }
+    return index;
+}
+
+void HandIndexer::multisetUnindex(uint64_t index, int count, std::vector<uint64_t>& values) {
+    values.assign(count, 0);
+    for (int i = 0; i < count; i++) {
+        int k = count - i;
+        // Largest w with C(w, k) <= index
+        uint64_t low = k - 1;
+        uint64_t high = k - 1;
+        while (choose(high + 1, k) <= index) {
+            high = high * 2 + 1;
+        }
+        while (low < high) {
+            uint64_t mid = low + (high - low + 1) / 2;
+            if (choose(mid, k) <= index) {
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+        index -= choose(low, k);
+        values[i] = low - (count - 1 - i);
+    }
+}
+
+void HandIndexer::countsOf(int shape, int round, int* counts) const {
+    for (int j = round; j >= 0; j--) {
+        counts[j] = shape % (cardsPerRound[j] + 1);
+        shape /= cardsPerRound[j] + 1;
+    }
+}
+
+uint64_t HandIndexer::suitSize(int shape, int round) const {
+    int counts[16];
+    countsOf(shape, round, counts);
+    uint64_t size = 1;
+    int used = 0;
+    for (int j = 0; j <= round; j++) {
+        size *= choose(RANKS - used, counts[j]);
+        used += counts[j];
+    }
+    return size;
+}
+
+uint64_t HandIndexer::suitIndex(const int* rankMasks, int shape, int round) const {
+    int counts[16];
+    countsOf(shape, round, counts);
+    uint64_t value = 0;
+    int usedMask = 0;
+    int used = 0;
+    for (int j = 0; j <= round; j++) {
+        // Colex rank of this round's ranks among those the suit has left
+        uint64_t subset = 0;
+        int nth = 1;
+        for (int bits = rankMasks[j]; bits; bits &= bits - 1) {
+            subset += choose(compressedRank(__builtin_ctz(bits), usedMask), nth++);
+        }
+        value = value * choose(RANKS - used, counts[j]) + subset;
+        usedMask |= rankMasks[j];
+        used += counts[j];
+    }
+    return value;
+}
+
+void HandIndexer::suitUnindex(uint64_t value, int shape, int round, int* rankMasks) const {
+    int counts[16];
+    countsOf(shape, round, counts);
+    uint64_t subsets[16];
+    int used = 0;
+    for (int j = 0; j <= round; j++) used += counts[j];
+    for (int j = round; j >= 0; j--) {
+        used -= counts[j];
+        uint64_t radix = choose(RANKS - used, counts[j]);
+        subsets[j] = value % radix;
+        value /= radix;
+    }
+    
+    int usedMask = 0;
+    for (int j = 0; j <= round; j++) {
+        int mask = 0;
+        uint64_t rest = subsets[j];
+        for (int k = counts[j]; k >= 1; k--) {
+            int position = k - 1;
+            while (choose(position + 1, k) <= rest) position++;
+            rest -= choose(position, k);
+            mask |= 1 << nthFreeRank(position, usedMask);
+        }
+        rankMasks[j] = mask;
+        usedMask |= mask;
+    }
+}
+
+void HandIndexer::buildRound(int round) {
+    // Every per-suit shape that fits in one suit
+    std::vector<int> shapes;
+    for (int shape = 0; shape < shapeSpace[round]; shape++) {
+        int counts[16];
+        countsOf(shape, round, counts);
+        int total = 0;
+        for (int j = 0; j <= round; j++) total += counts[j];
+        if (total <= RANKS) shapes.push_back(shape);
+    }
+    
+    // Multisets of four shapes (largest first) adding up to each round's deal
+    std::vector<Configuration>& result = configurations[round];
+    int n = static_cast<int>(shapes.size());
+    for (int a = n - 1; a >= 0; a--)
+    for (int b = a; b >= 0; b--)
+    for (int c = b; c >= 0; c--)
+    for (int d = c; d >= 0; d--) {
+        int picked[SUITS] = {shapes[a], shapes[b], shapes[c], shapes[d]};
+        bool matches = true;
+        for (int j = 0; j <= round && matches; j++) {
+            int total = 0;
+            for (int s = 0; s < SUITS; s++) {
+                int counts[16];
+                countsOf(picked[s], round, counts);
+                total += counts[j];
+            }
+            matches = total == cardsPerRound[j];
+        }
+        if (!matches) continue;
+        
+        Configuration config;
+        config.key = 0;
+        for (int s = 0; s < SUITS; s++) {
+            config.shapes[s] = picked[s];
+            config.key = config.key * shapeSpace[round] + picked[s];
+        }
+        result.push_back(config);
+    }
+    std::sort(result.begin(), result.end(),
+              [](const Configuration& x, const Configuration& y) { return x.key < y.key; });
+    
+    uint64_t offset = 0;
+    for (Configuration& config : result) {
+        config.offset = offset;
+        config.size = 1;
+        for (int s = 0; s < SUITS;) {
+            int group = 1;
+            while (s + group < SUITS && config.shapes[s + group] == config.shapes[s]) group++;
+            config.size *= choose(suitSize(config.shapes[s], round) + group - 1, group);
+            s += group;
+        }
+        offset += config.size;
+    }
+    roundSize[round] = offset;
+}
+
+uint64_t HandIndexer::index(const std::vector<Card>& cards, int round) const {
+    if (round < 0 || round >= getRounds() || static_cast<int>(cards.size()) < roundEnd[round]) {
+        throw std::invalid_argument("Not enough cards for the requested round");
+    }
+    
+    // Per suit, the ranks received in each round
+    int rankMasks[SUITS][16] = {};
+    int card = 0;
+    for (int j = 0; j <= round; j++) {
+        for (int i = 0; i < cardsPerRound[j]; i++, card++) {
+            int suit = static_cast<int>(cards[card].getSuit());
+            rankMasks[suit][j] |= 1 << (static_cast<int>(cards[card].getRank()) - 2);
+        }
+    }
+    
+    int shapes[SUITS];
+    int order[SUITS] = {0, 1, 2, 3};
+    for (int s = 0; s < SUITS; s++) {
+        int shape = 0;
+        for (int j = 0; j <= round; j++) {
+            shape = shape * (cardsPerRound[j] + 1) + __builtin_popcount(static_cast<unsigned>(rankMasks[s][j]));
+        }
+        shapes[s] = shape;
+    }
+    std::sort(order, order + SUITS, [&](int x, int y) { return shapes[x] > shapes[y]; });
+    
+    uint64_t key = 0;
+    for (int s = 0; s < SUITS; s++) key = key * shapeSpace[round] + shapes[order[s]];
+    const std::vector<Configuration>& configs = configurations[round];
+    auto found = std::lower_bound(configs.begin(), configs.end(), key,
+                                  [](const Configuration& config, uint64_t value) { return config.key < value; });
+    if (found == configs.end() || found->key != key) {
+        throw std::invalid_argument("Cards do not match the indexer's deal");
+    }
+    
+    uint64_t value = 0;
+    std::vector<uint64_t> group;
+    for (int s = 0; s < SUITS;) {
+        int shape = shapes[order[s]];
+        group.clear();
+        while (s < SUITS && shapes[order[s]] == shape) {
+            group.push_back(suitIndex(rankMasks[order[s]], shape, round));
+            s++;
+        }
+        uint64_t groupSize = choose(suitSize(shape, round) + group.size() - 1, static_cast<int>(group.size()));
+        value = value * groupSize + multisetIndex(group);
+    }
+    return found->offset + value;
+}
+
+uint64_t HandIndexer::index(const std::vector<Card>& holeCards, const std::vector<Card>& board) const {
+    std::vector<Card> cards(holeCards);
+    cards.insert(cards.end(), board.begin(), board.end());
+    for (int round = 0; round < getRounds(); round++) {
+        if (roundEnd[round] == static_cast<int>(cards.size())) {
+            return index(cards, round);
+        }
+    }
+    throw std::invalid_argument("Card count does not end a round");
+}
+
+std::vector<Card> HandIndexer::unindex(int round, uint64_t handIndex) const {
+    if (round < 0 || round >= getRounds() || handIndex >= roundSize[round]) {
+        throw std::out_of_range("Hand index out of range");
+    }
+    const std::vector<Configuration>& configs = configurations[round];
+    auto found = std::upper_bound(configs.begin(), configs.end(), handIndex,
+                                  [](uint64_t value, const Configuration& config) { return value < config.offset; });
+    const Configuration& config = *(found - 1);
+    uint64_t value = handIndex - config.offset;
+    
+    // Peel the groups off in reverse of the order index() packed them
+    std::vector<std::pair<int, int>> groups; // (first suit, size)
+    for (int s = 0; s < SUITS;) {
+        int size = 1;
+        while (s + size < SUITS && config.shapes[s + size] == config.shapes[s]) size++;
+        groups.push_back({s, size});
+        s += size;
+    }
+    int rankMasks[SUITS][16] = {};
+    std::vector<uint64_t> members;
+    for (int g = static_cast<int>(groups.size()) - 1; g >= 0; g--) {
+        int first = groups[g].first;
+        int size = groups[g].second;
+        int shape = config.shapes[first];
+        uint64_t groupSize = choose(suitSize(shape, round) + size - 1, size);
+        multisetUnindex(value % groupSize, size, members);
+        value /= groupSize;
+        for (int m = 0; m < size; m++) {
+            suitUnindex(members[m], shape, round, rankMasks[first + m]);
+        }
+    }
+    
+    std::vector<Card> cards;
+    for (int j = 0; j <= round; j++) {
+        for (int s = 0; s < SUITS; s++) {
+            for (int bits = rankMasks[s][j]; bits; bits &= bits - 1) {
+                cards.push_back(Card(static_cast<Suit>(s), static_cast<Rank>(__builtin_ctz(bits) + 2)));
+            }
+        }
+    }
+    return cards;
+}
+
+std::vector<Card> HandIndexer::canonicalize(const std::vector<Card>& cards, int round) const {
+    return unindex(round, index(cards, round));
+}
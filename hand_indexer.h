@@ -0,0 +1,72 @@
+#ifndef HAND_INDEXER_H
+#define HAND_INDEXER_H
+
+#include "card.h"
+#include "variants.h"
+#include <vector>
+#include <cstdint>
+
+// Perfect index of one player's cards up to suit relabelling. Cards arrive
+// in rounds (Hold'em: 2 hole, 3 flop, 1 turn, 1 river); two hands get the
+// same index exactly when a permutation of suits maps one onto the other,
+// and indices for a round run densely from 0 to getSize(round) - 1, so
+// per-hand caches can be flat arrays.
+//
+// Each suit's cards are described by the ranks it received in every round.
+// Suits are sorted by their per-round card counts; suits with identical
+// counts are interchangeable, so their rank sets are indexed as a multiset.
+class HandIndexer {
+public:
+    explicit HandIndexer(const std::vector<int>& cardsPerRound);
+    
+    // Hold'em {2,3,1,1}: 169 / 1,286,792 / 55,190,538 / 2,428,287,420 per street.
+    // Omaha {4,3,1,1}, Stud {3,1,1,1,1}. Treating the board as one round
+    // ({2,4}, {2,5}) gives the smaller 13,960,050 / 123,156,254 turn/river sets.
+    static const HandIndexer& holdem();
+    static const HandIndexer& omaha();
+    static const HandIndexer& stud();
+    static const HandIndexer& forVariant(const VariantInfo& variant);
+    
+    int getRounds() const { return static_cast<int>(cardsPerRound.size()); }
+    int getCardsThrough(int round) const { return roundEnd[round]; }
+    uint64_t getSize(int round) const { return roundSize[round]; }
+    
+    // cards in deal order; only the first getCardsThrough(round) are used
+    uint64_t index(const std::vector<Card>& cards, int round) const;
+    // Hole cards plus board; the round is implied by the total card count
+    uint64_t index(const std::vector<Card>& holeCards, const std::vector<Card>& board) const;
+    
+    // Canonical representative of an index, in deal order
+    std::vector<Card> unindex(int round, uint64_t handIndex) const;
+    std::vector<Card> canonicalize(const std::vector<Card>& cards, int round) const;
+    
+private:
+    static const int SUITS = 4;
+    static const int RANKS = 13;
+    
+    // A multiset of suit shapes whose per-round counts add up to the deal
+    struct Configuration {
+        uint64_t key;     // Sorted shape keys packed together
+        uint64_t offset;  // First index of this configuration
+        uint64_t size;
+        int shapes[SUITS]; // Shape key per canonical suit, largest first
+    };
+    
+    std::vector<int> cardsPerRound;
+    std::vector<int> roundEnd;
+    std::vector<uint64_t> roundSize;
+    std::vector<int> shapeSpace;  // Distinct packed suit shapes per round
+    std::vector<std::vector<Configuration>> configurations; // Per round, sorted by key
+    
+    void buildRound(int round);
+    void countsOf(int shape, int round, int* counts) const;
+    uint64_t suitSize(int shape, int round) const;
+    uint64_t suitIndex(const int* rankMasks, int shape, int round) const;
+    void suitUnindex(uint64_t value, int shape, int round, int* rankMasks) const;
+    
+    static uint64_t choose(uint64_t n, int k);
+    static uint64_t multisetIndex(std::vector<uint64_t> values);
+    static void multisetUnindex(uint64_t index, int count, std::vector<uint64_t>& values);
+};
+
+#endif
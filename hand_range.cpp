@@ -0,0 +1,246 @@
+#include "hand_range.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+
+namespace {
+    std::string trim(const std::string& text) {
+        size_t start = text.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) return "";
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(start, end - start + 1);
+    }
+    
+    std::vector<std::string> splitTokens(const std::string& text) {
+        std::vector<std::string> tokens;
+        size_t start = 0;
+        while (start <= text.size()) {
+            size_t comma = text.find(',', start);
+            if (comma == std::string::npos) comma = text.size();
+            std::string token = trim(text.substr(start, comma - start));
+            if (!token.empty()) tokens.push_back(token);
+            start = comma + 1;
+        }
+        return tokens;
+    }
+    
+    // "token:weight" -> token, weight (1 when absent)
+    std::string splitWeight(const std::string& token, double& weight) {
+        size_t colon = token.find(':');
+        weight = 1.0;
+        if (colon == std::string::npos) return token;
+        char* end = nullptr;
+        std::string number = trim(token.substr(colon + 1));
+        weight = std::strtod(number.c_str(), &end);
+        if (number.empty() || *end != '\0' || weight < 0.0) {
+            throw std::invalid_argument("Bad range weight: " + token);
+        }
+        return trim(token.substr(0, colon));
+    }
+    
+    [[noreturn]] void badToken(const std::string& token) {
+        throw std::invalid_argument("Bad range token: " + token);
+    }
+    
+    uint32_t chooseSmall(int n, int k) {
+        if (k > n) return 0;
+        uint32_t result = 1;
+        for (int i = 1; i <= k; i++) result = result * (n - k + i) / i;
+        return result;
+    }
+}
+
+HoldemRange::HoldemRange() : weights(NUM_COMBOS, 0.0) {
+}
+
+HoldemRange HoldemRange::any() {
+    HoldemRange range;
+    std::fill(range.weights.begin(), range.weights.end(), 1.0);
+    return range;
+}
+
+HoldemRange HoldemRange::parse(const std::string& text) {
+    HoldemRange range;
+    for (const std::string& raw : splitTokens(text)) {
+        double weight;
+        std::string token = splitWeight(raw, weight);
+        range.addToken(token, weight);
+    }
+    return range;
+}
+
+void HoldemRange::setWeight(int combo, double weight) {
+    weights[combo] = weight;
+}
+
+int HoldemRange::getComboCount() const {
+    return static_cast<int>(std::count_if(weights.begin(), weights.end(), [](double w) { return w > 0.0; }));
+}
+
+double HoldemRange::getTotalWeight() const {
+    double total = 0.0;
+    for (double weight : weights) total += weight;
+    return total;
+}
+
+void HoldemRange::removeCards(const std::vector<Card>& deadCards) {
+    for (const Card& dead : deadCards) {
+        int index = dead.getIndex();
+        for (int other = 0; other < 52; other++) {
+            if (other != index) weights[comboIndex(index, other)] = 0.0;
+        }
+    }
+}
+
+int HoldemRange::comboIndex(int firstCard, int secondCard) {
+    int high = std::max(firstCard, secondCard);
+    int low = std::min(firstCard, secondCard);
+    return high * (high - 1) / 2 + low;
+}
+
+void HoldemRange::comboCards(int combo, int& highCard, int& lowCard) {
+    // Invert high * (high - 1) / 2 + low
+    int high = 1;
+    while ((high + 1) * high / 2 <= combo) high++;
+    highCard = high;
+    lowCard = combo - high * (high - 1) / 2;
+}
+
+void HoldemRange::addClass(Rank high, Rank low, int suitedness, double weight) {
+    for (int s1 = 0; s1 < 4; s1++) {
+        for (int s2 = 0; s2 < 4; s2++) {
+            if (high == low && s2 <= s1) continue; // Each pair combo once
+            if (high != low && suitedness > 0 && s1 != s2) continue;
+            if (high != low && suitedness < 0 && s1 == s2) continue;
+            Card first(static_cast<Suit>(s1), high);
+            Card second(static_cast<Suit>(s2), low);
+            weights[comboIndex(first.getIndex(), second.getIndex())] = weight;
+        }
+    }
+}
+
+void HoldemRange::addToken(const std::string& token, double weight) {
+    if (token == "any" || token == "random") {
+        std::fill(weights.begin(), weights.end(), weight);
+        return;
+    }
+    
+    // Specific combo: "AhKh"
+    Card first(Suit::CLUBS, Rank::TWO);
+    Card second(Suit::CLUBS, Rank::TWO);
+    if (token.size() == 4 && Card::parse(token.substr(0, 2), first) && Card::parse(token.substr(2, 2), second)) {
+        if (first == second) badToken(token);
+        weights[comboIndex(first.getIndex(), second.getIndex())] = weight;
+        return;
+    }
+    
+    // Hand class, then an optional "+" or "-<class>"
+    auto readClass = [&token](const std::string& text, Rank& high, Rank& low, int& suitedness) {
+        if (text.size() < 2 || text.size() > 3 || !Card::parseRank(text[0], high) || !Card::parseRank(text[1], low)) {
+            badToken(token);
+        }
+        if (static_cast<int>(low) > static_cast<int>(high)) std::swap(high, low);
+        suitedness = 0;
+        if (text.size() == 3) {
+            if (text[2] == 's' || text[2] == 'S') suitedness = 1;
+            else if (text[2] == 'o' || text[2] == 'O') suitedness = -1;
+            else badToken(token);
+        }
+        if (high == low && suitedness != 0) badToken(token);
+    };
+    
+    Rank high, low;
+    int suitedness;
+    size_t dash = token.find('-');
+    bool plus = !token.empty() && token.back() == '+';
+    std::string head = dash != std::string::npos ? token.substr(0, dash)
+                                                 : (plus ? token.substr(0, token.size() - 1) : token);
+    readClass(head, high, low, suitedness);
+    int highValue = static_cast<int>(high);
+    int lowValue = static_cast<int>(low);
+    
+    if (dash != std::string::npos) {
+        // "99-66" or "A5s-A2s": both ends share the shape, walk the lower card
+        Rank endHigh, endLow;
+        int endSuitedness;
+        readClass(token.substr(dash + 1), endHigh, endLow, endSuitedness);
+        if (endSuitedness != suitedness) badToken(token);
+        if (high == low) {
+            if (endHigh != endLow) badToken(token);
+            int from = std::min(highValue, static_cast<int>(endHigh));
+            int to = std::max(highValue, static_cast<int>(endHigh));
+            for (int r = from; r <= to; r++) addClass(static_cast<Rank>(r), static_cast<Rank>(r), 0, weight);
+        } else {
+            if (endHigh != high || endHigh == endLow) badToken(token);
+            int from = std::min(lowValue, static_cast<int>(endLow));
+            int to = std::max(lowValue, static_cast<int>(endLow));
+            for (int r = from; r <= to; r++) addClass(high, static_cast<Rank>(r), suitedness, weight);
+        }
+    } else if (plus) {
+        // "TT+" every higher pair; "ATs+" kicker up to one below the top card
+        if (high == low) {
+            for (int r = highValue; r <= static_cast<int>(Rank::ACE); r++) {
+                addClass(static_cast<Rank>(r), static_cast<Rank>(r), 0, weight);
+            }
+        } else {
+            for (int r = lowValue; r < highValue; r++) addClass(high, static_cast<Rank>(r), suitedness, weight);
+        }
+    } else {
+        addClass(high, low, suitedness, weight);
+    }
+}
+
+OmahaRange OmahaRange::parse(const std::string& text) {
+    OmahaRange range;
+    for (const std::string& raw : splitTokens(text)) {
+        double weight;
+        std::string token = splitWeight(raw, weight);
+        if (token.size() != 8) badToken(raw);
+        std::vector<Card> cards;
+        for (int i = 0; i < 4; i++) {
+            Card card(Suit::CLUBS, Rank::TWO);
+            if (!Card::parse(token.substr(i * 2, 2), card)) badToken(raw);
+            cards.push_back(card);
+        }
+        range.add(cards, weight);
+    }
+    return range;
+}
+
+void OmahaRange::add(const std::vector<Card>& cards, double weight) {
+    if (cards.size() != 4) {
+        throw std::invalid_argument("Omaha hands have four cards");
+    }
+    int indices[4];
+    for (int i = 0; i < 4; i++) indices[i] = cards[i].getIndex();
+    std::sort(indices, indices + 4);
+    if (std::adjacent_find(indices, indices + 4) != indices + 4) {
+        throw std::invalid_argument("Omaha hand repeats a card");
+    }
+    
+    Entry entry = {comboIndex(indices), static_cast<float>(weight)};
+    auto position = std::lower_bound(entries.begin(), entries.end(), entry,
+                                     [](const Entry& a, const Entry& b) { return a.combo < b.combo; });
+    if (position != entries.end() && position->combo == entry.combo) {
+        position->weight = entry.weight;
+    } else {
+        entries.insert(position, entry);
+    }
+}
+
+uint32_t OmahaRange::comboIndex(const int* cardIndices) {
+    int sorted[4] = {cardIndices[0], cardIndices[1], cardIndices[2], cardIndices[3]};
+    std::sort(sorted, sorted + 4);
+    uint32_t index = 0;
+    for (int i = 0; i < 4; i++) index += chooseSmall(sorted[i], i + 1);
+    return index;
+}
+
+void OmahaRange::comboCards(uint32_t combo, int* cardIndices) {
+    for (int k = 4; k >= 1; k--) {
+        int card = k - 1;
+        while (chooseSmall(card + 1, k) <= combo) card++;
+        combo -= chooseSmall(card, k);
+        cardIndices[k - 1] = card;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef HAND_RANGE_H
+#define HAND_RANGE_H
+
+#include "card.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Weighted set of Hold'em starting hands: one weight per two-card combo,
+// indexed like PreflopEquity::comboIndex. Text ranges use the usual notation,
+// comma separated, each token optionally weighted with ":w":
+//   "AA"  "TT+"  "99-66"  "AKs"  "AQo+"  "A5s-A2s"  "KQ"  "AhKh"  "any"
+class HoldemRange {
+public:
+    static const int NUM_COMBOS = 1326;
+    
+    HoldemRange();
+    
+    // Throws std::invalid_argument on an unreadable token
+    static HoldemRange parse(const std::string& text);
+    static HoldemRange any();
+    
+    double getWeight(int combo) const { return weights[combo]; }
+    void setWeight(int combo, double weight);
+    const std::vector<double>& getWeights() const { return weights; } // Fits HandStrengthEngine::evaluateAgainstRange
+    
+    int getComboCount() const;   // Combos with positive weight
+    double getTotalWeight() const;
+    void removeCards(const std::vector<Card>& deadCards); // Zero every combo holding a dead card
+    
+    static int comboIndex(int firstCard, int secondCard); // Dense card indices, either order
+    static void comboCards(int combo, int& highCard, int& lowCard);
+    
+private:
+    std::vector<double> weights;
+    
+    void addToken(const std::string& token, double weight);
+    void addClass(Rank high, Rank low, int suitedness, double weight); // suitedness: 1 suited, -1 offsuit, 0 both
+};
+
+// Sparse weighted list of Omaha starting hands out of C(52,4) = 270,725.
+// Only listed combos are stored, sorted by index. Text form is a comma
+// separated list of four-card hands, optionally weighted:
+//   "AhKhQdJd, AsAdKsKd:0.5"
+class OmahaRange {
+public:
+    static const int NUM_COMBOS = 270725;
+    
+    struct Entry {
+        uint32_t combo;
+        float weight;
+    };
+    
+    static OmahaRange parse(const std::string& text);
+    
+    void add(const std::vector<Card>& cards, double weight = 1.0);
+    const std::vector<Entry>& getEntries() const { return entries; }
+    int getComboCount() const { return static_cast<int>(entries.size()); }
+    
+    // Colex rank of four distinct card indices, any order
+    static uint32_t comboIndex(const int* cardIndices);
+    static void comboCards(uint32_t combo, int* cardIndices);
+    
+private:
+    std::vector<Entry> entries;
+};
+
+#endif
@@ -0,0 +1,422 @@
+#include "hand_replay.h"
+#include "hand_archive.h"
+#include "game_log.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace {
+    bool isDecision(ActionType type) {
+        return type == ActionType::FOLD || type == ActionType::CHECK || type == ActionType::CALL ||
+               type == ActionType::RAISE || type == ActionType::ALL_IN;
+    }
+
+    bool sameAction(const GameAction& recorded, const GameAction& replayed) {
+        if (recorded.round != replayed.round || recorded.playerId != replayed.playerId ||
+            recorded.actionType != replayed.actionType || recorded.amount != replayed.amount ||
+            recorded.potAfterAction != replayed.potAfterAction ||
+            recorded.cardsDealt.size() != replayed.cardsDealt.size()) {
+            return false;
+        }
+        for (size_t c = 0; c < recorded.cardsDealt.size(); c++) {
+            if (!(recorded.cardsDealt[c] == replayed.cardsDealt[c])) return false;
+        }
+        return true;
+    }
+
+    std::string describe(const GameAction* action) {
+        if (!action) return "nothing";
+        std::ostringstream out;
+        out << "round " << static_cast<int>(action->round) << " player " << action->playerId << " type "
+            << static_cast<int>(action->actionType) << " amount " << action->amount << " level "
+            << action->potAfterAction;
+        for (const Card& card : action->cardsDealt) out << " " << card.toString();
+        return out.str();
+    }
+
+    void setDetail(std::string* detail, const std::string& text) {
+        if (detail) *detail = text;
+    }
+}
+
+void ReplayReport::add(ReplayOutcome outcome, const std::string& detail) {
+    hands++;
+    outcomes[static_cast<int>(outcome)]++;
+    if (outcome != ReplayOutcome::MATCHED && details.size() < MAX_DETAILS) {
+        details.push_back(detail);
+    }
+}
+
+void ReplayReport::merge(const ReplayReport& other) {
+    hands += other.hands;
+    for (int i = 0; i < OUTCOMES; i++) outcomes[i] += other.outcomes[i];
+    for (const std::string& detail : other.details) {
+        if (details.size() >= MAX_DETAILS) break;
+        details.push_back(detail);
+    }
+    seconds += other.seconds;
+}
+
+void HandReplayer::ScriptedDecisions::start(const ActionList& recorded) {
+    actions = &recorded;
+    next = 0;
+    diverged = false;
+}
+
+bool HandReplayer::ScriptedDecisions::requestDecision(PokerGame& game, const DecisionRequest& request,
+                                                      Decision& decision) {
+    while (next < actions->size() && !isDecision((*actions)[next].actionType)) next++;
+    if (next >= actions->size() || (*actions)[next].playerId != request.playerId) {
+        // The engine wants a decision the record does not have; end the hand quietly
+        diverged = true;
+        decision.action = request.canCheck ? PlayerAction::CHECK : PlayerAction::FOLD;
+        decision.raiseAmount = 0;
+        return true;
+    }
+    if (observer) observer(game, request, next);
+    const GameAction& action = (*actions)[next++];
+    decision.action = static_cast<PlayerAction>(action.actionType);
+    decision.raiseAmount = action.actionType == ActionType::RAISE ? std::max(action.amount, 1) : 0;
+    return true;
+}
+
+HandReplayer::HandReplayer(const VariantInfo& variantInfo)
+    : variant(variantInfo), game(&table, variantInfo) {
+    game.setDecisionProvider(&script);
+}
+
+const char* HandReplayer::outcomeName(ReplayOutcome outcome) {
+    switch (outcome) {
+        case ReplayOutcome::MATCHED: return "matched";
+        case ReplayOutcome::ACTIONS_DIFFER: return "actions differ";
+        case ReplayOutcome::CHIPS_NOT_CONSERVED: return "chips not conserved";
+        case ReplayOutcome::AWARDS_DIFFER: return "awards differ";
+        case ReplayOutcome::AWARD_OVER_CAP: return "award over cap";
+        case ReplayOutcome::UNSUPPORTED: return "unsupported";
+    }
+    return "unknown";
+}
+
+bool HandReplayer::seatPlayers(const HandHistory& hand, std::string* detail) {
+    const PlayerList& players = hand.getPlayers();
+    std::vector<const PlayerInfo*> bySeat(players.size(), nullptr);
+    for (const PlayerInfo& player : players) {
+        if (player.position < 0 || player.position >= static_cast<int>(players.size()) || bySeat[player.position]) {
+            setDetail(detail, "seats are not numbered 0 to " + std::to_string(players.size() - 1));
+            return false;
+        }
+        bySeat[player.position] = &player;
+    }
+    if (players.size() < 2) {
+        setDetail(detail, "fewer than two players");
+        return false;
+    }
+
+    while (table.getPlayerCount() > 0) {
+        table.removePlayer(table.getPlayerCount() - 1);
+    }
+    int dealer = 0;
+    for (const PlayerInfo* player : bySeat) {
+        table.addPlayer(player->name, player->startingChips, player->playerId);
+        if (player->isDealer) dealer = player->position;
+    }
+    table.setDealerPosition(dealer);
+    return true;
+}
+
+bool HandReplayer::setStakes(const HandHistory& hand, std::string* detail) {
+    // Forced bets are recorded at the bet level they set, so short stacks do not hide the stakes
+    std::vector<int> betSizes = variant.betSizes;
+    int ante = 0;
+    int blindsSeen = 0;
+    for (const GameAction& action : hand.getActions()) {
+        if (action.actionType != ActionType::POST_BLIND) continue;
+        if (action.round == HandHistoryRound::PRE_HAND && action.potAfterAction == 0) {
+            ante = std::max(ante, action.amount);
+        } else if (blindsSeen < 2) {
+            betSizes[variant.gameStruct == GAMESTRUCTURE_STUD ? 1 : blindsSeen] = action.potAfterAction;
+            blindsSeen++;
+        }
+    }
+
+    if (variant.gameStruct == GAMESTRUCTURE_STUD) {
+        if (blindsSeen != 1) {
+            setDetail(detail, "no bring-in recorded");
+            return false;
+        }
+        betSizes[0] = ante;
+        game.setBoardAnte(0);
+    } else {
+        if (blindsSeen != 2) {
+            setDetail(detail, "blinds not recorded");
+            return false;
+        }
+        game.setBoardAnte(ante);
+    }
+    game.setBetSizes(betSizes);
+    return true;
+}
+
+bool HandReplayer::stackDeck(const HandHistory& hand, std::string* detail) {
+    const Card BURN(Suit::CLUBS, Rank::TWO); // Placeholder until the unused cards are known
+    std::vector<int> burns;
+    dealOrder.clear();
+
+    int seats = static_cast<int>(hand.getPlayers().size());
+    int runs = 0;
+    if (variant.gameStruct == GAMESTRUCTURE_STUD) {
+        // Stud deals seat by seat and street by street, exactly as the cards were recorded
+        int initialDeals = 0;
+        for (const GameAction& action : hand.getActions()) {
+            if (action.actionType != ActionType::DEAL_CARDS || action.playerId < 0) continue;
+            if (action.round == HandHistoryRound::PRE_HAND) initialDeals++;
+            dealOrder.insert(dealOrder.end(), action.cardsDealt.begin(), action.cardsDealt.end());
+        }
+        if (initialDeals != seats) {
+            setDetail(detail, "hole cards not recorded");
+            return false;
+        }
+    } else {
+        // Hole cards go round the table one card at a time
+        int holeCards = variant.numHoleCards == NUMHOLECARDS_TWO ? 2 : 4;
+        std::vector<const ArenaVector<Card>*> holes(seats, nullptr);
+        for (const GameAction& action : hand.getActions()) {
+            if (action.actionType != ActionType::DEAL_CARDS || action.round != HandHistoryRound::PRE_HAND) continue;
+            for (const PlayerInfo& player : hand.getPlayers()) {
+                if (player.playerId == action.playerId) holes[player.position] = &action.cardsDealt;
+            }
+        }
+        for (int seat = 0; seat < seats; seat++) {
+            if (!holes[seat] || static_cast<int>(holes[seat]->size()) != holeCards) {
+                setDetail(detail, "hole cards not recorded");
+                return false;
+            }
+        }
+        for (int card = 0; card < holeCards; card++) {
+            for (int seat = 0; seat < seats; seat++) dealOrder.push_back((*holes[seat])[card]);
+        }
+
+        // A burn before every street; each run of a runout starts again from the board at the all-in
+        int board = 0;
+        int runoutFrom = -1;
+        for (const GameAction& action : hand.getActions()) {
+            if (action.actionType != ActionType::REVEAL_BOARD) continue;
+            if (action.round == HandHistoryRound::SHOWDOWN) {
+                if (runoutFrom < 0) runoutFrom = board;
+                board = runoutFrom;
+                runs++;
+            }
+            for (size_t c = 0; c < action.cardsDealt.size();) {
+                size_t street = board == 0 ? 3 : 1;
+                burns.push_back(static_cast<int>(dealOrder.size()));
+                dealOrder.push_back(BURN);
+                for (size_t i = 0; i < street && c < action.cardsDealt.size(); i++, c++) {
+                    dealOrder.push_back(action.cardsDealt[c]);
+                }
+                board += static_cast<int>(street);
+            }
+        }
+    }
+
+    std::vector<bool> used(52, false);
+    for (size_t i = 0, b = 0; i < dealOrder.size(); i++) {
+        if (b < burns.size() && burns[b] == static_cast<int>(i)) {
+            b++;
+            continue;
+        }
+        int index = dealOrder[i].getIndex();
+        if (used[index]) {
+            setDetail(detail, "card " + dealOrder[i].toString() + " recorded twice");
+            return false;
+        }
+        used[index] = true;
+    }
+    int unused = 0;
+    for (int burn : burns) {
+        while (unused < 52 && used[unused]) unused++;
+        if (unused == 52) {
+            setDetail(detail, "more cards recorded than a deck holds");
+            return false;
+        }
+        used[unused] = true;
+        dealOrder[burn] = Card::fromIndex(unused);
+    }
+
+    table.getDeck().reset();
+    table.getDeck().stack(dealOrder);
+    game.setRunItTimes(runs);
+    return true;
+}
+
+bool HandReplayer::awardsWithinContributions(const HandHistory& hand, std::string* detail) {
+    const PlayerList& players = hand.getPlayers();
+    contributed.assign(players.size(), 0);
+    streetBet.assign(players.size(), 0);
+
+    // Replays the betting the way the engine charges it: antes go straight in, blinds and
+    // the bring-in open the street, a raise tops up to its target and a short call or any
+    // all-in takes what is left of the stack
+    HandHistoryRound street = HandHistoryRound::PRE_HAND;
+    for (const GameAction& action : hand.getActions()) {
+        if (action.round != street) {
+            if (street != HandHistoryRound::PRE_HAND) std::fill(streetBet.begin(), streetBet.end(), 0);
+            street = action.round;
+        }
+        size_t seat = 0;
+        while (seat < players.size() && players[seat].playerId != action.playerId) seat++;
+        if (seat == players.size()) continue;
+
+        int behind = players[seat].startingChips - contributed[seat];
+        int amount = 0;
+        switch (action.actionType) {
+            case ActionType::POST_BLIND:
+                amount = std::min(action.amount, behind);
+                // Antes are recorded before any bet is set and don't count towards the street
+                if (action.round != HandHistoryRound::PRE_HAND || action.potAfterAction != 0) {
+                    streetBet[seat] += amount;
+                }
+                contributed[seat] += amount;
+                continue;
+            case ActionType::CALL: amount = std::min(action.amount, behind); break;
+            case ActionType::RAISE: amount = std::min(std::max(action.amount - streetBet[seat], 0), behind); break;
+            case ActionType::ALL_IN: amount = behind; break;
+            default: continue;
+        }
+        streetBet[seat] += amount;
+        contributed[seat] += amount;
+    }
+
+    const HandResolution& resolution = hand.getResolution();
+    for (size_t seat = 0; seat < players.size(); seat++) {
+        long long won = 0;
+        for (size_t w = 0; w < resolution.winners.size() && w < resolution.amounts.size(); w++) {
+            if (resolution.winners[w] == players[seat].playerId) won += resolution.amounts[w];
+        }
+        long long cap = contributed[seat];
+        for (size_t other = 0; other < players.size(); other++) {
+            if (other != seat) cap += std::min(contributed[seat], contributed[other]);
+        }
+        if (won > cap) {
+            setDetail(detail, players[seat].name + " won " + std::to_string(won) + " but put in " +
+                              std::to_string(contributed[seat]) + ", so could win at most " + std::to_string(cap));
+            return false;
+        }
+    }
+    return true;
+}
+
+ReplayOutcome HandReplayer::replay(const HandHistory& hand, std::string* detail) {
+    if (hand.getVariant() != PokerGame::historyVariant(variant)) {
+        setDetail(detail, "recorded in another variant");
+        return ReplayOutcome::UNSUPPORTED;
+    }
+    if (!seatPlayers(hand, detail) || !setStakes(hand, detail) || !stackDeck(hand, detail)) {
+        return ReplayOutcome::UNSUPPORTED;
+    }
+
+    // Same table reset as a tournament hand, minus the shuffle and the button move
+    table.setCurrentBet(0);
+    table.getSidePotManager().clearPots();
+    table.clearCommunityCards();
+
+    bool wasEnabled = GameLog::isEnabled();
+    GameLog::setEnabled(false);
+    script.start(hand.getActions());
+    game.startNewHand();
+    while (game.advance() != GameStepResult::HAND_COMPLETE) {
+    }
+    game.finishHand();
+    GameLog::setEnabled(wasEnabled);
+
+    const ActionList& recorded = hand.getActions();
+    const ActionList& replayed = game.getHandHistory().getActions();
+    size_t actions = std::max(recorded.size(), replayed.size());
+    for (size_t i = 0; i < actions; i++) {
+        const GameAction* expected = i < recorded.size() ? &recorded[i] : nullptr;
+        const GameAction* actual = i < replayed.size() ? &replayed[i] : nullptr;
+        if (!expected || !actual || !sameAction(*expected, *actual)) {
+            setDetail(detail, "action " + std::to_string(i) + ": recorded " + describe(expected) + ", replayed " +
+                              describe(actual));
+            return ReplayOutcome::ACTIONS_DIFFER;
+        }
+    }
+    if (script.hasDiverged()) {
+        setDetail(detail, "the engine asked for a decision the record does not have");
+        return ReplayOutcome::ACTIONS_DIFFER;
+    }
+
+    long long chipsBefore = 0;
+    long long chipsAfter = 0;
+    for (const PlayerInfo& player : hand.getPlayers()) chipsBefore += player.startingChips;
+    for (int i = 0; i < table.getPlayerCount(); i++) chipsAfter += table.getPlayer(i)->getChips();
+    if (chipsBefore != chipsAfter) {
+        setDetail(detail, std::to_string(chipsBefore) + " chips before the hand, " + std::to_string(chipsAfter) +
+                          " after");
+        return ReplayOutcome::CHIPS_NOT_CONSERVED;
+    }
+
+    const HandResolution& expected = hand.getResolution();
+    const HandResolution& actual = game.getHandHistory().getResolution();
+    if (expected.winners != actual.winners || expected.amounts != actual.amounts) {
+        setDetail(detail, "recorded \"" + expected.description + "\", replayed \"" + actual.description + "\"");
+        return ReplayOutcome::AWARDS_DIFFER;
+    }
+    if (!awardsWithinContributions(hand, detail)) {
+        return ReplayOutcome::AWARD_OVER_CAP;
+    }
+    return ReplayOutcome::MATCHED;
+}
+
+ReplayEngine::ReplayEngine(const VariantInfo& variant, ThreadPool& threadPool) : pool(threadPool) {
+    for (int w = 0; w < pool.getThreadCount(); w++) {
+        replayers.emplace_back(new HandReplayer(variant));
+    }
+}
+
+void ReplayEngine::replayBatch(const std::vector<HandHistory>& hands, const std::vector<int>& tableIds,
+                               size_t count, ReplayReport& report) {
+    std::vector<ReplayReport> workerReports(replayers.size());
+    pool.parallelFor(static_cast<int>(count), [&](int index, int worker) {
+        std::string detail;
+        ReplayOutcome outcome = replayers[worker]->replay(hands[index], &detail);
+        ReplayReport& workerReport = workerReports[worker];
+        if (outcome != ReplayOutcome::MATCHED && workerReport.details.size() < ReplayReport::MAX_DETAILS) {
+            detail = "table " + std::to_string(tableIds[index]) + " hand " +
+                     std::to_string(hands[index].getHandNumber()) + ": " + HandReplayer::outcomeName(outcome) +
+                     ", " + detail;
+        }
+        workerReport.add(outcome, detail);
+    });
+    for (const ReplayReport& workerReport : workerReports) {
+        report.merge(workerReport);
+    }
+}
+
+bool ReplayEngine::replayArchive(const std::string& path, ReplayReport& report) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<HandHistory> batch;
+    std::vector<int> tableIds;
+    batch.reserve(BATCH_HANDS);
+    tableIds.reserve(BATCH_HANDS);
+    bool read = HandArchive::readHands(path, [&](int tableId, const HandHistory& hand) {
+        batch.push_back(hand);
+        tableIds.push_back(tableId);
+        if (batch.size() == BATCH_HANDS) {
+            replayBatch(batch, tableIds, batch.size(), report);
+            batch.clear();
+            tableIds.clear();
+        }
+    });
+    if (!batch.empty()) {
+        replayBatch(batch, tableIds, batch.size(), report);
+    }
+    report.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return read;
+}
+
+void ReplayEngine::replayHands(const std::vector<HandHistory>& hands, ReplayReport& report) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> tableIds(hands.size(), -1);
+    replayBatch(hands, tableIds, hands.size(), report);
+    report.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
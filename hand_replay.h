@@ -0,0 +1,115 @@
+#ifndef HAND_REPLAY_H
+#define HAND_REPLAY_H
+
+#include "poker_game.h"
+#include "table.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+
+enum class ReplayOutcome {
+    MATCHED,             // Same actions, same awards, chips conserved, awards within the caps
+    ACTIONS_DIFFER,      // The engine recorded a different action, bet level or card
+    CHIPS_NOT_CONSERVED, // Chips at the table changed over the hand
+    AWARDS_DIFFER,       // Pots went to different players or in different amounts
+    AWARD_OVER_CAP,      // A seat won more than it could cover from the others' contributions
+    UNSUPPORTED          // Hole cards or stakes missing from the record, or another variant
+};
+
+struct ReplayReport {
+    static const int OUTCOMES = 6;
+    static const size_t MAX_DETAILS = 20;
+
+    long long hands = 0;
+    long long outcomes[OUTCOMES] = {};
+    std::vector<std::string> details; // The first failures, for the log
+    double seconds = 0.0;
+
+    long long count(ReplayOutcome outcome) const { return outcomes[static_cast<int>(outcome)]; }
+    void add(ReplayOutcome outcome, const std::string& detail);
+    void merge(const ReplayReport& other);
+};
+
+// Re-drives PokerGame through one recorded hand: the table is rebuilt from
+// the recorded seats, stacks and button, the deck is stacked so every deal
+// reproduces the recorded cards (burns come from unused cards), and a
+// scripted decision provider answers each decision with the recorded action,
+// so Player::makeDecision never runs. The replayed history is then compared
+// with the recording action by action, the awards against the recorded
+// HandResolution, and the table's chips against the starting stacks.
+// Independently of the engine's pot code, each seat's contribution is rebuilt
+// from the recorded actions and no seat may win more than its own stake plus,
+// from every opponent, the smaller of the two contributions.
+//
+// Needs every seat's hole cards, which PokerGame records since replays
+// were added. Blinds, antes and the bring-in are read from the forced bets.
+class HandReplayer {
+public:
+    explicit HandReplayer(const VariantInfo& variant);
+    HandReplayer(const HandReplayer&) = delete;
+    HandReplayer& operator=(const HandReplayer&) = delete;
+
+    // Sees the game just before each recorded decision is applied; actionIndex
+    // is that decision's position in the recorded actions
+    typedef std::function<void(const PokerGame& game, const DecisionRequest& request, size_t actionIndex)>
+        DecisionObserver;
+    void setDecisionObserver(DecisionObserver observer) { script.setObserver(std::move(observer)); }
+
+    ReplayOutcome replay(const HandHistory& hand, std::string* detail = nullptr);
+    const HandHistory& getReplayedHistory() const { return game.getHandHistory(); }
+
+    static const char* outcomeName(ReplayOutcome outcome);
+
+private:
+    // Answers each decision with the next recorded one
+    class ScriptedDecisions : public DecisionProvider {
+    public:
+        void start(const ActionList& recorded);
+        bool requestDecision(PokerGame& game, const DecisionRequest& request, Decision& decision) override;
+        bool hasDiverged() const { return diverged; }
+        void setObserver(DecisionObserver decisionObserver) { observer = std::move(decisionObserver); }
+
+    private:
+        DecisionObserver observer;
+        const ActionList* actions = nullptr;
+        size_t next = 0;
+        bool diverged = false;
+    };
+
+    VariantInfo variant;
+    Table table;
+    PokerGame game;
+    ScriptedDecisions script;
+    std::vector<Card> dealOrder;
+    std::vector<int> contributed; // Chips each seat put in, by position in the recorded players
+    std::vector<int> streetBet;   // The same for the current betting round
+
+    bool seatPlayers(const HandHistory& hand, std::string* detail);
+    bool setStakes(const HandHistory& hand, std::string* detail);
+    bool stackDeck(const HandHistory& hand, std::string* detail);
+    bool awardsWithinContributions(const HandHistory& hand, std::string* detail);
+};
+
+// Replays whole archives across the pool: hands are read in batches and
+// each pool thread replays its share with its own HandReplayer.
+class ReplayEngine {
+public:
+    static const size_t BATCH_HANDS = 8192;
+
+    ReplayEngine(const VariantInfo& variant, ThreadPool& pool);
+
+    // False if the file is not a hand archive
+    bool replayArchive(const std::string& path, ReplayReport& report);
+    void replayHands(const std::vector<HandHistory>& hands, ReplayReport& report);
+
+private:
+    ThreadPool& pool;
+    std::vector<std::unique_ptr<HandReplayer>> replayers; // One per pool thread
+
+    void replayBatch(const std::vector<HandHistory>& hands, const std::vector<int>& tableIds, size_t count,
+                     ReplayReport& report);
+};
+
+#endif
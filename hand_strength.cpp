@@ -0,0 +1,401 @@
+#include "hand_strength.h"
+#include "fast_evaluator.h"
+#include "hand_indexer.h"
+#include "preflop_equity.h"
+#include <unordered_map>
+#include <random>
+#include <stdexcept>
+#include <cmath>
+
+namespace {
+    const int DECK_SIZE = 52;
+    const int PREFLOP_SAMPLES = 2000;     // Boards per hand when no preflop table is loaded
+    const size_t MAX_CACHED_RESULTS = 1 << 18; // Per street, per thread
+    const int BOARD_CACHE_SIZE = 8;             // Boards with opponent tables, per thread
+    const int NEXT_COMBO_STRIDE = 17;           // Potentials sample one opponent combo in 17
+    const int SAMPLED_COMBOS = HandStrengthEngine::NUM_COMBOS / NEXT_COMBO_STRIDE;
+    static_assert(HandStrengthEngine::NUM_COMBOS % NEXT_COMBO_STRIDE == 0, "every card samples the same count");
+    
+    enum Standing { AHEAD = 0, TIED = 1, BEHIND = 2 };
+    
+    inline CardMask maskOfIndex(int cardIndex) {
+        return CardMask(1) << (16 * (cardIndex / 13) + cardIndex % 13);
+    }
+    
+    inline int standing(int heroValue, int opponentValue) {
+        // Branch-free: AHEAD 0, TIED 1, BEHIND 2
+        return (heroValue == opponentValue) + 2 * (heroValue < opponentValue);
+    }
+    
+    // Masks of every two-card combo, in PreflopEquity::comboIndex order
+    struct ComboMasks {
+        CardMask mask[HandStrengthEngine::NUM_COMBOS];
+        
+        ComboMasks() {
+            for (int first = 1; first < DECK_SIZE; first++) {
+                for (int second = 0; second < first; second++) {
+                    mask[first * (first - 1) / 2 + second] = maskOfIndex(first) | maskOfIndex(second);
+                }
+            }
+        }
+    };
+    
+    const ComboMasks& comboMasks() {
+        static const ComboMasks masks;
+        return masks;
+    }
+    
+    // Opponent values on one board: every combo now, and after each possible
+    // next card. Rows for the next card are built the first time a hero on
+    // this board enumerates that card. The uniform-range rows hold a fixed
+    // sample of combos (every NEXT_COMBO_STRIDE-th, offset by the card), so
+    // a new flop or turn costs a few thousand evaluations instead of 69k;
+    // weighted ranges, which can sit on a handful of combos, get full rows.
+    struct BoardTables {
+        CardMask board = ~CardMask(0);
+        uint64_t lastUse = 0;
+        std::vector<int> now;     // [combo], -1 when the combo shares a board card
+        std::vector<int> sampled; // [nextCard * SAMPLED_COMBOS + j] for combo card % stride + j * stride
+        uint64_t sampledRows = 0; // Bit per next card whose sampled row is built
+        std::vector<int> next;    // [nextCard * NUM_COMBOS + combo], weighted ranges only
+        uint64_t fullRows = 0;
+    };
+    
+    struct BoardCache {
+        BoardTables entries[BOARD_CACHE_SIZE];
+        uint64_t clock = 0;
+    };
+    
+    BoardCache& boardCache() {
+        thread_local BoardCache cache;
+        return cache;
+    }
+    
+    // Least recently used board is replaced, so a thread that rotates
+    // between a few tables keeps each table's board
+    BoardTables& boardTables(CardMask board) {
+        BoardCache& cache = boardCache();
+        cache.clock++;
+        BoardTables* victim = &cache.entries[0];
+        for (BoardTables& entry : cache.entries) {
+            if (entry.board == board) {
+                entry.lastUse = cache.clock;
+                return entry;
+            }
+            if (entry.lastUse < victim->lastUse) victim = &entry;
+        }
+        
+        const ComboMasks& combos = comboMasks();
+        const int n = HandStrengthEngine::NUM_COMBOS;
+        victim->board = board;
+        victim->lastUse = cache.clock;
+        victim->sampledRows = 0;
+        victim->fullRows = 0;
+        victim->now.resize(n);
+        for (int combo = 0; combo < n; combo++) {
+            victim->now[combo] = (combos.mask[combo] & board) ? -1 : FastEvaluator::evaluateUncounted(combos.mask[combo] | board);
+        }
+        return *victim;
+    }
+    
+    const int* sampledRow(BoardTables& tables, int card) {
+        if (tables.sampled.empty()) tables.sampled.resize(DECK_SIZE * SAMPLED_COMBOS);
+        int* row = &tables.sampled[card * SAMPLED_COMBOS];
+        if (!(tables.sampledRows & (1ULL << card))) {
+            const ComboMasks& combos = comboMasks();
+            CardMask dealt = tables.board | maskOfIndex(card);
+            for (int j = 0, combo = card % NEXT_COMBO_STRIDE; j < SAMPLED_COMBOS; j++, combo += NEXT_COMBO_STRIDE) {
+                row[j] = (combos.mask[combo] & dealt) ? -1 : FastEvaluator::evaluateUncounted(combos.mask[combo] | dealt);
+            }
+            tables.sampledRows |= 1ULL << card;
+        }
+        return row;
+    }
+    
+    const int* fullRow(BoardTables& tables, int card) {
+        const int n = HandStrengthEngine::NUM_COMBOS;
+        if (tables.next.empty()) tables.next.resize(DECK_SIZE * n);
+        int* row = &tables.next[card * n];
+        if (!(tables.fullRows & (1ULL << card))) {
+            const ComboMasks& combos = comboMasks();
+            CardMask dealt = tables.board | maskOfIndex(card);
+            for (int combo = 0; combo < n; combo++) {
+                row[combo] = (combos.mask[combo] & dealt) ? -1 : FastEvaluator::evaluateUncounted(combos.mask[combo] | dealt);
+            }
+            tables.fullRows |= 1ULL << card;
+        }
+        return row;
+    }
+    
+    HandStrength fromStanding(double handStrength, double positive, double negative, double squared) {
+        HandStrength result;
+        result.handStrength = handStrength;
+        result.positivePotential = positive;
+        result.negativePotential = negative;
+        result.effectiveStrength = handStrength * (1.0 - negative) + (1.0 - handStrength) * positive;
+        result.strengthSquared = squared;
+        return result;
+    }
+    
+    // Every opponent combo for hand strength; before the river, every next
+    // card against the sampled combos (uniform range) or every combo (weights)
+    HandStrength postflopStrength(CardMask hero, CardMask board, int boardCount, const double* weights) {
+        const ComboMasks& combos = comboMasks();
+        const int n = HandStrengthEngine::NUM_COMBOS;
+        bool lookAhead = boardCount < 5;
+        BoardTables& tables = boardTables(board);
+        CardMask dead = hero | board;
+        int heroNow = FastEvaluator::evaluateUncounted(dead);
+        
+        double nowTotals[3] = {0.0, 0.0, 0.0};
+        int liveCombos[HandStrengthEngine::NUM_COMBOS];
+        int liveStanding[HandStrengthEngine::NUM_COMBOS];
+        double liveWeight[HandStrengthEngine::NUM_COMBOS];
+        int liveCount = 0;
+        for (int combo = 0; combo < n; combo++) {
+            if (combos.mask[combo] & dead) continue;
+            double weight = weights ? weights[combo] : 1.0;
+            if (weight <= 0.0) continue;
+            int now = standing(heroNow, tables.now[combo]);
+            nowTotals[now] += weight;
+            liveCombos[liveCount] = combo;
+            liveStanding[liveCount] = now;
+            liveWeight[liveCount++] = weight;
+        }
+        
+        double total = nowTotals[AHEAD] + nowTotals[TIED] + nowTotals[BEHIND];
+        if (total <= 0.0) return fromStanding(0.0, 0.0, 0.0, 0.0);
+        double handStrength = (nowTotals[AHEAD] + nowTotals[TIED] * 0.5) / total;
+        if (!lookAhead) {
+            return fromStanding(handStrength, 0.0, 0.0, handStrength * handStrength);
+        }
+        
+        double transitions[3][3] = {{0.0}};
+        double transitionTotals[3] = {0.0, 0.0, 0.0};
+        double squared = 0.0;
+        int counted = 0;
+        for (int card = 0; card < DECK_SIZE; card++) {
+            if (maskOfIndex(card) & dead) continue;
+            int heroNext = FastEvaluator::evaluateUncounted(dead | maskOfIndex(card));
+            double cardTransitions[3][3] = {{0.0}};
+            if (weights) {
+                const int* row = fullRow(tables, card);
+                for (int live = 0; live < liveCount; live++) {
+                    int opponentNext = row[liveCombos[live]];
+                    if (opponentNext < 0) continue; // Opponent holds the next card
+                    cardTransitions[liveStanding[live]][standing(heroNext, opponentNext)] += liveWeight[live];
+                }
+            } else {
+                // Uniform range: integer counts over the card's sample
+                const int* row = sampledRow(tables, card);
+                int counts[9] = {0};
+                for (int j = 0, combo = card % NEXT_COMBO_STRIDE; j < SAMPLED_COMBOS; j++, combo += NEXT_COMBO_STRIDE) {
+                    if (row[j] < 0 || (combos.mask[combo] & hero)) continue;
+                    counts[standing(heroNow, tables.now[combo]) * 3 + standing(heroNext, row[j])]++;
+                }
+                for (int cell = 0; cell < 9; cell++) cardTransitions[cell / 3][cell % 3] = counts[cell];
+            }
+            
+            double cardWeight = 0.0;
+            double cardScore = 0.0;
+            for (int now = 0; now < 3; now++) {
+                for (int after = 0; after < 3; after++) {
+                    transitions[now][after] += cardTransitions[now][after];
+                    transitionTotals[now] += cardTransitions[now][after];
+                    cardWeight += cardTransitions[now][after];
+                }
+                cardScore += cardTransitions[now][AHEAD] + cardTransitions[now][TIED] * 0.5;
+            }
+            if (cardWeight > 0.0) {
+                squared += (cardScore / cardWeight) * (cardScore / cardWeight);
+                counted++;
+            }
+        }
+        
+        double positiveBase = transitionTotals[BEHIND] + transitionTotals[TIED] * 0.5;
+        double negativeBase = transitionTotals[AHEAD] + transitionTotals[TIED] * 0.5;
+        double positive = positiveBase > 0.0
+            ? (transitions[BEHIND][AHEAD] + transitions[BEHIND][TIED] * 0.5 + transitions[TIED][AHEAD] * 0.5) / positiveBase
+            : 0.0;
+        double negative = negativeBase > 0.0
+            ? (transitions[AHEAD][BEHIND] + transitions[AHEAD][TIED] * 0.5 + transitions[TIED][BEHIND] * 0.5) / negativeBase
+            : 0.0;
+        return fromStanding(handStrength, positive, negative, counted > 0 ? squared / counted : 0.0);
+    }
+    
+    // Showdown equity against a random hand; the preflop table when loaded
+    HandStrength preflopStrength(const std::vector<Card>& holeCards, int handClass) {
+        const PreflopEquity& table = PreflopEquity::shared();
+        double equity;
+        if (table.isLoaded()) {
+            equity = table.equityVsRandom(holeCards[0], holeCards[1], {});
+        } else {
+            CardMask hero = FastEvaluator::handMask(holeCards);
+            std::vector<CardMask> deck;
+            for (int card = 0; card < DECK_SIZE; card++) {
+                if (!(maskOfIndex(card) & hero)) deck.push_back(maskOfIndex(card));
+            }
+            std::mt19937 rng(static_cast<unsigned>(handClass) + 1);
+            double score = 0.0;
+            for (int sample = 0; sample < PREFLOP_SAMPLES; sample++) {
+                // Partial shuffle: two opponent cards, then five board cards
+                CardMask drawn[7];
+                for (int i = 0; i < 7; i++) {
+                    int j = i + static_cast<int>(rng() % (deck.size() - i));
+                    std::swap(deck[i], deck[j]);
+                    drawn[i] = deck[i];
+                }
+                CardMask board = drawn[2] | drawn[3] | drawn[4] | drawn[5] | drawn[6];
+                int heroValue = FastEvaluator::evaluateUncounted(hero | board);
+                int opponentValue = FastEvaluator::evaluateUncounted(drawn[0] | drawn[1] | board);
+                score += heroValue > opponentValue ? 1.0 : (heroValue == opponentValue ? 0.5 : 0.0);
+            }
+            equity = score / PREFLOP_SAMPLES;
+        }
+        return fromStanding(equity, 0.0, 0.0, equity * equity);
+    }
+    
+    const CardMask LANE_BITS = 0x1FFF;
+    
+    // Suits relabelled so the board's suit lanes are in descending order,
+    // hero lanes breaking ties. Hand strength against a uniform range doesn't
+    // depend on suit names, so every isomorphic (hero, board) pair maps to
+    // one pair and shares its tables and cached result.
+    void canonicalize(CardMask& hero, CardMask& board) {
+        uint64_t laneKey[4];
+        int order[4] = {0, 1, 2, 3};
+        for (int suit = 0; suit < 4; suit++) {
+            laneKey[suit] = (((board >> (16 * suit)) & LANE_BITS) << 13) | ((hero >> (16 * suit)) & LANE_BITS);
+        }
+        for (int i = 1; i < 4; i++) {
+            for (int j = i; j > 0 && laneKey[order[j]] > laneKey[order[j - 1]]; j--) std::swap(order[j], order[j - 1]);
+        }
+        CardMask canonicalHero = 0;
+        CardMask canonicalBoard = 0;
+        for (int lane = 0; lane < 4; lane++) {
+            canonicalHero |= ((hero >> (16 * order[lane])) & LANE_BITS) << (16 * lane);
+            canonicalBoard |= ((board >> (16 * order[lane])) & LANE_BITS) << (16 * lane);
+        }
+        hero = canonicalHero;
+        board = canonicalBoard;
+    }
+    
+    // Canonical board packed to 52 bits, then each hole card's 6-bit index
+    uint64_t resultKey(CardMask hero, CardMask board) {
+        uint64_t key = 0;
+        for (int lane = 0; lane < 4; lane++) key |= ((board >> (16 * lane)) & LANE_BITS) << (13 * lane);
+        int low = __builtin_ctzll(hero);
+        int high = 63 - __builtin_clzll(hero);
+        key |= static_cast<uint64_t>((low / 16) * 13 + low % 16) << 52;
+        key |= static_cast<uint64_t>((high / 16) * 13 + high % 16) << 58;
+        return key;
+    }
+    
+    std::vector<Card> cardsOf(CardMask cards) {
+        std::vector<Card> result;
+        for (; cards; cards &= cards - 1) {
+            int bit = __builtin_ctzll(cards);
+            result.push_back(Card::fromIndex((bit / 16) * 13 + bit % 16));
+        }
+        return result;
+    }
+    
+    struct ResultCache {
+        std::vector<HandStrength> preflop;
+        std::vector<bool> preflopValid;
+        std::unordered_map<uint64_t, HandStrength> postflop[3];
+    };
+    
+    ResultCache& resultCache() {
+        thread_local ResultCache cache;
+        return cache;
+    }
+    
+    void checkCards(int holeCount, int boardCount) {
+        if (holeCount != 2 || boardCount == 1 || boardCount == 2 || boardCount > 5) {
+            throw std::invalid_argument("Hand strength needs two hole cards and a board of 0 or 3-5 cards");
+        }
+    }
+    
+    HandStrength againstField(HandStrength single, int opponents) {
+        if (opponents <= 1) return single;
+        double handStrength = std::pow(single.handStrength, opponents);
+        return fromStanding(handStrength, single.positivePotential, single.negativePotential,
+                            std::pow(single.strengthSquared, opponents));
+    }
+}
+
+bool HandStrengthEngine::supports(const VariantInfo& variant) {
+    return variant.gameStruct == GAMESTRUCTURE_BOARD && variant.numHoleCards == NUMHOLECARDS_TWO &&
+           variant.handResolution == BESTHANDRESOLUTION_ANYFIVE && variant.potResolution == POTRESOLUTION_HIONLY;
+}
+
+HandStrength HandStrengthEngine::evaluate(const std::vector<Card>& holeCards, const std::vector<Card>& board, int opponents) {
+    checkCards(static_cast<int>(holeCards.size()), static_cast<int>(board.size()));
+    return evaluate(FastEvaluator::handMask(holeCards), FastEvaluator::handMask(board), opponents);
+}
+
+HandStrength HandStrengthEngine::evaluate(CardMask holeCards, CardMask board, int opponents) {
+    int boardCount = FastEvaluator::countCards(board);
+    checkCards(FastEvaluator::countCards(holeCards), boardCount);
+    ResultCache& cache = resultCache();
+    
+    if (boardCount == 0) {
+        const HandIndexer& indexer = HandIndexer::holdem();
+        std::vector<Card> hole = cardsOf(holeCards);
+        int handClass = static_cast<int>(indexer.index(hole, 0));
+        if (cache.preflop.empty()) {
+            cache.preflop.resize(indexer.getSize(0));
+            cache.preflopValid.assign(indexer.getSize(0), false);
+        }
+        if (!cache.preflopValid[handClass]) {
+            cache.preflop[handClass] = preflopStrength(hole, handClass);
+            cache.preflopValid[handClass] = true;
+        }
+        return againstField(cache.preflop[handClass], opponents);
+    }
+    
+    canonicalize(holeCards, board);
+    std::unordered_map<uint64_t, HandStrength>& results = cache.postflop[boardCount - 3];
+    uint64_t key = resultKey(holeCards, board);
+    auto found = results.find(key);
+    if (found == results.end()) {
+        if (results.size() >= MAX_CACHED_RESULTS) results.clear();
+        found = results.emplace(key, postflopStrength(holeCards, board, boardCount, nullptr)).first;
+    }
+    return againstField(found->second, opponents);
+}
+
+HandStrength HandStrengthEngine::evaluateAgainstRange(const std::vector<Card>& holeCards, const std::vector<Card>& board,
+                                                      const std::vector<double>& comboWeights) {
+    checkCards(static_cast<int>(holeCards.size()), static_cast<int>(board.size()));
+    if (comboWeights.size() != NUM_COMBOS) {
+        throw std::invalid_argument("Range needs one weight per two-card combo");
+    }
+    if (board.empty()) {
+        // All-in equity against the range, from the preflop table when loaded
+        const PreflopEquity& table = PreflopEquity::shared();
+        if (!table.isLoaded()) return evaluate(holeCards, board);
+        int hero = PreflopEquity::comboIndex(holeCards[0], holeCards[1]);
+        double score = 0.0;
+        double total = 0.0;
+        for (int combo = 0; combo < NUM_COMBOS; combo++) {
+            float equity = table.comboVsCombo(hero, combo);
+            if (equity < 0.0f || comboWeights[combo] <= 0.0) continue;
+            score += comboWeights[combo] * equity;
+            total += comboWeights[combo];
+        }
+        double equity = total > 0.0 ? score / total : 0.0;
+        return fromStanding(equity, 0.0, 0.0, equity * equity);
+    }
+    return postflopStrength(FastEvaluator::handMask(holeCards), FastEvaluator::handMask(board),
+                            static_cast<int>(board.size()), comboWeights.data());
+}
+
+void HandStrengthEngine::clearCache() {
+    ResultCache& cache = resultCache();
+    cache.preflop.clear();
+    cache.preflopValid.clear();
+    for (auto& results : cache.postflop) results.clear();
+    for (BoardTables& tables : boardCache().entries) tables = BoardTables();
+}
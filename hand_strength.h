@@ -0,0 +1,44 @@
+#ifndef HAND_STRENGTH_H
+#define HAND_STRENGTH_H
+
+#include "card.h"
+#include "fast_evaluator.h"
+#include "variants.h"
+#include <vector>
+
+// Billings-style strength of a Hold'em hand against one opponent holding any
+// two unseen cards (or a weighted range). Potentials look one card ahead, so
+// on the river they are zero and effective strength equals hand strength.
+// Against a uniform range, HS counts every opponent combo; the potentials
+// sample one combo in 17 for each next card, which keeps a decision on a new
+// flop or turn to tens of microseconds.
+struct HandStrength {
+    double handStrength;      // HS: chance of being ahead now, ties count half
+    double positivePotential; // PPot: behind or tied now, ahead after the next card
+    double negativePotential; // NPot: ahead or tied now, behind after the next card
+    double effectiveStrength; // EHS = HS * (1 - NPot) + (1 - HS) * PPot
+    double strengthSquared;   // HS^2 averaged over the next card (rewards draws)
+};
+
+class HandStrengthEngine {
+public:
+    static const int NUM_COMBOS = 1326;
+    
+    // Two hole cards, five-card hands from any of hole + board, high only
+    static bool supports(const VariantInfo& variant);
+    
+    // Board of 0, 3, 4 or 5 cards. Against several opponents the chance of
+    // being ahead of all of them is taken as HS^opponents.
+    static HandStrength evaluate(const std::vector<Card>& holeCards, const std::vector<Card>& board, int opponents = 1);
+    // Same from card masks, for callers that already hold the board as one
+    static HandStrength evaluate(CardMask holeCards, CardMask board, int opponents = 1);
+    
+    // Opponent weights indexed by PreflopEquity::comboIndex; uncached
+    static HandStrength evaluateAgainstRange(const std::vector<Card>& holeCards, const std::vector<Card>& board,
+                                             const std::vector<double>& comboWeights);
+    
+    // Drop the calling thread's cached boards and results
+    static void clearCache();
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "hand_importer.h"
+#include "hand_archive.h"
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+
+// Imports a PokerStars-style text hand history, optionally into a binary archive.
+// Usage: hh_import <input> [archive] [threads]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: hh_import <input> [archive] [threads]" << std::endl;
+        return 1;
+    }
+    std::string input = argv[1];
+    std::string archivePath = argc > 2 ? argv[2] : "";
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    ThreadPool pool(threads);
+    HandHistoryImporter importer(pool);
+    ImportStats stats;
+    std::atomic<long long> actions(0);
+    bool imported;
+    if (archivePath.empty()) {
+        imported = importer.importFile(input, [&](int, const HandHistory& hand, int) {
+            actions.fetch_add(static_cast<long long>(hand.getActions().size()), std::memory_order_relaxed);
+        }, &stats);
+    } else {
+        HandArchive archive;
+        if (!archive.open(archivePath)) {
+            std::cerr << "Cannot open archive " << archivePath << std::endl;
+            return 1;
+        }
+        imported = importer.importFile(input, archive, &stats);
+        std::cout << "Archived " << archive.getRecordsWritten() << " records in " << archive.getBatches()
+                  << " batches" << std::endl;
+    }
+    if (!imported) {
+        std::cerr << "Cannot read " << input << std::endl;
+        return 1;
+    }
+
+    double megabytes = stats.bytes / (1024.0 * 1024.0);
+    std::cout << "Imported " << stats.hands << " hands (" << stats.skipped << " skipped), "
+              << importer.getPlayerCount() << " players";
+    if (archivePath.empty()) std::cout << ", " << actions.load() << " actions";
+    std::cout << std::endl;
+    std::cout << megabytes << " MB in " << stats.seconds << "s, "
+              << (stats.seconds > 0 ? megabytes / stats.seconds : 0.0) << " MB/s on "
+              << pool.getThreadCount() << " threads" << std::endl;
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "hand_replay.h"
+#include "profiler.h"
+#include "alloc_stats.h"
+#include <iostream>
+#include <cstdlib>
+
+// Replays every hand of an archive through the engine and reports any that come out differently.
+// Usage: hh_replay <archive> [variant: 1=Hold'em, 2=Stud, 3=Omaha Hi-Lo] [threads]
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: hh_replay <archive> [variant: 1=Hold'em, 2=Stud, 3=Omaha Hi-Lo] [threads]" << std::endl;
+        return 1;
+    }
+    int choice = argc > 2 ? std::atoi(argv[2]) : 1;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    VariantInfo variant = choice == 2 ? PokerVariants::SEVEN_CARD_STUD
+                        : choice == 3 ? PokerVariants::OMAHA_HI_LO : PokerVariants::TEXAS_HOLDEM;
+
+    ThreadPool pool(threads);
+    ReplayEngine engine(variant, pool);
+    ReplayReport report;
+    if (!engine.replayArchive(argv[1], report)) {
+        std::cerr << "Cannot read archive " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Replayed " << report.hands << " " << variant.variantName << " hands in " << report.seconds
+              << "s on " << pool.getThreadCount() << " threads ("
+              << (report.seconds > 0 ? report.hands * 60.0 / report.seconds : 0.0) << " hands/minute)" << std::endl;
+    for (int i = 0; i < ReplayReport::OUTCOMES; i++) {
+        std::cout << "  " << HandReplayer::outcomeName(static_cast<ReplayOutcome>(i)) << ": " << report.outcomes[i]
+                  << std::endl;
+    }
+    for (const std::string& detail : report.details) {
+        std::cout << "  " << detail << std::endl;
+    }
+#ifdef PROFILE
+    Profiler::report(std::cout);
+#endif
+#ifdef ALLOC_STATS
+    AllocStats::report(std::cout, report.hands);
+#endif
+    bool clean = report.count(ReplayOutcome::ACTIONS_DIFFER) == 0 &&
+                 report.count(ReplayOutcome::CHIPS_NOT_CONSERVED) == 0 &&
+                 report.count(ReplayOutcome::AWARDS_DIFFER) == 0 &&
+                 report.count(ReplayOutcome::AWARD_OVER_CAP) == 0;
+    return clean ? 0 : 2;
+}
@@ -0,0 +1,178 @@
+#include "icm.h"
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+namespace {
+    const int MONTE_CARLO_CHUNKS = 64;
+    
+    // Zero stacks are already out: they take no part in the race for places
+    std::vector<int> collectLive(const std::vector<int>& stacks) {
+        std::vector<int> live;
+        for (size_t i = 0; i < stacks.size(); i++) {
+            if (stacks[i] > 0) live.push_back(static_cast<int>(i));
+        }
+        return live;
+    }
+}
+
+std::vector<double> IcmCalculator::exactEquity(const std::vector<int>& stacks, const std::vector<double>& payouts) {
+    std::vector<double> equity(stacks.size(), 0.0);
+    std::vector<int> live = collectLive(stacks);
+    int n = static_cast<int>(live.size());
+    int paid = std::min(static_cast<int>(payouts.size()), n);
+    if (n == 0 || paid == 0 || n > MAX_EXACT_PLAYERS) {
+        return equity;
+    }
+    
+    double total = 0.0;
+    for (int index : live) total += stacks[index];
+    
+    // placedProbability[mask]: chance the players in mask took the top places (any order).
+    // Masks are visited in increasing order, so every mask is complete before it is expanded.
+    std::vector<double> placedProbability(size_t(1) << n, 0.0);
+    std::vector<double> placedChips(size_t(1) << n, 0.0);
+    placedProbability[0] = 1.0;
+    
+    for (size_t mask = 0; mask < placedProbability.size(); mask++) {
+        if (mask != 0) {
+            int low = __builtin_ctzll(mask);
+            placedChips[mask] = placedChips[mask & (mask - 1)] + stacks[live[low]];
+        }
+        
+        double probability = placedProbability[mask];
+        int place = __builtin_popcountll(mask);
+        if (probability == 0.0 || place >= paid) continue;
+        
+        double remaining = total - placedChips[mask];
+        if (remaining <= 0.0) continue;
+        
+        double prize = payouts[place];
+        for (int j = 0; j < n; j++) {
+            if (mask & (size_t(1) << j)) continue;
+            double next = probability * stacks[live[j]] / remaining;
+            equity[live[j]] += next * prize;
+            placedProbability[mask | (size_t(1) << j)] += next;
+        }
+    }
+    return equity;
+}
+
+std::vector<double> IcmCalculator::monteCarloEquity(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                                    int samples, ThreadPool* pool, unsigned seed) {
+    std::vector<double> equity(stacks.size(), 0.0);
+    std::vector<int> live = collectLive(stacks);
+    int n = static_cast<int>(live.size());
+    int paid = std::min(static_cast<int>(payouts.size()), n);
+    if (n == 0 || paid == 0 || samples <= 0) {
+        return equity;
+    }
+    
+    std::vector<std::vector<double>> chunkTotals(MONTE_CARLO_CHUNKS, std::vector<double>(n, 0.0));
+    auto runChunk = [&](int chunk, int /* worker */) {
+        std::mt19937_64 rng(seed * 1000003ull + chunk);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<double>& totals = chunkTotals[chunk];
+        std::vector<std::pair<double, int>> race(n);
+        
+        int chunkSamples = samples / MONTE_CARLO_CHUNKS + (chunk < samples % MONTE_CARLO_CHUNKS ? 1 : 0);
+        for (int s = 0; s < chunkSamples; s++) {
+            for (int j = 0; j < n; j++) {
+                // Exponential arrival with rate = stack; earliest arrival finishes first
+                race[j] = {-std::log1p(-uniform(rng)) / stacks[live[j]], j};
+            }
+            std::partial_sort(race.begin(), race.begin() + paid, race.end());
+            for (int place = 0; place < paid; place++) {
+                totals[race[place].second] += payouts[place];
+            }
+        }
+    };
+    
+    if (pool) {
+        pool->parallelFor(MONTE_CARLO_CHUNKS, runChunk);
+    } else {
+        for (int chunk = 0; chunk < MONTE_CARLO_CHUNKS; chunk++) runChunk(chunk, 0);
+    }
+    
+    for (const std::vector<double>& totals : chunkTotals) {
+        for (int j = 0; j < n; j++) {
+            equity[live[j]] += totals[j];
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        equity[live[j]] /= samples;
+    }
+    return equity;
+}
+
+std::vector<double> IcmCalculator::equity(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                          ThreadPool* pool) {
+    if (static_cast<int>(collectLive(stacks).size()) <= DEFAULT_EXACT_PLAYERS) {
+        return exactEquity(stacks, payouts);
+    }
+    return monteCarloEquity(stacks, payouts, DEFAULT_SAMPLES, pool);
+}
+
+void IcmCalculator::confrontation(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                  int player, int opponent, ThreadPool* pool, double& gain, double& loss) {
+    int stake = std::min(stacks[player], stacks[opponent]);
+    
+    std::vector<int> won = stacks;
+    won[player] += stake;
+    won[opponent] -= stake;
+    std::vector<int> lost = stacks;
+    lost[player] -= stake;
+    lost[opponent] += stake;
+    
+    double now = equity(stacks, payouts, pool)[player];
+    gain = equity(won, payouts, pool)[player] - now;
+    // Busting leaves only the prize for the place the player finishes in
+    if (lost[player] > 0) {
+        loss = now - equity(lost, payouts, pool)[player];
+    } else {
+        int place = static_cast<int>(collectLive(lost).size()); // Everyone still alive finishes above
+        loss = now - (place < static_cast<int>(payouts.size()) ? payouts[place] : 0.0);
+    }
+}
+
+double IcmCalculator::bubbleFactor(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                   int player, int opponent, ThreadPool* pool) {
+    double gain = 0.0;
+    double loss = 0.0;
+    confrontation(stacks, payouts, player, opponent, pool, gain, loss);
+    return gain > 0.0 ? loss / gain : 1.0;
+}
+
+double IcmCalculator::riskPremium(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                  int player, int opponent, ThreadPool* pool) {
+    double gain = 0.0;
+    double loss = 0.0;
+    confrontation(stacks, payouts, player, opponent, pool, gain, loss);
+    if (gain + loss <= 0.0) return 0.0;
+    // Break-even win probability for an even-money all-in, minus chip-EV's 50%
+    return loss / (gain + loss) - 0.5;
+}
+
+std::vector<double> IcmCalculator::equityChange(const std::vector<int>& stacksBefore, const std::vector<int>& stacksAfter,
+                                                const std::vector<double>& payouts, ThreadPool* pool) {
+    std::vector<double> before = equity(stacksBefore, payouts, pool);
+    std::vector<double> after = equity(stacksAfter, payouts, pool);
+    
+    // Busted players lock in the places just below the survivors
+    std::vector<int> busted;
+    for (size_t i = 0; i < stacksAfter.size(); i++) {
+        if (stacksAfter[i] <= 0 && stacksBefore[i] > 0) busted.push_back(static_cast<int>(i));
+    }
+    std::sort(busted.begin(), busted.end(), [&](int a, int b) { return stacksBefore[a] > stacksBefore[b]; });
+    int place = static_cast<int>(collectLive(stacksAfter).size());
+    for (int index : busted) {
+        after[index] = place < static_cast<int>(payouts.size()) ? payouts[place] : 0.0;
+        place++;
+    }
+    
+    std::vector<double> change(stacksBefore.size(), 0.0);
+    for (size_t i = 0; i < change.size(); i++) {
+        change[i] = after[i] - before[i];
+    }
+    return change;
+}
@@ -0,0 +1,52 @@
+#ifndef ICM_H
+#define ICM_H
+
+#include "thread_pool.h"
+#include <vector>
+
+// Independent Chip Model: turns tournament stacks into expected prize money.
+// Finishing order follows Malmuth-Harville - each remaining place goes to a
+// player with probability proportional to their stack among those still
+// unplaced. Stacks must be positive (busted players have no equity to share);
+// payouts[k] is the prize for place k + 1.
+class IcmCalculator {
+public:
+    static const int MAX_EXACT_PLAYERS = 20;   // 2^n probability table
+    static const int DEFAULT_EXACT_PLAYERS = 12; // equity() switches to sampling above this
+    static const int DEFAULT_SAMPLES = 200000;
+    
+    // Exact expected payout per player. Memoized over bitmasks of the players
+    // already placed, so each finishing prefix is expanded once: O(2^n * n).
+    static std::vector<double> exactEquity(const std::vector<int>& stacks, const std::vector<double>& payouts);
+    
+    // Monte Carlo estimate. Each sample draws a full finishing order with an
+    // exponential race (rate = stack), which has the Harville distribution.
+    // Samples are split into fixed chunks with their own seeds, so the result
+    // depends on the seed but not on the thread count. pool may be nullptr.
+    static std::vector<double> monteCarloEquity(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                                int samples, ThreadPool* pool = nullptr, unsigned seed = 1);
+    
+    // Exact up to DEFAULT_EXACT_PLAYERS, sampled beyond
+    static std::vector<double> equity(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                                      ThreadPool* pool = nullptr);
+    
+    // All-in confrontation between player and opponent for the smaller stack.
+    // The bubble factor is equity lost on a loss over equity gained on a win;
+    // the risk premium is the win probability needed beyond chip-EV's 50%.
+    static double bubbleFactor(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                               int player, int opponent, ThreadPool* pool = nullptr);
+    static double riskPremium(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                              int player, int opponent, ThreadPool* pool = nullptr);
+    
+    // Post-hand analytics: prize equity each player gained (+) or lost (-) as the
+    // stacks moved. A stack of 0 afterwards means the player busted this hand;
+    // busted players share the places below the survivors, best starting stack first.
+    static std::vector<double> equityChange(const std::vector<int>& stacksBefore, const std::vector<int>& stacksAfter,
+                                            const std::vector<double>& payouts, ThreadPool* pool = nullptr);
+
+private:
+    static void confrontation(const std::vector<int>& stacks, const std::vector<double>& payouts,
+                              int player, int opponent, ThreadPool* pool, double& gain, double& loss);
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "incremental_hand.h"
+#include "metrics.h"
+#include <algorithm>
+#include <stdexcept>
+
+IncrementalHand::IncrementalHand()
+    : twoPlusThree(false), hiLo(false) {
+    clear();
+}
+
+void IncrementalHand::setRules(bool useTwoPlusThree, bool useHiLo) {
+    if (twoPlusThree == useTwoPlusThree && hiLo == useHiLo) return;
+    twoPlusThree = useTwoPlusThree;
+    hiLo = useHiLo;
+    rebuild();
+}
+
+void IncrementalHand::clear() {
+    cards = 0;
+    holeCount = 0;
+    boardCount = 0;
+    std::fill(rankCounts, rankCounts + 13, 0);
+    std::fill(suitCounts, suitCounts + 4, 0);
+    rankMask = 0;
+    highValue = -1;
+    lowValue = FAST_LOW_UNQUALIFIED;
+}
+
+void IncrementalHand::clearBoard() {
+    boardCount = 0;
+    rebuild();
+}
+
+void IncrementalHand::rebuild() {
+    // Replay the kept cards through the normal update path
+    CardMask keptHole[MAX_HOLE_CARDS];
+    CardMask keptBoard[MAX_BOARD_CARDS];
+    int keptHoleCount = holeCount;
+    int keptBoardCount = boardCount;
+    std::copy(hole, hole + holeCount, keptHole);
+    std::copy(board, board + boardCount, keptBoard);
+    
+    clear();
+    auto toCard = [](CardMask mask) {
+        int bit = __builtin_ctzll(mask);
+        return Card(static_cast<Suit>(bit / 16), static_cast<Rank>(bit % 16 + 2));
+    };
+    for (int i = 0; i < keptHoleCount; i++) addHoleCard(toCard(keptHole[i]));
+    for (int i = 0; i < keptBoardCount; i++) addBoardCard(toCard(keptBoard[i]));
+}
+
+void IncrementalHand::countCard(const Card& card) {
+    int rank = static_cast<int>(card.getRank()) - 2;
+    rankCounts[rank]++;
+    suitCounts[static_cast<int>(card.getSuit())]++;
+    rankMask |= 1 << rank;
+}
+
+void IncrementalHand::addHoleCard(const Card& card) {
+    if (holeCount >= MAX_HOLE_CARDS) {
+        throw std::logic_error("Too many cards for one seat");
+    }
+    CardMask added = FastEvaluator::cardMask(card);
+    cards |= added;
+    countCard(card);
+    
+    if (!twoPlusThree) {
+        hole[holeCount++] = added;
+        updateAnyFive();
+        return;
+    }
+    
+    // New combinations: this card with each earlier hole card and any three board cards
+    for (int other = 0; other < holeCount; other++) {
+        CardMask two = added | hole[other];
+        for (int a = 0; a < boardCount; a++)
+            for (int b = a + 1; b < boardCount; b++)
+                for (int c = b + 1; c < boardCount; c++)
+                    scoreOmahaCombo(two | board[a] | board[b] | board[c]);
+    }
+    if (holeCount >= 1 && boardCount >= 3) {
+        countOmahaUpdate();
+    }
+    hole[holeCount++] = added;
+}
+
+CardMask IncrementalHand::getBoardCards() const {
+    CardMask boardCards = 0;
+    for (int i = 0; i < boardCount; i++) boardCards |= board[i];
+    return boardCards;
+}
+
+void IncrementalHand::addBoardCard(const Card& card) {
+    if (boardCount >= MAX_BOARD_CARDS) {
+        throw std::logic_error("Board already has five cards");
+    }
+    CardMask added = FastEvaluator::cardMask(card);
+    cards |= added;
+    countCard(card);
+    
+    if (!twoPlusThree) {
+        board[boardCount++] = added;
+        updateAnyFive();
+        return;
+    }
+    
+    // New combinations: any two hole cards with this card and two earlier board cards
+    for (int h1 = 0; h1 < holeCount; h1++)
+        for (int h2 = h1 + 1; h2 < holeCount; h2++) {
+            CardMask three = hole[h1] | hole[h2] | added;
+            for (int a = 0; a < boardCount; a++)
+                for (int b = a + 1; b < boardCount; b++)
+                    scoreOmahaCombo(three | board[a] | board[b]);
+        }
+    if (holeCount >= 2 && boardCount >= 2) {
+        countOmahaUpdate();
+    }
+    board[boardCount++] = added;
+}
+
+void IncrementalHand::scoreOmahaCombo(CardMask five) {
+    highValue = std::max(highValue, FastEvaluator::evaluateUncounted(five));
+    if (hiLo) {
+        lowValue = std::min(lowValue, FastEvaluator::evaluateLowA5Uncounted(five));
+    }
+}
+
+void IncrementalHand::countOmahaUpdate() const {
+    Metrics::countEvaluation(EvaluatorKind::OMAHA_HI);
+    if (hiLo) {
+        Metrics::countEvaluation(EvaluatorKind::LOW);
+    }
+}
+
+void IncrementalHand::updateAnyFive() {
+    highValue = FastEvaluator::evaluate(cards);
+    if (hiLo) {
+        lowValue = FastEvaluator::evaluateLowA5(cards);
+    }
+}
+
+HandRank IncrementalHand::getHandRank() const {
+    return highValue < 0 ? HandRank::HIGH_CARD : FastEvaluator::getHandRank(highValue);
+}
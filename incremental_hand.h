@@ -0,0 +1,59 @@
+#ifndef INCREMENTAL_HAND_H
+#define INCREMENTAL_HAND_H
+
+#include "card.h"
+#include "fast_evaluator.h"
+
+// One seat's evaluation state, updated card by card as the hand is dealt so
+// the best hand so far is always a lookup. Any-five games (Hold'em, Stud)
+// re-rank the card mask on each card; Omaha's two-plus-three rule only
+// evaluates the new hole/board combinations a card makes possible, since
+// adding cards never removes a combination.
+class IncrementalHand {
+public:
+    static const int MAX_HOLE_CARDS = 7; // Stud deals every card to the seat
+    static const int MAX_BOARD_CARDS = 5;
+    
+    IncrementalHand();
+    
+    void setRules(bool twoPlusThree, bool hiLo); // Re-evaluates any cards already held
+    void clear();      // New hand: drop every card, keep the rules
+    void clearBoard(); // Board replaced (e.g. another run): keep the hole cards
+    void addHoleCard(const Card& card);
+    void addBoardCard(const Card& card);
+    
+    // FastEvaluator values; partial any-five hands rank what they have so far.
+    // Omaha high is -1 until two hole and three board cards are out.
+    int getHighValue() const { return highValue; }
+    int getLowValue() const { return lowValue; } // FAST_LOW_UNQUALIFIED without an 8-or-better low
+    HandRank getHandRank() const;
+    
+    CardMask getCards() const { return cards; }
+    CardMask getBoardCards() const; // Community cards only
+    int getCardCount() const { return holeCount + boardCount; }
+    int getRankCount(Rank rank) const { return rankCounts[static_cast<int>(rank) - 2]; }
+    int getSuitCount(Suit suit) const { return suitCounts[static_cast<int>(suit)]; }
+    int getRankMask() const { return rankMask; } // Bit (rank - 2) set for every rank held
+    
+private:
+    bool twoPlusThree;
+    bool hiLo;
+    CardMask cards;
+    CardMask hole[MAX_HOLE_CARDS];
+    CardMask board[MAX_BOARD_CARDS];
+    int holeCount;
+    int boardCount;
+    int rankCounts[13];
+    int suitCounts[4];
+    int rankMask;
+    int highValue;
+    int lowValue;
+    
+    void countCard(const Card& card);
+    void rebuild();
+    void scoreOmahaCombo(CardMask five);
+    void countOmahaUpdate() const; // One Metrics count per card that added combinations
+    void updateAnyFive();
+};
+
+#endif
@@ -0,0 +1,397 @@
+#include "limit_cfr.h"
+#include "fast_evaluator.h"
+#include "hand_strength.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+const char* LimitStrategy::DEFAULT_PATH = "limit_holdem_strategy.bin";
+
+namespace {
+    const char MAGIC[8] = {'L', 'I', 'M', 'I', 'T', 'C', 'F', 'R'};
+    const uint32_t FILE_VERSION = 1;
+    const int NUM_COMBOS = 1326;
+    const int DECK_SIZE = 52;
+    const int ITERATIONS_PER_TASK = 256;
+    const int ACTIONS = LimitBettingTree::NUM_ACTIONS;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t buckets;
+        uint32_t decisions;
+        int32_t betSizes[4];
+        uint64_t iterations;
+    };
+
+    inline CardMask toCardMask(int cardIndex) {
+        return FastEvaluator::cardMask(Card::fromIndex(cardIndex));
+    }
+
+    // Card masks of the 1326 two-card combos, and each combo's preflop equity percentile
+    struct ComboTables {
+        CardMask mask[NUM_COMBOS];
+        float percentile[NUM_COMBOS];
+
+        ComboTables() {
+            std::vector<double> equity(NUM_COMBOS);
+            for (int first = 1; first < DECK_SIZE; first++) {
+                for (int second = 0; second < first; second++) {
+                    int combo = first * (first - 1) / 2 + second;
+                    mask[combo] = toCardMask(first) | toCardMask(second);
+                    equity[combo] = HandStrengthEngine::evaluate({Card::fromIndex(first), Card::fromIndex(second)}, {})
+                                        .effectiveStrength;
+                }
+            }
+            std::vector<double> sorted(equity);
+            std::sort(sorted.begin(), sorted.end());
+            for (int combo = 0; combo < NUM_COMBOS; combo++) {
+                auto range = std::equal_range(sorted.begin(), sorted.end(), equity[combo]);
+                double below = range.first - sorted.begin();
+                double equal = range.second - range.first;
+                percentile[combo] = static_cast<float>((below + 0.5 * equal) / NUM_COMBOS);
+            }
+        }
+    };
+
+    const ComboTables& comboTables() {
+        static const ComboTables tables;
+        return tables;
+    }
+
+    int comboOf(int first, int second) {
+        int high = std::max(first, second);
+        int low = std::min(first, second);
+        return high * (high - 1) / 2 + low;
+    }
+
+    // Chance each hand is ahead of one random unseen hand on this board, ties half
+    void strengthOnBoard(CardMask board, const CardMask* holes, int count, double* strength) {
+        const ComboTables& tables = comboTables();
+        int values[NUM_COMBOS];
+        for (int combo = 0; combo < NUM_COMBOS; combo++) {
+            values[combo] = (tables.mask[combo] & board) ? -1 : FastEvaluator::evaluate(tables.mask[combo] | board);
+        }
+        for (int i = 0; i < count; i++) {
+            int value = FastEvaluator::evaluate(holes[i] | board);
+            double ahead = 0.0;
+            int opponents = 0;
+            for (int combo = 0; combo < NUM_COMBOS; combo++) {
+                if (values[combo] < 0 || (tables.mask[combo] & holes[i])) continue;
+                ahead += value > values[combo] ? 1.0 : (value == values[combo] ? 0.5 : 0.0);
+                opponents++;
+            }
+            strength[i] = opponents > 0 ? ahead / opponents : 0.0;
+        }
+    }
+
+    inline int toBucket(double strength, int buckets) {
+        return std::max(0, std::min(buckets - 1, static_cast<int>(strength * buckets)));
+    }
+
+    inline void atomicAdd(std::atomic<float>& target, float delta, bool floorAtZero) {
+        float current = target.load(std::memory_order_relaxed);
+        float next;
+        do {
+            next = current + delta;
+            if (floorAtZero && next < 0.0f) next = 0.0f;
+        } while (!target.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    }
+}
+
+LimitBettingTree::LimitBettingTree(const std::vector<int>& sizes) : betSizes(sizes), decisions(0) {
+    if (betSizes.size() < 4) {
+        throw std::invalid_argument("Limit board games need smallBlind, bigBlind, smallBet and bigBet");
+    }
+    build(0, 0, 0, 0, betSizes[0], betSizes[1]);
+}
+
+int LimitBettingTree::addTerminal(int round, int folder, int committed0, int committed1) {
+    Node node;
+    node.round = round;
+    node.player = -1;
+    node.raises = 0;
+    node.decision = -1;
+    node.folder = folder;
+    node.committed[0] = committed0;
+    node.committed[1] = committed1;
+    std::fill(node.children, node.children + NUM_ACTIONS, -1);
+    nodes.push_back(node);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+int LimitBettingTree::build(int round, int player, int raises, int actions, int committed0, int committed1) {
+    int index = addTerminal(round, -1, committed0, committed1);
+    Node node = nodes[index];
+    node.player = player;
+    node.raises = raises;
+    node.decision = decisions++;
+    decisionNodes.push_back(index);
+
+    int committed[2] = {committed0, committed1};
+    int other = 1 - player;
+    if (committed[player] < committed[other]) {
+        node.children[FOLD] = addTerminal(round, player, committed0, committed1);
+    }
+
+    // Calling (or checking) closes the street unless it is the street's first action
+    int called[2] = {committed0, committed1};
+    called[player] = committed[other];
+    if (actions == 0) {
+        node.children[CALL] = build(round, other, raises, 1, called[0], called[1]);
+    } else if (round + 1 < ROUNDS) {
+        node.children[CALL] = build(round + 1, 0, 0, 0, called[0], called[1]);
+    } else {
+        node.children[CALL] = addTerminal(round, -1, called[0], called[1]);
+    }
+
+    if (raises < MAX_RAISES) {
+        int raised[2] = {committed0, committed1};
+        raised[player] = committed[other] + (round < 2 ? betSizes[2] : betSizes[3]);
+        node.children[RAISE] = build(round, other, raises + 1, actions + 1, raised[0], raised[1]);
+    }
+
+    nodes[index] = node;
+    return index;
+}
+
+bool LimitStrategy::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FILE_VERSION || header.buckets == 0) {
+        return false;
+    }
+
+    std::unique_ptr<LimitBettingTree> loaded(new LimitBettingTree(
+        std::vector<int>(header.betSizes, header.betSizes + 4)));
+    if (loaded->getDecisionCount() != static_cast<int>(header.decisions)) return false;
+
+    std::vector<uint8_t> data(static_cast<size_t>(header.decisions) * header.buckets * ACTIONS);
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size())) return false;
+
+    tree = std::move(loaded);
+    buckets = static_cast<int>(header.buckets);
+    weights.swap(data);
+    return true;
+}
+
+bool LimitStrategy::matches(const VariantInfo& variant) const {
+    if (!tree || variant.gameStruct != GAMESTRUCTURE_BOARD || variant.numHoleCards != NUMHOLECARDS_TWO ||
+        variant.bettingStruct != BETTINGSTRUCTURE_LIMIT || variant.handResolution != BESTHANDRESOLUTION_ANYFIVE ||
+        variant.potResolution != POTRESOLUTION_HIONLY || variant.betSizes.size() < 4) {
+        return false;
+    }
+    return std::equal(variant.betSizes.begin(), variant.betSizes.begin() + 4, tree->getBetSizes().begin());
+}
+
+int LimitStrategy::bucket(const std::vector<Card>& holeCards, const std::vector<Card>& board, int buckets) {
+    if (holeCards.size() != 2) {
+        throw std::invalid_argument("Limit strategies need two hole cards");
+    }
+    if (board.empty()) {
+        int combo = comboOf(holeCards[0].getIndex(), holeCards[1].getIndex());
+        return toBucket(comboTables().percentile[combo], buckets);
+    }
+    CardMask hole = FastEvaluator::handMask(holeCards);
+    double strength;
+    strengthOnBoard(FastEvaluator::handMask(board), &hole, 1, &strength);
+    return toBucket(strength, buckets);
+}
+
+// Both hands, the board and every street's bucket for one sampled deal
+struct LimitCfrSolver::Deal {
+    CardMask holes[2];
+    int buckets[2][LimitBettingTree::ROUNDS];
+    int values[2]; // Showdown hand values
+};
+
+LimitCfrSolver::LimitCfrSolver(const VariantInfo& variant, int bucketCount, unsigned solverSeed)
+    : tree(variant.betSizes), buckets(bucketCount), seed(solverSeed), iterations(0) {
+    if (variant.gameStruct != GAMESTRUCTURE_BOARD || variant.numHoleCards != NUMHOLECARDS_TWO ||
+        variant.bettingStruct != BETTINGSTRUCTURE_LIMIT || variant.handResolution != BESTHANDRESOLUTION_ANYFIVE ||
+        variant.potResolution != POTRESOLUTION_HIONLY) {
+        throw std::invalid_argument("Limit CFR needs a limit, high-only board game with two hole cards");
+    }
+    if (buckets < 1) {
+        throw std::invalid_argument("Need at least one bucket");
+    }
+    size_t size = static_cast<size_t>(tree.getDecisionCount()) * buckets * ACTIONS;
+    regrets.reset(new std::atomic<float>[size]);
+    strategySums.reset(new std::atomic<float>[size]);
+    for (size_t i = 0; i < size; i++) {
+        regrets[i].store(0.0f, std::memory_order_relaxed);
+        strategySums[i].store(0.0f, std::memory_order_relaxed);
+    }
+    comboTables(); // Build the preflop percentiles before any worker needs them
+}
+
+void LimitCfrSolver::currentStrategy(const LimitBettingTree::Node& node, size_t infoSet, double* strategy) const {
+    // Regret matching over the legal actions; uniform while nothing is positive
+    double total = 0.0;
+    int legal = 0;
+    for (int a = 0; a < ACTIONS; a++) {
+        strategy[a] = 0.0;
+        if (node.children[a] < 0) continue;
+        strategy[a] = regrets[infoSet * ACTIONS + a].load(std::memory_order_relaxed);
+        total += strategy[a];
+        legal++;
+    }
+    for (int a = 0; a < ACTIONS; a++) {
+        if (node.children[a] < 0) continue;
+        strategy[a] = total > 0.0 ? strategy[a] / total : 1.0 / legal;
+    }
+}
+
+double LimitCfrSolver::traverse(int nodeIndex, int traverser, const Deal& deal, float weight, std::mt19937& rng) {
+    const LimitBettingTree::Node& node = tree.getNode(nodeIndex);
+    int opponent = 1 - traverser;
+    if (node.player < 0) {
+        if (node.folder >= 0) {
+            return node.folder == traverser ? -node.committed[traverser] : node.committed[opponent];
+        }
+        if (deal.values[traverser] == deal.values[opponent]) return 0.0;
+        return deal.values[traverser] > deal.values[opponent] ? node.committed[opponent] : -node.committed[traverser];
+    }
+
+    size_t infoSet = static_cast<size_t>(node.decision) * buckets + deal.buckets[node.player][node.round];
+    double strategy[ACTIONS];
+    currentStrategy(node, infoSet, strategy);
+
+    if (node.player == traverser) {
+        double utility[ACTIONS] = {0.0, 0.0, 0.0};
+        double nodeUtility = 0.0;
+        for (int a = 0; a < ACTIONS; a++) {
+            if (node.children[a] < 0) continue;
+            utility[a] = traverse(node.children[a], traverser, deal, weight, rng);
+            nodeUtility += strategy[a] * utility[a];
+        }
+        // CFR+: cumulative regrets never drop below zero
+        for (int a = 0; a < ACTIONS; a++) {
+            if (node.children[a] < 0) continue;
+            atomicAdd(regrets[infoSet * ACTIONS + a], static_cast<float>(utility[a] - nodeUtility), true);
+        }
+        return nodeUtility;
+    }
+
+    // Opponent: add to the average strategy (weighted by iteration) and sample one action
+    for (int a = 0; a < ACTIONS; a++) {
+        if (node.children[a] < 0) continue;
+        atomicAdd(strategySums[infoSet * ACTIONS + a], static_cast<float>(weight * strategy[a]), false);
+    }
+    double pick = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    int chosen = -1;
+    for (int a = 0; a < ACTIONS; a++) {
+        if (node.children[a] < 0) continue;
+        chosen = a;
+        pick -= strategy[a];
+        if (pick < 0.0) break;
+    }
+    return traverse(node.children[chosen], traverser, deal, weight, rng);
+}
+
+void LimitCfrSolver::train(long long count, ThreadPool* pool) {
+    long long first = iterations;
+    int tasks = static_cast<int>((count + ITERATIONS_PER_TASK - 1) / ITERATIONS_PER_TASK);
+
+    auto runTask = [&](int task, int /* worker */) {
+        std::mt19937 rng(seed * 2654435761u + static_cast<unsigned>((first / ITERATIONS_PER_TASK) + task));
+        long long begin = first + static_cast<long long>(task) * ITERATIONS_PER_TASK;
+        long long end = std::min(first + count, begin + ITERATIONS_PER_TASK);
+        for (long long iteration = begin; iteration < end; iteration++) {
+            // Nine distinct cards: two hands and the board
+            int cards[9];
+            uint64_t used = 0;
+            for (int dealt = 0; dealt < 9;) {
+                int card = static_cast<int>(rng() % DECK_SIZE);
+                if (used & (uint64_t(1) << card)) continue;
+                used |= uint64_t(1) << card;
+                cards[dealt++] = card;
+            }
+
+            Deal deal;
+            CardMask board = 0;
+            for (int player = 0; player < 2; player++) {
+                deal.holes[player] = toCardMask(cards[player * 2]) | toCardMask(cards[player * 2 + 1]);
+                int combo = comboOf(cards[player * 2], cards[player * 2 + 1]);
+                deal.buckets[player][0] = toBucket(comboTables().percentile[combo], buckets);
+            }
+            static const int BOARD_CARDS[LimitBettingTree::ROUNDS] = {0, 3, 4, 5};
+            for (int round = 1; round < LimitBettingTree::ROUNDS; round++) {
+                for (int i = BOARD_CARDS[round - 1]; i < BOARD_CARDS[round]; i++) board |= toCardMask(cards[4 + i]);
+                double strength[2];
+                strengthOnBoard(board, deal.holes, 2, strength);
+                for (int player = 0; player < 2; player++) {
+                    deal.buckets[player][round] = toBucket(strength[player], buckets);
+                }
+            }
+            for (int player = 0; player < 2; player++) {
+                deal.values[player] = FastEvaluator::evaluate(deal.holes[player] | board);
+            }
+
+            // Linear averaging: later iterations count for more
+            float weight = static_cast<float>(iteration + 1);
+            for (int traverser = 0; traverser < 2; traverser++) {
+                traverse(0, traverser, deal, weight, rng);
+            }
+        }
+    };
+
+    if (pool) {
+        pool->parallelFor(tasks, runTask);
+    } else {
+        for (int task = 0; task < tasks; task++) runTask(task, 0);
+    }
+    iterations += count;
+}
+
+void LimitCfrSolver::averageStrategy(int decision, int bucket, double* probabilities) const {
+    const LimitBettingTree::Node& node = tree.getNode(tree.getDecisionNode(decision));
+    size_t infoSet = static_cast<size_t>(decision) * buckets + bucket;
+    double total = 0.0;
+    int legal = 0;
+    for (int a = 0; a < ACTIONS; a++) {
+        probabilities[a] = 0.0;
+        if (node.children[a] < 0) continue;
+        probabilities[a] = strategySums[infoSet * ACTIONS + a].load(std::memory_order_relaxed);
+        total += probabilities[a];
+        legal++;
+    }
+    for (int a = 0; a < ACTIONS; a++) {
+        if (node.children[a] < 0) continue;
+        probabilities[a] = total > 0.0 ? probabilities[a] / total : 1.0 / legal;
+    }
+}
+
+bool LimitCfrSolver::save(const std::string& path) const {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.buckets = static_cast<uint32_t>(buckets);
+    header.decisions = static_cast<uint32_t>(tree.getDecisionCount());
+    for (int i = 0; i < 4; i++) header.betSizes[i] = tree.getBetSizes()[i];
+    header.iterations = static_cast<uint64_t>(iterations);
+
+    // Quantize each information set to one byte per action
+    std::vector<uint8_t> data(static_cast<size_t>(tree.getDecisionCount()) * buckets * ACTIONS, 0);
+    for (int i = 0; i < tree.getNodeCount(); i++) {
+        const LimitBettingTree::Node& node = tree.getNode(i);
+        if (node.decision < 0) continue;
+        for (int bucket = 0; bucket < buckets; bucket++) {
+            double probabilities[ACTIONS];
+            averageStrategy(node.decision, bucket, probabilities);
+            size_t base = (static_cast<size_t>(node.decision) * buckets + bucket) * ACTIONS;
+            for (int a = 0; a < ACTIONS; a++) {
+                data[base + a] = static_cast<uint8_t>(probabilities[a] * 255.0 + 0.5);
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
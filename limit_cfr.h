@@ -0,0 +1,118 @@
+#ifndef LIMIT_CFR_H
+#define LIMIT_CFR_H
+
+#include "card.h"
+#include "variants.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <random>
+#include <cstdint>
+
+// Heads-up limit betting for board games, laid out the way PokerGame plays it:
+// the small blind (player 0) acts first on every street, the blind is not a
+// raise, and each street allows four raises. Bets are betSizes[2] preflop and
+// on the flop, betSizes[3] on the turn and river.
+class LimitBettingTree {
+public:
+    enum Action { FOLD = 0, CALL = 1, RAISE = 2 }; // CALL doubles as check
+    static const int NUM_ACTIONS = 3;
+    static const int ROUNDS = 4;
+    static const int MAX_RAISES = 4; // MAXLIMITBETS_4
+
+    struct Node {
+        int round;       // 0 preflop .. 3 river
+        int player;      // To act, -1 at terminals
+        int raises;      // Raises so far this street
+        int decision;    // Dense id among decision nodes, -1 at terminals
+        int folder;      // Terminal: who folded, -1 for a showdown
+        int committed[2];
+        int children[NUM_ACTIONS]; // -1 where the action is not allowed
+    };
+
+    // betSizes as in VariantInfo for limit board games: smallBlind, bigBlind, smallBet, bigBet
+    explicit LimitBettingTree(const std::vector<int>& betSizes);
+
+    const Node& getNode(int index) const { return nodes[index]; }
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    int getDecisionCount() const { return decisions; }
+    int getDecisionNode(int decision) const { return decisionNodes[decision]; }
+    const std::vector<int>& getBetSizes() const { return betSizes; }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<int> betSizes;
+    std::vector<int> decisionNodes;
+    int decisions;
+
+    int build(int round, int player, int raises, int actions, int committed0, int committed1);
+    int addTerminal(int round, int folder, int committed0, int committed1);
+};
+
+// Average strategy exported by LimitCfrSolver: one byte per action for every
+// (decision node, bucket) pair, so a lookup is a single array read.
+class LimitStrategy {
+public:
+    static const char* DEFAULT_PATH;
+
+    bool load(const std::string& path); // False if missing or not a strategy file
+
+    bool matches(const VariantInfo& variant) const; // Same bet sizes and rules the file was solved for
+    const LimitBettingTree& getTree() const { return *tree; }
+    int getBuckets() const { return buckets; }
+
+    // Relative action weights (0-255) for FOLD, CALL and RAISE
+    const uint8_t* actionWeights(int decision, int bucket) const {
+        return &weights[(static_cast<size_t>(decision) * buckets + bucket) * LimitBettingTree::NUM_ACTIONS];
+    }
+
+    // Card abstraction shared with the solver: preflop by equity percentile
+    // among the 1326 combos, afterwards by hand strength against a random hand
+    static int bucket(const std::vector<Card>& holeCards, const std::vector<Card>& board, int buckets);
+
+private:
+    std::unique_ptr<LimitBettingTree> tree;
+    int buckets = 0;
+    std::vector<uint8_t> weights;
+};
+
+// Monte Carlo CFR+ (external sampling) over the heads-up limit tree with
+// hand-strength buckets. Regrets and strategy sums are flat arrays indexed
+// by information set (decision node * buckets + bucket); worker threads run
+// iterations concurrently and update them with relaxed atomics, no locks.
+// Information sets see only the current street's bucket (imperfect recall).
+class LimitCfrSolver {
+public:
+    static const int DEFAULT_BUCKETS = 8;
+
+    // Throws std::invalid_argument unless the variant is limit, two hole cards,
+    // high only, on a board
+    LimitCfrSolver(const VariantInfo& variant, int buckets = DEFAULT_BUCKETS, unsigned seed = 1);
+
+    // Runs more iterations (each traverses once for both players); pool may be nullptr
+    void train(long long iterations, ThreadPool* pool = nullptr);
+    long long getIterations() const { return iterations; }
+
+    const LimitBettingTree& getTree() const { return tree; }
+    int getBuckets() const { return buckets; }
+    void averageStrategy(int decision, int bucket, double* probabilities) const;
+
+    bool save(const std::string& path) const;
+
+private:
+    struct Deal;
+
+    LimitBettingTree tree;
+    int buckets;
+    unsigned seed;
+    long long iterations;
+    std::unique_ptr<std::atomic<float>[]> regrets;
+    std::unique_ptr<std::atomic<float>[]> strategySums;
+
+    double traverse(int nodeIndex, int traverser, const Deal& deal, float weight, std::mt19937& rng);
+    void currentStrategy(const LimitBettingTree::Node& node, size_t infoSet, double* strategy) const;
+};
+
+#endif
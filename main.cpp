@@ -1,9 +1,16 @@
 #include "poker_game.h"
 #include "table.h"
+#include "preflop_equity.h"
+#include "push_fold.h"
 #include <iostream>
 #include <memory>
 
 int main() {
+    // Optional: without the table, players fall back to the rank heuristics
+    PreflopEquity::shared().load(PreflopEquity::DEFAULT_PATH);
+    // Likewise the short-stack charts written by pushfold_gen
+    PushFoldCharts::shared().load(PushFoldCharts::DEFAULT_PATH);
+    
     std::cout << "=== POKER VARIANTS ===" << std::endl;
     std::cout << "Select a poker variant:" << std::endl;
     std::cout << "1. Texas Hold'em (NL)" << std::endl;
@@ -53,6 +60,11 @@ int main() {
             break;
     }
     
+    // Report exact pot equity whenever an all-in closes the action
+    game->setAllInEquityEnabled(true);
+    // Deal an all-in pot twice when there are cards to come
+    game->setRunItTimes(2);
+    
     // Track starting chip amounts for accurate gain/loss calculation
     std::vector<int> startingChips = {1000, 1000, 1000, 1000, 1000, 1000};
     
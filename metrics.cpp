@@ -0,0 +1,251 @@
+#include "metrics.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Metrics::ThreadCounters>> threads; // Kept after their thread exits
+        std::vector<std::string> variantNames{"(no game)"};
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    const char* actionName(int actionType) {
+        static const char* names[Metrics::ACTION_TYPES] = {"fold", "check", "call", "raise", "all_in",
+                                                           "post_blind", "deal_cards", "reveal_board"};
+        return names[actionType];
+    }
+
+    std::string labelValue(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            if (c == '\n') {
+                result += "\\n";
+                continue;
+            }
+            result += c;
+        }
+        return result;
+    }
+
+    void writeHeader(std::ostream& out, const char* name, const char* help) {
+        out << "# HELP " << name << " " << help << "\n# TYPE " << name << " counter\n";
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    const int POLL_SLICE_MS = 100;    // Bounds how long stop() waits on the exporter
+    const int REQUEST_WAIT_MS = 50;   // Clients that send nothing get the bare text after this
+}
+
+namespace Metrics {
+    thread_local ThreadCounters* localCounters = nullptr;
+
+    ThreadCounters& registerThread() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.threads.emplace_back(new ThreadCounters());
+        localCounters = shared.threads.back().get();
+        return *localCounters;
+    }
+
+    int variantSlot(const std::string& variantName) {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (size_t i = 1; i < shared.variantNames.size(); i++) {
+            if (shared.variantNames[i] == variantName) return static_cast<int>(i);
+        }
+        if (shared.variantNames.size() >= static_cast<size_t>(MAX_VARIANTS)) return 0;
+        shared.variantNames.push_back(variantName);
+        return static_cast<int>(shared.variantNames.size() - 1);
+    }
+
+    Snapshot snapshot() {
+        Snapshot merged;
+        std::memset(&merged, 0, sizeof(merged));
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (const auto& thread : shared.threads) {
+            for (int v = 0; v < MAX_VARIANTS; v++) merged.hands[v] += thread->hands[v].load(std::memory_order_relaxed);
+            for (int a = 0; a < ACTION_TYPES; a++) merged.actions[a] += thread->actions[a].load(std::memory_order_relaxed);
+            merged.showdowns += thread->showdowns.load(std::memory_order_relaxed);
+            merged.sidePots += thread->sidePots.load(std::memory_order_relaxed);
+            for (int k = 0; k < EVALUATOR_KINDS; k++) {
+                merged.evaluations[k] += thread->evaluations[k].load(std::memory_order_relaxed);
+            }
+        }
+        return merged;
+    }
+
+    void writePrometheus(std::ostream& out) {
+        Snapshot totals = snapshot();
+        std::vector<std::string> variants;
+        {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            variants = shared.variantNames;
+        }
+
+        writeHeader(out, "poker_hands_completed_total", "Hands played to completion.");
+        for (size_t v = 0; v < variants.size(); v++) {
+            out << "poker_hands_completed_total{variant=\"" << labelValue(variants[v]) << "\"} "
+                << totals.hands[v] << "\n";
+        }
+        writeHeader(out, "poker_actions_total", "Hand history actions recorded, by action type.");
+        for (int a = 0; a < ACTION_TYPES; a++) {
+            out << "poker_actions_total{type=\"" << actionName(a) << "\"} " << totals.actions[a] << "\n";
+        }
+        writeHeader(out, "poker_showdowns_total", "Hands that reached a showdown.");
+        out << "poker_showdowns_total " << totals.showdowns << "\n";
+        writeHeader(out, "poker_side_pots_created_total", "Pots created beyond the main pot.");
+        out << "poker_side_pots_created_total " << totals.sidePots << "\n";
+        writeHeader(out, "poker_evaluations_total", "Hand evaluator invocations, by kind.");
+        for (int k = 0; k < EVALUATOR_KINDS; k++) {
+            out << "poker_evaluations_total{kind=\"" << evaluatorName(static_cast<EvaluatorKind>(k)) << "\"} "
+                << totals.evaluations[k] << "\n";
+        }
+    }
+
+    const char* evaluatorName(EvaluatorKind kind) {
+        switch (kind) {
+            case EvaluatorKind::FIVE_CARD: return "five_card";
+            case EvaluatorKind::SEVEN_CARD: return "seven_card";
+            case EvaluatorKind::OMAHA_HI: return "omaha_hi";
+            case EvaluatorKind::LOW: return "low";
+        }
+        return "?";
+    }
+}
+
+MetricsExporter::MetricsExporter()
+    : interval(DEFAULT_INTERVAL_MS), listenFd(-1), running(false), stopping(false) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(const std::string& file, const std::string& socket, int intervalMs) {
+    if (running) return false;
+    filePath = file;
+    socketPath = socket;
+    interval = intervalMs > 0 ? intervalMs : DEFAULT_INTERVAL_MS;
+
+    if (!socketPath.empty()) {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) return false;
+        std::strcpy(address.sun_path, socketPath.c_str());
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) return false;
+        ::unlink(socketPath.c_str()); // A stale socket from an earlier run
+        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listenFd, 16) != 0) {
+            ::close(listenFd);
+            listenFd = -1;
+            return false;
+        }
+    }
+
+    stopping.store(false);
+    running = true;
+    worker = std::thread(&MetricsExporter::run, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running) return;
+    stopping.store(true);
+    worker.join();
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+        listenFd = -1;
+    }
+    writeFile();
+    running = false;
+}
+
+void MetricsExporter::run() {
+    auto nextWrite = std::chrono::steady_clock::now();
+    while (!stopping.load()) {
+        auto now = std::chrono::steady_clock::now();
+        if (!filePath.empty() && now >= nextWrite) {
+            writeFile();
+            nextWrite = now + std::chrono::milliseconds(interval);
+        }
+
+        int wait = POLL_SLICE_MS;
+        if (!filePath.empty()) {
+            auto untilWrite = std::chrono::duration_cast<std::chrono::milliseconds>(nextWrite - now).count();
+            if (untilWrite < wait) wait = untilWrite > 0 ? static_cast<int>(untilWrite) : 0;
+        }
+        if (listenFd < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+            continue;
+        }
+
+        pollfd listener = {listenFd, POLLIN, 0};
+        if (::poll(&listener, 1, wait) > 0 && (listener.revents & POLLIN)) {
+            int client = ::accept(listenFd, nullptr, nullptr);
+            if (client >= 0) {
+                serve(client);
+                ::close(client);
+            }
+        }
+    }
+}
+
+bool MetricsExporter::writeFile() const {
+    if (filePath.empty()) return true;
+    std::string staging = filePath + ".tmp";
+    {
+        std::ofstream out(staging);
+        if (!out) return false;
+        Metrics::writePrometheus(out);
+        if (!out) return false;
+    }
+    return std::rename(staging.c_str(), filePath.c_str()) == 0;
+}
+
+void MetricsExporter::serve(int client) const {
+    char request[1024];
+    ssize_t received = 0;
+    pollfd readable = {client, POLLIN, 0};
+    if (::poll(&readable, 1, REQUEST_WAIT_MS) > 0) {
+        received = ::recv(client, request, sizeof(request), 0);
+    }
+
+    std::ostringstream body;
+    Metrics::writePrometheus(body);
+    std::string text = body.str();
+    if (received >= 3 && std::memcmp(request, "GET", 3) == 0) {
+        sendAll(client, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                        std::to_string(text.size()) + "\r\nConnection: close\r\n\r\n");
+    }
+    sendAll(client, text);
+}
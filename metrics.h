@@ -0,0 +1,107 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+// Always-on engine counters. Each thread owns a block of counters that only
+// it writes, so an increment is a relaxed load and store with no lock and no
+// shared cache line; snapshot() sums every block, including those of
+// threads that have exited.
+//
+// Evaluator counts are per public entry point of HandEvaluator,
+// FastEvaluator and the Omaha helpers. The combinations an Omaha evaluation
+// scores internally are not counted again.
+enum class EvaluatorKind {
+    FIVE_CARD,  // High hand from exactly five cards
+    SEVEN_CARD, // High hand, best five of six or seven
+    OMAHA_HI,   // Two hole plus three board
+    LOW         // A-5 low, any shape
+};
+
+namespace Metrics {
+    const int MAX_VARIANTS = 16; // Slot 0 collects hands with no registered variant
+    const int ACTION_TYPES = 8;  // ActionType values
+    const int EVALUATOR_KINDS = 4;
+
+    struct ThreadCounters {
+        std::atomic<uint64_t> hands[MAX_VARIANTS];
+        std::atomic<uint64_t> actions[ACTION_TYPES];
+        std::atomic<uint64_t> showdowns;
+        std::atomic<uint64_t> sidePots;
+        std::atomic<uint64_t> evaluations[EVALUATOR_KINDS];
+    };
+
+    extern thread_local ThreadCounters* localCounters;
+    ThreadCounters& registerThread();
+
+    inline ThreadCounters& counters() {
+        return localCounters ? *localCounters : registerThread();
+    }
+    // Single writer per block: no read-modify-write needed
+    inline void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Registers a variant by name and returns its slot (same name, same slot)
+    int variantSlot(const std::string& variantName);
+
+    inline void countHand(int variant) { bump(counters().hands[variant]); }
+    inline void countAction(int actionType) { bump(counters().actions[actionType]); }
+    inline void countShowdown() { bump(counters().showdowns); }
+    inline void countSidePot() { bump(counters().sidePots); }
+    inline void countEvaluation(EvaluatorKind kind) { bump(counters().evaluations[static_cast<int>(kind)]); }
+
+    struct Snapshot {
+        uint64_t hands[MAX_VARIANTS];
+        uint64_t actions[ACTION_TYPES];
+        uint64_t showdowns;
+        uint64_t sidePots;
+        uint64_t evaluations[EVALUATOR_KINDS];
+    };
+    Snapshot snapshot();
+
+    // Prometheus text exposition format (version 0.0.4)
+    void writePrometheus(std::ostream& out);
+    const char* evaluatorName(EvaluatorKind kind);
+}
+
+// Publishes the metrics from a background thread: rewrites a file every
+// interval (written aside, then renamed into place, so readers never see a
+// partial snapshot) and/or answers each connection to a Unix socket with a
+// fresh snapshot. A request starting with GET gets an HTTP response, so
+// `curl --unix-socket` and Prometheus scrapes work; anything else gets the
+// bare text.
+class MetricsExporter {
+public:
+    static const int DEFAULT_INTERVAL_MS = 1000;
+
+    MetricsExporter();
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Either path may be empty. False if the socket cannot be bound.
+    bool start(const std::string& file, const std::string& socket, int intervalMs = DEFAULT_INTERVAL_MS);
+    void stop(); // Writes the file one last time
+
+    bool isRunning() const { return running; }
+
+private:
+    std::string filePath;
+    std::string socketPath;
+    int interval;
+    int listenFd;
+    bool running;
+    std::atomic<bool> stopping;
+    std::thread worker;
+
+    void run();
+    bool writeFile() const;
+    void serve(int client) const;
+};
+
+#endif
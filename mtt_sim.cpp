@@ -0,0 +1,156 @@
+#include "tournament.h"
+#include "preflop_equity.h"
+#include "push_fold.h"
+#include "profiler.h"
+#include "alloc_stats.h"
+#include "trace_writer.h"
+#include "metrics.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <iomanip>
+
+#ifdef PROFILE
+const double DECISION_P99_BUDGET_US = 150.0;
+#endif
+
+// Simulates a multi-table tournament between AI players; tables run in parallel across threads.
+// The default 10,000-entrant Hold'em event plays about 49k hands in about 38 s with one thread
+// on one core (pushfold_charts.bin loaded, no preflop_equity.bin).
+// Usage: mtt_sim [entrants] [variant: 1=Hold'em, 2=Stud, 3=Omaha Hi-Lo] [threads] [hand archive]
+//        [trace.json: Chrome/Perfetto timeline of hands, betting rounds, decisions and archive writes]
+//        [metrics: Prometheus text rewritten every second to this file, or served on unix:<socket path>]
+int main(int argc, char* argv[]) {
+    PreflopEquity::shared().load(PreflopEquity::DEFAULT_PATH);
+    PushFoldCharts::shared().load(PushFoldCharts::DEFAULT_PATH); // From pushfold_gen; charts off when missing
+    
+    TournamentConfig config;
+    config.entrants = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int choice = argc > 2 ? std::atoi(argv[2]) : 1;
+    config.threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    config.archivePath = argc > 4 ? argv[4] : "";
+    std::string tracePath = argc > 5 ? argv[5] : "";
+    std::string metricsTarget = argc > 6 ? argv[6] : "";
+    config.startingChips = 1500;
+    config.handsPerLevel = 10;
+    config.seed = 12345;
+    config.payouts = Tournament::defaultPayouts(config.entrants, config.entrants * 100.0);
+    
+    switch (choice) {
+        case 2:
+            config.variant = PokerVariants::SEVEN_CARD_STUD;
+            config.seatsPerTable = 7; // Seven cards each must come from one deck
+            break;
+        case 3:
+            config.variant = PokerVariants::OMAHA_HI_LO;
+            config.seatsPerTable = 9;
+            break;
+        default:
+            config.variant = PokerVariants::TEXAS_HOLDEM;
+            config.seatsPerTable = 9;
+            break;
+    }
+    
+    std::cout << "=== " << config.variant.variantName << " TOURNAMENT: " << config.entrants << " ENTRANTS ===" << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    if (!tracePath.empty()) {
+        Trace::nameThread("main");
+        Trace::start();
+    }
+    MetricsExporter metrics;
+    if (!metricsTarget.empty()) {
+        bool socket = metricsTarget.compare(0, 5, "unix:") == 0;
+        if (!metrics.start(socket ? "" : metricsTarget, socket ? metricsTarget.substr(5) : "")) {
+            std::cerr << "Cannot serve metrics on " << metricsTarget.substr(5) << std::endl;
+        }
+    }
+    Tournament tournament(config);
+    std::cout << "Tables: " << tournament.getActiveTables() << ", threads: " << tournament.getThreadCount() << std::endl;
+    
+    long long totalChips = tournament.getTotalChips();
+    int lastLevel = -1;
+    bool finalTableShown = false;
+    IcmSnapshot biggestSwing = {-1, 0, 0.0};
+    while (tournament.playRound()) {
+        for (const IcmSnapshot& change : tournament.getLastRoundIcmChanges()) {
+            if (std::abs(change.equity) > std::abs(biggestSwing.equity)) biggestSwing = change;
+        }
+        if (!finalTableShown && tournament.getActiveTables() == 1) {
+            finalTableShown = true;
+            std::cout << "\n=== FINAL TABLE (ICM) ===" << std::endl;
+            for (const IcmSnapshot& snapshot : tournament.getIcmEquities()) {
+                std::cout << "Player" << (snapshot.playerId + 1) << ": " << snapshot.chips << " chips, $"
+                          << std::fixed << std::setprecision(0) << snapshot.equity << std::endl;
+            }
+            std::cout.unsetf(std::ios::floatfield);
+            std::cout << std::setprecision(6) << std::endl;
+        }
+        if (tournament.getLevelIndex() != lastLevel) {
+            lastLevel = tournament.getLevelIndex();
+            BlindLevel level = tournament.getCurrentLevel();
+            std::cout << "Level " << (lastLevel + 1) << " (" << level.smallBlind << "/" << level.bigBlind
+                      << " ante " << level.ante << "): " << tournament.getPlayersRemaining() << " players, "
+                      << tournament.getActiveTables() << " tables" << std::endl;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Trace::stop();
+    metrics.stop();
+    
+    std::vector<TournamentFinish> standings = tournament.getStandings();
+    std::cout << "\n=== FINAL STANDINGS ===" << std::endl;
+    const OpponentStats& stats = tournament.getOpponentStats();
+    for (size_t i = 0; i < standings.size() && i < 10; i++) {
+        int id = standings[i].playerId;
+        std::cout << standings[i].place << ". " << standings[i].name << std::fixed << std::setprecision(0)
+                  << "  (" << stats.getHands(id) << " hands, VPIP " << 100 * stats.getVpip(id)
+                  << "%, PFR " << 100 * stats.getPfr(id) << "%, 3-bet " << 100 * stats.getThreeBet(id)
+                  << "%, fold to c-bet " << 100 * stats.getFoldToCbet(id) << "%, WTSD "
+                  << 100 * stats.getWentToShowdown(id) << "%, AF " << std::setprecision(1)
+                  << stats.getAggressionFactor(id) << ")" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    
+    std::cout << "\nHands: " << tournament.getHandsPlayed() << ", rounds: " << tournament.getRoundsPlayed()
+              << ", player moves: " << tournament.getPlayerMoves() << ", tables broken: " << tournament.getTablesBroken()
+              << std::endl;
+    std::cout << "Chips in play: " << tournament.getTotalChips() << " (started with " << totalChips << ")" << std::endl;
+    if (biggestSwing.playerId >= 0) {
+        std::cout << "Biggest ICM swing in one hand: Player" << (biggestSwing.playerId + 1) << " "
+                  << (biggestSwing.equity >= 0 ? "+$" : "-$") << static_cast<long long>(std::abs(biggestSwing.equity))
+                  << std::endl;
+    }
+    std::cout << "Time: " << seconds << "s" << std::endl;
+    if (tournament.getArchive().isOpen()) {
+        HandArchive& archive = tournament.getArchive();
+        archive.flush();
+        std::cout << "Archived " << archive.getRecordsWritten() << " records to " << config.archivePath << " in "
+                  << archive.getBatches() << " writes (" << archive.getProducerStalls() << " producer stalls, "
+                  << archive.getWriteErrors() << " write errors)" << std::endl;
+    }
+    if (!tracePath.empty()) {
+        if (Trace::write(tracePath)) {
+            std::cout << "Traced " << Trace::getEventCount() << " spans to " << tracePath << " ("
+                      << Trace::getDropped() << " dropped)" << std::endl;
+        } else {
+            std::cerr << "Cannot write trace to " << tracePath << std::endl;
+        }
+    }
+#ifdef ALLOC_STATS
+    AllocStats::report(std::cout, tournament.getHandsPlayed());
+#endif
+#ifdef PROFILE
+    Profiler::report(std::cout);
+    // Timing check: a bot decision has a budget, and a slow p99 fails the run
+    double decisionP99Us = Profiler::percentileNs(ProfilePhase::DECISION, 99.0) / 1000.0;
+    std::cout << "Decision p99: " << decisionP99Us << "us (budget " << DECISION_P99_BUDGET_US << "us)" << std::endl;
+    if (decisionP99Us > DECISION_P99_BUDGET_US) {
+        std::cerr << "Decision p99 is over budget" << std::endl;
+        return 3;
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include "opponent_stats.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    const char MAGIC[8] = {'O', 'P', 'P', 'S', 'T', 'A', 'T', 'S'};
+    const uint32_t FILE_VERSION = 1;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t counters;
+        uint32_t players;
+        uint32_t reserved;
+    };
+
+    bool isPostflop(HandHistoryRound round) {
+        return round == HandHistoryRound::FLOP || round == HandHistoryRound::TURN || round == HandHistoryRound::RIVER;
+    }
+}
+
+void OpponentStats::ensurePlayer(int playerId) {
+    size_t needed = static_cast<size_t>(playerId) + 1;
+    if (handFlags.size() < needed) handFlags.resize(needed, 0);
+    if (counters.size() < needed * NUM_COUNTERS) counters.resize(needed * NUM_COUNTERS, 0);
+}
+
+void OpponentStats::beginHand(const PlayerList& players) {
+    for (int playerId : handPlayers) handFlags[playerId] = 0;
+    handPlayers.clear();
+    for (const PlayerInfo& player : players) {
+        if (player.playerId < 0) continue;
+        ensurePlayer(player.playerId);
+        handFlags[player.playerId] = IN_HAND;
+        handPlayers.push_back(player.playerId);
+        add(player.playerId, HANDS);
+    }
+    latestRound = HandHistoryRound::PRE_HAND;
+    preflopRaises = 0;
+    preflopRaiser = -1;
+    roundBet = 0;
+    flopBet = false;
+    cbetPending = false;
+}
+
+void OpponentStats::enterRound(HandHistoryRound round) {
+    // The first action past preflop means everyone still in has seen the flop
+    if (latestRound <= HandHistoryRound::PRE_FLOP && round > HandHistoryRound::PRE_FLOP) {
+        for (int playerId : handPlayers) {
+            if ((handFlags[playerId] & FOLDED) == 0) {
+                handFlags[playerId] |= SAW_FLOP_FLAG;
+                add(playerId, SAW_FLOP);
+            }
+        }
+    }
+    if (round > HandHistoryRound::PRE_FLOP) {
+        roundBet = 0; // The blinds carry into preflop; every later street starts unbet
+    }
+    latestRound = round;
+}
+
+void OpponentStats::recordAction(const GameAction& action) {
+    if (action.round > latestRound) enterRound(action.round);
+
+    int playerId = action.playerId;
+    if (playerId < 0 || static_cast<size_t>(playerId) >= handFlags.size() || (handFlags[playerId] & IN_HAND) == 0) {
+        return;
+    }
+    if (action.actionType == ActionType::DEAL_CARDS) {
+        return; // Cards dealt or shown, not a decision
+    }
+    if (action.actionType == ActionType::POST_BLIND) {
+        roundBet = std::max(roundBet, action.potAfterAction);
+        return;
+    }
+
+    // potAfterAction is the table's bet level as PokerGame records it, so an
+    // all-in that lifts it is a raise and any other all-in a call
+    uint8_t& flags = handFlags[playerId];
+    ActionType type = action.actionType;
+    bool aggressive = type == ActionType::RAISE || (type == ActionType::ALL_IN && action.potAfterAction > roundBet);
+    bool calls = type == ActionType::CALL || (type == ActionType::ALL_IN && !aggressive);
+    if (type == ActionType::FOLD) flags |= FOLDED;
+
+    if (action.round == HandHistoryRound::PRE_FLOP) {
+        if (preflopRaises == 1 && preflopRaiser != playerId && (flags & THREE_BET_CHANCE) == 0) {
+            flags |= THREE_BET_CHANCE;
+            add(playerId, THREE_BET_CHANCES);
+            if (aggressive) add(playerId, THREE_BETS);
+        }
+        if ((aggressive || calls) && (flags & PUT_MONEY_IN) == 0) {
+            flags |= PUT_MONEY_IN;
+            add(playerId, VPIP);
+        }
+        if (aggressive) {
+            if ((flags & RAISED) == 0) {
+                flags |= RAISED;
+                add(playerId, PFR);
+            }
+            preflopRaises++;
+            preflopRaiser = playerId;
+        }
+    } else if (isPostflop(action.round)) {
+        if (action.round == HandHistoryRound::FLOP) {
+            if (cbetPending && playerId != preflopRaiser && (flags & FACED_CBET) == 0) {
+                flags |= FACED_CBET;
+                add(playerId, CBETS_FACED);
+                if (type == ActionType::FOLD) add(playerId, CBET_FOLDS);
+            }
+            if (aggressive) {
+                // Only the opening flop bet from the preflop raiser is a c-bet; a raise ends it
+                cbetPending = !flopBet && playerId == preflopRaiser;
+                flopBet = true;
+            }
+        }
+        if (aggressive) {
+            add(playerId, POSTFLOP_AGGRESSIVE);
+        } else if (calls) {
+            add(playerId, POSTFLOP_CALLS);
+        }
+    }
+    roundBet = std::max(roundBet, action.potAfterAction);
+}
+
+void OpponentStats::endHand(bool showdown) {
+    if (!showdown) return;
+    for (int playerId : handPlayers) {
+        uint8_t& flags = handFlags[playerId];
+        if (flags & FOLDED) continue;
+        if ((flags & SAW_FLOP_FLAG) == 0) { // All in before the flop and the board run more than once
+            flags |= SAW_FLOP_FLAG;
+            add(playerId, SAW_FLOP);
+        }
+        add(playerId, WENT_TO_SHOWDOWN);
+    }
+}
+
+double OpponentStats::rate(int playerId, Counter hits, Counter chances) const {
+    uint32_t total = getCount(playerId, chances);
+    return total > 0 ? static_cast<double>(getCount(playerId, hits)) / total : 0.0;
+}
+
+double OpponentStats::getVpip(int playerId) const {
+    return rate(playerId, VPIP, HANDS);
+}
+
+double OpponentStats::getPfr(int playerId) const {
+    return rate(playerId, PFR, HANDS);
+}
+
+double OpponentStats::getThreeBet(int playerId) const {
+    return rate(playerId, THREE_BETS, THREE_BET_CHANCES);
+}
+
+double OpponentStats::getFoldToCbet(int playerId) const {
+    return rate(playerId, CBET_FOLDS, CBETS_FACED);
+}
+
+double OpponentStats::getAggressionFactor(int playerId) const {
+    uint32_t calls = getCount(playerId, POSTFLOP_CALLS);
+    uint32_t aggressive = getCount(playerId, POSTFLOP_AGGRESSIVE);
+    return calls > 0 ? static_cast<double>(aggressive) / calls : aggressive;
+}
+
+double OpponentStats::getWentToShowdown(int playerId) const {
+    return rate(playerId, WENT_TO_SHOWDOWN, SAW_FLOP);
+}
+
+void OpponentStats::merge(const OpponentStats& other) {
+    if (counters.size() < other.counters.size()) {
+        counters.resize(other.counters.size(), 0);
+        handFlags.resize(other.counters.size() / NUM_COUNTERS, 0);
+    }
+    for (size_t i = 0; i < other.counters.size(); i++) {
+        counters[i] += other.counters[i];
+    }
+}
+
+void OpponentStats::reset() {
+    std::fill(counters.begin(), counters.end(), 0);
+}
+
+bool OpponentStats::save(const std::string& path) const {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.counters = NUM_COUNTERS;
+    header.players = static_cast<uint32_t>(counters.size() / NUM_COUNTERS);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(counters.data()), sizeof(uint32_t) * counters.size());
+    return static_cast<bool>(file);
+}
+
+bool OpponentStats::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FILE_VERSION ||
+        header.counters != NUM_COUNTERS) {
+        return false;
+    }
+
+    std::vector<uint32_t> data(static_cast<size_t>(header.players) * NUM_COUNTERS);
+    if (!file.read(reinterpret_cast<char*>(data.data()), sizeof(uint32_t) * data.size())) return false;
+    counters.swap(data);
+    if (handFlags.size() < header.players) handFlags.resize(header.players, 0);
+    if (counters.size() < handFlags.size() * NUM_COUNTERS) counters.resize(handFlags.size() * NUM_COUNTERS, 0);
+    return true;
+}
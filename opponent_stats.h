@@ -0,0 +1,91 @@
+#ifndef OPPONENT_STATS_H
+#define OPPONENT_STATS_H
+
+#include "hand_history.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Running per-player tendencies built up across hands and tables: VPIP, PFR,
+// 3-bet, fold to continuation bet, postflop aggression factor and went to
+// showdown. PokerGame feeds every GameAction as it is recorded, each costing
+// O(1); counters sit in flat arrays indexed by player id, so reading one is a
+// single lookup.
+//
+// A store is written by one thread at a time. Parallel simulations give each
+// worker (or table) its own store and merge the counters into a shared one
+// between rounds.
+class OpponentStats {
+public:
+    enum Counter {
+        HANDS,               // Dealt in
+        VPIP,                // Put money in voluntarily preflop
+        PFR,                 // Raised preflop
+        THREE_BET_CHANCES,   // Faced a single preflop raise
+        THREE_BETS,          // ...and re-raised it
+        CBETS_FACED,         // Faced the preflop raiser's first flop bet
+        CBET_FOLDS,          // ...and folded to it
+        POSTFLOP_AGGRESSIVE, // Postflop bets and raises
+        POSTFLOP_CALLS,
+        SAW_FLOP,
+        WENT_TO_SHOWDOWN,
+        NUM_COUNTERS
+    };
+
+    static const int MIN_HANDS = 20; // Hands before the derived rates mean much
+
+    // Hand boundaries: beginHand from the hand's PlayerInfo list, endHand once
+    // the pots are awarded (showdown = the hand was decided by a showdown)
+    void beginHand(const PlayerList& players);
+    void recordAction(const GameAction& action);
+    void endHand(bool showdown);
+
+    uint32_t getCount(int playerId, Counter counter) const {
+        size_t index = static_cast<size_t>(playerId) * NUM_COUNTERS + counter;
+        return playerId >= 0 && index < counters.size() ? counters[index] : 0;
+    }
+    int getHands(int playerId) const { return static_cast<int>(getCount(playerId, HANDS)); }
+
+    // Rates in [0, 1] (aggression factor is bets and raises per call); 0 without a sample
+    double getVpip(int playerId) const;
+    double getPfr(int playerId) const;
+    double getThreeBet(int playerId) const;
+    double getFoldToCbet(int playerId) const;
+    double getAggressionFactor(int playerId) const;
+    double getWentToShowdown(int playerId) const; // Of the hands where they saw the flop
+
+    void merge(const OpponentStats& other); // Adds the other store's counters
+    void reset();                           // Clears the counters, keeps the hand in progress
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path); // False if missing or not a stats file
+
+private:
+    // Per-hand state for each player id, cleared by beginHand
+    enum HandFlag : uint8_t {
+        IN_HAND = 1,
+        FOLDED = 2,
+        PUT_MONEY_IN = 4,
+        RAISED = 8,
+        THREE_BET_CHANCE = 16,
+        FACED_CBET = 32,
+        SAW_FLOP_FLAG = 64
+    };
+
+    std::vector<uint32_t> counters; // [playerId][Counter]
+    std::vector<uint8_t> handFlags;  // [playerId]
+    std::vector<int> handPlayers;
+    HandHistoryRound latestRound = HandHistoryRound::PRE_HAND;
+    int preflopRaises = 0;
+    int preflopRaiser = -1;
+    int roundBet = 0;         // Bet level of the current round, from potAfterAction
+    bool flopBet = false;     // Somebody has bet the flop
+    bool cbetPending = false; // The flop bet was a continuation bet and nobody has raised it
+
+    void ensurePlayer(int playerId);
+    void add(int playerId, Counter counter) { counters[static_cast<size_t>(playerId) * NUM_COUNTERS + counter]++; }
+    double rate(int playerId, Counter hits, Counter chances) const;
+    void enterRound(HandHistoryRound round);
+};
+
+#endif
@@ -1,13 +1,22 @@
 #include "player.h"
+#include "game_log.h"
 #include "hand_history.h"
 #include "variants.h"
+#include "hand_strength.h"
+#include "push_fold.h"
+#include "limit_cfr.h"
+#include "preflop_equity.h"
+#include "opponent_stats.h"
+#include "profiler.h"
+#include "alloc_stats.h"
 #include <iostream>
 #include <algorithm>
 #include <ctime>
 
 Player::Player(const std::string& playerName, int startingChips, int id, PlayerPersonality playerPersonality) 
     : name(playerName), chips(startingChips), cardsAtStartOfStreet(0), currentBet(0), inFor(0), folded(false), allIn(false), 
-      personality(playerPersonality), playerId(id), rng(std::time(nullptr) + id) {
+      personality(playerPersonality), playerId(id), rng(std::time(nullptr) + id), riskPremium(0.0),
+      opponentStats(nullptr) {
 }
 
 const std::string& Player::getName() const {
@@ -46,34 +55,69 @@ int Player::getHandSize() const {
     return hand.size();
 }
 
+double Player::getRiskPremium() const {
+    return riskPremium;
+}
+
+void Player::setLimitStrategy(std::shared_ptr<const LimitStrategy> strategy) {
+    limitStrategy = std::move(strategy);
+}
+
+void Player::setOpponentStats(const OpponentStats* stats) {
+    opponentStats = stats;
+}
+
+void Player::setRiskPremium(double premium) {
+    riskPremium = premium;
+}
+
 void Player::addCard(const Card& card) {
     hand.push_back(card);
     cardsFaceUp.push_back(false); // Default to face down for hold'em compatibility
+    liveHand.addHoleCard(card);
 }
 
 void Player::addCard(const Card& card, bool faceUp) {
     hand.push_back(card);
     cardsFaceUp.push_back(faceUp);
+    liveHand.addHoleCard(card);
 }
 
 void Player::clearHand() {
     hand.clear();
     cardsFaceUp.clear();
+    liveHand.clear();
+}
+
+void Player::setHandRules(bool twoPlusThree, bool hiLo) {
+    liveHand.setRules(twoPlusThree, hiLo);
+}
+
+void Player::addBoardCard(const Card& card) {
+    liveHand.addBoardCard(card);
+}
+
+void Player::clearBoardCards() {
+    liveHand.clearBoard();
+}
+
+const IncrementalHand& Player::getLiveHand() const {
+    return liveHand;
 }
 
 void Player::showHand() const {
     for (const auto& card : hand) {
-        std::cout << card.toString() << " ";
+        GameLog::out() << card.toString() << " ";
     }
 }
 
 void Player::showStudHand() const {
-    std::cout << name << ": ";
+    GameLog::out() << name << ": ";
     for (size_t i = 0; i < hand.size(); i++) {
         if (cardsFaceUp[i]) {
-            std::cout << hand[i].toString() << " ";
+            GameLog::out() << hand[i].toString() << " ";
         } else {
-            std::cout << "XX ";
+            GameLog::out() << "XX ";
         }
     }
 }
@@ -113,13 +157,13 @@ void Player::showStudHandWithNew() const {
         bool isNewCard = (static_cast<int>(i) >= cardsAtStartOfStreet);
         
         if (cardsFaceUp[i]) {
-            std::cout << hand[i].toString();
-            if (isNewCard) std::cout << "*"; // Mark new cards with *
-            std::cout << " ";
+            GameLog::out() << hand[i].toString();
+            if (isNewCard) GameLog::out() << "*"; // Mark new cards with *
+            GameLog::out() << " ";
         } else {
-            std::cout << "[" << hand[i].toString() << "]";
-            if (isNewCard) std::cout << "*"; // Mark new hole cards too
-            std::cout << " ";
+            GameLog::out() << "[" << hand[i].toString() << "]";
+            if (isNewCard) GameLog::out() << "*"; // Mark new hole cards too
+            GameLog::out() << " ";
         }
     }
 }
@@ -199,6 +243,7 @@ void Player::resetInFor() {
 void Player::resetForNewHand() {
     hand.clear();
     cardsFaceUp.clear();
+    liveHand.clear();
     currentBet = 0;
     inFor = 0;
     folded = false;
@@ -206,38 +251,49 @@ void Player::resetForNewHand() {
 }
 
 void Player::showStatus(bool showCards) const {
-    std::cout << std::setw(15) << name
+    GameLog::out() << std::setw(15) << name
               << " | Chips: " << std::setw(6) << chips
               << " | Bet: " << std::setw(4) << inFor;
 
     if (showCards) {
-        std::cout << " | Cards: ";
+        GameLog::out() << " | Cards: ";
         if (hand.size() > 0) {
             std::string cardStr = "";
             for (const auto& card : hand) {
                 cardStr += card.toString() + " ";
             }
-            std::cout << std::setw(12) << std::left << cardStr << std::right;
+            GameLog::out() << std::setw(12) << std::left << cardStr << std::right;
         } else {
-            std::cout << std::setw(12) << "(none)";
+            GameLog::out() << std::setw(12) << "(none)";
         }
     }
     if (folded) {
-        std::cout << " | FOLDED";
+        GameLog::out() << " | FOLDED";
     } else if (allIn) {
-        std::cout << " | ALL-IN";
+        GameLog::out() << " | ALL-IN";
     }
-    std::cout << std::endl;
+    GameLog::out() << std::endl;
 }
 
 // Decision making implementation
 PlayerAction Player::makeDecision(const HandHistory& history, int callAmount, bool canCheck, const VariantInfo* variant, int betCount) const {
+    ALLOC_SCOPE(AllocTag::DECISION);
+    PROFILE_SCOPE(ProfilePhase::DECISION);
     // Check bet cap for limit games (4-bet cap)
     bool canRaise = true;
     if (variant && variant->bettingStruct == BETTINGSTRUCTURE_LIMIT && betCount >= 4) {
         canRaise = false; // 4-bet cap reached
     }
     
+    // Short-stacked and nobody has entered the pot except by shoving: play the chart
+    PlayerAction chartAction;
+    if (variant && pushFoldDecision(history, *variant, canCheck, callAmount, chartAction)) {
+        return chartAction;
+    }
+    if (variant && limitStrategyDecision(history, *variant, canCheck, chartAction)) {
+        return chartAction;
+    }
+    
     // If we can't afford the call amount, go all-in or fold
     if (callAmount >= chips) {
         if (chips <= 50) { // Small stack, might as well try
@@ -248,9 +304,17 @@ PlayerAction Player::makeDecision(const HandHistory& history, int callAmount, bo
     }
     
     // Basic decision logic based on personality and simple heuristics
-    double handStrength = evaluateHandStrength();
+    double handStrength = evaluateHandStrength(history, variant);
     double potOdds = calculatePotOdds(callAmount, history.getCurrentPot());
     
+    // Tournament ICM pressure: putting chips at risk needs a better hand and price,
+    // scaled by how much of the stack the call puts in
+    if (riskPremium > 0.0 && callAmount > 0) {
+        double pressure = riskPremium * std::min(1.0, static_cast<double>(callAmount) / chips);
+        handStrength -= pressure;
+        potOdds -= pressure;
+    }
+    
     // Pre-flop decision making
     if (history.getCurrentRound() == HandHistoryRound::PRE_FLOP) {
         // If we can check for free, never fold - at minimum check
@@ -307,7 +371,7 @@ PlayerAction Player::makeDecision(const HandHistory& history, int callAmount, bo
     }
     
     // Post-flop decision making (more aggressive)
-    if (shouldFoldToAggression(history, callAmount)) {
+    if (shouldFoldToAggression(history, callAmount, variant)) {
         return PlayerAction::FOLD;
     }
     
@@ -401,7 +465,7 @@ PlayerAction Player::makeDecision(const HandHistory& history, int callAmount, bo
     return PlayerAction::FOLD;
 }
 
-int Player::calculateRaiseAmount(const HandHistory& /* history */, int currentBet, const VariantInfo& variant, UnifiedBettingRound currentRound) const {
+int Player::calculateRaiseAmount(const HandHistory& history, int currentBet, const VariantInfo& variant, UnifiedBettingRound currentRound) const {
     if (variant.bettingStruct == BETTINGSTRUCTURE_LIMIT) {
         // Limit poker logic
         if (variant.gameStruct == GAMESTRUCTURE_STUD) {
@@ -435,7 +499,7 @@ int Player::calculateRaiseAmount(const HandHistory& /* history */, int currentBe
         }
     } else {
         // No-limit poker logic (simplified for now)
-        double handStrength = evaluateHandStrength();
+        double handStrength = evaluateHandStrength(history, &variant);
         
         // Base raise size on current bet and hand strength
         int baseRaise = std::max(currentBet * 2, 50); // Minimum raise of 50
@@ -449,14 +513,26 @@ int Player::calculateRaiseAmount(const HandHistory& /* history */, int currentBe
 }
 
 // Decision helper implementations
-double Player::evaluateHandStrength() const {
+double Player::evaluateHandStrength(const HandHistory& history, const VariantInfo* variant) const {
     if (hand.empty()) return 0.0;
     
-    // Very basic hand strength evaluation
-    // This is a placeholder - real evaluation would depend on the variant
-    
     if (hand.size() < 2) return 0.1;
     
+    // Hold'em: measure the hand against every opponent holding on the board this seat was dealt
+    if (hand.size() == 2 && (!variant || HandStrengthEngine::supports(*variant))) {
+        CardMask hole = FastEvaluator::handMask(hand);
+        CardMask board = liveHand.getBoardCards();
+        if (!board) {
+            // Preflop equity vs a random hand: 40% (worst hands) maps to 0, 70% and up to 1
+            double equity = HandStrengthEngine::evaluate(hole, board).effectiveStrength;
+            return std::max(0.0, std::min(1.0, (equity - 0.40) / 0.30));
+        }
+        int opponents = std::max(1, history.getActivePlayerCount() - 1);
+        return HandStrengthEngine::evaluate(hole, board, opponents).effectiveStrength;
+    }
+    
+    // Other variants: very basic evaluation of our own cards only
+    
     // Look for pairs, high cards, suited cards
     std::vector<Rank> ranks;
     std::vector<Suit> suits;
@@ -494,24 +570,28 @@ double Player::calculatePotOdds(int callAmount, int potSize) const {
     return static_cast<double>(potSize) / (potSize + callAmount);
 }
 
-bool Player::shouldFoldToAggression(const HandHistory& history, int callAmount) const {
+bool Player::shouldFoldToAggression(const HandHistory& history, int callAmount, const VariantInfo* variant) const {
     // Never fold when we can check for free
     if (callAmount == 0) {
         return false;
     }
     
-    // Check if there was recent aggressive action
-    auto recentActions = history.getActionsForRound(history.getCurrentRound());
+    // Check if there was a big raise this round (the history tracks the largest as actions arrive)
+    int aggressorId = history.getRoundAggressor();
+    bool heavyAggression = aggressorId >= 0 && history.getRoundLargestRaise() > callAmount * 2;
     
-    bool heavyAggression = false;
-    for (const auto& action : recentActions) {
-        if (action.actionType == ActionType::RAISE && action.amount > callAmount * 2) {
-            heavyAggression = true;
-            break;
+    // Call down a habitual bettor lighter, give up sooner against one who rarely bets
+    double foldBelow = 0.6;
+    if (opponentStats && aggressorId >= 0 && opponentStats->getHands(aggressorId) >= OpponentStats::MIN_HANDS) {
+        double aggression = opponentStats->getAggressionFactor(aggressorId);
+        if (aggression > 3.0) {
+            foldBelow = 0.45;
+        } else if (aggression < 1.0) {
+            foldBelow = 0.7;
         }
     }
     
-    if (heavyAggression && evaluateHandStrength() < 0.6) {
+    if (heavyAggression && evaluateHandStrength(history, variant) < foldBelow) {
         return personality == PlayerPersonality::TIGHT_PASSIVE || 
                personality == PlayerPersonality::TIGHT_AGGRESSIVE;
     }
@@ -526,25 +606,184 @@ bool Player::shouldBluff(const HandHistory& history) const {
         return false;
     }
     
-    // Don't bluff if many players in hand
-    auto currentRoundActions = history.getActionsForRound(history.getCurrentRound());
-    int activePlayers = 0;
-    for (const auto& action : currentRoundActions) {
-        if (action.actionType != ActionType::FOLD) {
-            activePlayers++;
-        }
+    // Only bluff heads-up
+    int opponentId = history.getHeadsUpOpponent(playerId);
+    if (opponentId < 0) return false;
+    
+    // Random bluff frequency, scaled by how often the opponent folds to a bet
+    double frequency = 0.2;
+    if (opponentStats && opponentId >= 0 && opponentStats->getCount(opponentId, OpponentStats::CBETS_FACED) >= 10) {
+        frequency = 0.05 + 0.3 * opponentStats->getFoldToCbet(opponentId);
+    }
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return dist(rng) < frequency;
+}
+
+bool Player::pushFoldDecision(const HandHistory& history, const VariantInfo& variant, bool canCheck,
+                              int callAmount, PlayerAction& action) const {
+    if (variant.gameStruct != GAMESTRUCTURE_BOARD || variant.numHoleCards != NUMHOLECARDS_TWO ||
+        variant.bettingStruct != BETTINGSTRUCTURE_NO_LIMIT || variant.betSizes.size() < 2 ||
+        hand.size() != 2 || history.getCurrentRound() != HandHistoryRound::PRE_FLOP ||
+        !PushFoldCharts::shared().isLoaded()) {
+        return false;
     }
     
-    if (activePlayers > 2) return false;
+    const PlayerList& players = history.getPlayers();
+    int playerCount = static_cast<int>(players.size());
+    if (playerCount < PushFoldChart::MIN_PLAYERS) return false;
     
-    // Random bluff frequency
+    // Effective stack: ours against the deepest opponent, as the hand started
+    int dealerSeat = 0;
+    int ourStack = 0;
+    int deepestOpponent = 0;
+    for (const PlayerInfo& info : players) {
+        if (info.isDealer) dealerSeat = info.position;
+        if (info.playerId == playerId) {
+            ourStack = info.startingChips;
+        } else {
+            deepestOpponent = std::max(deepestOpponent, info.startingChips);
+        }
+    }
+    double bigBlind = variant.betSizes[1];
+    double stackBB = std::min(ourStack, deepestOpponent) / bigBlind;
+    if (stackBB > PushFoldChart::MAX_STACK_BB + 0.5) return false;
+    
+    // Antes are posted before the blinds, so every post but the last two is an ante
+    const ActionList& actions = history.getActions();
+    int posts = 0;
+    for (const GameAction& action : actions) {
+        if (action.round == HandHistoryRound::PRE_HAND && action.actionType == ActionType::POST_BLIND) posts++;
+    }
+    int ante = 0;
+    int pusherId = -1;
+    for (const GameAction& action : actions) {
+        if (action.round == HandHistoryRound::PRE_HAND) {
+            if (action.actionType == ActionType::POST_BLIND && posts-- > 2) ante = std::max(ante, action.amount);
+            continue;
+        }
+        // Only unopened pots, or a single shove with folds around it
+        if (action.round != HandHistoryRound::PRE_FLOP || action.playerId < 0 ||
+            action.actionType == ActionType::FOLD) {
+            continue;
+        }
+        if (action.actionType != ActionType::ALL_IN || pusherId >= 0) return false;
+        pusherId = action.playerId;
+    }
+    
+    // Seats in preflop action order, the first one after the big blind being 0.
+    // Tables bigger than the largest chart treat the extra early seats as its first seat.
+    auto actionOrder = [&](int id) {
+        for (const PlayerInfo& info : players) {
+            if (info.playerId == id) {
+                int order = ((info.position - dealerSeat - 3) % playerCount + playerCount) % playerCount;
+                return std::max(0, order - std::max(0, playerCount - PushFoldChart::MAX_PLAYERS));
+            }
+        }
+        return -1;
+    };
+    int chartPlayers = std::min(playerCount, PushFoldChart::MAX_PLAYERS);
+    const PushFoldChart* chart = PushFoldCharts::shared().get(chartPlayers, stackBB, variant.betSizes[0] / bigBlind,
+                                                              ante / bigBlind);
+    if (!chart) return false;
+    
+    int handClass = PreflopEquity::classIndex(hand[0], hand[1]);
+    int position = actionOrder(playerId);
     std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(rng) < 0.2; // 20% bluff frequency
+    if (pusherId < 0) {
+        if (position >= chartPlayers - 1) return false; // Big blind with nothing to face
+        bool push = dist(rng) < chart->pushFrequency(position, handClass);
+        action = push ? PlayerAction::ALL_IN : (canCheck ? PlayerAction::CHECK : PlayerAction::FOLD);
+        return true;
+    }
+    
+    int pusher = actionOrder(pusherId);
+    position = std::max(position, pusher + 1);
+    if (pusher < 0 || position >= chartPlayers) return false;
+    if (dist(rng) < chart->callFrequency(pusher, position, handClass)) {
+        action = callAmount >= chips ? PlayerAction::ALL_IN : PlayerAction::CALL;
+    } else {
+        action = PlayerAction::FOLD;
+    }
+    return true;
+}
+
+bool Player::limitStrategyDecision(const HandHistory& history, const VariantInfo& variant, bool canCheck,
+                                   PlayerAction& action) const {
+    const PlayerList& players = history.getPlayers();
+    if (!limitStrategy || !limitStrategy->matches(variant) || players.size() != 2 || hand.size() != 2) {
+        return false;
+    }
+    
+    // Heads-up the small blind sits left of the dealer and is player 0 in the tree
+    int smallBlindId = -1;
+    for (const PlayerInfo& info : players) {
+        if (!info.isDealer) smallBlindId = info.playerId;
+    }
+    
+    // Replay the hand's betting through the tree
+    const LimitBettingTree& tree = limitStrategy->getTree();
+    int nodeIndex = 0;
+    for (const GameAction& taken : history.getActions()) {
+        if (taken.playerId < 0 || taken.round == HandHistoryRound::PRE_HAND) continue;
+        const LimitBettingTree::Node& node = tree.getNode(nodeIndex);
+        int actor = taken.playerId == smallBlindId ? 0 : 1;
+        if (node.player != actor) return false;
+        int treeAction;
+        switch (taken.actionType) {
+            case ActionType::FOLD: treeAction = LimitBettingTree::FOLD; break;
+            case ActionType::CHECK:
+            case ActionType::CALL: treeAction = LimitBettingTree::CALL; break;
+            case ActionType::RAISE: treeAction = LimitBettingTree::RAISE; break;
+            default: return false; // All-ins leave the tree
+        }
+        nodeIndex = tree.getNode(nodeIndex).children[treeAction];
+        if (nodeIndex < 0) return false;
+    }
+    
+    const LimitBettingTree::Node& node = tree.getNode(nodeIndex);
+    int role = playerId == smallBlindId ? 0 : 1;
+    if (node.player != role) return false;
+    
+    int bucket = LimitStrategy::bucket(hand, history.getBoard(), limitStrategy->getBuckets());
+    const uint8_t* weights = limitStrategy->actionWeights(node.decision, bucket);
+    int total = 0;
+    for (int a = 0; a < LimitBettingTree::NUM_ACTIONS; a++) {
+        if (node.children[a] >= 0) total += weights[a];
+    }
+    int chosen = LimitBettingTree::CALL;
+    if (total > 0) {
+        int pick = std::uniform_int_distribution<int>(0, total - 1)(rng);
+        for (int a = 0; a < LimitBettingTree::NUM_ACTIONS; a++) {
+            if (node.children[a] < 0) continue;
+            if (pick < weights[a]) {
+                chosen = a;
+                break;
+            }
+            pick -= weights[a];
+        }
+    }
+    
+    if (chosen == LimitBettingTree::RAISE) {
+        action = PlayerAction::RAISE;
+    } else if (chosen == LimitBettingTree::FOLD && !canCheck) {
+        action = PlayerAction::FOLD;
+    } else {
+        action = canCheck ? PlayerAction::CHECK : PlayerAction::CALL;
+    }
+    return true;
 }
 
 bool Player::isHandPlayable() const {
     if (hand.size() < 2) return false;
     
+    bool tight = personality == PlayerPersonality::TIGHT_PASSIVE ||
+                 personality == PlayerPersonality::TIGHT_AGGRESSIVE;
+    if (hand.size() == 2) {
+        // Equity vs a random hand (precomputed table, or sampled once per hand class)
+        double equity = HandStrengthEngine::evaluate(hand, {}).effectiveStrength;
+        return equity >= (tight ? 0.55 : 0.50);
+    }
+    
     // Very basic preflop hand selection for Hold'em/Omaha
     std::vector<Rank> ranks;
     std::vector<Suit> suits;
@@ -574,8 +813,7 @@ bool Player::isHandPlayable() const {
     }
     
     // Tight players fold more hands
-    if (personality == PlayerPersonality::TIGHT_PASSIVE || 
-        personality == PlayerPersonality::TIGHT_AGGRESSIVE) {
+    if (tight) {
         return highCard >= static_cast<int>(Rank::QUEEN);
     }
     
@@ -3,13 +3,17 @@
 
 #include "card.h"
 #include "variants.h"
+#include "incremental_hand.h"
 #include <vector>
 #include <string>
 #include <iomanip>
 #include <random>
+#include <memory>
 
 class HandHistory; // Forward declaration
 struct VariantInfo; // Forward declaration
+class LimitStrategy; // Forward declaration
+class OpponentStats; // Forward declaration
 
 enum class PlayerPersonality {
     TIGHT_PASSIVE,   // Plays few hands, rarely raises
@@ -40,6 +44,12 @@ private:
     PlayerPersonality personality;
     int playerId; // Stable identifier for hand history tracking
     mutable std::mt19937 rng; // For decision randomness
+    double riskPremium; // Extra win probability tournament payouts demand before risking chips (0 = chip EV)
+    IncrementalHand liveHand; // Best hand so far with the board, updated as cards arrive
+    std::shared_ptr<const LimitStrategy> limitStrategy; // Solved heads-up limit play, if any
+    const OpponentStats* opponentStats; // Tendencies of the other players, if tracked
+    
+    friend class TableCheckpoint; // Checkpoints restore a seat mid-hand
 
 public:
     Player(const std::string& playerName, int startingChips, int id, 
@@ -55,6 +65,10 @@ public:
     bool hasFolded() const;
     bool isAllIn() const;
     int getHandSize() const;
+    double getRiskPremium() const;
+    void setRiskPremium(double premium); // Set per hand by the tournament from ICM
+    void setLimitStrategy(std::shared_ptr<const LimitStrategy> strategy); // Used heads-up in matching limit games
+    void setOpponentStats(const OpponentStats* stats); // Read when facing bets and choosing bluffs
     
     // Card management
     void addCard(const Card& card);
@@ -66,6 +80,10 @@ public:
     std::vector<Card> getUpCards() const; // Get only face-up cards
     Card getLowestUpCard() const; // For bring-in determination
     void markStartOfStreet(); // Mark current hand size for new card tracking
+    void setHandRules(bool twoPlusThree, bool hiLo); // How the live hand combines hole and board cards
+    void addBoardCard(const Card& card); // Community card, seen by every seat
+    void clearBoardCards();
+    const IncrementalHand& getLiveHand() const;
     
     // Chip management
     void addChips(int amount);
@@ -94,11 +112,15 @@ public:
     
 private:
     // Decision helpers
-    double evaluateHandStrength() const;
+    double evaluateHandStrength(const HandHistory& history, const VariantInfo* variant) const;
     double calculatePotOdds(int callAmount, int potSize) const;
-    bool shouldFoldToAggression(const HandHistory& history, int callAmount) const;
+    bool shouldFoldToAggression(const HandHistory& history, int callAmount, const VariantInfo* variant) const;
     bool shouldBluff(const HandHistory& history) const;
     bool isHandPlayable() const; // Basic preflop hand selection
+    bool pushFoldDecision(const HandHistory& history, const VariantInfo& variant, bool canCheck,
+                          int callAmount, PlayerAction& action) const; // Short-stack Hold'em chart play
+    bool limitStrategyDecision(const HandHistory& history, const VariantInfo& variant, bool canCheck,
+                               PlayerAction& action) const; // Heads-up limit play from the solved strategy
 };
 
 #endif 
\ No newline at end of file
@@ -1,5 +1,16 @@
 #include "poker_game.h"
+#include "game_log.h"
+#include "equity.h"
+#include "preflop_equity.h"
+#include "fast_evaluator.h"
+#include "opponent_stats.h"
+#include "table_checkpoint.h"
+#include "profiler.h"
+#include "alloc_stats.h"
+#include "trace_writer.h"
+#include "metrics.h"
 #include <iostream>
+#include <iomanip>
 #include <set>
 #include <map>
 #include <algorithm>
@@ -7,11 +18,27 @@
 PokerGame::PokerGame(Table* gameTable, const VariantInfo& variant)
     : table(gameTable), variantInfo(variant), currentPlayerIndex(0), handComplete(false), 
       currentHandHasChoppedPot(false), handHistory(PokerVariant::TEXAS_HOLDEM, 1), 
-      currentRound(UNIFIED_PRE_FLOP), betCount(0), currentActionPotIndex(0) {
+      currentRound(UNIFIED_PRE_FLOP), betCount(0), currentActionPotIndex(0),
+      allInEquityEnabled(false), runItTimes(1), flowState(HandFlowState::STREET_START),
+      bettingHistoryRound(HandHistoryRound::PRE_FLOP), bettingActionCount(0), bettingRoundClosed(false),
+      bettingRoundSkipped(false), decisionProvider(nullptr), tableId(-1),
+      decisionSequence(0), boardAnte(0), opponentStats(nullptr), archiveRing(nullptr),
+      checkpoints(nullptr), checkpointSlot(-1), profileVariant(Profiler::variantSlot(variant.variantName)),
+      metricsVariant(Metrics::variantSlot(variant.variantName)),
+      traceHandStart(Trace::NOT_STARTED), traceRoundStart(Trace::NOT_STARTED) {
     // TODO: HandHistory needs to be updated to use VariantInfo instead of PokerVariant
+    table->getSidePotManager().setArena(&handArena);
+}
+
+PokerGame::~PokerGame() {
+    table->getSidePotManager().releaseArena(&handArena);
 }
 
 void PokerGame::showGameState() const {
+    ALLOC_SCOPE(AllocTag::RENDERING);
+    if (!GameLog::isEnabled()) return; // Nothing to show; skip building the table display
+    PROFILE_SCOPE(ProfilePhase::RENDERING);
+    
     if (variantInfo.gameStruct == GAMESTRUCTURE_STUD) {
         table->showTableForStud();
     } else {
@@ -26,17 +53,8 @@ std::vector<int> PokerGame::findWinners(const std::vector<int>& eligiblePlayers)
 
 // Common pot mechanics (same across all poker variants)
 void PokerGame::collectBetsToInFor() {
-    std::cout << "DEBUG: Starting collectBetsToInFor() - current action pot index: " << currentActionPotIndex << std::endl;
-    
-    // Show all player inFor amounts before processing
-    for (int i = 0; i < table->getPlayerCount(); i++) {
-        Player* player = table->getPlayer(i);
-        if (player) {
-            std::cout << "DEBUG: " << player->getName() << " has inFor: $" << player->getInFor() 
-                     << " (folded: " << (player->hasFolded() ? "yes" : "no") 
-                     << ", allIn: " << (player->isAllIn() ? "yes" : "no") << ")" << std::endl;
-        }
-    }
+    ALLOC_SCOPE(AllocTag::POTS);
+    PROFILE_SCOPE(ProfilePhase::COLLECT_BETS);
     
     // Check if anyone went all-in this round
     bool anyoneAllIn = false;
@@ -51,7 +69,7 @@ void PokerGame::collectBetsToInFor() {
     if (!anyoneAllIn) {
         // Simple case: no all-ins, just collect all money to current action pot
         int totalAmount = 0;
-        std::set<int> eligiblePlayers;
+        PlayerSet eligiblePlayers(table->getSidePotManager().getAllocator());
         
         for (int i = 0; i < table->getPlayerCount(); i++) {
             Player* player = table->getPlayer(i);
@@ -64,35 +82,85 @@ void PokerGame::collectBetsToInFor() {
         }
         
         if (totalAmount > 0) {
-            std::cout << "DEBUG: No all-ins, adding $" << totalAmount << " to current action pot " << currentActionPotIndex << std::endl;
-            
             if (currentActionPotIndex == 0) {
                 table->getSidePotManager().addToMainPot(totalAmount);
                 table->getSidePotManager().addEligiblePlayersToMainPot(eligiblePlayers);
             } else {
-                table->getSidePotManager().addSidePot(totalAmount, currentActionPotIndex, eligiblePlayers);
+                table->getSidePotManager().addToSidePot(currentActionPotIndex, totalAmount, eligiblePlayers);
             }
         }
     } else {
-        // Complex case: handle all-in side pots (we'll implement this properly later)
-        std::cout << "DEBUG: All-in detected, complex side pot logic needed" << std::endl;
-        // For now, just collect everything to main pot - we'll fix this later
-        int totalAmount = 0;
-        std::set<int> eligiblePlayers;
-        
+        PROFILE_SCOPE(ProfilePhase::SIDE_POTS);
+        // Layer this round's bets at each all-in amount: a player all-in for X wins at
+        // most X from each bettor, and the chips above go to a new pot for the rest
+        std::vector<int> levels;
+        int topBet = 0;
         for (int i = 0; i < table->getPlayerCount(); i++) {
             Player* player = table->getPlayer(i);
-            if (player && player->getInFor() > 0) {
-                totalAmount += player->getInFor();
-                if (!player->hasFolded()) {
-                    eligiblePlayers.insert(i);
+            if (!player) continue;
+            if (player->isAllIn() && !player->hasFolded() && player->getInFor() > 0) {
+                levels.push_back(player->getInFor());
+            }
+            topBet = std::max(topBet, player->getInFor());
+        }
+        levels.push_back(topBet);
+        std::sort(levels.begin(), levels.end());
+        levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+        
+        // A player who went all-in for exactly the bet in an earlier round caps the current
+        // pot too, so this round's bets start a new one
+        SidePotManager& potManager = table->getSidePotManager();
+        bool currentPotCapped = false;
+        if (currentActionPotIndex < potManager.getNumberOfPots()) {
+            for (int seat : potManager.getPots()[currentActionPotIndex].eligiblePlayers) {
+                Player* player = table->getPlayer(seat);
+                if (player && player->isAllIn() && !player->hasFolded() && player->getInFor() == 0) {
+                    currentPotCapped = true;
+                    break;
                 }
             }
         }
         
-        if (totalAmount > 0) {
-            table->getSidePotManager().addToMainPot(totalAmount);
-            table->getSidePotManager().addEligiblePlayersToMainPot(eligiblePlayers);
+        int previousLevel = 0;
+        for (int level : levels) {
+            int amount = 0;
+            PlayerSet eligiblePlayers(potManager.getAllocator());
+            for (int i = 0; i < table->getPlayerCount(); i++) {
+                Player* player = table->getPlayer(i);
+                if (!player) continue;
+                int inFor = player->getInFor();
+                amount += std::min(inFor, level) - std::min(inFor, previousLevel);
+                if (inFor >= level && !player->hasFolded()) {
+                    eligiblePlayers.insert(i);
+                }
+            }
+            
+            if (amount > 0 && eligiblePlayers.empty()) {
+                // Everyone who bet this far folded, so no one left can win these chips
+                for (int i = 0; i < table->getPlayerCount(); i++) {
+                    Player* player = table->getPlayer(i);
+                    if (!player) continue;
+                    int share = std::min(player->getInFor(), level) - std::min(player->getInFor(), previousLevel);
+                    if (share > 0) {
+                        player->addChips(share);
+                        GameLog::out() << player->getName() << " gets $" << share
+                                  << " returned (unmatched portion)" << std::endl;
+                    }
+                }
+            } else if (amount > 0) {
+                if (previousLevel > 0 || currentPotCapped) {
+                    // Bets above the last all-in: a new top pot that later rounds add to
+                    potManager.addSidePot(amount, level, eligiblePlayers);
+                    currentActionPotIndex = potManager.getNumberOfPots() - 1;
+                    currentPotCapped = false;
+                } else if (currentActionPotIndex == 0) {
+                    potManager.addToMainPot(amount);
+                    potManager.addEligiblePlayersToMainPot(eligiblePlayers);
+                } else {
+                    potManager.addToSidePot(currentActionPotIndex, amount, eligiblePlayers);
+                }
+            }
+            previousLevel = level;
         }
     }
     
@@ -108,15 +176,15 @@ void PokerGame::collectBetsToInFor() {
 }
 
 void PokerGame::handleAllInSidePots(int allInPlayerIndex) {
+    PROFILE_SCOPE(ProfilePhase::SIDE_POTS);
     Player* allInPlayer = table->getPlayer(allInPlayerIndex);
     if (!allInPlayer) return;
     
     int allInAmount = allInPlayer->getInFor();
-    std::cout << "DEBUG: All-in amount = $" << allInAmount << std::endl;
     
     // Collect matching amounts from ALL active players for current action pot
     int potTotal = 0;
-    std::set<int> eligiblePlayers;
+    PlayerSet eligiblePlayers(table->getSidePotManager().getAllocator());
     
     for (int i = 0; i < table->getPlayerCount(); i++) {
         Player* player = table->getPlayer(i);
@@ -125,13 +193,8 @@ void PokerGame::handleAllInSidePots(int allInPlayerIndex) {
             int matchAmount = std::min(player->getInFor(), allInAmount);
             if (matchAmount > 0) {
                 potTotal += matchAmount;
-                std::cout << "DEBUG: Player " << player->getName() << " matches $" << matchAmount 
-                         << " (had $" << player->getInFor() << ")" << std::endl;
-                
                 // Set player's inFor to remaining amount after match
                 player->setInFor(player->getInFor() - matchAmount);
-            } else {
-                std::cout << "DEBUG: Player " << player->getName() << " has no inFor to match" << std::endl;
             }
             
             // All active players are eligible for this pot
@@ -141,7 +204,6 @@ void PokerGame::handleAllInSidePots(int allInPlayerIndex) {
     
     // Add matched amount to current action pot
     if (potTotal > 0) {
-        std::cout << "DEBUG: Adding $" << potTotal << " to current action pot " << currentActionPotIndex << std::endl;
         if (currentActionPotIndex == 0) {
             // Adding to main pot
             table->getSidePotManager().addToMainPot(potTotal);
@@ -154,7 +216,7 @@ void PokerGame::handleAllInSidePots(int allInPlayerIndex) {
     
     // Check if any players still have money left - if so, create new side pot
     bool hasRemainingMoney = false;
-    std::set<int> remainingEligible;
+    PlayerSet remainingEligible(table->getSidePotManager().getAllocator());
     
     for (int i = 0; i < table->getPlayerCount(); i++) {
         Player* player = table->getPlayer(i);
@@ -236,9 +298,12 @@ bool PokerGame::playerAllIn(int playerIndex) {
     Player* player = table->getPlayer(playerIndex);
     if (!player) return false;
     
-    int allInAmount = player->getCurrentBet() + player->getChips();
+    int allInAmount = player->getInFor() + player->getChips();
     PlayerAction action = player->goAllIn();
-    table->setCurrentBet(allInAmount);
+    // An all-in for less than the bet doesn't lower what the others owe
+    if (allInAmount > table->getCurrentBet()) {
+        table->setCurrentBet(allInAmount);
+    }
     return action == PlayerAction::ALL_IN;
 }
 
@@ -250,7 +315,7 @@ bool PokerGame::playerCheck(int playerIndex) {
     int callAmount = currentBet - player->getInFor();
     
     if (callAmount > 0) {
-        std::cout << player->getName() << " cannot check - must call or fold" << std::endl;
+        GameLog::out() << player->getName() << " cannot check - must call or fold" << std::endl;
         return false;
     }
     
@@ -260,6 +325,7 @@ bool PokerGame::playerCheck(int playerIndex) {
 
 // Virtual showdown methods (default implementations)
 void PokerGame::awardPotsStaged() {
+    ALLOC_SCOPE(AllocTag::POTS);
     const auto& pots = table->getSidePotManager().getPots();
     
     // Award pots in reverse order (side pots first, main pot last)
@@ -268,13 +334,13 @@ void PokerGame::awardPotsStaged() {
         std::vector<int> eligiblePlayers(pot.eligiblePlayers.begin(), pot.eligiblePlayers.end());
         
         if (!eligiblePlayers.empty()) {
-            std::cout << "\n=== AWARDING ";
+            GameLog::out() << "\n=== AWARDING ";
             if (i == 0) {
-                std::cout << "MAIN POT ($" << pot.amount << ") ===";
+                GameLog::out() << "MAIN POT ($" << pot.amount << ") ===";
             } else {
-                std::cout << "SIDE POT " << i << " ($" << pot.amount << ") ===";
+                GameLog::out() << "SIDE POT " << i << " ($" << pot.amount << ") ===";
             }
-            std::cout << std::endl;
+            GameLog::out() << std::endl;
             
             awardPot(pot.amount, eligiblePlayers);
         }
@@ -283,7 +349,7 @@ void PokerGame::awardPotsStaged() {
 
 void PokerGame::awardPot(int potAmount, const std::vector<int>& eligiblePlayers) {
     if (eligiblePlayers.empty()) {
-        std::cout << "No eligible players for pot!" << std::endl;
+        GameLog::out() << "No eligible players for pot!" << std::endl;
         return;
     }
     
@@ -291,7 +357,7 @@ void PokerGame::awardPot(int potAmount, const std::vector<int>& eligiblePlayers)
     displayWinningHands(winners, eligiblePlayers);
     
     // Use Hi-Lo specific pot transfer for Hi-Lo games
-    if (variantInfo.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY) {
+    if (isHiLoSplit(variantInfo)) {
         transferHiLoPotsToWinners(potAmount);
     } else {
         transferPotToWinners(potAmount, winners);
@@ -301,7 +367,7 @@ void PokerGame::awardPot(int potAmount, const std::vector<int>& eligiblePlayers)
 void PokerGame::transferPotToWinners(int potAmount, const std::vector<int>& winners) {
     // Default implementation for standard high-only games (Hold'em, 7-Card Stud)
     if (winners.empty()) {
-        std::cout << "No winners found for pot!" << std::endl;
+        GameLog::out() << "No winners found for pot!" << std::endl;
         return;
     }
     
@@ -318,14 +384,14 @@ void PokerGame::transferPotToWinners(int potAmount, const std::vector<int>& winn
         if (winner) {
             int award = amountPerWinner + (i < static_cast<size_t>(remainder) ? 1 : 0);
             winner->addChips(award);
-            std::cout << winner->getName() << " wins $" << award << std::endl;
+            GameLog::out() << winner->getName() << " wins $" << award << std::endl;
         }
     }
 }
 
 void PokerGame::transferHiLoPotsToWinners(int potAmount) {
     if (hiWinners.empty() && loWinners.empty()) {
-        std::cout << "No winners found for Hi-Lo pot!" << std::endl;
+        GameLog::out() << "No winners found for Hi-Lo pot!" << std::endl;
         return;
     }
     
@@ -338,7 +404,7 @@ void PokerGame::transferHiLoPotsToWinners(int potAmount) {
     
     if (loWinners.empty()) {
         // No qualifying low - all money goes to high winners
-        std::cout << "No qualifying low hand - full pot goes to high" << std::endl;
+        GameLog::out() << "No qualifying low hand - full pot goes to high" << std::endl;
         int amountPerHiWinner = potAmount / static_cast<int>(hiWinners.size());
         int remainder = potAmount % static_cast<int>(hiWinners.size());
         
@@ -348,7 +414,7 @@ void PokerGame::transferHiLoPotsToWinners(int potAmount) {
                 int award = amountPerHiWinner + (i < static_cast<size_t>(remainder) ? 1 : 0);
                 winner->addChips(award);
                 totalAwarded += award;
-                std::cout << winner->getName() << " wins $" << award << " (high)" << std::endl;
+                GameLog::out() << winner->getName() << " wins $" << award << " (high)" << std::endl;
             }
         }
     } else {
@@ -367,7 +433,7 @@ void PokerGame::transferHiLoPotsToWinners(int potAmount) {
                     int award = amountPerHiWinner + (i < static_cast<size_t>(hiRemainder) ? 1 : 0);
                     winner->addChips(award);
                     totalAwarded += award;
-                    std::cout << winner->getName() << " wins $" << award << " (high)" << std::endl;
+                    GameLog::out() << winner->getName() << " wins $" << award << " (high)" << std::endl;
                 }
             }
         }
@@ -382,52 +448,43 @@ void PokerGame::transferHiLoPotsToWinners(int potAmount) {
                 int award = amountPerLoWinner + (i < static_cast<size_t>(loRemainder) ? 1 : 0);
                 winner->addChips(award);
                 totalAwarded += award;
-                std::cout << winner->getName() << " wins $" << award << " (low)" << std::endl;
+                GameLog::out() << winner->getName() << " wins $" << award << " (low)" << std::endl;
             }
         }
     }
     
     // Verify we awarded exactly the pot amount
     if (totalAwarded != potAmount) {
-        std::cout << "ERROR: Pot awarding mismatch! Pot: $" << potAmount << ", Awarded: $" << totalAwarded << std::endl;
+        GameLog::out() << "ERROR: Pot awarding mismatch! Pot: $" << potAmount << ", Awarded: $" << totalAwarded << std::endl;
     }
 }
 
 // Utility functions for showdown
 std::vector<int> PokerGame::findBestHand(const std::vector<int>& eligiblePlayers) {
+    ALLOC_SCOPE(AllocTag::EVALUATION);
+    PROFILE_SCOPE(ProfilePhase::FIND_BEST_HAND);
     if (eligiblePlayers.empty()) {
         return {};
     }
     
     // Check if this is a hi-lo split pot variant
-    if (variantInfo.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY) {
+    if (isHiLoSplit(variantInfo)) {
         return findHiLoWinners(eligiblePlayers);
     }
     
-    // Standard high-only pot logic
-    HandResult bestHand;
-    bestHand.rank = HandRank::HIGH_CARD;
+    // Standard high-only pot logic: each seat's live hand already holds its best value
+    int bestValue = -1;
     std::vector<int> winners;
     
     for (int playerIndex : eligiblePlayers) {
         Player* player = table->getPlayer(playerIndex);
         if (player && !player->hasFolded()) {
-            HandResult hand;
-            
-            // Use appropriate hand evaluation based on variant
-            if (variantInfo.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE) {
-                // Omaha: must use exactly 2 hole + 3 community
-                hand = evaluateOmahaHand(player->getHand(), table->getCommunityCards());
-            } else {
-                // Hold'em/Stud: use any 5 cards
-                hand = HandEvaluator::evaluateHand(player->getHand(), table->getCommunityCards());
-            }
-            
-            if (hand > bestHand) {
-                bestHand = hand;
+            int value = player->getLiveHand().getHighValue();
+            if (value > bestValue) {
+                bestValue = value;
                 winners.clear();
                 winners.push_back(playerIndex);
-            } else if (hand == bestHand) {
+            } else if (value == bestValue) {
                 winners.push_back(playerIndex);
             }
         }
@@ -437,8 +494,12 @@ std::vector<int> PokerGame::findBestHand(const std::vector<int>& eligiblePlayers
 }
 
 void PokerGame::displayWinningHands(const std::vector<int>& winners, const std::vector<int>& eligiblePlayers) const {
+    ALLOC_SCOPE(AllocTag::RENDERING);
+    if (!GameLog::isEnabled()) return; // Display only - skip re-evaluating every hand
+    PROFILE_SCOPE(ProfilePhase::RENDERING);
+    
     // Check if this is a hi-lo split pot variant
-    if (variantInfo.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY) {
+    if (isHiLoSplit(variantInfo)) {
         displayHiLoWinningHands(winners, eligiblePlayers);
         return;
     }
@@ -460,11 +521,11 @@ void PokerGame::displayWinningHands(const std::vector<int>& winners, const std::
             }
             
             bool isWinner = std::find(winners.begin(), winners.end(), playerIndex) != winners.end();
-            std::cout << player->getName() << ": " << hand.description;
+            GameLog::out() << player->getName() << ": " << hand.description;
             if (isWinner) {
-                std::cout << " (WINNER)";
+                GameLog::out() << " (WINNER)";
             }
-            std::cout << std::endl;
+            GameLog::out() << std::endl;
         }
     }
 }
@@ -477,17 +538,29 @@ void PokerGame::splitPotAmongWinners(int potAmount, const std::vector<int>& winn
     int amountPerWinner = potAmount / static_cast<int>(winners.size());
     int remainder = potAmount % static_cast<int>(winners.size());
     
-    std::cout << "Pot split: $" << amountPerWinner << " each";
+    GameLog::out() << "Pot split: $" << amountPerWinner << " each";
     if (remainder > 0) {
-        std::cout << " (+" << remainder << " to first " << remainder << " winner" << (remainder > 1 ? "s" : "") << ")";
+        GameLog::out() << " (+" << remainder << " to first " << remainder << " winner" << (remainder > 1 ? "s" : "") << ")";
     }
-    std::cout << std::endl;
+    GameLog::out() << std::endl;
 }
 
 // Common betting round management methods
+PokerVariant PokerGame::historyVariant(const VariantInfo& variant) {
+    if (variant.gameStruct == GAMESTRUCTURE_STUD) return PokerVariant::SEVEN_CARD_STUD;
+    if (isHiLoSplit(variant)) return PokerVariant::OMAHA_HI_LO;
+    return PokerVariant::TEXAS_HOLDEM;
+}
+
 void PokerGame::initializeHandHistory(int handNumber) {
-    // TODO: Update HandHistory to use VariantInfo instead of PokerVariant
-    handHistory = HandHistory(PokerVariant::TEXAS_HOLDEM, handNumber);
+    // Nothing may point into the arena when it is reset: drop the last hand's history and pots first
+    handHistory = HandHistory(historyVariant(variantInfo), handNumber);
+    table->getSidePotManager().clearPots();
+    handArena.reset();
+    handHistory = HandHistory(historyVariant(variantInfo), handNumber, &handArena);
+    if (archiveRing) {
+        handHistory.setArchive(archiveRing, tableId);
+    }
     hasActedThisRound.assign(table->getPlayerCount(), false);
     
     // Add all players to hand history
@@ -498,10 +571,17 @@ void PokerGame::initializeHandHistory(int handNumber) {
             handHistory.addPlayer(player->getPlayerId(), player->getName(), i, player->getChips(), isDealer);
         }
     }
+    if (opponentStats) {
+        opponentStats->beginHand(handHistory.getPlayers());
+    }
 }
 
 void PokerGame::recordPlayerAction(HandHistoryRound round, int playerId, ActionType actionType, int amount, const std::string& description) {
     handHistory.recordAction(round, playerId, actionType, amount, table->getCurrentBet(), description);
+    countLastAction();
+    if (opponentStats) {
+        opponentStats->recordAction(handHistory.getActions().back());
+    }
 }
 
 bool PokerGame::isBettingComplete() const {
@@ -574,11 +654,44 @@ void PokerGame::resetBettingRound() {
 }
 
 void PokerGame::completeBettingRound(HandHistoryRound historyRound) {
+    PROFILE_SCOPE(ProfilePhase::BETTING_ROUND);
+    beginBettingRound(historyRound);
+    
+    while (bettingRoundNeedsDecision()) {
+        int playerIndex = currentPlayerIndex;
+        applyDecision(playerIndex, builtInDecision(playerIndex));
+    }
+    
+    finishBettingRound();
+}
+
+Decision PokerGame::builtInDecision(int playerIndex) const {
+    TraceSpan span("decision", tableId);
+    const Player* player = table->getPlayer(playerIndex);
+    int callAmount = table->getCurrentBet() - player->getInFor();
+    bool canCheck = (callAmount <= 0);
+    
+    Decision decision;
+    decision.action = player->makeDecision(handHistory, callAmount, canCheck, &variantInfo, betCount);
+    decision.raiseAmount = 0;
+    return decision;
+}
+
+void PokerGame::saveCheckpoint() {
+    if (checkpoints) {
+        checkpoints->save(checkpointSlot, *this);
+    }
+}
+
+void PokerGame::beginBettingRound(HandHistoryRound historyRound) {
     // Reset betting round state at the start of each betting round
     resetBettingRound();
-    
-    int actionCount = 0;
-    const int MAX_ACTIONS = 150; // Allow for multiple raises with many players
+    bettingHistoryRound = historyRound;
+    ALLOC_STREET(historyRound);
+    traceRoundStart = Trace::now();
+    bettingActionCount = 0;
+    bettingRoundClosed = false;
+    bettingRoundSkipped = false;
     
     // Special handling for Stud third street - show bring-in as first action
     if (variantInfo.gameStruct == GAMESTRUCTURE_STUD && historyRound == HandHistoryRound::PRE_FLOP) {
@@ -588,7 +701,7 @@ void PokerGame::completeBettingRound(HandHistoryRound historyRound) {
             Player* player = table->getPlayer(i);
             if (player && !player->hasFolded() && player->getInFor() > 0) {
                 showGameState();
-                std::cout << player->getName() << " brings in for $" << player->getInFor() << std::endl;
+                GameLog::out() << player->getName() << " brings in for $" << player->getInFor() << std::endl;
                 bringInPlayerIndex = i;
                 break;
             }
@@ -601,98 +714,137 @@ void PokerGame::completeBettingRound(HandHistoryRound historyRound) {
     
     // Quick exit if only one player remains
     if (countActivePlayers() <= 1) {
-        return;
+        bettingRoundSkipped = true;
     }
+}
+
+bool PokerGame::bettingRoundNeedsDecision() const {
+    const int MAX_ACTIONS = 150; // Allow for multiple raises with many players
     
-    while (!isBettingComplete() && actionCount < MAX_ACTIONS && countActivePlayers() > 1) {
-        int playerIndex = currentPlayerIndex;
-        
-        if (playerIndex == -1 || !canPlayerAct(playerIndex)) {
-            break;
+    if (bettingRoundSkipped || bettingRoundClosed) return false;
+    if (isBettingComplete() || bettingActionCount >= MAX_ACTIONS || countActivePlayers() <= 1) return false;
+    if (currentPlayerIndex == -1 || !canPlayerAct(currentPlayerIndex)) return false;
+    return table->getPlayer(currentPlayerIndex) != nullptr;
+}
+
+DecisionRequest PokerGame::buildDecisionRequest(int playerIndex) const {
+    const Player* player = table->getPlayer(playerIndex);
+    
+    DecisionRequest request;
+    request.tableId = tableId;
+    request.seat = playerIndex;
+    request.playerId = player ? player->getPlayerId() : -1;
+    request.currentBet = table->getCurrentBet();
+    request.callAmount = request.currentBet - (player ? player->getInFor() : 0);
+    request.canCheck = (request.callAmount <= 0);
+    request.betCount = betCount;
+    request.round = currentRound;
+    request.historyRound = bettingHistoryRound;
+    request.sequence = decisionSequence;
+    return request;
+}
+
+void PokerGame::applyDecision(int playerIndex, const Decision& decision) {
+    ALLOC_SCOPE(AllocTag::BETTING);
+    Player* player = table->getPlayer(playerIndex);
+    if (!player) return;
+    
+    int currentBet = table->getCurrentBet();
+    int callAmount = currentBet - player->getInFor();
+    int recordedAmount = callAmount;
+    
+    // A raise that doesn't go above the current bet is a call (or a check)
+    PlayerAction action = decision.action;
+    int raiseAmount = 0;
+    if (action == PlayerAction::RAISE) {
+        raiseAmount = decision.raiseAmount > 0 ? decision.raiseAmount
+                    : player->calculateRaiseAmount(handHistory, currentBet, variantInfo, currentRound);
+        if (raiseAmount <= currentBet) {
+            action = callAmount > 0 ? PlayerAction::CALL : PlayerAction::CHECK;
         }
-        
-        Player* player = table->getPlayer(playerIndex);
-        if (!player) {
+    }
+    // Nobody checks while owing chips; that's a fold
+    if (action == PlayerAction::CHECK && callAmount > 0) {
+        action = PlayerAction::FOLD;
+    }
+    
+    // Execute the player's decision
+    std::string actionDesc;
+    switch (action) {
+        case PlayerAction::FOLD:
+            playerFold(playerIndex);
+            actionDesc = "folds";
             break;
-        }
-        
-        int currentBet = table->getCurrentBet();
-        int callAmount = currentBet - player->getInFor();
-        bool canCheck = (callAmount <= 0);
-        
-        PlayerAction decision = player->makeDecision(handHistory, callAmount, canCheck, &variantInfo, betCount);
-        
-        // Execute the player's decision
-        std::string actionDesc;
-        switch (decision) {
-            case PlayerAction::FOLD:
-                playerFold(playerIndex);
-                actionDesc = "folds";
-                break;
-            case PlayerAction::CHECK:
-                playerCheck(playerIndex);
-                actionDesc = "checks";
-                break;
-            case PlayerAction::CALL:
-                playerCall(playerIndex);
-                actionDesc = "calls $" + std::to_string(player->getInFor());
-                break;
-            case PlayerAction::RAISE: {
-                int raiseAmount = player->calculateRaiseAmount(handHistory, currentBet, variantInfo, currentRound);
-                playerRaise(playerIndex, raiseAmount);
-                if (currentBet == 0) {
-                    actionDesc = "bets $" + std::to_string(raiseAmount);
-                } else {
-                    actionDesc = "raises to $" + std::to_string(raiseAmount);
-                }
-                // Increment bet count for limit games
-                if (variantInfo.bettingStruct == BETTINGSTRUCTURE_LIMIT) {
-                    betCount++;
-                }
-                
-                // When someone raises, players who now owe money need to act again
-                int newCurrentBet = table->getCurrentBet();
-                for (int i = 0; i < table->getPlayerCount(); i++) {
-                    Player* otherPlayer = table->getPlayer(i);
-                    if (otherPlayer && !otherPlayer->hasFolded() && !otherPlayer->isAllIn() && 
-                        i != playerIndex && otherPlayer->getInFor() < newCurrentBet) {
-                        hasActedThisRound[i] = false; // They need to act again
-                    }
+        case PlayerAction::CHECK:
+            playerCheck(playerIndex);
+            actionDesc = "checks";
+            break;
+        case PlayerAction::CALL:
+            playerCall(playerIndex);
+            actionDesc = "calls $" + std::to_string(player->getInFor());
+            break;
+        case PlayerAction::RAISE: {
+            playerRaise(playerIndex, raiseAmount);
+            recordedAmount = raiseAmount;
+            if (currentBet == 0) {
+                actionDesc = "bets $" + std::to_string(raiseAmount);
+            } else {
+                actionDesc = "raises to $" + std::to_string(raiseAmount);
+            }
+            // Increment bet count for limit games
+            if (variantInfo.bettingStruct == BETTINGSTRUCTURE_LIMIT) {
+                betCount++;
+            }
+            
+            // When someone raises, players who now owe money need to act again
+            int newCurrentBet = table->getCurrentBet();
+            for (int i = 0; i < table->getPlayerCount(); i++) {
+                Player* otherPlayer = table->getPlayer(i);
+                if (otherPlayer && !otherPlayer->hasFolded() && !otherPlayer->isAllIn() && 
+                    i != playerIndex && otherPlayer->getInFor() < newCurrentBet) {
+                    hasActedThisRound[i] = false; // They need to act again
                 }
-                break;
             }
-            case PlayerAction::ALL_IN:
-                playerAllIn(playerIndex);
-                actionDesc = "goes all-in for $" + std::to_string(player->getInFor());
-                std::cout << "DEBUG: " << player->getName() << " went all-in for $" << player->getInFor() << std::endl;
-                break;
-        }
-        
-        // Display the action
-        std::cout << player->getName() << " " << actionDesc << std::endl;
-        
-        // Record the action in hand history
-        recordPlayerAction(historyRound, player->getPlayerId(), 
-                          static_cast<ActionType>(decision), 
-                          (decision == PlayerAction::RAISE) ? player->calculateRaiseAmount(handHistory, currentBet, variantInfo, currentRound) : callAmount,
-                          actionDesc);
-        
-        // Mark player as having acted
-        hasActedThisRound[playerIndex] = true;
-        
-        // Advance to next player
-        advanceToNextPlayer();
-        actionCount++;
-        
-        // Emergency break: if everyone is just checking repeatedly, force round to end
-        if (actionCount >= 6 && decision == PlayerAction::CHECK) {
-            // If we've had 6+ consecutive checks, betting round should be over
             break;
         }
+        case PlayerAction::ALL_IN:
+            playerAllIn(playerIndex);
+            actionDesc = "goes all-in for $" + std::to_string(player->getInFor());
+            break;
     }
     
+    // Display the action
+    GameLog::out() << player->getName() << " " << actionDesc << std::endl;
+    
+    // Record the action in hand history
+    recordPlayerAction(bettingHistoryRound, player->getPlayerId(), 
+                      static_cast<ActionType>(action), recordedAmount, actionDesc);
+    
+    // Mark player as having acted
+    hasActedThisRound[playerIndex] = true;
+    
+    // Advance to next player
+    advanceToNextPlayer();
+    bettingActionCount++;
+    decisionSequence++;
+    
+    // Emergency break: checks only come in a round's first orbit, so one after two
+    // orbits means the round is stuck and must end
+    if (action == PlayerAction::CHECK && bettingActionCount > 2 * table->getPlayerCount()) {
+        bettingRoundClosed = true;
+    }
+    saveCheckpoint();
+}
+
+void PokerGame::finishBettingRound() {
     // Collect the inFor amounts to pots
-    collectBetsToInFor();
+    if (!bettingRoundSkipped) {
+        collectBetsToInFor();
+    }
+    static const char* spanNames[] = {"pre-hand", "pre-flop betting", "flop betting", "turn betting",
+                                      "river betting", "showdown"};
+    Trace::complete(spanNames[static_cast<int>(bettingHistoryRound)], tableId, traceRoundStart);
+    traceRoundStart = Trace::NOT_STARTED;
 }
 
 // Generic hand completion logic (same for all poker variants)
@@ -703,15 +855,32 @@ bool PokerGame::isHandComplete() const {
 
 // Unified game flow implementation
 void PokerGame::startNewHand() {
+    PROFILE_VARIANT(profileVariant);
+    ArenaScope arenaScope(&handArena);
+    ALLOC_STREET(HandHistoryRound::PRE_HAND);
+    traceHandStart = Trace::now();
     currentRound = UNIFIED_PRE_FLOP;
     handComplete = false;
     currentHandHasChoppedPot = false;
     hasActedThisRound.assign(table->getPlayerCount(), false);
     currentActionPotIndex = 0; // All money goes to main pot initially
+    allInExpectedChips.clear();
+    runBoards.clear();
+    flowState = HandFlowState::STREET_START;
     
     // Initialize hand history
     initializeHandHistory(1);
     
+    // Live hands follow this variant's hole/board rules as cards are dealt
+    bool twoPlusThree = (variantInfo.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE);
+    bool hiLo = isHiLoSplit(variantInfo);
+    for (int i = 0; i < table->getPlayerCount(); i++) {
+        Player* player = table->getPlayer(i);
+        if (player) {
+            player->setHandRules(twoPlusThree, hiLo);
+        }
+    }
+    
     // Deal initial cards based on variant
     dealInitialCards();
     
@@ -727,12 +896,18 @@ void PokerGame::startNewHand() {
         // UTG (3 seats after dealer for board games)
         int dealerPos = table->getDealerPosition();
         currentPlayerIndex = (dealerPos + 3) % table->getPlayerCount();
+        if (!canPlayerAct(currentPlayerIndex)) {
+            advanceToNextPlayer(); // All in from the ante or a blind
+        }
     } else {
         // Stud: player with bring-in acts first (set in postAntesAndBringIn)
     }
+    saveCheckpoint();
 }
 
 void PokerGame::dealInitialCards() {
+    ALLOC_SCOPE(AllocTag::DEALING);
+    PROFILE_SCOPE(ProfilePhase::DEALING);
     if (variantInfo.gameStruct == GAMESTRUCTURE_BOARD) {
         // Deal hole cards based on variant
         int numHoleCards = (variantInfo.numHoleCards == NUMHOLECARDS_TWO) ? 2 : 4;
@@ -745,6 +920,15 @@ void PokerGame::dealInitialCards() {
                 }
             }
         }
+        // Every seat's hole cards go into the history so the hand can be replayed
+        for (int i = 0; i < table->getPlayerCount(); i++) {
+            Player* player = table->getPlayer(i);
+            if (player) {
+                handHistory.recordHoleCards(HandHistoryRound::PRE_HAND, player->getPlayerId(), player->getHand(),
+                                            "Hole cards");
+                countLastAction();
+            }
+        }
     } else if (variantInfo.gameStruct == GAMESTRUCTURE_STUD) {
         // Deal 2 down, 1 up for seven card stud
         for (int i = 0; i < table->getPlayerCount(); i++) {
@@ -755,6 +939,9 @@ void PokerGame::dealInitialCards() {
                 player->addCard(table->getDeck().dealCard(), false);
                 // One up card
                 player->addCard(table->getDeck().dealCard(), true);
+                handHistory.recordHoleCards(HandHistoryRound::PRE_HAND, player->getPlayerId(), player->getHand(),
+                                            "Third street");
+                countLastAction();
             }
         }
         // Mark initial 3rd street cards as not "new" so they don't get asterisks
@@ -768,13 +955,9 @@ void PokerGame::dealInitialCards() {
 }
 
 void PokerGame::runBettingRounds() {
-    switch (variantInfo.gameStruct) {
-        case GAMESTRUCTURE_BOARD:
-            gameFlowForBOARD();
-            break;
-        case GAMESTRUCTURE_STUD:
-            gameFlowForSTUD();
-            break;
+    // Runs to completion unless an external decision provider suspends the hand
+    if (advance() != GameStepResult::HAND_COMPLETE) {
+        return;
     }
     
     // Conduct showdown if we reached it
@@ -783,128 +966,509 @@ void PokerGame::runBettingRounds() {
     }
 }
 
-void PokerGame::gameFlowForBOARD() {
-    while (!isHandComplete()) {
-        if (currentRound == UNIFIED_PRE_FLOP) {
-            std::cout << "\n=== PRE-FLOP ===" << std::endl;
-            showGameState();
-            completeBettingRound(HandHistoryRound::PRE_FLOP);
-            nextRound();
-        } else if (currentRound == UNIFIED_FLOP) {
-            std::cout << "\n=== FLOP ===" << std::endl;
-            table->dealFlop();
-            showGameState();
-            completeBettingRound(HandHistoryRound::FLOP);
-            nextRound();
-        } else if (currentRound == UNIFIED_TURN) {
-            std::cout << "\n=== TURN ===" << std::endl;
-            table->dealTurn();
-            showGameState();
-            completeBettingRound(HandHistoryRound::TURN);
-            nextRound();
-        } else if (currentRound == UNIFIED_RIVER) {
-            std::cout << "\n=== RIVER ===" << std::endl;
-            table->dealRiver();
-            showGameState();
-            completeBettingRound(HandHistoryRound::RIVER);
-            currentRound = UNIFIED_SHOWDOWN;
-        }
-    }
-}
-
-void PokerGame::gameFlowForSTUD() {
-    while (!isHandComplete()) {
-        if (currentRound == UNIFIED_PRE_FLOP) { // Third street
-            std::cout << "\n=== THIRD STREET ===" << std::endl;
-            // Don't show game state before betting - bring-in will be shown as first action
-            completeBettingRound(HandHistoryRound::PRE_FLOP);
-            nextRound();
-        } else if (currentRound == UNIFIED_FLOP) { // Fourth street
-            std::cout << "\n=== FOURTH STREET ===" << std::endl;
-            // Mark start of new street for all players
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->markStartOfStreet();
+GameStepResult PokerGame::advance() {
+    PROFILE_VARIANT(profileVariant);
+    ArenaScope arenaScope(&handArena);
+    while (true) {
+        switch (flowState) {
+            case HandFlowState::STREET_START: {
+                if (isHandComplete()) {
+                    flowState = HandFlowState::COMPLETE;
+                    break;
                 }
-            }
-            // Deal one up card to each player
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->addCard(table->getDeck().dealCard(), true);
+                if (currentRound != UNIFIED_PRE_FLOP && isActionClosed()) {
+                    runOutRemainingCards();
+                    break;
                 }
-            }
-            showGameState();
-            // Set betting order based on highest up cards
-            currentPlayerIndex = findStudFirstToAct();
-            completeBettingRound(HandHistoryRound::FLOP);
-            nextRound();
-        } else if (currentRound == UNIFIED_TURN) { // Fifth street
-            std::cout << "\n=== FIFTH STREET ===" << std::endl;
-            // Mark start of new street for all players
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->markStartOfStreet();
+                
+                HandHistoryRound historyRound = (variantInfo.gameStruct == GAMESTRUCTURE_STUD)
+                    ? beginStreetForSTUD() : beginStreetForBOARD();
+                
+                if (!decisionProvider) {
+                    // Built-in AI answers synchronously - run the whole round in one go.
+                    // Checkpoints taken during the round resume it from BETTING.
+                    flowState = HandFlowState::BETTING;
+                    completeBettingRound(historyRound);
+                    endStreet();
+                    flowState = HandFlowState::STREET_START;
+                } else {
+                    beginBettingRound(historyRound);
+                    flowState = HandFlowState::BETTING;
+                    saveCheckpoint();
                 }
+                break;
             }
-            // Deal one up card to each player
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->addCard(table->getDeck().dealCard(), true);
+            
+            case HandFlowState::BETTING: {
+                if (!bettingRoundNeedsDecision()) {
+                    finishBettingRound();
+                    endStreet();
+                    flowState = HandFlowState::STREET_START;
+                    break;
                 }
-            }
-            showGameState();
-            // Set betting order based on highest up cards
-            currentPlayerIndex = findStudFirstToAct();
-            completeBettingRound(HandHistoryRound::TURN);
-            nextRound();
-        } else if (currentRound == UNIFIED_RIVER) { // Sixth street
-            std::cout << "\n=== SIXTH STREET ===" << std::endl;
-            // Mark start of new street for all players
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->markStartOfStreet();
+                
+                int playerIndex = currentPlayerIndex;
+                Decision decision;
+                if (!decisionProvider) {
+                    decision = builtInDecision(playerIndex); // Restored from a checkpoint mid-round
+                } else if (!requestTracedDecision(playerIndex, decision)) {
+                    flowState = HandFlowState::AWAITING_DECISION;
+                    saveCheckpoint();
+                    return GameStepResult::AWAITING_DECISION;
                 }
+                applyDecision(playerIndex, decision);
+                break;
             }
-            // Deal one up card to each player
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->addCard(table->getDeck().dealCard(), true);
-                }
+            
+            case HandFlowState::AWAITING_DECISION:
+                return GameStepResult::AWAITING_DECISION;
+            
+            case HandFlowState::COMPLETE:
+                return GameStepResult::HAND_COMPLETE;
+        }
+    }
+}
+
+bool PokerGame::requestTracedDecision(int playerIndex, Decision& decision) {
+    TraceSpan span("decision", tableId);
+    return decisionProvider->requestDecision(*this, buildDecisionRequest(playerIndex), decision);
+}
+
+bool PokerGame::submitDecision(const Decision& decision) {
+    PROFILE_VARIANT(profileVariant);
+    ArenaScope arenaScope(&handArena);
+    if (flowState != HandFlowState::AWAITING_DECISION) {
+        return false;
+    }
+    
+    flowState = HandFlowState::BETTING;
+    applyDecision(currentPlayerIndex, decision);
+    return true;
+}
+
+bool PokerGame::isAwaitingDecision() const {
+    return flowState == HandFlowState::AWAITING_DECISION;
+}
+
+DecisionRequest PokerGame::getPendingRequest() const {
+    return buildDecisionRequest(currentPlayerIndex);
+}
+
+void PokerGame::finishHand() {
+    PROFILE_VARIANT(profileVariant);
+    ArenaScope arenaScope(&handArena);
+    ALLOC_STREET(HandHistoryRound::SHOWDOWN);
+    std::vector<int> chipsBefore;
+    for (int i = 0; i < table->getPlayerCount(); i++) {
+        Player* player = table->getPlayer(i);
+        chipsBefore.push_back(player ? player->getChips() : 0);
+    }
+    
+    bool showdown = atShowdown();
+    if (showdown) {
+        conductShowdown();
+    } else if (isHandComplete()) {
+        // Everyone folded except one player - award pot without showdown
+        awardPotsWithoutShowdown();
+    }
+    recordResolution(chipsBefore);
+    if (opponentStats) {
+        opponentStats->endHand(showdown);
+    }
+    countHandMetrics(showdown);
+    handComplete = true;
+    saveCheckpoint();
+    Trace::complete("hand", tableId, traceHandStart);
+    traceHandStart = Trace::NOT_STARTED;
+    ALLOC_STREET(HandHistoryRound::PRE_HAND); // Anything until the next deal is setup for the next hand
+}
+
+void PokerGame::countLastAction() const {
+    Metrics::countAction(static_cast<int>(handHistory.getActions().back().actionType));
+}
+
+void PokerGame::countHandMetrics(bool showdown) const {
+    Metrics::countHand(metricsVariant);
+    if (showdown) {
+        Metrics::countShowdown();
+    }
+}
+
+void PokerGame::recordResolution(const std::vector<int>& chipsBefore) {
+    std::vector<int> winners;
+    std::vector<int> amounts;
+    std::string description;
+    for (int i = 0; i < table->getPlayerCount() && i < static_cast<int>(chipsBefore.size()); i++) {
+        Player* player = table->getPlayer(i);
+        if (!player || player->getChips() <= chipsBefore[i]) continue;
+        int won = player->getChips() - chipsBefore[i];
+        winners.push_back(player->getPlayerId());
+        amounts.push_back(won);
+        if (!description.empty()) description += ", ";
+        description += player->getName() + " wins $" + std::to_string(won);
+    }
+    handHistory.recordResolution(winners, amounts, description);
+}
+
+HandHistoryRound PokerGame::beginStreetForBOARD() {
+    ALLOC_SCOPE(AllocTag::DEALING);
+    if (currentRound == UNIFIED_PRE_FLOP) {
+        GameLog::out() << "\n=== PRE-FLOP ===" << std::endl;
+        showGameState();
+        return HandHistoryRound::PRE_FLOP;
+    } else if (currentRound == UNIFIED_FLOP) {
+        GameLog::out() << "\n=== FLOP ===" << std::endl;
+        table->dealFlop();
+        recordBoardReveal(HandHistoryRound::FLOP, 3, "Flop");
+        showGameState();
+        return HandHistoryRound::FLOP;
+    } else if (currentRound == UNIFIED_TURN) {
+        GameLog::out() << "\n=== TURN ===" << std::endl;
+        table->dealTurn();
+        recordBoardReveal(HandHistoryRound::TURN, 1, "Turn");
+        showGameState();
+        return HandHistoryRound::TURN;
+    }
+    
+    GameLog::out() << "\n=== RIVER ===" << std::endl;
+    table->dealRiver();
+    recordBoardReveal(HandHistoryRound::RIVER, 1, "River");
+    showGameState();
+    return HandHistoryRound::RIVER;
+}
+
+void PokerGame::recordBoardReveal(HandHistoryRound round, int count, const std::string& description) {
+    const std::vector<Card>& board = table->getCommunityCards();
+    std::vector<Card> revealed(board.end() - std::min<size_t>(count, board.size()), board.end());
+    handHistory.recordCardDeal(round, revealed, description);
+    countLastAction();
+    if (opponentStats) {
+        opponentStats->recordAction(handHistory.getActions().back());
+    }
+}
+
+HandHistoryRound PokerGame::beginStreetForSTUD() {
+    ALLOC_SCOPE(AllocTag::DEALING);
+    if (currentRound == UNIFIED_PRE_FLOP) { // Third street
+        GameLog::out() << "\n=== THIRD STREET ===" << std::endl;
+        // Don't show game state before betting - bring-in will be shown as first action
+        return HandHistoryRound::PRE_FLOP;
+    }
+    
+    HandHistoryRound historyRound;
+    bool faceUp = true;
+    if (currentRound == UNIFIED_FLOP) {
+        GameLog::out() << "\n=== FOURTH STREET ===" << std::endl;
+        historyRound = HandHistoryRound::FLOP;
+    } else if (currentRound == UNIFIED_TURN) {
+        GameLog::out() << "\n=== FIFTH STREET ===" << std::endl;
+        historyRound = HandHistoryRound::TURN;
+    } else if (currentRound == UNIFIED_RIVER) {
+        GameLog::out() << "\n=== SIXTH STREET ===" << std::endl;
+        historyRound = HandHistoryRound::RIVER;
+    } else {
+        GameLog::out() << "\n=== SEVENTH STREET ===" << std::endl;
+        historyRound = HandHistoryRound::SHOWDOWN;
+        faceUp = false; // Final card is dealt down
+    }
+    
+    // Mark start of new street for all players
+    for (int i = 0; i < table->getPlayerCount(); i++) {
+        Player* player = table->getPlayer(i);
+        if (player && !player->hasFolded()) {
+            player->markStartOfStreet();
+        }
+    }
+    // Deal one card to each player
+    {
+        PROFILE_SCOPE(ProfilePhase::DEALING);
+        for (int i = 0; i < table->getPlayerCount(); i++) {
+            Player* player = table->getPlayer(i);
+            if (player && !player->hasFolded()) {
+                player->addCard(table->getDeck().dealCard(), faceUp);
+                handHistory.recordHoleCards(historyRound, player->getPlayerId(), {player->getHand().back()}, "Dealt");
+                countLastAction();
+            }
+        }
+    }
+    showGameState();
+    // Set betting order based on highest up cards; an all-in high hand passes to the next seat
+    currentPlayerIndex = findStudFirstToAct();
+    if (currentPlayerIndex >= 0 && !canPlayerAct(currentPlayerIndex)) {
+        advanceToNextPlayer();
+    }
+    return historyRound;
+}
+
+void PokerGame::endStreet() {
+    // Board games are done after the river, Stud after seventh street
+    bool lastStreet = (variantInfo.gameStruct == GAMESTRUCTURE_STUD) ? (currentRound == UNIFIED_FINAL)
+                                                                     : (currentRound == UNIFIED_RIVER);
+    if (lastStreet) {
+        currentRound = UNIFIED_SHOWDOWN;
+    } else {
+        nextRound();
+    }
+}
+
+bool PokerGame::isActionClosed() const {
+    // Two or more players still contesting the pot, but at most one of them has chips behind
+    return countActivePlayers() > 1 && allRemainingPlayersAllIn();
+}
+
+void PokerGame::runOutRemainingCards() {
+    ALLOC_SCOPE(AllocTag::DEALING);
+    ALLOC_STREET(HandHistoryRound::SHOWDOWN);
+    GameLog::out() << "\n=== ALL-IN RUNOUT ===" << std::endl;
+    
+    if (allInEquityEnabled) {
+        computeAllInEquity();
+    }
+    
+    if (variantInfo.gameStruct == GAMESTRUCTURE_BOARD && runItTimes > 1) {
+        dealMultipleRuns();
+    } else if (variantInfo.gameStruct == GAMESTRUCTURE_BOARD) {
+        int boardBefore = static_cast<int>(table->getCommunityCards().size());
+        table->dealRemainingBoard();
+        recordBoardReveal(HandHistoryRound::SHOWDOWN, static_cast<int>(table->getCommunityCards().size()) - boardBefore,
+                          "Runout");
+    } else {
+        // Deal every remaining street in order; all runout cards are marked as new
+        for (int i = 0; i < table->getPlayerCount(); i++) {
+            Player* player = table->getPlayer(i);
+            if (player && !player->hasFolded()) {
+                player->markStartOfStreet();
             }
-            showGameState();
-            // Set betting order based on highest up cards
-            currentPlayerIndex = findStudFirstToAct();
-            completeBettingRound(HandHistoryRound::RIVER);
-            nextRound();
-        } else if (currentRound == UNIFIED_FINAL) { // Seventh street
-            std::cout << "\n=== SEVENTH STREET ===" << std::endl;
-            // Mark start of new street for all players
+        }
+        PROFILE_SCOPE(ProfilePhase::DEALING);
+        for (int street = currentRound; street <= UNIFIED_FINAL; street++) {
+            bool faceUp = (street != UNIFIED_FINAL); // Seventh street is dealt down
             for (int i = 0; i < table->getPlayerCount(); i++) {
                 Player* player = table->getPlayer(i);
                 if (player && !player->hasFolded()) {
-                    player->markStartOfStreet();
+                    player->addCard(table->getDeck().dealCard(), faceUp);
+                    handHistory.recordHoleCards(HandHistoryRound::SHOWDOWN, player->getPlayerId(),
+                                                {player->getHand().back()}, "Runout");
+                    countLastAction();
                 }
             }
-            // Deal final down card to each player
-            for (int i = 0; i < table->getPlayerCount(); i++) {
-                Player* player = table->getPlayer(i);
-                if (player && !player->hasFolded()) {
-                    player->addCard(table->getDeck().dealCard(), false);
+        }
+    }
+    
+    currentRound = UNIFIED_SHOWDOWN;
+    showGameState();
+    saveCheckpoint();
+}
+
+void PokerGame::dealMultipleRuns() {
+    std::vector<Card> boardAtAllIn = table->getCommunityCards();
+    int missingCards = 5 - static_cast<int>(boardAtAllIn.size());
+    int burns = boardAtAllIn.empty() ? 3 : missingCards;
+    int runs = std::min(runItTimes, table->getDeck().size() / (missingCards + burns));
+    
+    if (runs <= 1) {
+        table->dealRemainingBoard();
+        recordBoardReveal(HandHistoryRound::SHOWDOWN, missingCards, "Runout");
+        return;
+    }
+    
+    // Every run comes off the same remaining deck, one after another
+    GameLog::out() << "Running it " << runs << " times" << std::endl;
+    for (int run = 0; run < runs; run++) {
+        runBoards.push_back(table->dealBoardRun(boardAtAllIn));
+        handHistory.recordCardDeal(HandHistoryRound::SHOWDOWN,
+                                   std::vector<Card>(runBoards.back().end() - missingCards, runBoards.back().end()),
+                                   "Run " + std::to_string(run + 1));
+        countLastAction();
+        
+        GameLog::out() << "Run " << (run + 1) << ": ";
+        for (const auto& card : runBoards.back()) {
+            GameLog::out() << card.toString() << " ";
+        }
+        GameLog::out() << std::endl;
+    }
+    
+    // The table shows the first run's board
+    table->clearCommunityCards();
+    for (const auto& card : runBoards[0]) {
+        table->addCommunityCard(card);
+    }
+}
+
+void PokerGame::awardPotsAcrossRuns() {
+    ALLOC_SCOPE(AllocTag::POTS);
+    int runs = static_cast<int>(runBoards.size());
+    int seats = table->getPlayerCount();
+    bool twoPlusThree = (variantInfo.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE);
+    bool hiLo = isHiLoSplit(variantInfo);
+    
+    // Hole-card state for every live seat, built once and shared by all runs
+    std::vector<std::vector<CardMask>> holeCards(seats);
+    std::vector<CardMask> holeMasks(seats, 0);
+    for (int i = 0; i < seats; i++) {
+        Player* player = table->getPlayer(i);
+        if (player && !player->hasFolded()) {
+            for (const auto& card : player->getHand()) {
+                holeCards[i].push_back(FastEvaluator::cardMask(card));
+            }
+            holeMasks[i] = FastEvaluator::handMask(player->getHand());
+        }
+    }
+    
+    // Evaluate every run in one pass (indexed run * seats + seat)
+    std::vector<int> hiValues(runs * seats, -1);
+    std::vector<int> loValues(runs * seats, FAST_LOW_UNQUALIFIED);
+    for (int run = 0; run < runs; run++) {
+        CardMask boardCards[5];
+        CardMask boardMask = 0;
+        for (int c = 0; c < 5; c++) {
+            boardCards[c] = FastEvaluator::cardMask(runBoards[run][c]);
+            boardMask |= boardCards[c];
+        }
+        
+        for (int i = 0; i < seats; i++) {
+            if (holeCards[i].empty()) continue;
+            int slot = run * seats + i;
+            if (twoPlusThree) {
+                int holeCount = static_cast<int>(holeCards[i].size());
+                hiValues[slot] = FastEvaluator::evaluateOmaha(holeCards[i].data(), holeCount, boardCards, 5);
+                if (hiLo) {
+                    loValues[slot] = FastEvaluator::evaluateOmahaLowA5(holeCards[i].data(), holeCount, boardCards, 5);
+                }
+            } else {
+                hiValues[slot] = FastEvaluator::evaluate(holeMasks[i] | boardMask);
+                if (hiLo) {
+                    loValues[slot] = FastEvaluator::evaluateLowA5(holeMasks[i] | boardMask);
                 }
             }
-            showGameState();
-            // Set betting order based on highest up cards (same as 6th street)
-            currentPlayerIndex = findStudFirstToAct();
-            completeBettingRound(HandHistoryRound::SHOWDOWN);
-            currentRound = UNIFIED_SHOWDOWN;
         }
     }
+    
+    const auto& pots = table->getSidePotManager().getPots();
+    
+    // Award pots in reverse order (side pots first, main pot last), each split evenly across runs
+    for (int p = static_cast<int>(pots.size()) - 1; p >= 0; p--) {
+        const SidePot& pot = pots[p];
+        if (pot.eligiblePlayers.empty()) continue;
+        
+        GameLog::out() << "\n=== AWARDING ";
+        if (p == 0) {
+            GameLog::out() << "MAIN POT ($" << pot.amount << ")";
+        } else {
+            GameLog::out() << "SIDE POT " << p << " ($" << pot.amount << ")";
+        }
+        GameLog::out() << " ACROSS " << runs << " RUNS ===" << std::endl;
+        
+        std::vector<int> firstRunWinners;
+        for (int run = 0; run < runs; run++) {
+            int portion = pot.amount / runs + (run < pot.amount % runs ? 1 : 0);
+            
+            // Folded seats keep their pot eligibility but carry no evaluation (-1)
+            int bestHi = -1;
+            int bestLo = FAST_LOW_UNQUALIFIED;
+            for (int seat : pot.eligiblePlayers) {
+                bestHi = std::max(bestHi, hiValues[run * seats + seat]);
+                bestLo = std::min(bestLo, loValues[run * seats + seat]);
+            }
+            
+            hiWinners.clear();
+            loWinners.clear();
+            for (int seat : pot.eligiblePlayers) {
+                if (hiValues[run * seats + seat] == bestHi && bestHi >= 0) hiWinners.push_back(seat);
+                if (bestLo != FAST_LOW_UNQUALIFIED && loValues[run * seats + seat] == bestLo) loWinners.push_back(seat);
+            }
+            
+            // A pot whose runs go to different players counts as chopped
+            if (run == 0) {
+                firstRunWinners = hiWinners;
+            } else if (hiWinners != firstRunWinners) {
+                currentHandHasChoppedPot = true;
+            }
+            
+            GameLog::out() << "Run " << (run + 1) << " ($" << portion << "):" << std::endl;
+            if (hiLo) {
+                transferHiLoPotsToWinners(portion);
+            } else {
+                transferPotToWinners(portion, hiWinners);
+            }
+        }
+    }
+}
+
+bool PokerGame::computePreflopHeadsUpEquity(const std::vector<std::vector<Card>>& seatCards,
+                                            const std::vector<SidePot>& pots) {
+    // Only heads-up Hold'em before the flop is covered by the precomputed table
+    const PreflopEquity& preflop = PreflopEquity::shared();
+    if (!preflop.isLoaded() || variantInfo.gameStruct != GAMESTRUCTURE_BOARD ||
+        variantInfo.numHoleCards != NUMHOLECARDS_TWO || variantInfo.handResolution != BESTHANDRESOLUTION_ANYFIVE ||
+        isHiLoSplit(variantInfo) || !table->getCommunityCards().empty()) {
+        return false;
+    }
+    
+    std::vector<int> live;
+    for (size_t i = 0; i < seatCards.size(); i++) {
+        if (seatCards[i].size() == 2) live.push_back(static_cast<int>(i));
+    }
+    if (live.size() != 2) return false;
+    
+    const std::vector<Card>& first = seatCards[live[0]];
+    const std::vector<Card>& second = seatCards[live[1]];
+    double equity = preflop.equityVsCombo(first[0], first[1], second[0], second[1]);
+    if (equity < 0.0) return false;
+    
+    // Pots only one of the two can win (uncalled chips) go to that seat outright
+    allInExpectedChips.assign(seatCards.size(), 0.0);
+    for (const SidePot& pot : pots) {
+        bool firstEligible = std::find(pot.eligiblePlayers.begin(), pot.eligiblePlayers.end(), live[0]) != pot.eligiblePlayers.end();
+        bool secondEligible = std::find(pot.eligiblePlayers.begin(), pot.eligiblePlayers.end(), live[1]) != pot.eligiblePlayers.end();
+        if (firstEligible && secondEligible) {
+            allInExpectedChips[live[0]] += pot.amount * equity;
+            allInExpectedChips[live[1]] += pot.amount * (1.0 - equity);
+        } else if (firstEligible) {
+            allInExpectedChips[live[0]] += pot.amount;
+        } else if (secondEligible) {
+            allInExpectedChips[live[1]] += pot.amount;
+        }
+    }
+    return true;
+}
+
+void PokerGame::computeAllInEquity() {
+    ALLOC_SCOPE(AllocTag::EVALUATION);
+    std::vector<std::vector<Card>> seatCards(table->getPlayerCount());
+    for (int i = 0; i < table->getPlayerCount(); i++) {
+        Player* player = table->getPlayer(i);
+        if (player && !player->hasFolded()) {
+            seatCards[i] = player->getHand();
+        }
+    }
+    
+    const auto& pots = table->getSidePotManager().getPots();
+    if (!computePreflopHeadsUpEquity(seatCards, pots)) {
+        allInExpectedChips = EquityCalculator::expectedPotShares(seatCards, table->getCommunityCards(),
+                                                                 table->getDeck().getRemainingCards(),
+                                                                 pots, variantInfo);
+    }
+    if (allInExpectedChips.empty()) {
+        GameLog::out() << "All-in equity skipped (too many runouts to enumerate)" << std::endl;
+        return;
+    }
+    
+    int totalPot = table->getPot();
+    std::ostream& out = GameLog::out();
+    std::ios::fmtflags oldFlags = out.flags();
+    std::streamsize oldPrecision = out.precision();
+    out << "All-in equity:" << std::endl;
+    for (int i = 0; i < table->getPlayerCount(); i++) {
+        Player* player = table->getPlayer(i);
+        if (player && !player->hasFolded() && totalPot > 0) {
+            out << "  " << player->getName() << ": " << std::fixed << std::setprecision(1)
+                      << (100.0 * allInExpectedChips[i] / totalPot) << "% (EV $"
+                      << allInExpectedChips[i] << ")" << std::endl;
+        }
+    }
+    out.flags(oldFlags);
+    out.precision(oldPrecision);
 }
 
 void PokerGame::postBlinds() {
@@ -923,46 +1487,128 @@ void PokerGame::postBlinds() {
         int smallBlind = variantInfo.betSizes[0];
         int bigBlind = variantInfo.betSizes[1];
         
-        smallBlindPlayer->addToInFor(smallBlind);
+        if (boardAnte > 0) {
+            GameLog::out() << "All players ante $" << boardAnte << std::endl;
+            std::vector<std::pair<int, int>> antes;
+            for (int i = 0; i < playerCount; i++) {
+                Player* player = table->getPlayer(i);
+                if (player) {
+                    antes.emplace_back(i, collectAnte(player, boardAnte));
+                }
+            }
+            addAntesToPots(antes);
+        }
+        
+        int smallPosted = postForcedBet(smallBlindPlayer, smallBlind);
         table->setCurrentBet(smallBlind);
         
         recordPlayerAction(HandHistoryRound::PRE_HAND, smallBlindPlayer->getPlayerId(),
-                          ActionType::POST_BLIND, smallBlind,
-                          "posts small blind $" + std::to_string(smallBlind));
+                          ActionType::POST_BLIND, smallPosted,
+                          "posts small blind $" + std::to_string(smallPosted));
         
-        bigBlindPlayer->addToInFor(bigBlind);
+        int bigPosted = postForcedBet(bigBlindPlayer, bigBlind);
         table->setCurrentBet(bigBlind);
         
         recordPlayerAction(HandHistoryRound::PRE_HAND, bigBlindPlayer->getPlayerId(),
-                          ActionType::POST_BLIND, bigBlind,
-                          "posts big blind $" + std::to_string(bigBlind));
+                          ActionType::POST_BLIND, bigPosted,
+                          "posts big blind $" + std::to_string(bigPosted));
         
-        std::cout << smallBlindPlayer->getName() << " posts SB $" << smallBlind 
-                  << ", " << bigBlindPlayer->getName() << " posts BB $" << bigBlind << std::endl;
+        GameLog::out() << smallBlindPlayer->getName() << " posts SB $" << smallPosted 
+                  << ", " << bigBlindPlayer->getName() << " posts BB $" << bigPosted << std::endl;
     }
 }
 
+int PokerGame::postForcedBet(Player* player, int amount) {
+    // A stack that can't cover the forced bet goes all-in for what it has
+    if (player->getChips() <= amount) {
+        int posted = player->getChips();
+        player->goAllIn();
+        return posted;
+    }
+    player->addToInFor(amount);
+    return amount;
+}
+
+int PokerGame::collectAnte(Player* player, int ante) {
+    int taken = std::min(ante, player->getChips());
+    player->deductChips(taken);  // Take chips but don't add to inFor
+    if (player->getChips() == 0) {
+        player->goAllIn(); // Nothing left behind the ante
+    }
+    recordPlayerAction(HandHistoryRound::PRE_HAND, player->getPlayerId(),
+                      ActionType::POST_BLIND, taken,
+                      "posts ante $" + std::to_string(taken));
+    return taken;
+}
+
+void PokerGame::addAntesToPots(const std::vector<std::pair<int, int>>& antes) {
+    SidePotManager& potManager = table->getSidePotManager();
+    int fullAnte = 0;
+    int totalAntes = 0;
+    for (const auto& ante : antes) {
+        fullAnte = std::max(fullAnte, ante.second);
+        totalAntes += ante.second;
+    }
+    
+    bool anyShort = false;
+    for (const auto& ante : antes) {
+        if (ante.second > 0 && ante.second < fullAnte) {
+            anyShort = true;
+            break;
+        }
+    }
+    if (!anyShort) {
+        // Antes are dead money; eligibility comes from the betting that follows
+        potManager.addToMainPot(totalAntes);
+        return;
+    }
+    
+    // A short ante put its player all-in with no inFor, so layer the antes: that player
+    // can win their ante from each player, and later bets go to the top pot only
+    std::vector<int> levels;
+    for (const auto& ante : antes) {
+        if (ante.second > 0) {
+            levels.push_back(ante.second);
+        }
+    }
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    
+    int previousLevel = 0;
+    for (int level : levels) {
+        PlayerSet eligiblePlayers(potManager.getAllocator());
+        for (const auto& ante : antes) {
+            if (ante.second >= level) {
+                eligiblePlayers.insert(ante.first);
+            }
+        }
+        int amount = (level - previousLevel) * static_cast<int>(eligiblePlayers.size());
+        if (previousLevel == 0) {
+            potManager.addToMainPot(amount);
+            potManager.addEligiblePlayersToMainPot(eligiblePlayers);
+        } else {
+            potManager.addSidePot(amount, level, eligiblePlayers);
+        }
+        previousLevel = level;
+    }
+    currentActionPotIndex = potManager.getNumberOfPots() - 1;
+}
+
 void PokerGame::postAntesAndBringIn() {
     int ante = variantInfo.betSizes[0];
     int bringIn = variantInfo.betSizes[1];
     
-    std::cout << "All players ante $" << ante << std::endl;
+    GameLog::out() << "All players ante $" << ante << std::endl;
     
     // Collect antes from all players - goes directly to pot, not inFor
-    int totalAntes = 0;
+    std::vector<std::pair<int, int>> antes;
     for (int i = 0; i < table->getPlayerCount(); i++) {
         Player* player = table->getPlayer(i);
         if (player) {
-            player->deductChips(ante);  // Take chips but don't add to inFor
-            totalAntes += ante;
-            recordPlayerAction(HandHistoryRound::PRE_HAND, player->getPlayerId(),
-                              ActionType::POST_BLIND, ante,
-                              "posts ante $" + std::to_string(ante));
+            antes.emplace_back(i, collectAnte(player, ante));
         }
     }
-    
-    // Add antes directly to the main pot
-    table->getSidePotManager().addToMainPot(totalAntes);
+    addAntesToPots(antes);
     
     // Find player with lowest up card for bring-in
     int bringInPlayer = -1;
@@ -982,17 +1628,20 @@ void PokerGame::postAntesAndBringIn() {
     
     if (bringInPlayer != -1) {
         Player* bringInPlayerPtr = table->getPlayer(bringInPlayer);
-        bringInPlayerPtr->addToInFor(bringIn);
+        int bringInPosted = postForcedBet(bringInPlayerPtr, bringIn);
         table->setCurrentBet(bringIn);
         
         recordPlayerAction(HandHistoryRound::PRE_FLOP, bringInPlayerPtr->getPlayerId(),
-                          ActionType::POST_BLIND, bringIn,
-                          "brings in for $" + std::to_string(bringIn));
+                          ActionType::POST_BLIND, bringInPosted,
+                          "brings in for $" + std::to_string(bringInPosted));
         
         // Don't show bring-in immediately - will be shown as first betting action
         
         // First to act is next player after bring-in
         currentPlayerIndex = (bringInPlayer + 1) % table->getPlayerCount();
+        if (!canPlayerAct(currentPlayerIndex)) {
+            advanceToNextPlayer(); // All in from the ante
+        }
     }
 }
 
@@ -1135,26 +1784,32 @@ void PokerGame::nextRound() {
 }
 
 void PokerGame::conductShowdown() {
-    std::cout << "\n=== SHOWDOWN ===" << std::endl;
+    TraceSpan span("showdown", tableId);
+    GameLog::out() << "\n=== SHOWDOWN ===" << std::endl;
     
     // Show all players' cards (for board games only - Stud cards are already visible)
     if (variantInfo.gameStruct == GAMESTRUCTURE_BOARD) {
         for (int i = 0; i < table->getPlayerCount(); i++) {
             Player* player = table->getPlayer(i);
             if (player && !player->hasFolded()) {
-                std::cout << player->getName() << " hole cards: ";
+                GameLog::out() << player->getName() << " hole cards: ";
                 for (const auto& card : player->getHand()) {
-                    std::cout << card.toString() << " ";
+                    GameLog::out() << card.toString() << " ";
                 }
-                std::cout << std::endl;
+                GameLog::out() << std::endl;
             }
         }
     }
     
-    awardPotsStaged();
+    if (runBoards.size() > 1) {
+        awardPotsAcrossRuns();
+    } else {
+        awardPotsStaged();
+    }
 }
 
 void PokerGame::awardPotsWithoutShowdown() {
+    ALLOC_SCOPE(AllocTag::POTS);
     // Find the single remaining active player
     int remainingPlayer = -1;
     int activeCount = 0;
@@ -1168,21 +1823,21 @@ void PokerGame::awardPotsWithoutShowdown() {
     }
     
     if (activeCount != 1) {
-        std::cout << "Error: awardPotsWithoutShowdown called but " << activeCount << " players remain active!" << std::endl;
+        GameLog::out() << "Error: awardPotsWithoutShowdown called but " << activeCount << " players remain active!" << std::endl;
         return;
     }
     
     Player* winner = table->getPlayer(remainingPlayer);
     if (!winner) {
-        std::cout << "Error: Could not find remaining player!" << std::endl;
+        GameLog::out() << "Error: Could not find remaining player!" << std::endl;
         return;
     }
     
     const auto& pots = table->getSidePotManager().getPots();
     int totalWinnings = 0;
     
-    std::cout << "\n=== ALL OTHER PLAYERS FOLDED ===" << std::endl;
-    std::cout << winner->getName() << " wins by default!" << std::endl;
+    GameLog::out() << "\n=== ALL OTHER PLAYERS FOLDED ===" << std::endl;
+    GameLog::out() << winner->getName() << " wins by default!" << std::endl;
     
     // Award all pots to the remaining player
     for (size_t i = 0; i < pots.size(); i++) {
@@ -1190,21 +1845,21 @@ void PokerGame::awardPotsWithoutShowdown() {
         
         // Check if this player is eligible for this pot
         if (pot.eligiblePlayers.find(remainingPlayer) != pot.eligiblePlayers.end()) {
-            std::cout << "Awarding ";
+            GameLog::out() << "Awarding ";
             if (i == 0) {
-                std::cout << "main pot";
+                GameLog::out() << "main pot";
             } else {
-                std::cout << "side pot " << i;
+                GameLog::out() << "side pot " << i;
             }
-            std::cout << " ($" << pot.amount << ") to " << winner->getName() << std::endl;
+            GameLog::out() << " ($" << pot.amount << ") to " << winner->getName() << std::endl;
             
             winner->addChips(pot.amount);
             totalWinnings += pot.amount;
         }
     }
     
-    std::cout << winner->getName() << " total winnings: $" << totalWinnings << std::endl;
-    std::cout << winner->getName() << " now has $" << winner->getChips() << std::endl;
+    GameLog::out() << winner->getName() << " total winnings: $" << totalWinnings << std::endl;
+    GameLog::out() << winner->getName() << " now has $" << winner->getChips() << std::endl;
 }
 
 bool PokerGame::atShowdown() const {
@@ -1213,6 +1868,7 @@ bool PokerGame::atShowdown() const {
 
 // Omaha hand evaluation (exactly 2 hole + 3 community)
 HandResult PokerGame::evaluateOmahaHand(const std::vector<Card>& holeCards, const std::vector<Card>& communityCards) const {
+    Metrics::countEvaluation(EvaluatorKind::OMAHA_HI);
     HandResult bestHand;
     bestHand.rank = HandRank::HIGH_CARD;
     
@@ -1250,6 +1906,7 @@ HandResult PokerGame::evaluateOmahaHand(const std::vector<Card>& holeCards, cons
 }
 
 LowHandResult PokerGame::evaluateOmahaLowHand(const std::vector<Card>& holeCards, const std::vector<Card>& communityCards) const {
+    Metrics::countEvaluation(EvaluatorKind::LOW);
     if (holeCards.size() != 4 || communityCards.size() != 5) {
         return LO_HAND_UNQUALIFIED;
     }
@@ -1291,65 +1948,33 @@ std::vector<int> PokerGame::findHiLoWinners(const std::vector<int>& eligiblePlay
         return {};
     }
     
-    // Find high hand winners
-    HandResult bestHighHand;
-    bestHighHand.rank = HandRank::HIGH_CARD;
+    // Live hands carry both values; the low is already 8-or-better qualified
+    int bestHigh = -1;
     std::vector<int> highWinners;
-    
-    // Find low hand winners
-    LowHandResult bestLowHand = LO_HAND_UNQUALIFIED;
+    int bestLow = FAST_LOW_UNQUALIFIED;
     std::vector<int> lowWinners;
     
-    // Evaluate all eligible players for both high and low
     for (int playerIndex : eligiblePlayers) {
         Player* player = table->getPlayer(playerIndex);
         if (player && !player->hasFolded()) {
+            const IncrementalHand& live = player->getLiveHand();
             
-            // Evaluate high hand
-            HandResult highHand;
-            if (variantInfo.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE) {
-                // Omaha: must use exactly 2 hole + 3 community
-                highHand = evaluateOmahaHand(player->getHand(), table->getCommunityCards());
-            } else {
-                // Hold'em/Stud: use any 5 cards
-                highHand = HandEvaluator::evaluateHand(player->getHand(), table->getCommunityCards());
-            }
-            
-            if (highHand > bestHighHand) {
-                bestHighHand = highHand;
+            int highValue = live.getHighValue();
+            if (highValue > bestHigh) {
+                bestHigh = highValue;
                 highWinners.clear();
                 highWinners.push_back(playerIndex);
-            } else if (highHand == bestHighHand) {
+            } else if (highValue == bestHigh) {
                 highWinners.push_back(playerIndex);
             }
             
-            // Evaluate low hand
-            LowHandResult lowHand;
-            if (variantInfo.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE) {
-                // Omaha: must use exactly 2 hole + 3 community for low
-                lowHand = evaluateOmahaLowHand(player->getHand(), table->getCommunityCards());
-            } else {
-                // Hold'em/Stud: use any 5 cards for low
-                lowHand = HandEvaluator::evaluateLowHand(player->getHand(), table->getCommunityCards());
-            }
-            
-            // Apply 8-or-better qualification for HILO_A5_MUSTQUALIFY games
-            if (variantInfo.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY) {
-                // Check if hand qualifies: no pairs AND highest card is 8 or lower
-                bool hasNoPairs = (lowHand.values.size() >= 6 && lowHand.values[0] == 0); // handType == 0
-                bool highCardIsEightOrLower = (lowHand.values.size() >= 6 && lowHand.values[1] <= 8); // highest card <= 8
-                
-                if (!hasNoPairs || !highCardIsEightOrLower) {
-                    lowHand = LO_HAND_UNQUALIFIED; // Hand doesn't qualify for low
-                }
-            }
-            
-            // With LO_HAND_UNQUALIFIED, we can simply compare all low hands
-            if (lowHand < bestLowHand) {
-                bestLowHand = lowHand;
+            int lowValue = live.getLowValue();
+            if (lowValue == FAST_LOW_UNQUALIFIED) continue;
+            if (lowValue < bestLow) {
+                bestLow = lowValue;
                 lowWinners.clear();
                 lowWinners.push_back(playerIndex);
-            } else if (lowHand == bestLowHand) {
+            } else if (lowValue == bestLow) {
                 lowWinners.push_back(playerIndex);
             }
         }
@@ -1358,11 +1983,11 @@ std::vector<int> PokerGame::findHiLoWinners(const std::vector<int>& eligiblePlay
     // Store both high and low winners for proper Hi-Lo pot splitting
     // We'll handle the actual split in transferHiLoPotsToWinners
     hiWinners = highWinners;
-    loWinners = (bestLowHand.qualified) ? lowWinners : std::vector<int>();
+    loWinners = lowWinners; // Empty when nobody qualified
     
     // For compatibility, return combined list but actual pot splitting will use hiWinners/loWinners
     std::vector<int> allWinners = highWinners;
-    if (bestLowHand.qualified) {
+    if (!lowWinners.empty()) {
         for (int lowWinner : lowWinners) {
             if (std::find(allWinners.begin(), allWinners.end(), lowWinner) == allWinners.end()) {
                 allWinners.push_back(lowWinner);
@@ -1412,7 +2037,7 @@ void PokerGame::displayHiLoWinningHands(const std::vector<int>& /* winners */, c
             }
             
             // Apply 8-or-better qualification for winner determination
-            if (variantInfo.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY) {
+            if (isHiLoSplit(variantInfo)) {
                 bool hasNoPairs = (lowHand.values.size() >= 6 && lowHand.values[0] == 0);
                 bool highCardIsEightOrLower = (lowHand.values.size() >= 6 && lowHand.values[1] <= 8);
                 
@@ -1449,7 +2074,7 @@ void PokerGame::displayHiLoWinningHands(const std::vector<int>& /* winners */, c
             }
             
             // Apply 8-or-better qualification for display
-            if (variantInfo.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY) {
+            if (isHiLoSplit(variantInfo)) {
                 bool hasNoPairs = (lowHand.values.size() >= 6 && lowHand.values[0] == 0);
                 bool highCardIsEightOrLower = (lowHand.values.size() >= 6 && lowHand.values[1] <= 8);
                 
@@ -1461,48 +2086,48 @@ void PokerGame::displayHiLoWinningHands(const std::vector<int>& /* winners */, c
             bool isHighWinner = std::find(highWinners.begin(), highWinners.end(), playerIndex) != highWinners.end();
             bool isLowWinner = std::find(lowWinners.begin(), lowWinners.end(), playerIndex) != lowWinners.end();
             
-            std::cout << player->getName() << ":" << std::endl;
-            std::cout << "  High: " << highHand.description;
+            GameLog::out() << player->getName() << ":" << std::endl;
+            GameLog::out() << "  High: " << highHand.description;
             if (isHighWinner) {
-                std::cout << " (HIGH WINNER)";
+                GameLog::out() << " (HIGH WINNER)";
             }
-            std::cout << std::endl;
+            GameLog::out() << std::endl;
             
             // Display low hand with proper qualification messaging
-            std::cout << "  Low: ";
+            GameLog::out() << "  Low: ";
             if (lowHand.qualified) {
-                std::cout << lowHand.description;
+                GameLog::out() << lowHand.description;
                 if (isLowWinner) {
-                    std::cout << " (LOW WINNER)";
+                    GameLog::out() << " (LOW WINNER)";
                 }
             } else {
-                std::cout << "No qualifying low";
+                GameLog::out() << "No qualifying low";
             }
-            std::cout << std::endl;
+            GameLog::out() << std::endl;
         }
     }
     
     // Summary of pot split
     if (bestLowHand.qualified) {
-        std::cout << "\n=== POT SPLIT ===\n";
-        std::cout << "High half goes to: ";
+        GameLog::out() << "\n=== POT SPLIT ===\n";
+        GameLog::out() << "High half goes to: ";
         for (size_t i = 0; i < highWinners.size(); i++) {
-            if (i > 0) std::cout << ", ";
-            std::cout << table->getPlayer(highWinners[i])->getName();
+            if (i > 0) GameLog::out() << ", ";
+            GameLog::out() << table->getPlayer(highWinners[i])->getName();
         }
-        std::cout << "\nLow half goes to: ";
+        GameLog::out() << "\nLow half goes to: ";
         for (size_t i = 0; i < lowWinners.size(); i++) {
-            if (i > 0) std::cout << ", ";
-            std::cout << table->getPlayer(lowWinners[i])->getName();
+            if (i > 0) GameLog::out() << ", ";
+            GameLog::out() << table->getPlayer(lowWinners[i])->getName();
         }
-        std::cout << std::endl;
+        GameLog::out() << std::endl;
     } else {
-        std::cout << "\n=== NO QUALIFYING LOW ===\n";
-        std::cout << "Entire pot goes to high winners: ";
+        GameLog::out() << "\n=== NO QUALIFYING LOW ===\n";
+        GameLog::out() << "Entire pot goes to high winners: ";
         for (size_t i = 0; i < highWinners.size(); i++) {
-            if (i > 0) std::cout << ", ";
-            std::cout << table->getPlayer(highWinners[i])->getName();
+            if (i > 0) GameLog::out() << ", ";
+            GameLog::out() << table->getPlayer(highWinners[i])->getName();
         }
-        std::cout << std::endl;
+        GameLog::out() << std::endl;
     }
 }
\ No newline at end of file
@@ -7,20 +7,51 @@
 #include "poker_variant.h"
 #include "variants.h"
 #include "hand_history.h"
+#include "decision_provider.h"
 #include <vector>
 
+class OpponentStats; // Forward declaration
+class ArchiveRing; // Forward declaration
+class CheckpointStore; // Forward declaration
+
 class PokerGame {
+    friend class TableCheckpoint;
+    
 protected:
     Table* table;
     VariantInfo variantInfo;
     int currentPlayerIndex;
     bool handComplete;
     bool currentHandHasChoppedPot; // Track if current hand has chopped pot
-    HandHistory handHistory;
+    MonotonicArena handArena; // This hand's history, pot sets and evaluator scratch; reset at startNewHand
+    HandHistory handHistory; // Declared after handArena, which holds its storage
     std::vector<bool> hasActedThisRound;
     UnifiedBettingRound currentRound;
     int betCount; // Track number of bets in current round for limit games
     int currentActionPotIndex; // Index of the pot that receives new money (0=main, 1=side1, etc.)
+    bool allInEquityEnabled; // Compute exact pot equity when an all-in closes the action
+    std::vector<double> allInExpectedChips; // Per-seat expected winnings at the moment of the all-in
+    int runItTimes; // Boards dealt for an all-in pot (run it twice/three times)
+    std::vector<std::vector<Card>> runBoards; // Completed board for each run when running it more than once
+    
+    // Resumable hand flow: where advance() picks up again
+    HandFlowState flowState;
+    HandHistoryRound bettingHistoryRound; // History round of the betting round in progress
+    int bettingActionCount; // Actions taken so far in the current betting round
+    bool bettingRoundClosed; // Betting ended early (checks past two orbits)
+    bool bettingRoundSkipped; // Round opened with one player left, nothing to collect
+    DecisionProvider* decisionProvider; // nullptr = built-in player AI, synchronous fast path
+    int tableId; // Identifier handed to decision providers and schedulers
+    long long decisionSequence; // Decisions applied so far; identifies the pending request
+    int boardAnte; // Per-player ante for BOARD games (tournament levels); 0 = none
+    OpponentStats* opponentStats; // Fed every recorded action; nullptr = not tracked
+    ArchiveRing* archiveRing; // Hand histories are streamed here; nullptr = not archived
+    CheckpointStore* checkpoints; // Table state saved at every action boundary; nullptr = not checkpointed
+    int checkpointSlot;
+    int profileVariant; // Profiler slot for this variant's phase timings
+    int metricsVariant; // Metrics slot for hands completed
+    uint64_t traceHandStart; // Trace clock at the deal; Trace::NOT_STARTED when not traced
+    uint64_t traceRoundStart;
     
     // Hi-Lo specific winner tracking
     std::vector<int> hiWinners;
@@ -28,7 +59,7 @@ protected:
     
 public:
     PokerGame(Table* gameTable, const VariantInfo& variant);
-    virtual ~PokerGame() = default;
+    virtual ~PokerGame();
     
     // Unified game flow methods (no longer pure virtual)
     virtual void startNewHand();
@@ -38,17 +69,45 @@ public:
     virtual void awardPotsWithoutShowdown();
     virtual bool atShowdown() const;
     
-    // Structure-specific game flow methods
-    virtual void gameFlowForBOARD();
-    virtual void gameFlowForSTUD();
+    // All-in runout: once nobody can act, deal everything left and go to showdown
+    virtual bool isActionClosed() const;
+    virtual void runOutRemainingCards();
+    virtual void computeAllInEquity();
+    // Heads-up Hold'em all-in before the flop, read from the preflop equity table
+    virtual bool computePreflopHeadsUpEquity(const std::vector<std::vector<Card>>& seatCards,
+                                             const std::vector<SidePot>& pots);
+    virtual void dealMultipleRuns(); // Deal runItTimes boards from the same remaining deck
+    virtual void awardPotsAcrossRuns(); // Split every pot across the runs, all runs evaluated in one batch
+    
+    // Resumable hand flow. advance() runs the hand until a decision must come
+    // from outside (the provider suspended) or betting is over; submitDecision()
+    // answers the pending decision so the next advance() can continue.
+    virtual GameStepResult advance();
+    virtual bool submitDecision(const Decision& decision);
+    virtual bool isAwaitingDecision() const;
+    virtual DecisionRequest getPendingRequest() const;
+    virtual void finishHand(); // Showdown, or award the pots to the last player standing
+    void recordResolution(const std::vector<int>& chipsBefore); // What each seat collected since chipsBefore
+    void countLastAction() const;               // The action just added to handHistory into Metrics
+    void countHandMetrics(bool showdown) const; // Hand and showdown into Metrics
+    
+    // Structure-specific street setup (deal, display, first to act)
+    virtual HandHistoryRound beginStreetForBOARD();
+    void recordBoardReveal(HandHistoryRound round, int count, const std::string& description);
+    virtual HandHistoryRound beginStreetForSTUD();
+    virtual void endStreet();
     
     // Unified betting operations
     virtual void postBlinds();        // For BOARD games
     virtual void postAntesAndBringIn(); // For STUD games
+    virtual int postForcedBet(Player* player, int amount); // Blind/bring-in, all-in if short; returns amount posted
+    virtual int collectAnte(Player* player, int ante);     // Dead ante straight from the stack; returns amount taken
+    virtual void addAntesToPots(const std::vector<std::pair<int, int>>& antes); // (seat, ante taken) pairs
     virtual void nextRound();         // Advance to next unified round
     
     // Generic hand completion logic (same for all poker variants)
     virtual bool isHandComplete() const;
+    bool isHandFinished() const { return handComplete; } // finishHand() has awarded the pots
     
     // Virtual showdown methods (can be overridden for variant-specific behavior)
     virtual void awardPotsStaged(); // Award pots in reverse order (side pots first)
@@ -74,6 +133,7 @@ public:
     virtual bool playerCheck(int playerIndex);
     
     // Common betting round management
+    static PokerVariant historyVariant(const VariantInfo& variant); // How hand histories label this variant
     virtual void initializeHandHistory(int handNumber);
     virtual void recordPlayerAction(HandHistoryRound round, int playerId, ActionType actionType, int amount, const std::string& description);
     virtual bool isBettingComplete() const;
@@ -83,9 +143,19 @@ public:
     virtual bool canPlayerAct(int playerIndex) const;
     virtual void resetBettingRound();
     
-    // Intelligent betting round completion using player AI
+    // Intelligent betting round completion using player AI (synchronous fast path)
     virtual void completeBettingRound(HandHistoryRound historyRound);
     
+    // Betting round pieces shared by the synchronous and resumable flows
+    virtual void beginBettingRound(HandHistoryRound historyRound);
+    virtual bool bettingRoundNeedsDecision() const;
+    virtual DecisionRequest buildDecisionRequest(int playerIndex) const;
+    virtual void applyDecision(int playerIndex, const Decision& decision);
+    virtual void finishBettingRound();
+    Decision builtInDecision(int playerIndex) const; // Player::makeDecision for the seat
+    bool requestTracedDecision(int playerIndex, Decision& decision); // Asks the decision provider
+    void saveCheckpoint(); // Snapshot into the checkpoint slot, if any
+    
     // Utility functions for showdown (common operations)
     virtual std::vector<int> findBestHand(const std::vector<int>& eligiblePlayers); // Find winners among eligible players (virtual for variants)
     virtual void displayWinningHands(const std::vector<int>& winners, const std::vector<int>& eligiblePlayers) const; // Show hand descriptions (virtual for variants)
@@ -103,8 +173,26 @@ public:
     bool determineBettorForStud(const std::vector<Card>& hand1, const std::vector<Card>& hand2) const; // Compare Stud up cards for betting order
     
     // Getters
-    VariantInfo getVariantInfo() const { return variantInfo; }
+    const VariantInfo& getVariantInfo() const { return variantInfo; }
     int getCurrentPlayerIndex() const { return currentPlayerIndex; }
+    const std::vector<double>& getAllInExpectedChips() const { return allInExpectedChips; }
+    
+    Table* getTable() const { return table; }
+    const HandHistory& getHandHistory() const { return handHistory; }
+    HandFlowState getFlowState() const { return flowState; }
+    int getTableId() const { return tableId; }
+    
+    void setTableId(int id) { tableId = id; }
+    void setDecisionProvider(DecisionProvider* provider) { decisionProvider = provider; }
+    void setAllInEquityEnabled(bool enabled) { allInEquityEnabled = enabled; }
+    void setRunItTimes(int times) { runItTimes = times < 1 ? 1 : times; }
+    // Tournament levels: replace the variant's bet sizes (same layout as VariantInfo::betSizes)
+    void setBetSizes(const std::vector<int>& betSizes) { variantInfo.betSizes = betSizes; }
+    void setBoardAnte(int ante) { boardAnte = ante; }
+    void setOpponentStats(OpponentStats* stats) { opponentStats = stats; }
+    void setArchive(ArchiveRing* ring) { archiveRing = ring; } // Ring used only from the thread playing this table
+    void setCheckpoints(CheckpointStore* store, int slot) { checkpoints = store; checkpointSlot = slot; }
+    const std::vector<std::vector<Card>>& getRunBoards() const { return runBoards; }
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,361 @@
+#include "preflop_equity.h"
+#include "fast_evaluator.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <unordered_map>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char* PreflopEquity::DEFAULT_PATH = "preflop_equity.bin";
+
+namespace {
+    const char MAGIC[8] = {'P', 'F', 'E', 'Q', 'U', 'I', 'T', 'Y'};
+    const uint32_t FILE_VERSION = 1;
+    const int DECK_SIZE = 52;
+    
+    // Card indices of every combo, and the combos making up every class
+    struct ComboTables {
+        int high[PreflopEquity::NUM_COMBOS];
+        int low[PreflopEquity::NUM_COMBOS];
+        int classOf[PreflopEquity::NUM_COMBOS];
+        std::vector<int> classCombos[PreflopEquity::NUM_CLASSES];
+        
+        ComboTables() {
+            for (int first = 1; first < DECK_SIZE; first++) {
+                for (int second = 0; second < first; second++) {
+                    int combo = first * (first - 1) / 2 + second;
+                    high[combo] = first;
+                    low[combo] = second;
+                    classOf[combo] = PreflopEquity::classIndex(Card::fromIndex(first), Card::fromIndex(second));
+                    classCombos[classOf[combo]].push_back(combo);
+                }
+            }
+        }
+    };
+    
+    const ComboTables& comboTables() {
+        static const ComboTables tables;
+        return tables;
+    }
+    
+    uint64_t comboMask(int combo) {
+        const ComboTables& tables = comboTables();
+        return (uint64_t(1) << tables.high[combo]) | (uint64_t(1) << tables.low[combo]);
+    }
+    
+    uint64_t deadMask(const std::vector<Card>& cards) {
+        uint64_t mask = 0;
+        for (const Card& card : cards) mask |= uint64_t(1) << card.getIndex();
+        return mask;
+    }
+    
+    int comboFromIndices(int a, int b) {
+        int first = std::max(a, b);
+        int second = std::min(a, b);
+        return first * (first - 1) / 2 + second;
+    }
+    
+    // Smallest (hero, villain) key over all 24 suit relabellings
+    uint32_t canonicalMatchup(int hero, int villain) {
+        const ComboTables& tables = comboTables();
+        int cards[4] = {tables.high[hero], tables.low[hero], tables.high[villain], tables.low[villain]};
+        int perm[4] = {0, 1, 2, 3};
+        uint32_t best = UINT32_MAX;
+        do {
+            int mapped[4];
+            for (int i = 0; i < 4; i++) {
+                mapped[i] = perm[cards[i] / 13] * 13 + cards[i] % 13;
+            }
+            uint32_t key = static_cast<uint32_t>(comboFromIndices(mapped[0], mapped[1]) * PreflopEquity::NUM_COMBOS +
+                                                 comboFromIndices(mapped[2], mapped[3]));
+            best = std::min(best, key);
+        } while (std::next_permutation(perm, perm + 4));
+        return best;
+    }
+    
+    CardMask toCardMask(int cardIndex) {
+        return FastEvaluator::cardMask(Card::fromIndex(cardIndex));
+    }
+    
+    double matchupEquity(int hero, int villain, int samples, unsigned seed) {
+        const ComboTables& tables = comboTables();
+        CardMask heroMask = toCardMask(tables.high[hero]) | toCardMask(tables.low[hero]);
+        CardMask villainMask = toCardMask(tables.high[villain]) | toCardMask(tables.low[villain]);
+        uint64_t used = comboMask(hero) | comboMask(villain);
+        
+        std::vector<CardMask> deck;
+        for (int i = 0; i < DECK_SIZE; i++) {
+            if (!(used & (uint64_t(1) << i))) deck.push_back(toCardMask(i));
+        }
+        int n = static_cast<int>(deck.size());
+        
+        double share = 0.0;
+        long long boards = 0;
+        auto score = [&](CardMask board) {
+            int heroValue = FastEvaluator::evaluate(heroMask | board);
+            int villainValue = FastEvaluator::evaluate(villainMask | board);
+            share += heroValue > villainValue ? 1.0 : (heroValue == villainValue ? 0.5 : 0.0);
+            boards++;
+        };
+        
+        if (samples <= 0) {
+            for (int a = 0; a < n; a++)
+                for (int b = a + 1; b < n; b++)
+                    for (int c = b + 1; c < n; c++) {
+                        CardMask three = deck[a] | deck[b] | deck[c];
+                        for (int d = c + 1; d < n; d++)
+                            for (int e = d + 1; e < n; e++)
+                                score(three | deck[d] | deck[e]);
+                    }
+        } else {
+            std::mt19937 rng(seed);
+            for (int s = 0; s < samples; s++) {
+                // Partial Fisher-Yates: the first five slots become the board
+                CardMask board = 0;
+                for (int i = 0; i < 5; i++) {
+                    int j = i + static_cast<int>(rng() % (n - i));
+                    std::swap(deck[i], deck[j]);
+                    board |= deck[i];
+                }
+                score(board);
+            }
+        }
+        return boards > 0 ? share / boards : 0.0;
+    }
+}
+
+PreflopEquity::PreflopEquity()
+    : header(nullptr), comboMatrix(nullptr), classMatrix(nullptr), vsRandom(nullptr), mappedSize(0) {
+}
+
+PreflopEquity::~PreflopEquity() {
+    unload();
+}
+
+PreflopEquity& PreflopEquity::shared() {
+    static PreflopEquity table;
+    return table;
+}
+
+bool PreflopEquity::load(const std::string& path) {
+    unload();
+    
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping stays valid without the descriptor
+    if (mapped == MAP_FAILED) return false;
+    
+    const Header* candidate = static_cast<const Header*>(mapped);
+    size_t comboEnd = candidate->comboOffset + sizeof(float) * NUM_COMBOS * NUM_COMBOS;
+    size_t classEnd = candidate->classOffset + sizeof(float) * NUM_CLASSES * NUM_CLASSES;
+    size_t randomEnd = candidate->vsRandomOffset + sizeof(float) * NUM_COMBOS;
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 || candidate->version != FILE_VERSION ||
+        candidate->combos != NUM_COMBOS || candidate->classes != NUM_CLASSES ||
+        comboEnd > size || classEnd > size || randomEnd > size) {
+        munmap(mapped, size);
+        return false;
+    }
+    
+    const char* base = static_cast<const char*>(mapped);
+    header = candidate;
+    comboMatrix = reinterpret_cast<const float*>(base + header->comboOffset);
+    classMatrix = reinterpret_cast<const float*>(base + header->classOffset);
+    vsRandom = reinterpret_cast<const float*>(base + header->vsRandomOffset);
+    mappedSize = size;
+    return true;
+}
+
+void PreflopEquity::unload() {
+    if (header) {
+        munmap(const_cast<Header*>(header), mappedSize);
+    }
+    header = nullptr;
+    comboMatrix = nullptr;
+    classMatrix = nullptr;
+    vsRandom = nullptr;
+    mappedSize = 0;
+}
+
+int PreflopEquity::getSamples() const {
+    return header ? static_cast<int>(header->samples) : 0;
+}
+
+int PreflopEquity::comboIndex(const Card& first, const Card& second) {
+    return comboFromIndices(first.getIndex(), second.getIndex());
+}
+
+int PreflopEquity::classIndex(const Card& first, const Card& second) {
+    int high = std::max(static_cast<int>(first.getRank()), static_cast<int>(second.getRank())) - 2;
+    int low = std::min(static_cast<int>(first.getRank()), static_cast<int>(second.getRank())) - 2;
+    // Aces in the top-left corner
+    int highRow = 12 - high;
+    int lowRow = 12 - low;
+    if (first.getSuit() == second.getSuit()) {
+        return highRow * 13 + lowRow;  // Suited: above the diagonal
+    }
+    return lowRow * 13 + highRow;      // Offsuit (and pairs, on the diagonal)
+}
+
+std::string PreflopEquity::className(int classIndex) {
+    static const char RANK_CHARS[] = "23456789TJQKA";
+    int row = classIndex / 13;
+    int col = classIndex % 13;
+    if (row == col) {
+        return std::string(2, RANK_CHARS[12 - row]);
+    }
+    if (row < col) {
+        return std::string(1, RANK_CHARS[12 - row]) + RANK_CHARS[12 - col] + "s";
+    }
+    return std::string(1, RANK_CHARS[12 - col]) + RANK_CHARS[12 - row] + "o";
+}
+
+void PreflopEquity::comboCards(int combo, int& high, int& low) {
+    high = comboTables().high[combo];
+    low = comboTables().low[combo];
+}
+
+float PreflopEquity::comboVsCombo(int combo, int opponentCombo) const {
+    if (!header) return -1.0f;
+    return comboMatrix[combo * NUM_COMBOS + opponentCombo];
+}
+
+float PreflopEquity::classVsClass(int handClass, int opponentClass) const {
+    if (!header) return -1.0f;
+    return classMatrix[handClass * NUM_CLASSES + opponentClass];
+}
+
+float PreflopEquity::comboVsRandom(int combo) const {
+    if (!header) return -1.0f;
+    return vsRandom[combo];
+}
+
+double PreflopEquity::equityVsRandom(const Card& first, const Card& second, const std::vector<Card>& deadCards) const {
+    if (!header) return -1.0;
+    int combo = comboIndex(first, second);
+    if (deadCards.empty()) {
+        return vsRandom[combo];
+    }
+    
+    uint64_t blocked = deadMask(deadCards) | comboMask(combo);
+    double total = 0.0;
+    int count = 0;
+    for (int opponent = 0; opponent < NUM_COMBOS; opponent++) {
+        if (comboMask(opponent) & blocked) continue;
+        total += comboMatrix[combo * NUM_COMBOS + opponent];
+        count++;
+    }
+    return count > 0 ? total / count : -1.0;
+}
+
+double PreflopEquity::equityVsClass(const Card& first, const Card& second, int opponentClass,
+                                    const std::vector<Card>& deadCards) const {
+    if (!header) return -1.0;
+    int combo = comboIndex(first, second);
+    uint64_t blocked = deadMask(deadCards) | comboMask(combo);
+    
+    double total = 0.0;
+    int count = 0;
+    for (int opponent : comboTables().classCombos[opponentClass]) {
+        if (comboMask(opponent) & blocked) continue;
+        total += comboMatrix[combo * NUM_COMBOS + opponent];
+        count++;
+    }
+    return count > 0 ? total / count : -1.0;
+}
+
+double PreflopEquity::equityVsCombo(const Card& first, const Card& second,
+                                    const Card& opponentFirst, const Card& opponentSecond) const {
+    if (!header) return -1.0;
+    return comboMatrix[comboIndex(first, second) * NUM_COMBOS + comboIndex(opponentFirst, opponentSecond)];
+}
+
+bool PreflopEquity::generate(const std::string& path, int samples, ThreadPool& pool) {
+    // Collect each heads-up matchup once per suit relabelling
+    std::unordered_map<uint32_t, int> uniqueIndex;
+    std::vector<uint32_t> uniqueKeys;
+    std::vector<int> matchupOf(NUM_COMBOS * NUM_COMBOS, -1);
+    for (int hero = 0; hero < NUM_COMBOS; hero++) {
+        for (int villain = hero + 1; villain < NUM_COMBOS; villain++) {
+            if (comboMask(hero) & comboMask(villain)) continue;
+            uint32_t key = canonicalMatchup(hero, villain);
+            auto found = uniqueIndex.find(key);
+            if (found == uniqueIndex.end()) {
+                found = uniqueIndex.emplace(key, static_cast<int>(uniqueKeys.size())).first;
+                uniqueKeys.push_back(key);
+            }
+            matchupOf[hero * NUM_COMBOS + villain] = found->second;
+        }
+    }
+    
+    std::vector<float> uniqueEquity(uniqueKeys.size());
+    pool.parallelFor(static_cast<int>(uniqueKeys.size()), [&](int index, int /* worker */) {
+        int hero = static_cast<int>(uniqueKeys[index] / NUM_COMBOS);
+        int villain = static_cast<int>(uniqueKeys[index] % NUM_COMBOS);
+        uniqueEquity[index] = static_cast<float>(matchupEquity(hero, villain, samples, 0x9E3779B9u ^ uniqueKeys[index]));
+    });
+    
+    std::vector<float> combos(NUM_COMBOS * NUM_COMBOS, -1.0f);
+    for (int hero = 0; hero < NUM_COMBOS; hero++) {
+        for (int villain = hero + 1; villain < NUM_COMBOS; villain++) {
+            int matchup = matchupOf[hero * NUM_COMBOS + villain];
+            if (matchup < 0) continue;
+            combos[hero * NUM_COMBOS + villain] = uniqueEquity[matchup];
+            combos[villain * NUM_COMBOS + hero] = 1.0f - uniqueEquity[matchup];
+        }
+    }
+    
+    // Class and vs-random tables average over every compatible combo pair
+    std::vector<double> classTotals(NUM_CLASSES * NUM_CLASSES, 0.0);
+    std::vector<int> classCounts(NUM_CLASSES * NUM_CLASSES, 0);
+    std::vector<float> random(NUM_COMBOS, 0.0f);
+    const ComboTables& tables = comboTables();
+    for (int hero = 0; hero < NUM_COMBOS; hero++) {
+        double total = 0.0;
+        int count = 0;
+        for (int villain = 0; villain < NUM_COMBOS; villain++) {
+            float equity = combos[hero * NUM_COMBOS + villain];
+            if (equity < 0.0f) continue;
+            int cell = tables.classOf[hero] * NUM_CLASSES + tables.classOf[villain];
+            classTotals[cell] += equity;
+            classCounts[cell]++;
+            total += equity;
+            count++;
+        }
+        random[hero] = static_cast<float>(total / count);
+    }
+    std::vector<float> classes(NUM_CLASSES * NUM_CLASSES, -1.0f);
+    for (size_t cell = 0; cell < classes.size(); cell++) {
+        if (classCounts[cell] > 0) classes[cell] = static_cast<float>(classTotals[cell] / classCounts[cell]);
+    }
+    
+    Header fileHeader;
+    std::memset(&fileHeader, 0, sizeof(fileHeader));
+    std::memcpy(fileHeader.magic, MAGIC, sizeof(MAGIC));
+    fileHeader.version = FILE_VERSION;
+    fileHeader.combos = NUM_COMBOS;
+    fileHeader.classes = NUM_CLASSES;
+    fileHeader.samples = static_cast<uint32_t>(samples > 0 ? samples : 0);
+    fileHeader.comboOffset = sizeof(Header);
+    fileHeader.classOffset = fileHeader.comboOffset + sizeof(float) * combos.size();
+    fileHeader.vsRandomOffset = fileHeader.classOffset + sizeof(float) * classes.size();
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+    file.write(reinterpret_cast<const char*>(combos.data()), sizeof(float) * combos.size());
+    file.write(reinterpret_cast<const char*>(classes.data()), sizeof(float) * classes.size());
+    file.write(reinterpret_cast<const char*>(random.data()), sizeof(float) * random.size());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,78 @@
+#ifndef PREFLOP_EQUITY_H
+#define PREFLOP_EQUITY_H
+
+#include "card.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Heads-up Hold'em preflop all-in equity, precomputed offline (preflop_gen)
+// and memory-mapped read-only, so loading is just an mmap of the file.
+//
+// Equity is the share of the pot won on average (win + tie / 2).
+// Combos are indexed 0-1325 from their two card indices; canonical classes
+// use the usual 13x13 grid (pairs on the diagonal, suited above, offsuit below).
+class PreflopEquity {
+public:
+    static const int NUM_COMBOS = 1326;
+    static const int NUM_CLASSES = 169;
+    static const char* DEFAULT_PATH;
+    
+    PreflopEquity();
+    ~PreflopEquity();
+    PreflopEquity(const PreflopEquity&) = delete;
+    PreflopEquity& operator=(const PreflopEquity&) = delete;
+    
+    // Maps the table file; false if missing or not a valid table
+    bool load(const std::string& path);
+    void unload();
+    bool isLoaded() const { return header != nullptr; }
+    int getSamples() const; // Boards sampled per matchup when generated; 0 = exact enumeration
+    
+    static int comboIndex(const Card& first, const Card& second);
+    static int classIndex(const Card& first, const Card& second);
+    static std::string className(int classIndex);
+    
+    // Raw lookups (-1 when the two combos share a card)
+    float comboVsCombo(int combo, int opponentCombo) const;
+    float classVsClass(int handClass, int opponentClass) const;
+    float comboVsRandom(int combo) const; // Against any hand, no other cards known
+    
+    // Card removal: opponent combos that use a dead card (or one of ours) are
+    // excluded and the rest weighted evenly
+    double equityVsRandom(const Card& first, const Card& second, const std::vector<Card>& deadCards) const;
+    double equityVsClass(const Card& first, const Card& second, int opponentClass,
+                         const std::vector<Card>& deadCards) const;
+    double equityVsCombo(const Card& first, const Card& second, const Card& opponentFirst, const Card& opponentSecond) const;
+    
+    // Process-wide table used by the player AI and the all-in EV report
+    static PreflopEquity& shared();
+    
+    // Offline generation. samples = 0 enumerates all 1,712,304 boards per matchup;
+    // otherwise each matchup uses that many random boards. Matchups equal up to a
+    // suit relabelling are computed once, spread across the pool's threads.
+    static bool generate(const std::string& path, int samples, ThreadPool& pool);
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t combos;
+        uint32_t classes;
+        uint32_t samples;
+        uint64_t comboOffset;    // float[NUM_COMBOS * NUM_COMBOS]
+        uint64_t classOffset;    // float[NUM_CLASSES * NUM_CLASSES]
+        uint64_t vsRandomOffset; // float[NUM_COMBOS]
+    };
+    
+    const Header* header;
+    const float* comboMatrix;
+    const float* classMatrix;
+    const float* vsRandom;
+    size_t mappedSize;
+    
+    static void comboCards(int combo, int& high, int& low);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "preflop_equity.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+// Builds the heads-up preflop equity table read by PreflopEquity.
+// Usage: preflop_gen [output] [boards per matchup, default 20000; 0 = exact] [threads]
+// Exact enumeration visits C(48,5) boards for each of ~47k distinct matchups.
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : PreflopEquity::DEFAULT_PATH;
+    int samples = argc > 2 ? std::atoi(argv[2]) : 20000;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    
+    ThreadPool pool(threads);
+    std::cout << "Generating " << path << " (" << (samples > 0 ? std::to_string(samples) + " boards per matchup" : "exact")
+              << ", " << pool.getThreadCount() << " threads)" << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    if (!PreflopEquity::generate(path, samples, pool)) {
+        std::cerr << "Could not write " << path << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    PreflopEquity table;
+    if (!table.load(path)) {
+        std::cerr << "Written table failed to load" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Done in " << seconds << "s" << std::endl;
+    int aces = PreflopEquity::classIndex(Card(Suit::SPADES, Rank::ACE), Card(Suit::HEARTS, Rank::ACE));
+    int kings = PreflopEquity::classIndex(Card(Suit::SPADES, Rank::KING), Card(Suit::HEARTS, Rank::KING));
+    int aceKing = PreflopEquity::classIndex(Card(Suit::SPADES, Rank::ACE), Card(Suit::SPADES, Rank::KING));
+    std::cout << "AA vs KK: " << table.classVsClass(aces, kings) << std::endl;
+    std::cout << "AKs vs KK: " << table.classVsClass(aceKing, kings) << std::endl;
+    std::cout << "AA vs random: " << table.equityVsRandom(Card(Suit::SPADES, Rank::ACE), Card(Suit::HEARTS, Rank::ACE), {})
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include "profiler.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+PhaseHistogram::PhaseHistogram() {
+    clear();
+}
+
+void PhaseHistogram::merge(const PhaseHistogram& other) {
+    for (int i = 0; i < BUCKETS; i++) counts[i] += other.counts[i];
+    total += other.total;
+}
+
+void PhaseHistogram::clear() {
+    std::memset(counts, 0, sizeof(counts));
+    total = 0;
+}
+
+uint64_t PhaseHistogram::valueAtPercentile(double percentile) const {
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    const int half = 1 << (SUB_BUCKET_BITS - 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += counts[i];
+        if (seen < rank) continue;
+        if (i < (1 << SUB_BUCKET_BITS)) return static_cast<uint64_t>(i);
+        int shift = i / half - 1;
+        uint64_t low = static_cast<uint64_t>(i % half + half) << shift;
+        return low + (1ULL << shift) / 2;
+    }
+    return 0;
+}
+
+namespace {
+    struct ThreadProfile {
+        std::unique_ptr<PhaseHistogram[]> variants[Profiler::MAX_VARIANTS]; // PHASES each, made on first sample
+        int variant = 0;
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadProfile>> threads; // Kept after their thread exits
+        std::vector<std::string> variantNames{"(no game)"};
+        // Clock calibration for reports
+        uint64_t startTicks = Profiler::now();
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    thread_local ThreadProfile* localProfile = nullptr;
+
+    ThreadProfile& threadProfile() {
+        if (!localProfile) {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.threads.emplace_back(new ThreadProfile());
+            localProfile = shared.threads.back().get();
+        }
+        return *localProfile;
+    }
+
+    double ticksPerNanosecond() {
+#if defined(__x86_64__) || defined(__i386__)
+        Registry& shared = registry();
+        double nanoseconds = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - shared.startTime).count();
+        uint64_t ticks = Profiler::now() - shared.startTicks;
+        return nanoseconds > 1e6 ? static_cast<double>(ticks) / nanoseconds : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+}
+
+namespace Profiler {
+    int variantSlot(const std::string& variantName) {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (size_t i = 1; i < shared.variantNames.size(); i++) {
+            if (shared.variantNames[i] == variantName) return static_cast<int>(i);
+        }
+        if (shared.variantNames.size() >= static_cast<size_t>(MAX_VARIANTS)) return 0;
+        shared.variantNames.push_back(variantName);
+        return static_cast<int>(shared.variantNames.size() - 1);
+    }
+
+    void setVariant(int slot) {
+        threadProfile().variant = (slot >= 0 && slot < MAX_VARIANTS) ? slot : 0;
+    }
+
+    void record(ProfilePhase phase, uint64_t ticks) {
+        ThreadProfile& profile = threadProfile();
+        std::unique_ptr<PhaseHistogram[]>& histograms = profile.variants[profile.variant];
+        if (!histograms) histograms.reset(new PhaseHistogram[PHASES]);
+        histograms[static_cast<int>(phase)].record(ticks);
+    }
+
+    void report(std::ostream& out) {
+        double ticksPerNs = ticksPerNanosecond();
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+
+        out << "Phase timings (ns):" << std::endl;
+        out << std::left << std::setw(18) << "  variant" << std::setw(16) << "phase" << std::right
+            << std::setw(12) << "samples" << std::setw(10) << "p50" << std::setw(10) << "p99"
+            << std::setw(10) << "p999" << std::endl;
+        for (size_t v = 0; v < shared.variantNames.size(); v++) {
+            for (int p = 0; p < PHASES; p++) {
+                PhaseHistogram merged;
+                for (const auto& thread : shared.threads) {
+                    if (thread->variants[v]) merged.merge(thread->variants[v][p]);
+                }
+                if (merged.getCount() == 0) continue;
+
+                auto ns = [&](double percentile) {
+                    return static_cast<long long>(merged.valueAtPercentile(percentile) / ticksPerNs + 0.5);
+                };
+                out << "  " << std::left << std::setw(16) << shared.variantNames[v].substr(0, 15)
+                    << std::setw(16) << phaseName(static_cast<ProfilePhase>(p)) << std::right
+                    << std::setw(12) << merged.getCount() << std::setw(10) << ns(50.0)
+                    << std::setw(10) << ns(99.0) << std::setw(10) << ns(99.9) << std::endl;
+            }
+        }
+    }
+
+    uint64_t percentileNs(ProfilePhase phase, double percentile) {
+        double ticksPerNs = ticksPerNanosecond();
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        PhaseHistogram merged;
+        for (const auto& thread : shared.threads) {
+            for (const auto& histograms : thread->variants) {
+                if (histograms) merged.merge(histograms[static_cast<int>(phase)]);
+            }
+        }
+        return static_cast<uint64_t>(merged.valueAtPercentile(percentile) / ticksPerNs + 0.5);
+    }
+
+    void reset() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (const auto& thread : shared.threads) {
+            for (auto& histograms : thread->variants) {
+                if (!histograms) continue;
+                for (int p = 0; p < PHASES; p++) histograms[p].clear();
+            }
+        }
+    }
+
+    const char* phaseName(ProfilePhase phase) {
+        switch (phase) {
+            case ProfilePhase::DEALING: return "dealing";
+            case ProfilePhase::BETTING_ROUND: return "betting round";
+            case ProfilePhase::DECISION: return "decision";
+            case ProfilePhase::COLLECT_BETS: return "collect bets";
+            case ProfilePhase::SIDE_POTS: return "side pots";
+            case ProfilePhase::FIND_BEST_HAND: return "find best hand";
+            case ProfilePhase::RENDERING: return "rendering";
+        }
+        return "?";
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <ostream>
+#include <string>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Hot-path phase timing. Scopes are compiled in only with -DPROFILE
+// (make PROFILE=1); otherwise PROFILE_SCOPE and PROFILE_VARIANT expand to
+// nothing. Each thread records into its own log-linear histograms, one per
+// phase and variant, so recording is a clock read, a shift and an
+// increment; report() merges every thread's histograms.
+//
+// Phases nest where the code does: a betting round includes its decisions
+// and its bet collection.
+enum class ProfilePhase {
+    DEALING,        // Shuffle, hole cards, streets, runouts
+    BETTING_ROUND,  // PokerGame::completeBettingRound
+    DECISION,       // Player::makeDecision
+    COLLECT_BETS,   // PokerGame::collectBetsToInFor
+    SIDE_POTS,      // Side-pot construction
+    FIND_BEST_HAND, // PokerGame::findBestHand
+    RENDERING       // Table display while logging is on
+};
+
+// HDR-style histogram of tick counts: exact below 2^SUB_BUCKET_BITS, then
+// SUB_BUCKET_BITS significant bits per power of two (about 3% resolution)
+class PhaseHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int MAX_VALUE_BITS = 40; // Longer samples are clamped
+    static const int BUCKETS = (1 << SUB_BUCKET_BITS) +
+                               (MAX_VALUE_BITS - SUB_BUCKET_BITS) * (1 << (SUB_BUCKET_BITS - 1));
+
+    PhaseHistogram();
+
+    void record(uint64_t value) {
+        counts[bucketFor(value)]++;
+        total++;
+    }
+    void merge(const PhaseHistogram& other);
+    void clear();
+
+    uint64_t getCount() const { return total; }
+    uint64_t valueAtPercentile(double percentile) const; // Bucket midpoint; 0 when empty
+
+    static int bucketFor(uint64_t value) {
+        const uint64_t sub = 1ULL << SUB_BUCKET_BITS;
+        if (value < sub) return static_cast<int>(value);
+        if (value >= (1ULL << MAX_VALUE_BITS)) value = (1ULL << MAX_VALUE_BITS) - 1;
+        int shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS + 1;
+        return shift * static_cast<int>(sub / 2) + static_cast<int>(value >> shift);
+    }
+
+private:
+    uint64_t counts[BUCKETS];
+    uint64_t total;
+};
+
+namespace Profiler {
+    const int PHASES = 7;
+    const int MAX_VARIANTS = 16; // Slot 0 collects phases run outside any game
+
+    // Registers a variant by name and returns its slot (same name, same slot)
+    int variantSlot(const std::string& variantName);
+    void setVariant(int slot); // Attributes this thread's samples until changed
+
+    // Raw clock: TSC ticks on x86, nanoseconds elsewhere
+    inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+    void record(ProfilePhase phase, uint64_t ticks);
+
+    // p50/p99/p999 in nanoseconds per phase and variant, every thread merged.
+    // Reads other threads' counters without locking: call while they are idle.
+    void report(std::ostream& out);
+    // One phase over every variant and thread, in nanoseconds; 0 with no samples
+    uint64_t percentileNs(ProfilePhase phase, double percentile);
+    void reset();
+    const char* phaseName(ProfilePhase phase);
+}
+
+class PhaseTimer {
+public:
+    explicit PhaseTimer(ProfilePhase timedPhase) : phase(timedPhase), start(Profiler::now()) {}
+    ~PhaseTimer() { Profiler::record(phase, Profiler::now() - start); }
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    ProfilePhase phase;
+    uint64_t start;
+};
+
+#ifdef PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) PhaseTimer PROFILE_CONCAT(phaseTimer, __LINE__)(phase)
+#define PROFILE_VARIANT(slot) Profiler::setVariant(slot)
+#else
+#define PROFILE_SCOPE(phase) ((void)0)
+#define PROFILE_VARIANT(slot) ((void)0)
+#endif
+
+#endif
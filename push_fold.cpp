@@ -0,0 +1,336 @@
+#include "push_fold.h"
+#include "preflop_equity.h"
+#include "fast_evaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+const char* PushFoldCharts::DEFAULT_PATH = "pushfold_charts.bin";
+
+namespace {
+    const char MAGIC[8] = {'P', 'U', 'S', 'H', 'F', 'O', 'L', 'D'};
+    const uint32_t FILE_VERSION = 2;
+    const int CLASSES = PushFoldChart::NUM_CLASSES;
+    const int DECK_SIZE = 52;
+    const int FALLBACK_SAMPLES = 400; // Boards per class pair without the preflop table
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t charts;
+    };
+
+    // Before each chart's push and call arrays
+    struct ChartHeader {
+        uint32_t players;
+        uint32_t stackBB;
+        double smallBlind;
+        double ante;
+    };
+
+    // Opponent class odds given our class (card removal included), and the
+    // same odds multiplied by our equity against that class
+    struct ClassMatchups {
+        std::vector<double> odds;
+        std::vector<double> oddsEquity;
+    };
+
+    inline uint64_t cardBit(int cardIndex) {
+        return uint64_t(1) << cardIndex;
+    }
+
+    inline CardMask toCardMask(int cardIndex) {
+        return FastEvaluator::cardMask(Card::fromIndex(cardIndex));
+    }
+
+    std::vector<double> estimateClassEquity(const std::vector<std::vector<int>>& classCards, ThreadPool* pool) {
+        std::vector<double> equity(CLASSES * CLASSES, 0.5);
+        auto estimateRow = [&](int hero, int /* worker */) {
+            std::mt19937 rng(0x5F3759DFu + hero);
+            for (int villain = hero + 1; villain < CLASSES; villain++) {
+                const std::vector<int>& heroCards = classCards[hero];
+                const std::vector<int>& villainCards = classCards[villain];
+                double share = 0.0;
+                for (int s = 0; s < FALLBACK_SAMPLES; s++) {
+                    // Random compatible combo from each class, then a random board
+                    int heroCombo, villainCombo;
+                    uint64_t used;
+                    do {
+                        heroCombo = heroCards[rng() % heroCards.size()];
+                        villainCombo = villainCards[rng() % villainCards.size()];
+                        used = cardBit(heroCombo >> 6) | cardBit(heroCombo & 63);
+                    } while (used & (cardBit(villainCombo >> 6) | cardBit(villainCombo & 63)));
+                    used |= cardBit(villainCombo >> 6) | cardBit(villainCombo & 63);
+                    CardMask heroHand = toCardMask(heroCombo >> 6) | toCardMask(heroCombo & 63);
+                    CardMask villainHand = toCardMask(villainCombo >> 6) | toCardMask(villainCombo & 63);
+                    CardMask board = 0;
+                    for (int dealt = 0; dealt < 5;) {
+                        int card = static_cast<int>(rng() % DECK_SIZE);
+                        if (used & cardBit(card)) continue;
+                        used |= cardBit(card);
+                        board |= toCardMask(card);
+                        dealt++;
+                    }
+                    int heroValue = FastEvaluator::evaluate(heroHand | board);
+                    int villainValue = FastEvaluator::evaluate(villainHand | board);
+                    share += heroValue > villainValue ? 1.0 : (heroValue == villainValue ? 0.5 : 0.0);
+                }
+                equity[hero * CLASSES + villain] = share / FALLBACK_SAMPLES;
+                equity[villain * CLASSES + hero] = 1.0 - share / FALLBACK_SAMPLES;
+            }
+        };
+        if (pool) {
+            pool->parallelFor(CLASSES, estimateRow);
+        } else {
+            for (int hero = 0; hero < CLASSES; hero++) estimateRow(hero, 0);
+        }
+        return equity;
+    }
+
+    ClassMatchups buildMatchups(ThreadPool* pool) {
+        // Combos of each class, packed as (high card << 6) | low card
+        std::vector<std::vector<int>> classCards(CLASSES);
+        std::vector<int> comboClass;
+        std::vector<uint64_t> comboMask;
+        for (int first = 1; first < DECK_SIZE; first++) {
+            for (int second = 0; second < first; second++) {
+                int handClass = PreflopEquity::classIndex(Card::fromIndex(first), Card::fromIndex(second));
+                classCards[handClass].push_back((first << 6) | second);
+                comboClass.push_back(handClass);
+                comboMask.push_back(cardBit(first) | cardBit(second));
+            }
+        }
+
+        std::vector<double> pairs(CLASSES * CLASSES, 0.0);
+        for (size_t hero = 0; hero < comboMask.size(); hero++) {
+            for (size_t villain = 0; villain < comboMask.size(); villain++) {
+                if (comboMask[hero] & comboMask[villain]) continue;
+                pairs[comboClass[hero] * CLASSES + comboClass[villain]] += 1.0;
+            }
+        }
+
+        const PreflopEquity& table = PreflopEquity::shared();
+        std::vector<double> equity;
+        if (table.isLoaded()) {
+            equity.resize(CLASSES * CLASSES);
+            for (int hero = 0; hero < CLASSES; hero++) {
+                for (int villain = 0; villain < CLASSES; villain++) {
+                    equity[hero * CLASSES + villain] = table.classVsClass(hero, villain);
+                }
+            }
+        } else {
+            equity = estimateClassEquity(classCards, pool);
+        }
+
+        ClassMatchups matchups;
+        matchups.odds.resize(CLASSES * CLASSES);
+        matchups.oddsEquity.resize(CLASSES * CLASSES);
+        for (int hero = 0; hero < CLASSES; hero++) {
+            double total = 0.0;
+            for (int villain = 0; villain < CLASSES; villain++) total += pairs[hero * CLASSES + villain];
+            for (int villain = 0; villain < CLASSES; villain++) {
+                int cell = hero * CLASSES + villain;
+                matchups.odds[cell] = pairs[cell] / total;
+                matchups.oddsEquity[cell] = matchups.odds[cell] * equity[cell];
+            }
+        }
+        return matchups;
+    }
+
+    const ClassMatchups& classMatchups(ThreadPool* pool) {
+        static const ClassMatchups matchups = buildMatchups(pool);
+        return matchups;
+    }
+
+    inline void weightedSums(const double* odds, const double* oddsEquity, const double* strategy,
+                             double& weight, double& equity) {
+        weight = 0.0;
+        equity = 0.0;
+        for (int c = 0; c < CLASSES; c++) {
+            weight += odds[c] * strategy[c];
+            equity += oddsEquity[c] * strategy[c];
+        }
+    }
+}
+
+PushFoldChart PushFoldChart::solve(const PushFoldSettings& settings, ThreadPool* pool, int iterations) {
+    const ClassMatchups& matchups = classMatchups(pool);
+    int n = settings.players;
+
+    // Forced bets by position; a stack that can't cover them is simply all in
+    std::vector<double> posted(n, settings.ante);
+    posted[n - 2] += settings.smallBlind;
+    posted[n - 1] += 1.0;
+    double deadMoney = 0.0;
+    for (double amount : posted) deadMoney += amount;
+    double stack = std::max(static_cast<double>(settings.stackBB), posted[n - 1]);
+
+    // Average strategies start at even odds; best responses are pure
+    std::vector<double> push(n * CLASSES, 0.5), call(n * n * CLASSES, 0.5);
+    std::vector<double> pushResponse(push.size(), 0.0), callResponse(call.size(), 0.0);
+
+    auto respond = [&](int pusher, int /* worker */) {
+        const double* pushRange = &push[pusher * CLASSES];
+        for (int c = 0; c < CLASSES; c++) {
+            const double* odds = &matchups.odds[c * CLASSES];
+            const double* oddsEquity = &matchups.oddsEquity[c * CLASSES];
+
+            // Calling: equity against the pusher's range, for the pot that caller would play for
+            double weight, equity;
+            weightedSums(odds, oddsEquity, pushRange, weight, equity);
+            double callEquity = weight > 0.0 ? equity / weight : 0.5;
+            for (int caller = pusher + 1; caller < n; caller++) {
+                double pot = 2.0 * stack + deadMoney - posted[pusher] - posted[caller];
+                callResponse[(pusher * n + caller) * CLASSES + c] = callEquity * pot > stack - posted[caller] ? 1.0 : 0.0;
+            }
+
+            // Pushing: the first caller behind takes it to showdown, otherwise the blinds and antes are ours
+            double stillFolding = 1.0;
+            double value = 0.0;
+            for (int caller = pusher + 1; caller < n; caller++) {
+                const double* callRange = &call[(pusher * n + caller) * CLASSES];
+                weightedSums(odds, oddsEquity, callRange, weight, equity);
+                double pot = 2.0 * stack + deadMoney - posted[pusher] - posted[caller];
+                value += stillFolding * equity * pot;
+                stillFolding *= 1.0 - weight;
+            }
+            value += stillFolding * (stack - posted[pusher] + deadMoney);
+            pushResponse[pusher * CLASSES + c] = value > stack - posted[pusher] ? 1.0 : 0.0;
+        }
+    };
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        if (pool) {
+            pool->parallelFor(n - 1, respond);
+        } else {
+            for (int pusher = 0; pusher < n - 1; pusher++) respond(pusher, 0);
+        }
+        double step = 1.0 / (iteration + 2);
+        for (size_t i = 0; i < push.size(); i++) push[i] += (pushResponse[i] - push[i]) * step;
+        for (size_t i = 0; i < call.size(); i++) call[i] += (callResponse[i] - call[i]) * step;
+    }
+
+    PushFoldChart chart;
+    chart.settings = settings;
+    chart.push.assign(push.begin(), push.end());
+    chart.call.assign(call.begin(), call.end());
+    // The big blind never pushes, and nobody calls their own push or an earlier seat's
+    for (int c = 0; c < CLASSES; c++) chart.push[(n - 1) * CLASSES + c] = 0.0f;
+    for (int pusher = 0; pusher < n; pusher++) {
+        for (int caller = 0; caller <= pusher; caller++) {
+            std::fill_n(chart.call.begin() + (pusher * n + caller) * CLASSES, CLASSES, 0.0f);
+        }
+    }
+    return chart;
+}
+
+bool PushFoldChart::write(std::ostream& out) const {
+    ChartHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.players = static_cast<uint32_t>(settings.players);
+    header.stackBB = static_cast<uint32_t>(settings.stackBB);
+    header.smallBlind = settings.smallBlind;
+    header.ante = settings.ante;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(push.data()), sizeof(float) * push.size());
+    out.write(reinterpret_cast<const char*>(call.data()), sizeof(float) * call.size());
+    return static_cast<bool>(out);
+}
+
+bool PushFoldChart::read(std::istream& in) {
+    ChartHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (header.players < MIN_PLAYERS || header.players > MAX_PLAYERS || header.stackBB < 1 ||
+        header.stackBB > MAX_STACK_BB) {
+        return false;
+    }
+
+    int n = static_cast<int>(header.players);
+    std::vector<float> pushData(n * CLASSES), callData(n * n * CLASSES);
+    in.read(reinterpret_cast<char*>(pushData.data()), sizeof(float) * pushData.size());
+    in.read(reinterpret_cast<char*>(callData.data()), sizeof(float) * callData.size());
+    if (!in) return false;
+
+    settings = {n, static_cast<int>(header.stackBB), header.smallBlind, header.ante};
+    push.swap(pushData);
+    call.swap(callData);
+    return true;
+}
+
+PushFoldCharts& PushFoldCharts::shared() {
+    static PushFoldCharts charts;
+    return charts;
+}
+
+bool PushFoldCharts::generate(const std::string& path, double smallBlindBB, const std::vector<double>& antesBB,
+                              ThreadPool& pool, int iterations) {
+    // Settings are stored at the lookup resolution so a file chart always matches its own key
+    std::vector<PushFoldSettings> settings;
+    for (double ante : antesBB) {
+        for (int players = PushFoldChart::MIN_PLAYERS; players <= PushFoldChart::MAX_PLAYERS; players++) {
+            for (int stack = 1; stack <= PushFoldChart::MAX_STACK_BB; stack++) {
+                settings.push_back({players, stack, smallBlindKey(smallBlindBB) / 100.0, anteKey(ante) / 40.0});
+            }
+        }
+    }
+
+    // Equity matchups first, so the fallback estimate can use the whole pool
+    classMatchups(&pool);
+    std::vector<PushFoldChart> charts(settings.size());
+    pool.parallelFor(static_cast<int>(settings.size()), [&](int index, int /* worker */) {
+        charts[index] = PushFoldChart::solve(settings[index], nullptr, iterations);
+    });
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.charts = static_cast<uint32_t>(charts.size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const PushFoldChart& chart : charts) {
+        if (!chart.write(file)) return false;
+    }
+    return static_cast<bool>(file);
+}
+
+bool PushFoldCharts::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != FILE_VERSION) return false;
+
+    int slotCount = (PushFoldChart::MAX_PLAYERS - PushFoldChart::MIN_PLAYERS + 1) * PushFoldChart::MAX_STACK_BB;
+    std::vector<std::vector<Entry>> loaded(slotCount);
+    for (uint32_t i = 0; i < header.charts; i++) {
+        Entry entry;
+        if (!entry.chart.read(file)) return false;
+        const PushFoldSettings& settings = entry.chart.getSettings();
+        entry.smallBlindKey = smallBlindKey(settings.smallBlind);
+        entry.anteKey = anteKey(settings.ante);
+        loaded[slotIndex(settings.players, settings.stackBB)].push_back(std::move(entry));
+    }
+
+    slots.swap(loaded);
+    chartCount = static_cast<int>(header.charts);
+    return true;
+}
+
+const PushFoldChart* PushFoldCharts::get(int players, double stackBB, double smallBlindBB, double anteBB) const {
+    int stack = std::max(1, static_cast<int>(std::lround(stackBB)));
+    if (chartCount == 0 || players < PushFoldChart::MIN_PLAYERS || players > PushFoldChart::MAX_PLAYERS ||
+        stack > PushFoldChart::MAX_STACK_BB) {
+        return nullptr;
+    }
+    long smallBlind = smallBlindKey(smallBlindBB);
+    long ante = anteKey(anteBB);
+    for (const Entry& entry : slots[slotIndex(players, stack)]) {
+        if (entry.smallBlindKey == smallBlind && entry.anteKey == ante) return &entry.chart;
+    }
+    return nullptr;
+}
@@ -0,0 +1,100 @@
+#ifndef PUSH_FOLD_H
+#define PUSH_FOLD_H
+
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cmath>
+
+// Short-stack No-Limit Hold'em where every decision is all-in or fold.
+// Everyone starts the hand with the same effective stack; amounts are in big blinds.
+struct PushFoldSettings {
+    int players;       // 2-6
+    int stackBB;       // Effective stack before posting
+    double smallBlind; // Usually 0.5
+    double ante;       // Per player
+};
+
+// Equilibrium push and call frequencies over the 169 starting-hand classes
+// (PreflopEquity::classIndex). Positions follow preflop action order:
+// 0 acts first, players - 2 is the small blind and players - 1 the big blind
+// (heads-up that makes the small blind position 0).
+//
+// Solved by fictitious play: every iteration each pusher and caller plays a
+// best response to the others' average strategies, and the averages move
+// towards it. Only one caller is modelled; once somebody calls, everyone
+// behind folds, so the showdown is always heads-up.
+class PushFoldChart {
+public:
+    static const int NUM_CLASSES = 169;
+    static const int MIN_PLAYERS = 2;
+    static const int MAX_PLAYERS = 6;
+    static const int MAX_STACK_BB = 15;
+    static const int DEFAULT_ITERATIONS = 300;
+
+    float pushFrequency(int position, int handClass) const {
+        return push[position * NUM_CLASSES + handClass];
+    }
+    float callFrequency(int pusher, int caller, int handClass) const {
+        return call[(pusher * settings.players + caller) * NUM_CLASSES + handClass];
+    }
+    const PushFoldSettings& getSettings() const { return settings; }
+
+    // Class-vs-class equity comes from PreflopEquity::shared() when it is loaded,
+    // otherwise from a one-off Monte Carlo estimate. pool may be nullptr.
+    static PushFoldChart solve(const PushFoldSettings& settings, ThreadPool* pool = nullptr,
+                               int iterations = DEFAULT_ITERATIONS);
+
+private:
+    friend class PushFoldCharts;
+
+    bool write(std::ostream& out) const;
+    bool read(std::istream& in); // False if truncated or not a chart
+
+    PushFoldSettings settings;
+    std::vector<float> push; // [position][class]
+    std::vector<float> call; // [pusher][caller][class]
+};
+
+// Read-only chart set for the player AI, solved offline by pushfold_gen and
+// loaded once at startup, before any table runs. Charts are keyed by players,
+// whole big blinds of stack, and the small blind and ante in 1/100 and 1/40
+// of a big blind; lookups take no lock and never solve.
+class PushFoldCharts {
+public:
+    static const char* DEFAULT_PATH;
+
+    static PushFoldCharts& shared();
+
+    // Offline generation: every player count and stack depth up to MAX_STACK_BB
+    // for each ante, charts solved in parallel across the pool's threads
+    static bool generate(const std::string& path, double smallBlindBB, const std::vector<double>& antesBB,
+                         ThreadPool& pool, int iterations = PushFoldChart::DEFAULT_ITERATIONS);
+
+    bool load(const std::string& path); // False if missing or not a chart file
+    bool isLoaded() const { return chartCount > 0; }
+    int getChartCount() const { return chartCount; }
+
+    // nullptr outside MIN/MAX_PLAYERS, above MAX_STACK_BB or for a blind and
+    // ante structure the file doesn't cover; the bot then plays its heuristics
+    const PushFoldChart* get(int players, double stackBB, double smallBlindBB, double anteBB) const;
+
+private:
+    struct Entry {
+        long smallBlindKey;
+        long anteKey;
+        PushFoldChart chart;
+    };
+
+    static long smallBlindKey(double smallBlindBB) { return std::lround(smallBlindBB * 100.0); }
+    static long anteKey(double anteBB) { return std::lround(anteBB * 40.0); }
+    static int slotIndex(int players, int stackBB) {
+        return (players - PushFoldChart::MIN_PLAYERS) * PushFoldChart::MAX_STACK_BB + stackBB - 1;
+    }
+
+    int chartCount = 0;
+    std::vector<std::vector<Entry>> slots; // [players - MIN_PLAYERS][stack - 1], one entry per structure
+};
+
+#endif
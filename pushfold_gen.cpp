@@ -0,0 +1,57 @@
+#include "push_fold.h"
+#include "preflop_equity.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+
+// Solves the push/fold charts read by PushFoldCharts: 2-6 players, 1-15 big blinds,
+// for each ante. The default antes cover the tournament schedule (none, 1/10, 1/8
+// and 3/20 of the big blind); other structures fall back to the bot's heuristics.
+// Usage: pushfold_gen [output] [antes in big blinds, comma-separated] [iterations] [threads]
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : PushFoldCharts::DEFAULT_PATH;
+    std::string anteList = argc > 2 ? argv[2] : "0,0.1,0.125,0.15";
+    int iterations = argc > 3 ? std::atoi(argv[3]) : PushFoldChart::DEFAULT_ITERATIONS;
+    int threads = argc > 4 ? std::atoi(argv[4]) : 0;
+    
+    std::vector<double> antes;
+    std::stringstream antesIn(anteList);
+    for (std::string ante; std::getline(antesIn, ante, ',');) {
+        antes.push_back(std::atof(ante.c_str()));
+    }
+    
+    // Exact class equities when the preflop table is there, otherwise a Monte Carlo estimate
+    bool exact = PreflopEquity::shared().load(PreflopEquity::DEFAULT_PATH);
+    ThreadPool pool(threads);
+    std::cout << "Solving push/fold charts for antes " << anteList << " (" << iterations << " iterations, "
+              << (exact ? "preflop table" : "sampled equities") << ", " << pool.getThreadCount() << " threads)"
+              << std::endl;
+    
+    auto start = std::chrono::steady_clock::now();
+    if (!PushFoldCharts::generate(path, 0.5, antes, pool, iterations)) {
+        std::cerr << "Could not write " << path << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    PushFoldCharts charts;
+    if (!charts.load(path)) {
+        std::cerr << "Written charts failed to load" << std::endl;
+        return 1;
+    }
+    std::cout << "Done in " << seconds << "s, " << charts.getChartCount() << " charts" << std::endl;
+    
+    // Heads-up at 10 big blinds with the first ante: how much of the deck the small blind shoves
+    const PushFoldChart* headsUp = charts.get(2, 10.0, 0.5, antes.empty() ? 0.0 : antes[0]);
+    if (headsUp) {
+        int shoves = 0;
+        for (int c = 0; c < PushFoldChart::NUM_CLASSES; c++) {
+            shoves += headsUp->pushFrequency(0, c) > 0.5f ? 1 : 0;
+        }
+        std::cout << "Heads-up 10bb small blind pushes " << shoves << " of " << PushFoldChart::NUM_CLASSES
+                  << " classes" << std::endl;
+    }
+    std::cout << "Wrote " << path << std::endl;
+    return 0;
+}
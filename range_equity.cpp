@@ -0,0 +1,317 @@
+#include "range_equity.h"
+#include "fast_evaluator.h"
+#include "preflop_equity.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+namespace {
+    const int CHUNKS = 64;
+    const int DECK_SIZE = 52;
+    
+    inline CardMask maskOfIndex(int cardIndex) {
+        return CardMask(1) << (16 * (cardIndex / 13) + cardIndex % 13);
+    }
+    
+    // Board completions: every one after the flop, a fixed-seed sample before it
+    class Runouts {
+    public:
+        Runouts(CardMask used, int missing, int samples, unsigned seed)
+            : missing(missing), samples(samples), seed(seed) {
+            for (int card = 0; card < DECK_SIZE; card++) {
+                if (!(maskOfIndex(card) & used)) deck.push_back(maskOfIndex(card));
+            }
+            int n = static_cast<int>(deck.size());
+            if (missing == 0) {
+                enumerated.push_back(0);
+            } else if (missing == 1) {
+                enumerated = deck;
+            } else if (missing == 2) {
+                for (int a = 0; a < n; a++)
+                    for (int b = a + 1; b < n; b++)
+                        enumerated.push_back(deck[a] | deck[b]);
+            }
+        }
+        
+        bool isSampled() const { return enumerated.empty(); }
+        double count() const { return isSampled() ? samples : static_cast<double>(enumerated.size()); }
+        
+        template <typename Fn>
+        void forChunk(int chunk, Fn&& fn) const {
+            if (!isSampled()) {
+                size_t begin = enumerated.size() * chunk / CHUNKS;
+                size_t end = enumerated.size() * (chunk + 1) / CHUNKS;
+                for (size_t i = begin; i < end; i++) fn(enumerated[i]);
+                return;
+            }
+            int begin = static_cast<int>(static_cast<long long>(samples) * chunk / CHUNKS);
+            int end = static_cast<int>(static_cast<long long>(samples) * (chunk + 1) / CHUNKS);
+            std::mt19937 rng(seed * CHUNKS + chunk);
+            std::vector<CardMask> cards(deck);
+            int n = static_cast<int>(cards.size());
+            for (int s = begin; s < end; s++) {
+                CardMask runout = 0;
+                for (int i = 0; i < missing; i++) {
+                    int j = i + static_cast<int>(rng() % (n - i));
+                    std::swap(cards[i], cards[j]);
+                    runout |= cards[i];
+                }
+                fn(runout);
+            }
+        }
+        
+    private:
+        int missing;
+        int samples;
+        unsigned seed;
+        std::vector<CardMask> deck;
+        std::vector<CardMask> enumerated;
+    };
+    
+    // Values pushed in ascending order; weight sums below / up to a value
+    class SortedWeights {
+    public:
+        void clear() {
+            values.clear();
+            prefix.assign(1, 0.0);
+        }
+        void push(int value, double weight) {
+            values.push_back(value);
+            prefix.push_back(prefix.back() + weight);
+        }
+        double total() const { return prefix.back(); }
+        double below(int value) const {
+            return prefix[std::lower_bound(values.begin(), values.end(), value) - values.begin()];
+        }
+        double atMost(int value) const {
+            return prefix[std::upper_bound(values.begin(), values.end(), value) - values.begin()];
+        }
+        
+    private:
+        std::vector<int> values;
+        std::vector<double> prefix{0.0};
+    };
+    
+    struct HoldemCombo {
+        int combo;
+        int high;
+        int low;
+        CardMask mask;
+        double weight;
+    };
+    
+    std::vector<HoldemCombo> liveCombos(const HoldemRange& range, CardMask used) {
+        std::vector<HoldemCombo> combos;
+        for (int combo = 0; combo < HoldemRange::NUM_COMBOS; combo++) {
+            double weight = range.getWeight(combo);
+            if (weight <= 0.0) continue;
+            HoldemCombo entry;
+            entry.combo = combo;
+            HoldemRange::comboCards(combo, entry.high, entry.low);
+            entry.mask = maskOfIndex(entry.high) | maskOfIndex(entry.low);
+            entry.weight = weight;
+            if (!(entry.mask & used)) combos.push_back(entry);
+        }
+        return combos;
+    }
+    
+    struct OmahaCombo {
+        CardMask hole[4];
+        CardMask mask;
+        double weight;
+    };
+    
+    std::vector<OmahaCombo> liveCombos(const OmahaRange& range, CardMask used) {
+        std::vector<OmahaCombo> combos;
+        for (const OmahaRange::Entry& entry : range.getEntries()) {
+            if (entry.weight <= 0.0f) continue;
+            int cards[4];
+            OmahaRange::comboCards(entry.combo, cards);
+            OmahaCombo combo;
+            combo.mask = 0;
+            for (int i = 0; i < 4; i++) {
+                combo.hole[i] = maskOfIndex(cards[i]);
+                combo.mask |= combo.hole[i];
+            }
+            combo.weight = entry.weight;
+            if (!(combo.mask & used)) combos.push_back(combo);
+        }
+        return combos;
+    }
+    
+    CardMask boardMask(const std::vector<Card>& board, const std::vector<Card>& deadCards, CardMask& deadMask) {
+        if (board.size() == 1 || board.size() == 2 || board.size() > 5) {
+            throw std::invalid_argument("Board must have 0, 3, 4 or 5 cards");
+        }
+        deadMask = FastEvaluator::handMask(deadCards);
+        return FastEvaluator::handMask(board);
+    }
+    
+    template <typename Fn>
+    void runChunks(ThreadPool* pool, Fn&& fn) {
+        if (pool) {
+            pool->parallelFor(CHUNKS, [&](int chunk, int /* worker */) { fn(chunk); });
+        } else {
+            for (int chunk = 0; chunk < CHUNKS; chunk++) fn(chunk);
+        }
+    }
+    
+    RangeEquity::Result combine(const std::vector<double>& scores, const std::vector<double>& weights, double runouts) {
+        double score = 0.0;
+        double weight = 0.0;
+        for (int chunk = 0; chunk < CHUNKS; chunk++) {
+            score += scores[chunk];
+            weight += weights[chunk];
+        }
+        RangeEquity::Result result;
+        result.equity = weight > 0.0 ? score / weight : 0.0;
+        result.matchups = runouts > 0.0 ? weight / runouts : 0.0;
+        return result;
+    }
+}
+
+RangeEquity::Result RangeEquity::holdem(const HoldemRange& hero, const HoldemRange& villain, const std::vector<Card>& board,
+                                        const std::vector<Card>& deadCards, ThreadPool* pool, int samples, unsigned seed) {
+    CardMask dead;
+    CardMask boardCards = boardMask(board, deadCards, dead);
+    std::vector<HoldemCombo> heroCombos = liveCombos(hero, boardCards | dead);
+    std::vector<HoldemCombo> villainCombos = liveCombos(villain, boardCards | dead);
+    
+    // Preflop with the equity table: every combo pair is already exact
+    const PreflopEquity& table = PreflopEquity::shared();
+    if (board.empty() && deadCards.empty() && table.isLoaded()) {
+        Result result = {0.0, 0.0};
+        double score = 0.0;
+        for (const HoldemCombo& h : heroCombos) {
+            for (const HoldemCombo& v : villainCombos) {
+                if (h.mask & v.mask) continue;
+                double weight = h.weight * v.weight;
+                score += weight * table.comboVsCombo(h.combo, v.combo);
+                result.matchups += weight;
+            }
+        }
+        result.equity = result.matchups > 0.0 ? score / result.matchups : 0.0;
+        return result;
+    }
+    
+    Runouts runouts(boardCards | dead, 5 - static_cast<int>(board.size()), samples, seed);
+    std::vector<double> scores(CHUNKS, 0.0);
+    std::vector<double> weights(CHUNKS, 0.0);
+    
+    runChunks(pool, [&](int chunk) {
+        SortedWeights all;
+        std::vector<SortedWeights> byCard(DECK_SIZE);
+        std::vector<int> villainValue(HoldemRange::NUM_COMBOS, 0);
+        std::vector<double> villainWeight(HoldemRange::NUM_COMBOS, 0.0);
+        std::vector<std::pair<int, int>> ranked; // (value, index into villainCombos)
+        double score = 0.0;
+        double weight = 0.0;
+        
+        runouts.forChunk(chunk, [&](CardMask runout) {
+            CardMask full = boardCards | runout;
+            
+            // Rank the villain's live combos on this board
+            ranked.clear();
+            for (size_t i = 0; i < villainCombos.size(); i++) {
+                const HoldemCombo& v = villainCombos[i];
+                villainWeight[v.combo] = 0.0;
+                if (v.mask & runout) continue;
+                int value = FastEvaluator::evaluate(v.mask | full);
+                villainValue[v.combo] = value;
+                villainWeight[v.combo] = v.weight;
+                ranked.push_back({value, static_cast<int>(i)});
+            }
+            std::sort(ranked.begin(), ranked.end());
+            all.clear();
+            for (SortedWeights& cardWeights : byCard) cardWeights.clear();
+            for (const auto& entry : ranked) {
+                const HoldemCombo& v = villainCombos[entry.second];
+                all.push(entry.first, v.weight);
+                byCard[v.high].push(entry.first, v.weight);
+                byCard[v.low].push(entry.first, v.weight);
+            }
+            
+            // Villain combos sharing a hero card are taken back out; the combo
+            // holding both hero cards was removed twice and is added back once
+            for (const HoldemCombo& h : heroCombos) {
+                if (h.mask & runout) continue;
+                int value = FastEvaluator::evaluate(h.mask | full);
+                const SortedWeights& first = byCard[h.high];
+                const SortedWeights& second = byCard[h.low];
+                double same = villainWeight[h.combo];
+                int sameValue = villainValue[h.combo];
+                
+                double below = all.below(value) - first.below(value) - second.below(value) +
+                               (same > 0.0 && sameValue < value ? same : 0.0);
+                double upTo = all.atMost(value) - first.atMost(value) - second.atMost(value) +
+                              (same > 0.0 && sameValue <= value ? same : 0.0);
+                double total = all.total() - first.total() - second.total() + same;
+                
+                score += h.weight * (below + 0.5 * (upTo - below));
+                weight += h.weight * total;
+            }
+        });
+        scores[chunk] = score;
+        weights[chunk] = weight;
+    });
+    return combine(scores, weights, runouts.count());
+}
+
+RangeEquity::Result RangeEquity::omaha(const OmahaRange& hero, const OmahaRange& villain, const std::vector<Card>& board,
+                                       bool hiLo, const std::vector<Card>& deadCards, ThreadPool* pool,
+                                       int samples, unsigned seed) {
+    CardMask dead;
+    CardMask boardCards = boardMask(board, deadCards, dead);
+    std::vector<OmahaCombo> heroCombos = liveCombos(hero, boardCards | dead);
+    std::vector<OmahaCombo> villainCombos = liveCombos(villain, boardCards | dead);
+    
+    Runouts runouts(boardCards | dead, 5 - static_cast<int>(board.size()), samples, seed);
+    std::vector<double> scores(CHUNKS, 0.0);
+    std::vector<double> weights(CHUNKS, 0.0);
+    
+    runChunks(pool, [&](int chunk) {
+        std::vector<int> heroHigh(heroCombos.size()), heroLow(heroCombos.size());
+        std::vector<int> villainHigh(villainCombos.size()), villainLow(villainCombos.size());
+        double score = 0.0;
+        double weight = 0.0;
+        
+        auto evaluateAll = [&](const std::vector<OmahaCombo>& combos, const CardMask* five, CardMask runout,
+                               std::vector<int>& high, std::vector<int>& low) {
+            for (size_t i = 0; i < combos.size(); i++) {
+                if (combos[i].mask & runout) continue;
+                high[i] = FastEvaluator::evaluateOmaha(combos[i].hole, 4, five, 5);
+                low[i] = hiLo ? FastEvaluator::evaluateOmahaLowA5(combos[i].hole, 4, five, 5) : FAST_LOW_UNQUALIFIED;
+            }
+        };
+        
+        runouts.forChunk(chunk, [&](CardMask runout) {
+            CardMask five[5];
+            int count = 0;
+            for (CardMask rest = boardCards | runout; rest; rest &= rest - 1) {
+                five[count++] = rest & (~rest + 1); // Lowest set bit
+            }
+            evaluateAll(heroCombos, five, runout, heroHigh, heroLow);
+            evaluateAll(villainCombos, five, runout, villainHigh, villainLow);
+            
+            for (size_t h = 0; h < heroCombos.size(); h++) {
+                if (heroCombos[h].mask & runout) continue;
+                for (size_t v = 0; v < villainCombos.size(); v++) {
+                    if ((villainCombos[v].mask & runout) || (villainCombos[v].mask & heroCombos[h].mask)) continue;
+                    double pairWeight = heroCombos[h].weight * villainCombos[v].weight;
+                    double highShare = heroHigh[h] > villainHigh[v] ? 1.0 : (heroHigh[h] == villainHigh[v] ? 0.5 : 0.0);
+                    double share = highShare;
+                    if (heroLow[h] != FAST_LOW_UNQUALIFIED || villainLow[v] != FAST_LOW_UNQUALIFIED) {
+                        // Low half to the better qualifying low
+                        double lowShare = heroLow[h] < villainLow[v] ? 1.0 : (heroLow[h] == villainLow[v] ? 0.5 : 0.0);
+                        share = 0.5 * highShare + 0.5 * lowShare;
+                    }
+                    score += pairWeight * share;
+                    weight += pairWeight;
+                }
+            }
+        });
+        scores[chunk] = score;
+        weights[chunk] = weight;
+    });
+    return combine(scores, weights, runouts.count());
+}
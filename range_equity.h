@@ -0,0 +1,35 @@
+#ifndef RANGE_EQUITY_H
+#define RANGE_EQUITY_H
+
+#include "hand_range.h"
+#include "thread_pool.h"
+#include <vector>
+
+// All-in equity of one range against another. Every (hero combo, villain
+// combo, runout) triple with no card in common counts once, weighted by the
+// two combo weights. Runouts are enumerated when the board has three or more
+// cards and sampled before the flop (unless the preflop table answers).
+// Runouts are split into fixed chunks, so results do not depend on the
+// thread count. pool may be nullptr.
+class RangeEquity {
+public:
+    static const int DEFAULT_SAMPLES = 20000; // Preflop boards when enumeration is out of reach
+    
+    struct Result {
+        double equity;    // Hero's share of the pot, ties split
+        double matchups;  // Weight of the combo pairs counted, averaged over runouts
+    };
+    
+    // Villain combos per runout are ranked once and searched by value, so the
+    // cost is O(hero + villain * log villain) evaluations per runout
+    static Result holdem(const HoldemRange& hero, const HoldemRange& villain, const std::vector<Card>& board,
+                         const std::vector<Card>& deadCards = {}, ThreadPool* pool = nullptr,
+                         int samples = DEFAULT_SAMPLES, unsigned seed = 1);
+    
+    // Omaha high, or Omaha high-low (8-or-better) when hiLo is set
+    static Result omaha(const OmahaRange& hero, const OmahaRange& villain, const std::vector<Card>& board,
+                        bool hiLo, const std::vector<Card>& deadCards = {}, ThreadPool* pool = nullptr,
+                        int samples = DEFAULT_SAMPLES, unsigned seed = 1);
+};
+
+#endif
@@ -1,7 +1,27 @@
 #include "side_pot.h"
+#include "game_log.h"
+#include "profiler.h"
+#include "alloc_stats.h"
+#include "metrics.h"
 #include <iostream>
 #include <algorithm>
 
+void SidePotManager::setArena(MonotonicArena* arena) {
+    allocator = ArenaAllocator<int>(arena);
+}
+
+void SidePotManager::releaseArena(MonotonicArena* arena) {
+    for (const SidePot& pot : pots) {
+        if (pot.eligiblePlayers.get_allocator().getArena() == arena) {
+            pots.clear();
+            break;
+        }
+    }
+    if (allocator.getArena() == arena) {
+        allocator = ArenaAllocator<int>();
+    }
+}
+
 void SidePotManager::clearPots() {
     pots.clear();
 }
@@ -11,6 +31,8 @@ void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int
 }
 
 void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int>>& playerBets, bool clearExisting) {
+    ALLOC_SCOPE(AllocTag::POTS);
+    PROFILE_SCOPE(ProfilePhase::SIDE_POTS);
     if (clearExisting) {
         clearPots();
     }
@@ -35,7 +57,7 @@ void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int
     }
     
     // Cap all bets at the maximum matchable amount
-    std::vector<std::pair<int, int>> cappedBets;
+    ArenaVector<std::pair<int, int>> cappedBets(allocator);
     for (const auto& playerBet : playerBets) {
         int cappedAmount = std::min(playerBet.second, maxMatchableBet);
         if (cappedAmount > 0) {
@@ -44,14 +66,14 @@ void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int
     }
     
     // Collect unique bet levels and sort them (ascending)
-    std::set<int> betLevels;
+    ArenaSet<int> betLevels(allocator);
     for (const auto& playerBet : cappedBets) {
         if (playerBet.second > 0) {
             betLevels.insert(playerBet.second);
         }
     }
     
-    std::vector<int> sortedLevels(betLevels.begin(), betLevels.end());
+    ArenaVector<int> sortedLevels(betLevels.begin(), betLevels.end(), allocator);
     std::sort(sortedLevels.begin(), sortedLevels.end());
     
     // Create pots starting from the smallest bet amount
@@ -61,7 +83,7 @@ void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int
         int potContribution = currentLevel - previousLevel;
         
         // Find all players who bet at least this level
-        std::set<int> eligiblePlayers;
+        PlayerSet eligiblePlayers(allocator);
         for (const auto& playerBet : cappedBets) {
             if (playerBet.second >= currentLevel) {
                 eligiblePlayers.insert(playerBet.first);
@@ -71,8 +93,11 @@ void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int
         // Only create pot if more than one player is eligible
         if (eligiblePlayers.size() > 1) {
             int potAmount = potContribution * static_cast<int>(eligiblePlayers.size());
-            pots.emplace_back(potAmount, currentLevel);
+            pots.emplace_back(potAmount, currentLevel, allocator);
             pots.back().eligiblePlayers = eligiblePlayers;
+            if (pots.size() > 1) {
+                Metrics::countSidePot();
+            }
             
 
         }
@@ -81,9 +106,9 @@ void SidePotManager::createSidePotsFromBets(const std::vector<std::pair<int, int
     }
 }
 
-void SidePotManager::addToPot(int amount, const std::set<int>& eligiblePlayers) {
+void SidePotManager::addToPot(int amount, const PlayerSet& eligiblePlayers) {
     if (pots.empty()) {
-        pots.emplace_back(amount, 0);
+        pots.emplace_back(amount, 0, allocator);
         pots.back().eligiblePlayers = eligiblePlayers;
     } else {
         pots[0].amount += amount;
@@ -100,13 +125,11 @@ void SidePotManager::addToMainPot(int amount) {
         pots[0].amount += amount;
     } else {
         // Create a new main pot - eligibility will be set when active players create pots
-        std::set<int> emptyEligibility;
-        pots.emplace_back(amount, 0);
-        pots.back().eligiblePlayers = emptyEligibility;
+        pots.emplace_back(amount, 0, allocator);
     }
 }
 
-void SidePotManager::addEligiblePlayersToMainPot(const std::set<int>& players) {
+void SidePotManager::addEligiblePlayersToMainPot(const PlayerSet& players) {
     if (!pots.empty()) {
         for (int playerIndex : players) {
             pots[0].eligiblePlayers.insert(playerIndex);
@@ -114,12 +137,13 @@ void SidePotManager::addEligiblePlayersToMainPot(const std::set<int>& players) {
     }
 }
 
-void SidePotManager::addSidePot(int amount, int betLevel, const std::set<int>& eligiblePlayers) {
-    pots.emplace_back(amount, betLevel);
+void SidePotManager::addSidePot(int amount, int betLevel, const PlayerSet& eligiblePlayers) {
+    pots.emplace_back(amount, betLevel, allocator);
     pots.back().eligiblePlayers = eligiblePlayers;
+    Metrics::countSidePot();
 }
 
-bool SidePotManager::addToExistingSidePot(int amount, const std::set<int>& eligiblePlayers) {
+bool SidePotManager::addToExistingSidePot(int amount, const PlayerSet& eligiblePlayers) {
     // Check if there's already a side pot for these players
     for (size_t i = 1; i < pots.size(); i++) { // Skip main pot (index 0)
         if (pots[i].eligiblePlayers == eligiblePlayers) {
@@ -131,6 +155,14 @@ bool SidePotManager::addToExistingSidePot(int amount, const std::set<int>& eligi
     return false; // No existing side pot found
 }
 
+void SidePotManager::addToSidePot(int potIndex, int amount, const PlayerSet& eligiblePlayers) {
+    SidePot& pot = pots[potIndex];
+    pot.amount += amount;
+    for (int player : eligiblePlayers) {
+        pot.eligiblePlayers.insert(player);
+    }
+}
+
 int SidePotManager::getTotalPotAmount() const {
     int total = 0;
     for (const auto& pot : pots) {
@@ -153,17 +185,17 @@ const std::vector<SidePot>& SidePotManager::getPots() const {
 
 void SidePotManager::showPotBreakdown() const {
     if (pots.empty()) {
-        std::cout << "No pots created yet." << std::endl;
+        GameLog::out() << "No pots created yet." << std::endl;
         return;
     }
     
     for (size_t i = 0; i < pots.size(); i++) {
         const auto& pot = pots[i];
         if (i == 0) {
-            std::cout << "Main Pot: $" << pot.amount;
+            GameLog::out() << "Main Pot: $" << pot.amount;
         } else {
-            std::cout << "  |  Side Pot " << i << ": $" << pot.amount;
+            GameLog::out() << "  |  Side Pot " << i << ": $" << pot.amount;
         }
     }
-    std::cout << std::endl;
+    GameLog::out() << std::endl;
 } 
\ No newline at end of file
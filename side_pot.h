@@ -1,30 +1,44 @@
 #ifndef SIDE_POT_H
 #define SIDE_POT_H
 
+#include "arena.h"
 #include <vector>
 #include <set>
 
+typedef ArenaSet<int> PlayerSet; // Seat indices
+
 struct SidePot {
     int amount;
     int betLevel;
-    std::set<int> eligiblePlayers;
+    PlayerSet eligiblePlayers;
     
-    SidePot(int amt, int level) : amount(amt), betLevel(level) {}
+    SidePot(int amt, int level, const ArenaAllocator<int>& allocator = ArenaAllocator<int>())
+        : amount(amt), betLevel(level), eligiblePlayers(allocator) {}
 };
 
 class SidePotManager {
 private:
-    std::vector<SidePot> pots;
+    std::vector<SidePot> pots; // Capacity is kept across hands; eligibility sets use the arena
+    ArenaAllocator<int> allocator;
+    
+    friend class TableCheckpoint;
     
 public:
+    // Pots built from here on take their player sets from the arena (nullptr = heap)
+    void setArena(MonotonicArena* arena);
+    // Drops pots built in the arena, and stops using it, before it is reset or destroyed
+    void releaseArena(MonotonicArena* arena);
+    const ArenaAllocator<int>& getAllocator() const { return allocator; }
+    
     void clearPots();
     void createSidePotsFromBets(const std::vector<std::pair<int, int>>& playerBets);
     void createSidePotsFromBets(const std::vector<std::pair<int, int>>& playerBets, bool clearExisting);
-    void addToPot(int amount, const std::set<int>& eligiblePlayers);
+    void addToPot(int amount, const PlayerSet& eligiblePlayers);
     void addToMainPot(int amount);
-    void addEligiblePlayersToMainPot(const std::set<int>& players); // Add eligible players to main pot
-    void addSidePot(int amount, int betLevel, const std::set<int>& eligiblePlayers); // Add a new side pot
-    bool addToExistingSidePot(int amount, const std::set<int>& eligiblePlayers); // Add to existing side pot if found
+    void addEligiblePlayersToMainPot(const PlayerSet& players); // Add eligible players to main pot
+    void addSidePot(int amount, int betLevel, const PlayerSet& eligiblePlayers); // Add a new side pot
+    bool addToExistingSidePot(int amount, const PlayerSet& eligiblePlayers); // Add to existing side pot if found
+    void addToSidePot(int potIndex, int amount, const PlayerSet& eligiblePlayers); // Add to the pot at potIndex
     
     int getTotalPotAmount() const;
     int getMainPotAmount() const;
@@ -0,0 +1,230 @@
+#include "strategy_backtest.h"
+#include "hand_archive.h"
+#include "equity.h"
+#include <algorithm>
+#include <chrono>
+
+void BacktestStreet::merge(const BacktestStreet& other) {
+    decisions += other.decisions;
+    agreed += other.agreed;
+    for (int r = 0; r < ACTIONS; r++) {
+        for (int c = 0; c < ACTIONS; c++) confusion[r][c] += other.confusion[r][c];
+    }
+    evDecisions += other.evDecisions;
+    recordedEv += other.recordedEv;
+    candidateEv += other.candidateEv;
+}
+
+BacktestStreet BacktestReport::total() const {
+    BacktestStreet sum;
+    for (const BacktestStreet& street : streets) sum.merge(street);
+    return sum;
+}
+
+PlayerCandidate::PlayerCandidate(PlayerPersonality playerPersonality) : personality(playerPersonality) {
+}
+
+void PlayerCandidate::decide(const DecisionBatch& batch, PlayerAction* actions) {
+    bool twoPlusThree = (batch.variant->handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE);
+    bool hiLo = isHiLoSplit(*batch.variant);
+    for (size_t i = 0; i < batch.count; i++) {
+        const DecisionPoint& point = batch.points[i];
+        const HandHistory& hand = (*batch.hands)[point.handIndex];
+
+        Player player("Candidate", point.stack, point.playerId, personality);
+        player.setHandRules(twoPlusThree, hiLo);
+        for (int c = 0; c < point.cardCount; c++) {
+            player.addCard(Card::fromIndex(point.cards[c]), ((point.faceUp >> c) & 1) != 0);
+        }
+        for (int b = 0; b < point.boardCount; b++) {
+            player.addBoardCard(Card::fromIndex(point.board[b]));
+        }
+
+        // What the player knew: everything before the decision except the other seats' cards
+        HandHistory history(hand.getVariant(), hand.getHandNumber());
+        for (const PlayerInfo& info : hand.getPlayers()) {
+            history.addPlayer(info.playerId, info.name, info.position, info.startingChips, info.isDealer);
+        }
+        const ActionList& recorded = hand.getActions();
+        for (int a = 0; a < point.actionIndex; a++) {
+            if (recorded[a].actionType == ActionType::DEAL_CARDS && recorded[a].playerId != point.playerId) continue;
+            history.appendAction(recorded[a]);
+        }
+        actions[i] = player.makeDecision(history, point.callAmount, point.canCheck, batch.variant, point.betCount);
+    }
+}
+
+StrategyBacktest::StrategyBacktest(const VariantInfo& variantInfo, ThreadPool& threadPool)
+    : variant(variantInfo), pool(threadPool) {
+    for (int w = 0; w < pool.getThreadCount(); w++) {
+        workers.emplace_back(new Worker());
+        Worker& worker = *workers.back();
+        worker.replayer.reset(new HandReplayer(variant));
+        worker.replayer->setDecisionObserver(
+            [this, &worker](const PokerGame& game, const DecisionRequest& request, size_t actionIndex) {
+                capture(worker, game, request, actionIndex);
+            });
+    }
+}
+
+double StrategyBacktest::evProxy(const DecisionPoint& point, PlayerAction action) {
+    if (point.potShare < 0.0 || action == PlayerAction::FOLD) return 0.0;
+    int call = std::max(0, std::min(point.callAmount, point.stack));
+    return point.potShare - call;
+}
+
+void StrategyBacktest::capture(Worker& worker, const PokerGame& game, const DecisionRequest& request,
+                               size_t actionIndex) {
+    int street = static_cast<int>(request.historyRound) - static_cast<int>(HandHistoryRound::PRE_FLOP);
+    if (street < 0 || street >= BacktestReport::STREETS) return;
+    const Table& table = *game.getTable();
+    const Player* player = table.getPlayer(request.seat);
+    if (!player) return;
+    const GameAction& action = worker.hand->getActions()[actionIndex];
+
+    DecisionPoint point;
+    point.handIndex = worker.handIndex;
+    point.actionIndex = static_cast<int>(actionIndex);
+    point.playerId = request.playerId;
+    point.seat = request.seat;
+    point.callAmount = request.callAmount;
+    point.canCheck = request.canCheck;
+    point.betCount = request.betCount;
+    point.stack = player->getChips();
+    point.recorded = static_cast<PlayerAction>(action.actionType);
+    point.recordedAmount = action.amount;
+
+    const std::vector<Card>& hand = player->getHand();
+    std::vector<Card> upCards = player->getUpCards();
+    point.cardCount = static_cast<uint8_t>(std::min<size_t>(hand.size(), DecisionPoint::MAX_CARDS));
+    point.faceUp = 0;
+    for (int c = 0; c < point.cardCount; c++) {
+        point.cards[c] = static_cast<uint8_t>(hand[c].getIndex());
+        if (std::find(upCards.begin(), upCards.end(), hand[c]) != upCards.end()) point.faceUp |= 1 << c;
+    }
+    const std::vector<Card>& board = table.getCommunityCards();
+    point.boardCount = static_cast<uint8_t>(std::min<size_t>(board.size(), 5));
+    for (int b = 0; b < point.boardCount; b++) point.board[b] = static_cast<uint8_t>(board[b].getIndex());
+
+    // Pot share against the cards the opponents really held; every dealt card is out of the deck
+    int seats = table.getPlayerCount();
+    std::vector<std::vector<Card>> seatCards(seats);
+    std::vector<bool> dealt(52, false);
+    for (const Card& card : board) dealt[card.getIndex()] = true;
+    point.pot = table.getPot();
+    point.opponents = 0;
+    SidePot pot(0, 0);
+    for (int i = 0; i < seats; i++) {
+        const Player* seat = table.getPlayer(i);
+        if (!seat) continue;
+        point.pot += seat->getInFor();
+        for (const Card& card : seat->getHand()) dealt[card.getIndex()] = true;
+        if (seat->hasFolded()) continue;
+        seatCards[i] = seat->getHand();
+        pot.eligiblePlayers.insert(i);
+        if (i != request.seat) point.opponents++;
+    }
+    pot.amount = point.pot + std::max(0, std::min(point.callAmount, point.stack));
+    std::vector<Card> remaining;
+    for (int index = 0; index < 52; index++) {
+        if (!dealt[index]) remaining.push_back(Card::fromIndex(index));
+    }
+    std::vector<double> shares = EquityCalculator::expectedPotShares(seatCards, board, remaining, {pot}, variant,
+                                                                     MAX_EQUITY_COMPLETIONS);
+    point.potShare = shares.empty() ? -1.0 : shares[request.seat];
+
+    worker.points[street].push_back(point);
+}
+
+void StrategyBacktest::runBatch(const std::vector<HandHistory>& hands, CandidateStrategy& candidate,
+                                BacktestReport& report) {
+    for (auto& worker : workers) {
+        for (auto& points : worker->points) points.clear();
+        worker->replayed = 0;
+        worker->skipped = 0;
+    }
+
+    pool.parallelFor(static_cast<int>(hands.size()), [&](int index, int w) {
+        Worker& worker = *workers[w];
+        worker.hand = &hands[index];
+        worker.handIndex = index;
+        size_t before[BacktestReport::STREETS];
+        for (int s = 0; s < BacktestReport::STREETS; s++) before[s] = worker.points[s].size();
+        if (worker.replayer->replay(hands[index]) == ReplayOutcome::MATCHED) {
+            worker.replayed++;
+        } else {
+            // The engine did not reach the recorded states, so its decision points are not the recorded ones
+            for (int s = 0; s < BacktestReport::STREETS; s++) worker.points[s].resize(before[s]);
+            worker.skipped++;
+        }
+    });
+    for (const auto& worker : workers) {
+        report.hands += worker->replayed;
+        report.skippedHands += worker->skipped;
+    }
+
+    for (int s = 0; s < BacktestReport::STREETS; s++) {
+        streetPoints.clear();
+        for (const auto& worker : workers) {
+            streetPoints.insert(streetPoints.end(), worker->points[s].begin(), worker->points[s].end());
+        }
+        if (streetPoints.empty()) continue;
+        // Same order whichever thread replayed which hand
+        std::sort(streetPoints.begin(), streetPoints.end(), [](const DecisionPoint& a, const DecisionPoint& b) {
+            return a.handIndex != b.handIndex ? a.handIndex < b.handIndex : a.actionIndex < b.actionIndex;
+        });
+        streetActions.assign(streetPoints.size(), PlayerAction::FOLD);
+
+        HandHistoryRound street = static_cast<HandHistoryRound>(static_cast<int>(HandHistoryRound::PRE_FLOP) + s);
+        int chunks = static_cast<int>((streetPoints.size() + CHUNK_DECISIONS - 1) / CHUNK_DECISIONS);
+        pool.parallelFor(chunks, [&](int chunk, int /* worker */) {
+            size_t first = static_cast<size_t>(chunk) * CHUNK_DECISIONS;
+            DecisionBatch batch = {&variant, street, &streetPoints[first],
+                                   std::min(CHUNK_DECISIONS, streetPoints.size() - first), &hands};
+            candidate.decide(batch, &streetActions[first]);
+        });
+
+        BacktestStreet& totals = report.streets[s];
+        for (size_t i = 0; i < streetPoints.size(); i++) {
+            const DecisionPoint& point = streetPoints[i];
+            PlayerAction chosen = streetActions[i];
+            totals.decisions++;
+            if (chosen == point.recorded) totals.agreed++;
+            totals.confusion[static_cast<int>(point.recorded)][static_cast<int>(chosen)]++;
+            if (point.potShare >= 0.0) {
+                totals.evDecisions++;
+                totals.recordedEv += evProxy(point, point.recorded);
+                totals.candidateEv += evProxy(point, chosen);
+            }
+        }
+    }
+}
+
+bool StrategyBacktest::runArchive(const std::string& path, CandidateStrategy& candidate, BacktestReport& report) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<HandHistory> batch;
+    batch.reserve(BATCH_HANDS);
+    bool read = HandArchive::readHands(path, [&](int /* tableId */, const HandHistory& hand) {
+        batch.push_back(hand);
+        if (batch.size() == BATCH_HANDS) {
+            runBatch(batch, candidate, report);
+            batch.clear();
+        }
+    });
+    if (!batch.empty()) {
+        runBatch(batch, candidate, report);
+    }
+    report.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return read;
+}
+
+void StrategyBacktest::runHands(const std::vector<HandHistory>& hands, CandidateStrategy& candidate,
+                                BacktestReport& report) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t first = 0; first < hands.size(); first += BATCH_HANDS) {
+        std::vector<HandHistory> batch(hands.begin() + first,
+                                       hands.begin() + std::min(hands.size(), first + BATCH_HANDS));
+        runBatch(batch, candidate, report);
+    }
+    report.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,131 @@
+#ifndef STRATEGY_BACKTEST_H
+#define STRATEGY_BACKTEST_H
+
+#include "hand_replay.h"
+#include "player.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+// The state in front of one recorded decision, as the engine saw it during replay
+struct DecisionPoint {
+    static const int MAX_CARDS = 7;
+
+    int handIndex;        // Into DecisionBatch::hands
+    int actionIndex;      // The recorded action taken here
+    int playerId;
+    int seat;
+    int callAmount;
+    bool canCheck;
+    int betCount;         // Bets and raises so far this round (limit cap)
+    int pot;              // Collected pots plus this round's bets
+    int stack;            // Chips behind
+    int opponents;        // Other players still in the hand
+    uint8_t cardCount;
+    uint8_t faceUp;       // Bit i set when cards[i] is face up (Stud)
+    uint8_t cards[MAX_CARDS];   // Card::getIndex()
+    uint8_t boardCount;
+    uint8_t board[5];
+    PlayerAction recorded;
+    int recordedAmount;
+    double potShare;      // Expected chips from pot + call against the opponents' actual cards; < 0 if not enumerated
+};
+
+// Decisions of one variant and one street, handed to a candidate together
+struct DecisionBatch {
+    const VariantInfo* variant;
+    HandHistoryRound street;
+    const DecisionPoint* points;
+    size_t count;
+    const std::vector<HandHistory>* hands; // The recorded hands the points refer to
+};
+
+// A strategy under test. decide() fills one action per point; it is called
+// from several pool threads at once, each with its own batch.
+class CandidateStrategy {
+public:
+    virtual ~CandidateStrategy() = default;
+    virtual void decide(const DecisionBatch& batch, PlayerAction* actions) = 0;
+};
+
+// The built-in AI with a given personality: each point rebuilds a Player
+// holding the decider's cards and the history up to the decision, minus
+// the other players' hole cards.
+class PlayerCandidate : public CandidateStrategy {
+public:
+    explicit PlayerCandidate(PlayerPersonality personality);
+    void decide(const DecisionBatch& batch, PlayerAction* actions) override;
+
+private:
+    PlayerPersonality personality;
+};
+
+struct BacktestStreet {
+    static const int ACTIONS = 5; // PlayerAction values
+
+    long long decisions = 0;
+    long long agreed = 0;
+    long long confusion[ACTIONS][ACTIONS] = {}; // [recorded][candidate]
+    long long evDecisions = 0; // Decisions with a pot share
+    double recordedEv = 0.0;   // EV proxy of the recorded actions on those decisions
+    double candidateEv = 0.0;  // EV proxy of the candidate's actions
+
+    void merge(const BacktestStreet& other);
+};
+
+struct BacktestReport {
+    static const int STREETS = 5; // PRE_FLOP through SHOWDOWN (Stud's seventh street)
+
+    long long hands = 0;
+    long long skippedHands = 0; // Hands the replay could not reproduce
+    BacktestStreet streets[STREETS];
+    double seconds = 0.0;
+
+    BacktestStreet total() const;
+};
+
+// Walks every recorded decision of an archive: hands are replayed through
+// the engine in batches across the pool (HandReplayer with a decision
+// observer), the decision points are grouped by street, and the candidate
+// gets each street in chunks spread over the pool. Agreement is counted
+// per street; the EV proxy prices folding at 0 and any other action at the
+// pot share less the call, with the pot share enumerated against the
+// opponents' recorded cards where that takes at most MAX_EQUITY_COMPLETIONS
+// boards (so mostly postflop). Raises get no credit for fold equity.
+class StrategyBacktest {
+public:
+    static const size_t BATCH_HANDS = 4096;
+    static const size_t CHUNK_DECISIONS = 512;
+    static const long long MAX_EQUITY_COMPLETIONS = 20000;
+
+    StrategyBacktest(const VariantInfo& variant, ThreadPool& pool);
+
+    // False if the file is not a hand archive
+    bool runArchive(const std::string& path, CandidateStrategy& candidate, BacktestReport& report);
+    void runHands(const std::vector<HandHistory>& hands, CandidateStrategy& candidate, BacktestReport& report);
+
+    static double evProxy(const DecisionPoint& point, PlayerAction action);
+
+private:
+    struct Worker {
+        std::unique_ptr<HandReplayer> replayer;
+        const HandHistory* hand; // Being replayed
+        int handIndex;
+        std::vector<DecisionPoint> points[BacktestReport::STREETS];
+        long long replayed;
+        long long skipped;
+    };
+
+    VariantInfo variant;
+    ThreadPool& pool;
+    std::vector<std::unique_ptr<Worker>> workers; // One per pool thread
+    std::vector<DecisionPoint> streetPoints;
+    std::vector<PlayerAction> streetActions;
+
+    void capture(Worker& worker, const PokerGame& game, const DecisionRequest& request, size_t actionIndex);
+    void runBatch(const std::vector<HandHistory>& hands, CandidateStrategy& candidate, BacktestReport& report);
+};
+
+#endif
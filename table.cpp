@@ -1,4 +1,7 @@
 #include "table.h"
+#include "game_log.h"
+#include "profiler.h"
+#include "alloc_stats.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -27,6 +30,21 @@ void Table::removePlayer(int index) {
     }
 }
 
+std::unique_ptr<Player> Table::takePlayer(int index) {
+    if (index < 0 || index >= static_cast<int>(players.size())) {
+        return nullptr;
+    }
+    std::unique_ptr<Player> player = std::move(players[index]);
+    removePlayer(index); // Erases the empty slot and keeps the dealer position valid
+    return player;
+}
+
+void Table::seatPlayer(std::unique_ptr<Player> player) {
+    if (player) {
+        players.push_back(std::move(player));
+    }
+}
+
 Player* Table::getPlayer(int index) {
     if (index >= 0 && index < static_cast<int>(players.size())) {
         return players[index].get();
@@ -60,6 +78,7 @@ int Table::getNextActivePlayer(int startIndex) const {
 }
 
 void Table::startNewHand() {
+    ALLOC_SCOPE(AllocTag::DEALING);
     // Reset all players for new hand
     for (auto& player : players) {
         player->resetForNewHand();
@@ -71,13 +90,16 @@ void Table::startNewHand() {
     sidePotManager.clearPots();
     
     // Shuffle deck
-    deck.reset();
-    deck.shuffle();
+    {
+        PROFILE_SCOPE(ProfilePhase::DEALING);
+        deck.reset();
+        deck.shuffle();
+    }
     
     // Advance dealer
     advanceDealer();
     
-    std::cout << "\n=== NEW HAND - Dealer: " << players[dealerPosition]->getName() << " ===" << std::endl;
+    GameLog::out() << "\n=== NEW HAND - Dealer: " << players[dealerPosition]->getName() << " ===" << std::endl;
 }
 
 Card Table::dealCard() {
@@ -96,13 +118,14 @@ void Table::dealHoleCards() {
 }
 
 void Table::dealFlop() {
+    PROFILE_SCOPE(ProfilePhase::DEALING);
 
     // Burn card
     dealCard();
     
     // Deal 3 community cards
     for (int i = 0; i < 3; i++) {
-        communityCards.push_back(dealCard());
+        placeCommunityCard(dealCard());
     }
     
     // Show the board
@@ -110,35 +133,79 @@ void Table::dealFlop() {
 }
 
 void Table::dealTurn() {
+    PROFILE_SCOPE(ProfilePhase::DEALING);
 
     // Burn card
     dealCard();
     
     // Deal 1 community card
-    communityCards.push_back(dealCard());
+    placeCommunityCard(dealCard());
     
     // Show the board
     showCommunityCards();
 }
 
 void Table::dealRiver() {
+    PROFILE_SCOPE(ProfilePhase::DEALING);
 
     // Burn card
     dealCard();
     
     // Deal 1 community card
-    communityCards.push_back(dealCard());
+    placeCommunityCard(dealCard());
     
     // Show the board
     showCommunityCards();
 }
 
+void Table::dealRemainingBoard() {
+    std::vector<Card> board = dealBoardRun(communityCards);
+    for (size_t i = communityCards.size(); i < board.size(); i++) {
+        placeCommunityCard(board[i]);
+    }
+    
+    // Show the final board once
+    showCommunityCards();
+}
+
+std::vector<Card> Table::dealBoardRun(const std::vector<Card>& boardSoFar) {
+    PROFILE_SCOPE(ProfilePhase::DEALING);
+    // Same burn/deal sequence as street-by-street dealing so the runout is identical
+    std::vector<Card> board = boardSoFar;
+    while (board.size() < 5) {
+        // Burn card
+        dealCard();
+        
+        int streetCards = board.empty() ? 3 : 1;
+        for (int i = 0; i < streetCards; i++) {
+            board.push_back(dealCard());
+        }
+    }
+    return board;
+}
+
 const std::vector<Card>& Table::getCommunityCards() const {
     return communityCards;
 }
 
 void Table::clearCommunityCards() {
     communityCards.clear();
+    for (auto& player : players) {
+        player->clearBoardCards();
+    }
+}
+
+void Table::addCommunityCard(const Card& card) {
+    placeCommunityCard(card);
+}
+
+void Table::placeCommunityCard(const Card& card) {
+    communityCards.push_back(card);
+    for (auto& player : players) {
+        if (player->getHandSize() > 0) {
+            player->addBoardCard(card);
+        }
+    }
 }
 
 void Table::showCommunityCards() const {
@@ -146,27 +213,27 @@ void Table::showCommunityCards() const {
     int mainPot = sidePotManager.getMainPotAmount();
     
     if (communityCards.empty()) {
-        std::cout << "Community Cards: (none) | Total Pot: $" << totalPot;
-        std::cout << " | Main Pot: $" << mainPot << std::endl;
+        GameLog::out() << "Community Cards: (none) | Total Pot: $" << totalPot;
+        GameLog::out() << " | Main Pot: $" << mainPot << std::endl;
         return;
     }
     
-    std::cout << "Community Cards: ";
+    GameLog::out() << "Community Cards: ";
     for (const auto& card : communityCards) {
-        std::cout << card.toString() << " ";
+        GameLog::out() << card.toString() << " ";
     }
-    std::cout << "| Total Pot: $" << totalPot;
-    std::cout << " | Main Pot: $" << mainPot;
+    GameLog::out() << "| Total Pot: $" << totalPot;
+    GameLog::out() << " | Main Pot: $" << mainPot;
     
     // Show side pots if any exist
     // We need to check if there are multiple pots by getting pot count from sidePotManager
     // For now, let's check if total pot is greater than main pot
     if (totalPot > mainPot) {
         int sidePotAmount = totalPot - mainPot;
-        std::cout << "   Side Pot 1: $" << sidePotAmount;
+        GameLog::out() << "   Side Pot 1: $" << sidePotAmount;
     }
     
-    std::cout << std::endl;
+    GameLog::out() << std::endl;
 }
 
 int Table::getCurrentBet() const {
@@ -231,11 +298,12 @@ void Table::createSidePotsFromCurrentBets() {
 }
 
 void Table::createSidePotsFromInFor() {
+    PROFILE_SCOPE(ProfilePhase::SIDE_POTS);
     // Matching-based pot allocation logic
     // Process all-ins once at end of betting round
     
     // Find all unique all-in amounts and sort from smallest to largest
-    std::set<int> allInLevels;
+    ArenaSet<int> allInLevels(sidePotManager.getAllocator());
     for (int i = 0; i < getPlayerCount(); i++) {
         Player* player = getPlayer(i);
         if (player && player->isAllIn() && player->getInFor() > 0) {
@@ -246,7 +314,7 @@ void Table::createSidePotsFromInFor() {
     // If no all-in players, just add everything to main pot
     if (allInLevels.empty()) {
         int totalAmount = 0;
-        std::set<int> eligiblePlayers;
+        PlayerSet eligiblePlayers(sidePotManager.getAllocator());
         
         // Collect all money from all players (including folded)
         for (int i = 0; i < getPlayerCount(); i++) {
@@ -278,7 +346,7 @@ void Table::createSidePotsFromInFor() {
         int matchAmount = allInLevel - previousLevel;
         if (matchAmount <= 0) continue;
         
-        std::set<int> eligiblePlayers;
+        PlayerSet eligiblePlayers(sidePotManager.getAllocator());
         int potTotal = 0;
         
         // Match this amount from all players who have at least this much
@@ -320,7 +388,7 @@ void Table::createSidePotsFromInFor() {
     
     // Handle remaining money from players who contributed more than highest all-in
     int highestAllIn = allInLevels.empty() ? 0 : *allInLevels.rbegin();
-    std::set<int> remainingEligible;
+    PlayerSet remainingEligible(sidePotManager.getAllocator());
     int remainingTotal = 0;
     
     for (int i = 0; i < getPlayerCount(); i++) {
@@ -363,7 +431,7 @@ void Table::returnUnmatchedChips(const std::vector<std::pair<int, int>>& playerB
             Player* player = getPlayer(playerBet.first);
             if (player) {
                 player->addChips(unmatchedAmount);
-                std::cout << player->getName() << " gets $" << unmatchedAmount 
+                GameLog::out() << player->getName() << " gets $" << unmatchedAmount 
                           << " returned (unmatched portion)" << std::endl;
             }
         }
@@ -383,27 +451,27 @@ void Table::showPotBreakdown() const {
 }
 
 void Table::showTable() const {
-    std::cout << "\n=== TABLE STATUS ===" << std::endl;
-    std::cout << "Pot: $" << getPot() << " | Current Bet: $" << currentBet << std::endl;
+    GameLog::out() << "\n=== TABLE STATUS ===" << std::endl;
+    GameLog::out() << "Pot: $" << getPot() << " | Current Bet: $" << currentBet << std::endl;
     showCommunityCards();
-    std::cout << "\nPlayers:" << std::endl;
+    GameLog::out() << "\nPlayers:" << std::endl;
     for (size_t i = 0; i < players.size(); i++) {
-        std::cout << (i == static_cast<size_t>(dealerPosition) ? "[D] " : "    ");
+        GameLog::out() << (i == static_cast<size_t>(dealerPosition) ? "[D] " : "    ");
         players[i]->showStatus(true);
     }
-    std::cout << std::endl;
+    GameLog::out() << std::endl;
 }
 
 void Table::showTableForStud() const {
-    std::cout << "\n=== TABLE STATUS ===" << std::endl;
-    std::cout << "Pot: $" << getPot() << " | Current Bet: $" << currentBet << std::endl;
-    std::cout << "\nPlayers:" << std::endl;
+    GameLog::out() << "\n=== TABLE STATUS ===" << std::endl;
+    GameLog::out() << "Pot: $" << getPot() << " | Current Bet: $" << currentBet << std::endl;
+    GameLog::out() << "\nPlayers:" << std::endl;
     for (size_t i = 0; i < players.size(); i++) {
-        std::cout << "    "; // No dealer button for Stud
+        GameLog::out() << "    "; // No dealer button for Stud
         
         // Show player info without cards
         Player* player = players[i].get();
-        std::cout << std::setw(15) << player->getName()
+        GameLog::out() << std::setw(15) << player->getName()
                   << " | Chips: " << std::setw(6) << player->getChips()
                   << " | Bet: " << std::setw(4) << player->getInFor()
                   << " | Cards: ";
@@ -412,19 +480,25 @@ void Table::showTableForStud() const {
         player->showStudHandWithNew();
         
         if (player->hasFolded()) {
-            std::cout << " | FOLDED";
+            GameLog::out() << " | FOLDED";
         } else if (player->isAllIn()) {
-            std::cout << " | ALL-IN";
+            GameLog::out() << " | ALL-IN";
         }
-        std::cout << std::endl;
+        GameLog::out() << std::endl;
     }
-    std::cout << std::endl;
+    GameLog::out() << std::endl;
 }
 
 int Table::getDealerPosition() const {
     return dealerPosition;
 }
 
+void Table::setDealerPosition(int position) {
+    if (position >= 0 && position < static_cast<int>(players.size())) {
+        dealerPosition = position;
+    }
+}
+
 void Table::advanceDealer() {
     dealerPosition = (dealerPosition + 1) % players.size();
 }
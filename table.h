@@ -15,6 +15,10 @@ private:
     int dealerPosition;
     int currentBet;
     SidePotManager sidePotManager;
+    
+    void placeCommunityCard(const Card& card); // Board plus every seat's live hand
+    
+    friend class TableCheckpoint;
 
 public:
     Table();
@@ -22,6 +26,8 @@ public:
     // Player management
     void addPlayer(const std::string& name, int chips, int playerId, PlayerPersonality personality = PlayerPersonality::TIGHT_PASSIVE);
     void removePlayer(int index);
+    std::unique_ptr<Player> takePlayer(int index); // Unseat a player to move them to another table
+    void seatPlayer(std::unique_ptr<Player> player);
     Player* getPlayer(int index);
     const Player* getPlayer(int index) const;
     int getPlayerCount() const;
@@ -34,10 +40,13 @@ public:
     void dealFlop();
     void dealTurn();
     void dealRiver();
+    void dealRemainingBoard(); // All-in runout: complete the board without per-street display
+    std::vector<Card> dealBoardRun(const std::vector<Card>& boardSoFar); // Complete a copy of a board from the deck
     
     // Community cards
     const std::vector<Card>& getCommunityCards() const;
     void clearCommunityCards();
+    void addCommunityCard(const Card& card);
     void showCommunityCards() const;
     
     // Betting and pot management
@@ -60,6 +69,7 @@ public:
     
     // Dealer position
     int getDealerPosition() const;
+    void setDealerPosition(int position); // Replays put the button where the recorded hand had it
     void advanceDealer();
     
     // Deck access
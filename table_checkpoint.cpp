@@ -0,0 +1,518 @@
+#include "table_checkpoint.h"
+#include "trace_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[8] = {'T', 'A', 'B', 'L', 'E', 'C', 'K', 'P'};
+    const uint32_t FILE_VERSION = 1;
+    const size_t HEADER_BYTES = 4096; // Keeps the slots page aligned
+    const size_t BUFFER_ALIGN = 64;
+    const size_t MAX_STRING = 255;    // Names and descriptions are cut to a length byte
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t slotCount;
+        uint64_t bufferBytes;
+    };
+
+    // Bounded append in host byte order; the file is read back on the machine that wrote it
+    class SnapshotWriter {
+    public:
+        SnapshotWriter(uint8_t* buffer, size_t capacity) : at(buffer), end(buffer + capacity), overflow(false) {}
+
+        void put8(int value) {
+            if (at < end) *at++ = static_cast<uint8_t>(value);
+            else overflow = true;
+        }
+        void put32(int32_t value) { putBytes(&value, sizeof(value)); }
+        void put64(int64_t value) { putBytes(&value, sizeof(value)); }
+        void putDouble(double value) { putBytes(&value, sizeof(value)); }
+        void putBytes(const void* data, size_t count) {
+            if (static_cast<size_t>(end - at) < count) {
+                overflow = true;
+                return;
+            }
+            std::memcpy(at, data, count);
+            at += count;
+        }
+        void putString(const std::string& text) {
+            size_t count = std::min(text.size(), MAX_STRING);
+            put8(static_cast<int>(count));
+            putBytes(text.data(), count);
+        }
+        template <class CardVector>
+        void putCards(const CardVector& cards) {
+            put8(static_cast<int>(cards.size()));
+            for (const Card& card : cards) put8(card.getIndex());
+        }
+
+        uint8_t* position() const { return at; }
+        bool failed() const { return overflow; }
+
+    private:
+        uint8_t* at;
+        uint8_t* end;
+        bool overflow;
+    };
+
+    // Bounds-checked reads; once anything is out of range every read returns zero
+    class SnapshotReader {
+    public:
+        SnapshotReader(const uint8_t* data, size_t length) : at(data), end(data + length), bad(false) {}
+
+        int get8() {
+            if (at >= end) {
+                bad = true;
+                return 0;
+            }
+            return *at++;
+        }
+        int32_t get32() {
+            int32_t value = 0;
+            getBytes(&value, sizeof(value));
+            return value;
+        }
+        int64_t get64() {
+            int64_t value = 0;
+            getBytes(&value, sizeof(value));
+            return value;
+        }
+        double getDouble() {
+            double value = 0.0;
+            getBytes(&value, sizeof(value));
+            return value;
+        }
+        void getBytes(void* out, size_t count) {
+            if (bad || static_cast<size_t>(end - at) < count) {
+                bad = true;
+                return;
+            }
+            std::memcpy(out, at, count);
+            at += count;
+        }
+        std::string getString() {
+            size_t count = static_cast<size_t>(get8());
+            if (bad || static_cast<size_t>(end - at) < count) {
+                bad = true;
+                return std::string();
+            }
+            std::string text(reinterpret_cast<const char*>(at), count);
+            at += count;
+            return text;
+        }
+        template <class CardVector>
+        bool getCards(CardVector& cards) {
+            int count = get8();
+            cards.clear();
+            cards.reserve(count);
+            for (int i = 0; i < count; i++) {
+                int index = get8();
+                if (index >= 52) bad = true;
+                if (bad) return false;
+                cards.push_back(Card::fromIndex(index));
+            }
+            return !bad;
+        }
+
+        bool failed() const { return bad; }
+
+    private:
+        const uint8_t* at;
+        const uint8_t* end;
+        bool bad;
+    };
+
+    void writeVariant(SnapshotWriter& out, const VariantInfo& variant) {
+        out.put8(variant.gameStruct);
+        out.put8(variant.numHoleCards);
+        out.put8(variant.bettingStruct);
+        out.put8(variant.handResolution);
+        out.put8(variant.potResolution);
+    }
+
+    bool variantMatches(SnapshotReader& in, const VariantInfo& variant) {
+        bool matches = in.get8() == variant.gameStruct;
+        matches = (in.get8() == variant.numHoleCards) && matches;
+        matches = (in.get8() == variant.bettingStruct) && matches;
+        matches = (in.get8() == variant.handResolution) && matches;
+        matches = (in.get8() == variant.potResolution) && matches;
+        return matches && !in.failed();
+    }
+
+    void writeAction(SnapshotWriter& out, const GameAction& action) {
+        out.put8(static_cast<int>(action.round));
+        out.put8(static_cast<int>(action.actionType));
+        out.put32(action.playerId);
+        out.put32(action.amount);
+        out.put32(action.potAfterAction);
+        out.putCards(action.cardsDealt);
+        out.putString(action.description);
+    }
+
+    bool readAction(SnapshotReader& in, GameAction& action) {
+        action.round = static_cast<HandHistoryRound>(in.get8());
+        action.actionType = static_cast<ActionType>(in.get8());
+        action.playerId = in.get32();
+        action.amount = in.get32();
+        action.potAfterAction = in.get32();
+        in.getCards(action.cardsDealt);
+        action.description = in.getString();
+        return !in.failed();
+    }
+}
+
+size_t TableCheckpoint::write(const PokerGame& game, uint8_t* out, size_t capacity) {
+    SnapshotWriter writer(out, capacity);
+    const Table& table = *game.table;
+
+    writer.put8(FORMAT_VERSION);
+    writeVariant(writer, game.variantInfo);
+
+    // Flow: where advance() picks up
+    writer.put8(static_cast<int>(game.flowState));
+    writer.put8(game.currentRound);
+    writer.put8(static_cast<int>(game.bettingHistoryRound));
+    writer.put8((game.handComplete ? 1 : 0) | (game.currentHandHasChoppedPot ? 2 : 0) |
+                (game.bettingRoundClosed ? 4 : 0) | (game.bettingRoundSkipped ? 8 : 0));
+    writer.put32(game.currentPlayerIndex);
+    writer.put32(game.betCount);
+    writer.put32(game.currentActionPotIndex);
+    writer.put32(game.bettingActionCount);
+    writer.put32(game.runItTimes);
+    writer.put32(game.boardAnte);
+    writer.put64(game.decisionSequence);
+    writer.put8(static_cast<int>(game.variantInfo.betSizes.size()));
+    for (int size : game.variantInfo.betSizes) writer.put32(size);
+    writer.put8(static_cast<int>(game.hasActedThisRound.size()));
+    for (bool acted : game.hasActedThisRound) writer.put8(acted ? 1 : 0);
+    writer.put8(static_cast<int>(game.allInExpectedChips.size()));
+    for (double chips : game.allInExpectedChips) writer.putDouble(chips);
+    writer.put8(static_cast<int>(game.runBoards.size()));
+    for (const std::vector<Card>& board : game.runBoards) writer.putCards(board);
+
+    // Table
+    writer.put32(table.dealerPosition);
+    writer.put32(table.currentBet);
+    writer.putCards(table.communityCards);
+    writer.putCards(table.deck.cards);
+    const std::vector<SidePot>& pots = table.sidePotManager.pots;
+    writer.put8(static_cast<int>(pots.size()));
+    for (const SidePot& pot : pots) {
+        writer.put32(pot.amount);
+        writer.put32(pot.betLevel);
+        writer.put8(static_cast<int>(pot.eligiblePlayers.size()));
+        for (int seat : pot.eligiblePlayers) writer.put8(seat);
+    }
+
+    // Seats
+    writer.put8(static_cast<int>(table.players.size()));
+    for (const auto& seat : table.players) {
+        const Player& player = *seat;
+        writer.putString(player.name);
+        writer.put32(player.playerId);
+        writer.put32(player.chips);
+        writer.put8(static_cast<int>(player.personality));
+        writer.put32(player.currentBet);
+        writer.put32(player.inFor);
+        writer.put32(player.cardsAtStartOfStreet);
+        writer.put8((player.folded ? 1 : 0) | (player.allIn ? 2 : 0));
+        writer.putDouble(player.riskPremium);
+        writer.putCards(player.hand);
+        int faceUp = 0;
+        for (size_t c = 0; c < player.cardsFaceUp.size() && c < 8; c++) {
+            if (player.cardsFaceUp[c]) faceUp |= 1 << c;
+        }
+        writer.put8(faceUp);
+    }
+
+    // Hand history so far
+    const HandHistory& history = game.handHistory;
+    writer.put8(static_cast<int>(history.variant));
+    writer.put32(history.handNumber);
+    writer.put8(history.isComplete ? 1 : 0);
+    writer.put8(static_cast<int>(history.players.size()));
+    for (const PlayerInfo& info : history.players) {
+        writer.put32(info.playerId);
+        writer.putString(info.name);
+        writer.put32(info.position);
+        writer.put32(info.startingChips);
+        writer.put8(info.isDealer ? 1 : 0);
+    }
+    writer.put32(static_cast<int32_t>(history.actions.size()));
+    for (const GameAction& action : history.actions) writeAction(writer, action);
+    const HandResolution& resolution = history.resolution;
+    writer.put8(static_cast<int>(resolution.winners.size()));
+    for (size_t i = 0; i < resolution.winners.size(); i++) {
+        writer.put32(resolution.winners[i]);
+        writer.put32(i < resolution.amounts.size() ? resolution.amounts[i] : 0);
+    }
+    writer.putString(resolution.description);
+
+    if (writer.failed()) return 0;
+    return static_cast<size_t>(writer.position() - out);
+}
+
+bool TableCheckpoint::read(const uint8_t* data, size_t length, PokerGame& game) {
+    SnapshotReader reader(data, length);
+    if (reader.get8() != FORMAT_VERSION || !variantMatches(reader, game.variantInfo)) return false;
+    Table& table = *game.table;
+
+    game.flowState = static_cast<HandFlowState>(reader.get8());
+    game.currentRound = static_cast<UnifiedBettingRound>(reader.get8());
+    game.bettingHistoryRound = static_cast<HandHistoryRound>(reader.get8());
+    int flags = reader.get8();
+    game.handComplete = (flags & 1) != 0;
+    game.currentHandHasChoppedPot = (flags & 2) != 0;
+    game.bettingRoundClosed = (flags & 4) != 0;
+    game.bettingRoundSkipped = (flags & 8) != 0;
+    game.currentPlayerIndex = reader.get32();
+    game.betCount = reader.get32();
+    game.currentActionPotIndex = reader.get32();
+    game.bettingActionCount = reader.get32();
+    game.traceHandStart = Trace::NOT_STARTED; // Spans opened before the crash are not resumed
+    game.traceRoundStart = Trace::NOT_STARTED;
+    game.runItTimes = reader.get32();
+    game.boardAnte = reader.get32();
+    game.decisionSequence = reader.get64();
+    game.variantInfo.betSizes.resize(reader.get8());
+    for (int& size : game.variantInfo.betSizes) size = reader.get32();
+    game.hasActedThisRound.resize(reader.get8());
+    for (size_t i = 0; i < game.hasActedThisRound.size(); i++) game.hasActedThisRound[i] = reader.get8() != 0;
+    game.allInExpectedChips.resize(reader.get8());
+    for (double& chips : game.allInExpectedChips) chips = reader.getDouble();
+    game.runBoards.resize(reader.get8());
+    for (std::vector<Card>& board : game.runBoards) reader.getCards(board);
+    game.hiWinners.clear();
+    game.loWinners.clear();
+
+    table.dealerPosition = reader.get32();
+    table.currentBet = reader.get32();
+    reader.getCards(table.communityCards);
+    reader.getCards(table.deck.cards);
+    std::vector<SidePot>& pots = table.sidePotManager.pots;
+    pots.clear();
+    int potCount = reader.get8();
+    for (int p = 0; p < potCount && !reader.failed(); p++) {
+        int amount = reader.get32();
+        int betLevel = reader.get32();
+        pots.emplace_back(amount, betLevel);
+        int eligible = reader.get8();
+        for (int e = 0; e < eligible; e++) pots.back().eligiblePlayers.insert(reader.get8());
+    }
+
+    bool twoPlusThree = (game.variantInfo.handResolution == BESTHANDRESOLUTION_TWOPLUSTHREE);
+    bool hiLo = isHiLoSplit(game.variantInfo);
+    size_t seatCount = static_cast<size_t>(reader.get8());
+    for (size_t s = 0; s < seatCount && !reader.failed(); s++) {
+        std::string name = reader.getString();
+        int playerId = reader.get32();
+        int chips = reader.get32();
+        PlayerPersonality personality = static_cast<PlayerPersonality>(reader.get8());
+        // The player already in the seat keeps its strategy and stats hooks
+        if (s >= table.players.size()) {
+            table.players.emplace_back(new Player(name, chips, playerId, personality));
+        } else if (!table.players[s] || table.players[s]->playerId != playerId) {
+            table.players[s].reset(new Player(name, chips, playerId, personality));
+        }
+        Player& player = *table.players[s];
+        player.name = name;
+        player.chips = chips;
+        player.personality = personality;
+        player.currentBet = reader.get32();
+        player.inFor = reader.get32();
+        player.cardsAtStartOfStreet = reader.get32();
+        int seatFlags = reader.get8();
+        player.folded = (seatFlags & 1) != 0;
+        player.allIn = (seatFlags & 2) != 0;
+        player.riskPremium = reader.getDouble();
+        reader.getCards(player.hand);
+        int faceUp = reader.get8();
+        player.cardsFaceUp.assign(player.hand.size(), false);
+        for (size_t c = 0; c < player.hand.size() && c < 8; c++) player.cardsFaceUp[c] = ((faceUp >> c) & 1) != 0;
+
+        player.liveHand.setRules(twoPlusThree, hiLo);
+        player.liveHand.clear();
+        for (const Card& card : player.hand) player.liveHand.addHoleCard(card);
+        for (const Card& card : table.communityCards) player.liveHand.addBoardCard(card);
+    }
+    table.players.resize(std::min(table.players.size(), seatCount));
+
+    PokerVariant variant = static_cast<PokerVariant>(reader.get8());
+    int handNumber = reader.get32();
+    HandHistory& history = game.handHistory;
+    history = HandHistory(variant, handNumber);
+    history.isComplete = reader.get8() != 0;
+    history.players.resize(reader.get8());
+    for (PlayerInfo& info : history.players) {
+        info.playerId = reader.get32();
+        info.name = reader.getString();
+        info.position = reader.get32();
+        info.startingChips = reader.get32();
+        info.isDealer = reader.get8() != 0;
+        history.livePlayerIdSum += info.playerId;
+    }
+    int32_t actionCount = reader.get32();
+    if (actionCount < 0 || static_cast<size_t>(actionCount) > length) return false;
+    history.actions.resize(actionCount);
+    for (GameAction& action : history.actions) {
+        if (!readAction(reader, action)) return false;
+        history.trackAction(action);
+    }
+    int winners = reader.get8();
+    for (int w = 0; w < winners; w++) {
+        history.resolution.winners.push_back(reader.get32());
+        history.resolution.amounts.push_back(reader.get32());
+    }
+    history.resolution.description = reader.getString();
+
+    return !reader.failed();
+}
+
+CheckpointStore::CheckpointStore()
+    : base(nullptr), mappedBytes(0), slotCount(0), bufferBytes(0), saves(0), overflows(0) {
+}
+
+CheckpointStore::~CheckpointStore() {
+    close();
+}
+
+bool CheckpointStore::open(const std::string& path, int slots, size_t bytesPerBuffer) {
+    close();
+    if (slots <= 0 || bytesPerBuffer <= sizeof(BufferHeader)) return false;
+    size_t alignedBuffer = (bytesPerBuffer + BUFFER_ALIGN - 1) / BUFFER_ALIGN * BUFFER_ALIGN;
+    size_t length = HEADER_BYTES + static_cast<size_t>(slots) * 2 * alignedBuffer;
+
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0) return false;
+
+    // Same shape: keep the checkpoints. Anything else is started over (sparse, so untouched slots cost no disk).
+    FileHeader header;
+    struct stat info;
+    bool matches = pread(file, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                   std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == FILE_VERSION &&
+                   header.slotCount == static_cast<uint32_t>(slots) && header.bufferBytes == alignedBuffer &&
+                   fstat(file, &info) == 0 && static_cast<size_t>(info.st_size) == length;
+    if (!matches) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FILE_VERSION;
+        header.slotCount = static_cast<uint32_t>(slots);
+        header.bufferBytes = alignedBuffer;
+        if (ftruncate(file, 0) != 0 || ftruncate(file, static_cast<off_t>(length)) != 0 ||
+            pwrite(file, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            ::close(file);
+            return false;
+        }
+    }
+
+    void* mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    ::close(file);
+    if (mapped == MAP_FAILED) return false;
+
+    base = static_cast<uint8_t*>(mapped);
+    mappedBytes = length;
+    slotCount = slots;
+    bufferBytes = alignedBuffer;
+    return true;
+}
+
+void CheckpointStore::close() {
+    if (!base) return;
+    munmap(base, mappedBytes);
+    base = nullptr;
+    mappedBytes = 0;
+    slotCount = 0;
+}
+
+CheckpointStore::BufferHeader* CheckpointStore::buffer(int slot, int which) const {
+    return reinterpret_cast<BufferHeader*>(base + HEADER_BYTES + (static_cast<size_t>(slot) * 2 + which) * bufferBytes);
+}
+
+uint32_t CheckpointStore::checksum(const uint8_t* data, size_t length) {
+    // FNV-1a over 8-byte words, then the tail
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+bool CheckpointStore::save(int slot, const PokerGame& game) {
+    if (!base || slot < 0 || slot >= slotCount) return false;
+
+    BufferHeader* first = buffer(slot, 0);
+    BufferHeader* second = buffer(slot, 1);
+    BufferHeader* target = first->sequence <= second->sequence ? first : second;
+    uint64_t sequence = std::max(first->sequence, second->sequence) + 1;
+
+    uint8_t* data = reinterpret_cast<uint8_t*>(target + 1);
+    size_t length = TableCheckpoint::write(game, data, bufferBytes - sizeof(BufferHeader));
+    if (length == 0) {
+        overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    target->length = static_cast<uint32_t>(length);
+    target->checksum = checksum(data, length);
+    std::atomic_thread_fence(std::memory_order_release); // Data before the sequence that publishes it
+    target->sequence = sequence;
+    saves.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+const CheckpointStore::BufferHeader* CheckpointStore::newest(int slot) const {
+    if (!base || slot < 0 || slot >= slotCount) return nullptr;
+
+    const BufferHeader* candidates[2] = {buffer(slot, 0), buffer(slot, 1)};
+    if (candidates[1]->sequence > candidates[0]->sequence) std::swap(candidates[0], candidates[1]);
+    for (const BufferHeader* candidate : candidates) {
+        if (candidate->sequence == 0) continue;
+        if (candidate->length == 0 || candidate->length > bufferBytes - sizeof(BufferHeader)) continue;
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(candidate + 1);
+        if (checksum(data, candidate->length) == candidate->checksum) return candidate;
+    }
+    return nullptr; // Never saved, or both buffers torn
+}
+
+bool CheckpointStore::hasCheckpoint(int slot) const {
+    return newest(slot) != nullptr;
+}
+
+bool CheckpointStore::restore(int slot, PokerGame& game) const {
+    const BufferHeader* header = newest(slot);
+    if (!header) return false;
+    return TableCheckpoint::read(reinterpret_cast<const uint8_t*>(header + 1), header->length, game);
+}
+
+void CheckpointStore::clear(int slot) {
+    if (!base || slot < 0 || slot >= slotCount) return;
+    buffer(slot, 0)->sequence = 0;
+    buffer(slot, 1)->sequence = 0;
+}
+
+void CheckpointStore::flush() {
+    if (base) msync(base, mappedBytes, MS_SYNC);
+}
+
+int CheckpointStore::restoreAll(const std::vector<PokerGame*>& games, ThreadPool& pool) const {
+    std::atomic<int> restored(0);
+    int count = static_cast<int>(std::min(games.size(), static_cast<size_t>(slotCount)));
+    pool.parallelFor(count, [&](int slot, int /* worker */) {
+        if (games[slot] && restore(slot, *games[slot])) {
+            restored.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    return restored.load();
+}
@@ -0,0 +1,88 @@
+#ifndef TABLE_CHECKPOINT_H
+#define TABLE_CHECKPOINT_H
+
+#include "poker_game.h"
+#include "thread_pool.h"
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Compact binary snapshot of a game in progress: seats (stacks, cards, bets,
+// folded/all-in), deck order, board, pots, button, the flow state with the
+// acting seat, and the hand history so far. Restoring puts the game back at
+// the same action boundary, so advance() carries on where it stopped.
+//
+// Not captured: decision providers, opponent stats, limit strategies and the
+// archive ring, which belong to the owner (reused seats keep theirs), and the
+// players' random state. A restored hand is not streamed to the archive.
+class TableCheckpoint {
+public:
+    static const uint8_t FORMAT_VERSION = 1;
+
+    // Bytes written, or 0 if the snapshot does not fit in capacity
+    static size_t write(const PokerGame& game, uint8_t* out, size_t capacity);
+    // False if the data is damaged or was taken from another kind of game.
+    // Seats holding the same player are reused, others are replaced.
+    static bool read(const uint8_t* data, size_t length, PokerGame& game);
+};
+
+// Checkpoints for many tables in one memory-mapped file, one fixed-size slot
+// per table. A slot holds two buffers: each save goes into the older one and
+// is published by bumping its sequence number after a checksum, so a crash
+// in the middle of a save leaves the previous checkpoint intact. The mapping
+// is shared, so a crashed process loses nothing the kernel has; flush() asks
+// for it to reach the disk as well.
+//
+// Saves to different slots may run on different threads; one slot belongs to
+// one table thread at a time.
+class CheckpointStore {
+public:
+    static const size_t DEFAULT_BUFFER_BYTES = 4096; // Fits a full-ring hand with room to spare
+
+    CheckpointStore();
+    ~CheckpointStore(); // close()
+    CheckpointStore(const CheckpointStore&) = delete;
+    CheckpointStore& operator=(const CheckpointStore&) = delete;
+
+    // Reopens a store of the same shape with its checkpoints; anything else starts empty
+    bool open(const std::string& path, int slotCount, size_t bufferBytes = DEFAULT_BUFFER_BYTES);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+    int getSlotCount() const { return slotCount; }
+
+    // False (previous checkpoint kept) if the snapshot outgrew a buffer
+    bool save(int slot, const PokerGame& game);
+    bool restore(int slot, PokerGame& game) const; // Newest intact checkpoint; false if none
+    bool hasCheckpoint(int slot) const;
+    void clear(int slot); // The table closed
+    void flush();         // msync the whole file
+
+    // Restores slot i into games[i] (null entries skipped) across the pool;
+    // returns the number of games restored
+    int restoreAll(const std::vector<PokerGame*>& games, ThreadPool& pool) const;
+
+    uint64_t getSaves() const { return saves.load(std::memory_order_relaxed); }
+    uint64_t getOverflows() const { return overflows.load(std::memory_order_relaxed); }
+
+private:
+    struct BufferHeader {
+        uint64_t sequence; // 0 = never written
+        uint32_t length;
+        uint32_t checksum;
+    };
+
+    uint8_t* base;
+    size_t mappedBytes;
+    int slotCount;
+    size_t bufferBytes; // Header included
+    std::atomic<uint64_t> saves;
+    std::atomic<uint64_t> overflows;
+
+    BufferHeader* buffer(int slot, int which) const;
+    const BufferHeader* newest(int slot) const; // Highest sequence that passes its checksum
+    static uint32_t checksum(const uint8_t* data, size_t length);
+};
+
+#endif
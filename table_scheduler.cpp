@@ -0,0 +1,195 @@
+#include "table_scheduler.h"
+#include <algorithm>
+
+TableScheduler::TableScheduler()
+    : nowMs(0), tickMs(100), tickOriginMs(0), tickOriginTick(0), actionTimeoutMs(0), initialTimeBankMs(0),
+      checkpoints(nullptr) {
+}
+
+int TableScheduler::addTable(PokerGame* game) {
+    int tableId = static_cast<int>(tables.size());
+    tables.push_back(game);
+    queued.push_back(false);
+    clocks.emplace_back();
+    clocks.back().timer.ownerId = tableId;
+    clocks.back().seat = -1;
+    clocks.back().armedAtMs = 0;
+    game->setTableId(tableId);
+    if (checkpoints) {
+        game->setCheckpoints(checkpoints, tableId);
+    }
+    return tableId;
+}
+
+PokerGame* TableScheduler::getTable(int tableId) const {
+    if (tableId < 0 || tableId >= static_cast<int>(tables.size())) {
+        return nullptr;
+    }
+    return tables[tableId];
+}
+
+void TableScheduler::markReady(int tableId) {
+    if (!queued[tableId]) {
+        queued[tableId] = true;
+        readyTables.push_back(tableId);
+    }
+}
+
+void TableScheduler::startHand(int tableId) {
+    PokerGame* game = getTable(tableId);
+    if (!game) return;
+    
+    game->startNewHand();
+    markReady(tableId);
+}
+
+bool TableScheduler::restoreTable(int tableId) {
+    PokerGame* game = getTable(tableId);
+    if (!game || !checkpoints || !checkpoints->restore(tableId, *game)) return false;
+    
+    if (game->isHandFinished()) {
+        if (onHandComplete) {
+            onHandComplete(tableId, *game);
+        }
+    } else if (game->isAwaitingDecision()) {
+        startClock(tableId);
+    } else {
+        markReady(tableId);
+    }
+    return true;
+}
+
+void TableScheduler::submitDecision(const DecisionRequest& request, const Decision& decision) {
+    std::lock_guard<std::mutex> lock(inboxMutex);
+    inbox.push_back({request.tableId, request.sequence, decision});
+}
+
+void TableScheduler::drainInbox() {
+    std::vector<PendingDecision> arrived;
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        arrived.swap(inbox);
+    }
+    
+    for (const PendingDecision& pending : arrived) {
+        PokerGame* game = getTable(pending.tableId);
+        if (!game || !game->isAwaitingDecision() ||
+            game->getPendingRequest().sequence != pending.sequence) {
+            continue; // Stale: the clock already acted, or the answer came twice
+        }
+        stopClock(pending.tableId);
+        if (game->submitDecision(pending.decision)) {
+            markReady(pending.tableId);
+        }
+    }
+}
+
+int TableScheduler::runReady() {
+    drainInbox();
+    
+    int advanced = 0;
+    size_t count = readyTables.size();
+    for (size_t i = 0; i < count; i++) {
+        int tableId = readyTables.front();
+        readyTables.pop_front();
+        queued[tableId] = false;
+        
+        PokerGame* game = tables[tableId];
+        advanced++;
+        if (game->advance() == GameStepResult::HAND_COMPLETE) {
+            game->finishHand();
+            if (onHandComplete) {
+                // The callback may start the next hand, which re-queues the table
+                onHandComplete(tableId, *game);
+            }
+        } else {
+            // Parked until its decision is submitted or the clock runs out
+            startClock(tableId);
+        }
+    }
+    return advanced;
+}
+
+bool TableScheduler::setActionClock(int timeoutMs, int timeBankMs, int resolutionMs) {
+    actionTimeoutMs = timeoutMs;
+    initialTimeBankMs = timeBankMs;
+    int resolution = resolutionMs > 0 ? resolutionMs : 1;
+    if (resolution == tickMs) return true;
+    // Armed clocks hold expiries in the old ticks
+    if (timerWheel.getArmedCount() > 0) return false;
+    
+    // Restart tick counting from the wheel's current tick, so ticks never run backwards
+    tickOriginTick = timerWheel.getCurrentTick();
+    tickOriginMs = nowMs;
+    tickMs = resolution;
+    return true;
+}
+
+uint64_t TableScheduler::tickAt(long long ms) const {
+    return tickOriginTick + static_cast<uint64_t>((ms - tickOriginMs) / tickMs);
+}
+
+int& TableScheduler::timeBankFor(int tableId, int seat) {
+    std::vector<int>& banks = clocks[tableId].timeBankMs;
+    if (seat >= static_cast<int>(banks.size())) {
+        banks.resize(seat + 1, initialTimeBankMs);
+    }
+    return banks[seat];
+}
+
+int TableScheduler::getTimeBank(int tableId, int seat) {
+    if (!getTable(tableId) || seat < 0) return 0;
+    return timeBankFor(tableId, seat);
+}
+
+void TableScheduler::startClock(int tableId) {
+    if (actionTimeoutMs <= 0) return;
+    
+    TableClock& clock = clocks[tableId];
+    clock.seat = tables[tableId]->getPendingRequest().seat;
+    clock.armedAtMs = nowMs;
+    
+    long long allowedMs = actionTimeoutMs + timeBankFor(tableId, clock.seat);
+    uint64_t ticks = static_cast<uint64_t>((allowedMs + tickMs - 1) / tickMs);
+    // The wheel counts from its last tick, which may trail nowMs by part of a tick
+    uint64_t targetTick = tickAt(nowMs) + ticks;
+    uint64_t currentTick = timerWheel.getCurrentTick();
+    timerWheel.arm(clock.timer, targetTick > currentTick ? targetTick - currentTick : 0);
+}
+
+void TableScheduler::stopClock(int tableId) {
+    TableClock& clock = clocks[tableId];
+    if (!clock.timer.isArmed()) return;
+    timerWheel.cancel(clock.timer);
+    
+    // Time past the base allowance comes out of the seat's bank
+    long long usedMs = nowMs - clock.armedAtMs;
+    if (usedMs > actionTimeoutMs) {
+        int& bank = timeBankFor(tableId, clock.seat);
+        bank = static_cast<int>(std::max<long long>(0, bank - (usedMs - actionTimeoutMs)));
+    }
+}
+
+void TableScheduler::expireClock(int tableId) {
+    PokerGame* game = tables[tableId];
+    if (!game->isAwaitingDecision()) return;
+    
+    timeBankFor(tableId, clocks[tableId].seat) = 0;
+    
+    // Same path as a submitted answer: check if free, fold otherwise
+    Decision decision;
+    decision.action = game->getPendingRequest().canCheck ? PlayerAction::CHECK : PlayerAction::FOLD;
+    decision.raiseAmount = 0;
+    if (game->submitDecision(decision)) {
+        markReady(tableId);
+    }
+}
+
+void TableScheduler::advanceClock(long long currentTimeMs) {
+    if (currentTimeMs > nowMs) {
+        nowMs = currentTimeMs;
+    }
+    timerWheel.advanceTo(tickAt(nowMs), [this](TimerNode& timer) {
+        expireClock(timer.ownerId);
+    });
+}
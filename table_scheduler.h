@@ -0,0 +1,105 @@
+#ifndef TABLE_SCHEDULER_H
+#define TABLE_SCHEDULER_H
+
+#include "poker_game.h"
+#include "decision_provider.h"
+#include "timer_wheel.h"
+#include "table_checkpoint.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+
+// Runs many tables' hands on a single thread. A table is only touched when it
+// is ready to make progress; tables parked on an outside decision cost nothing
+// until submitDecision() for them arrives. Games are owned by the caller.
+//
+// Suspended decisions run on an action clock: the seat gets actionTimeoutMs
+// plus whatever is left in its time bank. Clocks live in a timer wheel, so
+// expiring them never scans tables; an expired clock checks if the seat may
+// check and folds otherwise.
+class TableScheduler {
+public:
+    typedef std::function<void(int tableId, PokerGame& game)> HandCompleteCallback;
+
+private:
+    struct PendingDecision {
+        int tableId;
+        long long sequence;
+        Decision decision;
+    };
+    
+    // Action clock for a table's pending decision (one decision pends per table)
+    struct TableClock {
+        TimerNode timer;
+        int seat;
+        long long armedAtMs;
+        std::vector<int> timeBankMs; // Remaining bank per seat
+    };
+    
+    std::vector<PokerGame*> tables;
+    std::deque<TableClock> clocks;     // deque keeps TimerNode addresses stable as tables are added
+    TimerWheel timerWheel;
+    long long nowMs;
+    int tickMs;
+    long long tickOriginMs;            // Wheel tick = tickOriginTick + (ms - tickOriginMs) / tickMs
+    uint64_t tickOriginTick;
+    int actionTimeoutMs;               // 0 disables action clocks
+    int initialTimeBankMs;
+    std::vector<bool> queued;          // Table already in readyTables
+    std::deque<int> readyTables;       // Tables that can advance right now
+    std::vector<PendingDecision> inbox; // Decisions posted from other threads
+    std::mutex inboxMutex;
+    HandCompleteCallback onHandComplete;
+    CheckpointStore* checkpoints;      // nullptr = tables are not checkpointed
+    
+    void markReady(int tableId);
+    void drainInbox();
+    void startClock(int tableId);
+    void stopClock(int tableId);
+    void expireClock(int tableId);
+    int& timeBankFor(int tableId, int seat);
+    uint64_t tickAt(long long ms) const;
+
+public:
+    TableScheduler();
+    
+    // Registers a game and assigns its table id
+    int addTable(PokerGame* game);
+    int getTableCount() const { return static_cast<int>(tables.size()); }
+    PokerGame* getTable(int tableId) const;
+    
+    void setHandCompleteCallback(HandCompleteCallback callback) { onHandComplete = std::move(callback); }
+    
+    // Tables added from here on checkpoint every action into the slot of their table id
+    void setCheckpoints(CheckpointStore* store) { checkpoints = store; }
+    // After a restart: puts the table back where its checkpoint left it and
+    // queues it. A pending outside decision is armed again (clients re-read it
+    // with getPendingRequest()); a finished hand goes to the hand-complete
+    // callback. False if the table has no checkpoint.
+    bool restoreTable(int tableId);
+    
+    // Deals a new hand on the table and queues it for running
+    void startHand(int tableId);
+    
+    // Thread-safe: answers the given request; picked up by the next runReady().
+    // Answers to a request that is no longer pending (timed out, repeated) are ignored.
+    void submitDecision(const DecisionRequest& request, const Decision& decision);
+    
+    // Action clocks. resolutionMs is the timer tick; it can only change while no
+    // clock is armed, otherwise the old tick is kept and this returns false.
+    bool setActionClock(int timeoutMs, int timeBankMs, int resolutionMs = 100);
+    int getTimeBank(int tableId, int seat);
+    
+    // Moves the scheduler's clock forward (scheduler thread only) and applies
+    // the default action for every decision whose clock ran out
+    void advanceClock(long long currentTimeMs);
+    long long getCurrentTimeMs() const { return nowMs; }
+    
+    // Advances every ready table until it suspends or its hand completes.
+    // Returns the number of tables advanced.
+    int runReady();
+    bool hasReadyTables() const { return !readyTables.empty(); }
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : currentTask(nullptr), taskCount(0), nextIndex(0), busyWorkers(0), generation(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (threadCount <= 0) threadCount = 1;
+    }
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::runIndices(const Task& task, int count, int worker) {
+    int index;
+    while ((index = nextIndex.fetch_add(1)) < count) {
+        task(index, worker);
+    }
+}
+
+void ThreadPool::workerLoop(int worker) {
+    long long seenGeneration = 0;
+    while (true) {
+        const Task* task;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+            task = currentTask;
+            count = taskCount;
+            if (!task) continue; // Woke after that loop already finished
+            busyWorkers++;
+        }
+        
+        runIndices(*task, count, worker);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        workDone.notify_one();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const Task& task) {
+    if (count <= 0) return;
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; i++) task(i, 0);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex = 0;
+        generation++;
+    }
+    workReady.notify_all();
+    
+    runIndices(task, count, 0);
+    
+    // Wait for stragglers; workers that never woke up for this generation find no indices left
+    std::unique_lock<std::mutex> lock(mutex);
+    workDone.wait(lock, [&] { return busyWorkers == 0; });
+    currentTask = nullptr;
+}
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// Fixed set of worker threads for data-parallel loops (tournament rounds,
+// simulations). parallelFor hands out indices dynamically and returns once
+// every index has run, so each call doubles as a barrier. The calling thread
+// works too, so a pool of N threads starts N - 1 workers.
+class ThreadPool {
+public:
+    typedef std::function<void(int index, int worker)> Task;
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+    const Task* currentTask;
+    int taskCount;
+    std::atomic<int> nextIndex;
+    int busyWorkers;
+    long long generation; // Bumped for every parallelFor so workers see new work
+    bool stopping;
+    
+    void workerLoop(int worker);
+    void runIndices(const Task& task, int count, int worker);
+
+public:
+    // threadCount <= 0 uses one thread per hardware core
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+    
+    // Runs task(i, worker) for i in [0, count); worker is in [0, getThreadCount())
+    void parallelFor(int count, const Task& task);
+};
+
+#endif
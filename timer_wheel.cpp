@@ -0,0 +1,89 @@
+#include "timer_wheel.h"
+
+TimerWheel::TimerWheel() : currentTick(0), armedCount(0) {
+    for (int level = 0; level < LEVELS; level++) {
+        for (int slot = 0; slot < SLOTS; slot++) {
+            slots[level][slot].prev = &slots[level][slot];
+            slots[level][slot].next = &slots[level][slot];
+        }
+    }
+}
+
+void TimerWheel::unlink(TimerNode& timer) {
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = nullptr;
+    timer.next = nullptr;
+}
+
+void TimerWheel::insert(TimerNode& timer) {
+    uint64_t delta = timer.expiry - currentTick;
+    
+    // Pick the finest level whose range covers the delay
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    uint64_t expiry = timer.expiry;
+    if (level == LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * LEVELS))) {
+        // Beyond the wheel's range: park in the farthest slot, it gets re-filed on cascade
+        expiry = currentTick + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    }
+    
+    TimerNode& head = slots[level][(expiry >> (SLOT_BITS * level)) & SLOT_MASK];
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+}
+
+void TimerWheel::arm(TimerNode& timer, uint64_t delayTicks) {
+    if (timer.isArmed()) {
+        cancel(timer);
+    }
+    timer.expiry = currentTick + (delayTicks > 0 ? delayTicks : 1);
+    insert(timer);
+    armedCount++;
+}
+
+void TimerWheel::cancel(TimerNode& timer) {
+    if (!timer.isArmed()) return;
+    unlink(timer);
+    armedCount--;
+}
+
+void TimerWheel::cascade(int level) {
+    // Re-file everything in the slot this level just reached; it all lands lower down
+    TimerNode& head = slots[level][(currentTick >> (SLOT_BITS * level)) & SLOT_MASK];
+    while (head.next != &head) {
+        TimerNode* timer = head.next;
+        unlink(*timer);
+        insert(*timer);
+    }
+}
+
+void TimerWheel::advanceTo(uint64_t targetTick, const FireCallback& onFire) {
+    while (currentTick < targetTick) {
+        if (armedCount == 0) {
+            // Nothing can fire - skip straight to the target
+            currentTick = targetTick;
+            return;
+        }
+        
+        currentTick++;
+        
+        // Crossing a boundary of a coarser level pulls its next slot down
+        for (int level = 1; level < LEVELS; level++) {
+            if ((currentTick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) break;
+            cascade(level);
+        }
+        
+        TimerNode& head = slots[0][currentTick & SLOT_MASK];
+        while (head.next != &head) {
+            TimerNode* timer = head.next;
+            unlink(*timer);
+            armedCount--;
+            onFire(*timer);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+
+// Intrusive timer entry. The owner embeds it and keeps it at a fixed address
+// while armed; arming and cancelling just link/unlink it from a wheel slot.
+struct TimerNode {
+    TimerNode* prev;
+    TimerNode* next;
+    uint64_t expiry; // Absolute tick
+    int ownerId;     // Free for the owner (table id for the scheduler)
+    
+    TimerNode() : prev(nullptr), next(nullptr), expiry(0), ownerId(-1) {}
+    bool isArmed() const { return next != nullptr; }
+};
+
+// Hierarchical timer wheel: four levels of 256 slots. Arm and cancel are O(1);
+// advancing touches only the slot for each tick plus an occasional cascade
+// from the coarser levels, never the full set of timers.
+class TimerWheel {
+public:
+    typedef std::function<void(TimerNode& timer)> FireCallback;
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int SLOT_MASK = SLOTS - 1;
+    
+    TimerNode slots[LEVELS][SLOTS]; // Sentinels of circular lists
+    uint64_t currentTick;
+    int armedCount;
+    
+    void insert(TimerNode& timer);
+    void cascade(int level);
+    static void unlink(TimerNode& timer);
+
+public:
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    
+    // Fires delayTicks from now (a delay of 0 fires on the next tick)
+    void arm(TimerNode& timer, uint64_t delayTicks);
+    void cancel(TimerNode& timer);
+    
+    // Moves time forward to targetTick, firing every timer that expires on the way.
+    // Timers are disarmed before their callback runs, so callbacks may re-arm them.
+    void advanceTo(uint64_t targetTick, const FireCallback& onFire);
+    
+    uint64_t getCurrentTick() const { return currentTick; }
+    int getArmedCount() const { return armedCount; }
+};
+
+#endif
@@ -0,0 +1,463 @@
+#include "tournament.h"
+#include "game_log.h"
+#include "trace_writer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const PlayerPersonality PERSONALITIES[] = {
+        PlayerPersonality::TIGHT_PASSIVE,
+        PlayerPersonality::TIGHT_AGGRESSIVE,
+        PlayerPersonality::LOOSE_PASSIVE,
+        PlayerPersonality::LOOSE_AGGRESSIVE
+    };
+    
+    struct Bust {
+        int startingChips;
+        int playerId;
+        std::string name;
+    };
+}
+
+Tournament::Tournament(const TournamentConfig& tournamentConfig)
+    : config(tournamentConfig), pool(tournamentConfig.threads), activeTables(0), playersRemaining(0),
+      roundsPlayed(0), handsPlayed(0), playerMoves(0), tablesBroken(0) {
+    if (config.seatsPerTable < 2) config.seatsPerTable = 2;
+    if (config.levels.empty()) config.levels = defaultSchedule();
+    seatDraw();
+    
+    // A table is played by one pool thread at a time, so each table's ring has a single producer
+    if (!config.archivePath.empty() && archive.open(config.archivePath)) {
+        for (auto& tournamentTable : tables) {
+            tournamentTable->game->setArchive(archive.addRing());
+        }
+    }
+}
+
+std::vector<BlindLevel> Tournament::defaultSchedule() {
+    return {
+        {10, 20, 0}, {15, 30, 0}, {25, 50, 5}, {50, 100, 10}, {75, 150, 15},
+        {100, 200, 25}, {150, 300, 40}, {200, 400, 50}, {300, 600, 75}, {400, 800, 100},
+        {600, 1200, 150}, {800, 1600, 200}, {1000, 2000, 300}, {1500, 3000, 400}, {2000, 4000, 500}
+    };
+}
+
+void Tournament::seatDraw() {
+    std::mt19937 rng(config.seed);
+    
+    std::vector<int> draw(config.entrants);
+    for (int i = 0; i < config.entrants; i++) draw[i] = i;
+    std::shuffle(draw.begin(), draw.end(), rng);
+    
+    // Fewest tables that seat everyone, filled round-robin so sizes differ by at most one
+    int tableCount = (config.entrants + config.seatsPerTable - 1) / config.seatsPerTable;
+    if (tableCount < 1) tableCount = 1;
+    for (int t = 0; t < tableCount; t++) {
+        std::unique_ptr<TournamentTable> tournamentTable(new TournamentTable());
+        tournamentTable->id = t;
+        tournamentTable->rng.seed(config.seed + 7919u * (t + 1));
+        tournamentTable->version = 0;
+        tournamentTable->broken = false;
+        tournamentTable->game.reset(new PokerGame(&tournamentTable->table, config.variant));
+        tournamentTable->game->setTableId(t);
+        tournamentTable->game->setOpponentStats(&tournamentTable->roundStats);
+        tournamentTable->game->setRunItTimes(config.runItTimes);
+        tables.push_back(std::move(tournamentTable));
+    }
+    
+    for (int seat = 0; seat < config.entrants; seat++) {
+        int playerId = draw[seat];
+        Table& table = tables[seat % tableCount]->table;
+        table.addPlayer("Player" + std::to_string(playerId + 1), config.startingChips,
+                        playerId, PERSONALITIES[playerId % 4]);
+        table.getPlayer(table.getPlayerCount() - 1)->setOpponentStats(&opponentStats);
+    }
+    
+    activeTables = tableCount;
+    playersRemaining = config.entrants;
+    for (auto& tournamentTable : tables) {
+        tableSizeChanged(*tournamentTable);
+    }
+}
+
+BlindLevel Tournament::getCurrentLevel() const {
+    int index = getLevelIndex();
+    int last = static_cast<int>(config.levels.size()) - 1;
+    if (index <= last) {
+        return config.levels[index];
+    }
+    
+    // Off the end of the schedule: keep doubling so the tournament always finishes
+    BlindLevel level = config.levels[last];
+    for (int i = last; i < index && level.bigBlind < (1 << 28); i++) {
+        level.smallBlind *= 2;
+        level.bigBlind *= 2;
+        level.ante *= 2;
+    }
+    return level;
+}
+
+std::vector<double> Tournament::defaultPayouts(int entrants, double prizePool) {
+    int paid = std::max(1, entrants / 8);
+    std::vector<double> payouts(paid);
+    double weightTotal = 0.0;
+    for (int place = 0; place < paid; place++) {
+        payouts[place] = 1.0 / std::pow(place + 1.0, 1.2);
+        weightTotal += payouts[place];
+    }
+    for (double& payout : payouts) {
+        payout = payout / weightTotal * prizePool;
+    }
+    return payouts;
+}
+
+bool Tournament::isIcmActive() const {
+    return !config.payouts.empty() && playersRemaining <= config.icmMaxPlayers;
+}
+
+void Tournament::applyIcmPressure() {
+    std::vector<int> stacks;
+    std::vector<Player*> players;
+    std::vector<int> tableStart; // First index of each table's players in stacks
+    for (auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        tableStart.push_back(static_cast<int>(stacks.size()));
+        for (int i = 0; i < tournamentTable->table.getPlayerCount(); i++) {
+            Player* player = tournamentTable->table.getPlayer(i);
+            stacks.push_back(player->getChips());
+            players.push_back(player);
+        }
+    }
+    tableStart.push_back(static_cast<int>(stacks.size()));
+    
+    // Each player's premium is measured against the biggest other stack at their table
+    for (size_t t = 0; t + 1 < tableStart.size(); t++) {
+        for (int i = tableStart[t]; i < tableStart[t + 1]; i++) {
+            int opponent = -1;
+            for (int j = tableStart[t]; j < tableStart[t + 1]; j++) {
+                if (j != i && (opponent == -1 || stacks[j] > stacks[opponent])) opponent = j;
+            }
+            double premium = 0.0;
+            if (opponent != -1) {
+                premium = IcmCalculator::riskPremium(stacks, config.payouts, i, opponent, &pool);
+            }
+            players[i]->setRiskPremium(std::max(0.0, premium));
+        }
+    }
+}
+
+void Tournament::recordIcmChanges() {
+    // Called before eliminations, so busted players are still seated with 0 chips
+    // and each table's seats line up with its starting stacks
+    std::vector<int> before;
+    std::vector<int> after;
+    std::vector<int> playerIds;
+    for (auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        for (int i = 0; i < tournamentTable->table.getPlayerCount(); i++) {
+            playerIds.push_back(tournamentTable->startingStacks[i].first);
+            before.push_back(tournamentTable->startingStacks[i].second);
+            after.push_back(tournamentTable->table.getPlayer(i)->getChips());
+        }
+    }
+    
+    std::vector<double> change = IcmCalculator::equityChange(before, after, config.payouts, &pool);
+    for (size_t i = 0; i < playerIds.size(); i++) {
+        lastRoundIcmChanges.push_back({playerIds[i], after[i], change[i]});
+    }
+}
+
+std::vector<IcmSnapshot> Tournament::getIcmEquities() {
+    std::vector<IcmSnapshot> snapshots;
+    std::vector<int> stacks;
+    for (auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        for (int i = 0; i < tournamentTable->table.getPlayerCount(); i++) {
+            const Player* player = tournamentTable->table.getPlayer(i);
+            snapshots.push_back({player->getPlayerId(), player->getChips(), 0.0});
+            stacks.push_back(player->getChips());
+        }
+    }
+    if (config.payouts.empty()) {
+        return snapshots;
+    }
+    
+    std::vector<double> equity = IcmCalculator::equity(stacks, config.payouts, &pool);
+    for (size_t i = 0; i < snapshots.size(); i++) {
+        snapshots[i].equity = equity[i];
+    }
+    return snapshots;
+}
+
+std::vector<int> Tournament::betSizesFor(const BlindLevel& level) const {
+    if (config.variant.gameStruct == GAMESTRUCTURE_STUD) {
+        // ante, bringIn, smallBet, bigBet
+        return {level.ante, level.smallBlind, level.bigBlind, level.bigBlind * 2};
+    }
+    if (config.variant.bettingStruct == BETTINGSTRUCTURE_LIMIT) {
+        // smallBlind, bigBlind, smallBet, bigBet
+        return {level.smallBlind, level.bigBlind, level.bigBlind, level.bigBlind * 2};
+    }
+    return {level.smallBlind, level.bigBlind};
+}
+
+void Tournament::snapshotStacks(TournamentTable& tournamentTable) {
+    tournamentTable.startingStacks.clear();
+    for (int i = 0; i < tournamentTable.table.getPlayerCount(); i++) {
+        const Player* player = tournamentTable.table.getPlayer(i);
+        tournamentTable.startingStacks.push_back({player->getPlayerId(), player->getChips()});
+    }
+}
+
+void Tournament::playTableHand(TournamentTable& tournamentTable, const BlindLevel& level) {
+    Table& table = tournamentTable.table;
+    PokerGame& game = *tournamentTable.game;
+    
+    snapshotStacks(tournamentTable);
+    for (int i = 0; i < table.getPlayerCount(); i++) {
+        table.getPlayer(i)->resetForNewHand();
+    }
+    
+    table.setCurrentBet(0);
+    table.getSidePotManager().clearPots();
+    table.clearCommunityCards();
+    if (config.variant.gameStruct == GAMESTRUCTURE_BOARD) {
+        table.advanceDealer();
+    }
+    table.getDeck().reset();
+    table.getDeck().shuffle(static_cast<unsigned>(tournamentTable.rng()));
+    
+    game.setBetSizes(betSizesFor(level));
+    game.setBoardAnte(config.variant.gameStruct == GAMESTRUCTURE_BOARD ? level.ante : 0);
+    
+    // No decision provider, so the built-in AI plays the whole hand in one advance()
+    game.startNewHand();
+    while (game.advance() != GameStepResult::HAND_COMPLETE) {
+    }
+    game.finishHand();
+}
+
+bool Tournament::playRound() {
+    if (playersRemaining <= 1) {
+        return false;
+    }
+    
+    std::vector<TournamentTable*> playing;
+    for (auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        if (tournamentTable->table.getPlayerCount() >= 2) {
+            playing.push_back(tournamentTable.get());
+        } else {
+            snapshotStacks(*tournamentTable); // Sits out, but keeps its stacks current
+        }
+    }
+    
+    if (isIcmActive()) {
+        applyIcmPressure();
+    }
+    
+    BlindLevel level = getCurrentLevel();
+    {
+        TraceSpan span("round", -1); // Ends with the slowest table: gaps beneath it are idle workers
+        pool.parallelFor(static_cast<int>(playing.size()), [&](int index, int /* worker */) {
+            // Hands on pool threads stay quiet; the calling thread's setting is restored
+            bool wasEnabled = GameLog::isEnabled();
+            GameLog::setEnabled(false);
+            playTableHand(*playing[index], level);
+            GameLog::setEnabled(wasEnabled);
+        });
+    }
+    
+    // Tables only wrote their own stores; fold them into the shared one the players read
+    for (TournamentTable* tournamentTable : playing) {
+        opponentStats.merge(tournamentTable->roundStats);
+        tournamentTable->roundStats.reset();
+    }
+    
+    handsPlayed += playing.size();
+    roundsPlayed++;
+    
+    lastRoundIcmChanges.clear();
+    if (isIcmActive()) {
+        recordIcmChanges();
+    }
+    processEliminations();
+    breakTables();
+    balanceTables();
+    compactHeaps();
+    return playersRemaining > 1;
+}
+
+void Tournament::run() {
+    while (playRound()) {
+    }
+}
+
+void Tournament::processEliminations() {
+    std::vector<Bust> busts;
+    
+    for (auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        Table& table = tournamentTable->table;
+        
+        bool changed = false;
+        for (int i = table.getPlayerCount() - 1; i >= 0; i--) {
+            Player* player = table.getPlayer(i);
+            if (player->getChips() > 0) continue;
+            
+            int startingChips = 0;
+            for (const auto& stack : tournamentTable->startingStacks) {
+                if (stack.first == player->getPlayerId()) startingChips = stack.second;
+            }
+            busts.push_back({startingChips, player->getPlayerId(), player->getName()});
+            table.removePlayer(i);
+            changed = true;
+        }
+        if (changed) {
+            tableSizeChanged(*tournamentTable);
+        }
+    }
+    
+    // Players busting on the same round: the bigger starting stack finishes higher
+    std::sort(busts.begin(), busts.end(), [](const Bust& a, const Bust& b) {
+        return a.startingChips != b.startingChips ? a.startingChips < b.startingChips : a.playerId < b.playerId;
+    });
+    for (const Bust& bust : busts) {
+        finishes.push_back({bust.playerId, bust.name, playersRemaining});
+        playersRemaining--;
+    }
+}
+
+void Tournament::breakTables() {
+    // Break the smallest table while the rest have seats for everyone
+    while (activeTables > 1 && playersRemaining <= (activeTables - 1) * config.seatsPerTable) {
+        TournamentTable* breaking = smallestTable();
+        breaking->broken = true;
+        breaking->version++;
+        activeTables--;
+        tablesBroken++;
+        
+        while (breaking->table.getPlayerCount() > 0) {
+            movePlayer(*breaking, *smallestTable(breaking->id));
+        }
+    }
+}
+
+void Tournament::balanceTables() {
+    while (activeTables > 1) {
+        TournamentTable* largest = largestTable();
+        TournamentTable* smallest = smallestTable();
+        if (largest->table.getPlayerCount() - smallest->table.getPlayerCount() <= 1) {
+            break;
+        }
+        movePlayer(*largest, *smallest);
+    }
+}
+
+void Tournament::movePlayer(TournamentTable& from, TournamentTable& to) {
+    Table& table = from.table;
+    int count = table.getPlayerCount();
+    
+    // Move whoever would post the big blind next hand, the usual balancing rule
+    int index = (config.variant.gameStruct == GAMESTRUCTURE_BOARD && count > 0)
+              ? (table.getDealerPosition() + 3) % count
+              : count - 1;
+    
+    to.table.seatPlayer(table.takePlayer(index));
+    playerMoves++;
+    
+    if (!from.broken) tableSizeChanged(from);
+    tableSizeChanged(to);
+}
+
+void Tournament::tableSizeChanged(TournamentTable& tournamentTable) {
+    tournamentTable.version++;
+    SizeEntry entry = {tournamentTable.table.getPlayerCount(), tournamentTable.id, tournamentTable.version};
+    largestTables.push(entry);
+    smallestTables.push(entry);
+}
+
+bool Tournament::isCurrent(const SizeEntry& entry) const {
+    const TournamentTable& tournamentTable = *tables[entry.tableId];
+    return !tournamentTable.broken && tournamentTable.version == entry.version;
+}
+
+Tournament::TournamentTable* Tournament::largestTable() {
+    while (!isCurrent(largestTables.top())) {
+        largestTables.pop();
+    }
+    return tables[largestTables.top().tableId].get();
+}
+
+Tournament::TournamentTable* Tournament::smallestTable(int excludeTableId) {
+    while (!isCurrent(smallestTables.top())) {
+        smallestTables.pop();
+    }
+    if (smallestTables.top().tableId != excludeTableId) {
+        return tables[smallestTables.top().tableId].get();
+    }
+    
+    // The excluded table is on top: look one entry further down
+    SizeEntry excluded = smallestTables.top();
+    smallestTables.pop();
+    while (!isCurrent(smallestTables.top())) {
+        smallestTables.pop();
+    }
+    TournamentTable* result = tables[smallestTables.top().tableId].get();
+    smallestTables.push(excluded);
+    return result;
+}
+
+void Tournament::compactHeaps() {
+    // Stale entries below the top are only dropped when they surface; rebuild
+    // once they dominate so the heaps stay proportional to the live tables
+    if (largestTables.size() + smallestTables.size() <= static_cast<size_t>(8 * activeTables + 64)) {
+        return;
+    }
+    largestTables = decltype(largestTables)();
+    smallestTables = decltype(smallestTables)();
+    for (auto& tournamentTable : tables) {
+        if (!tournamentTable->broken) {
+            SizeEntry entry = {tournamentTable->table.getPlayerCount(), tournamentTable->id, tournamentTable->version};
+            largestTables.push(entry);
+            smallestTables.push(entry);
+        }
+    }
+}
+
+long long Tournament::getTotalChips() const {
+    long long total = 0;
+    for (const auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        for (int i = 0; i < tournamentTable->table.getPlayerCount(); i++) {
+            total += tournamentTable->table.getPlayer(i)->getChips();
+        }
+    }
+    return total;
+}
+
+std::vector<TournamentFinish> Tournament::getStandings() const {
+    // Players still in are ranked by stack
+    std::vector<std::pair<int, TournamentFinish>> alive;
+    for (const auto& tournamentTable : tables) {
+        if (tournamentTable->broken) continue;
+        for (int i = 0; i < tournamentTable->table.getPlayerCount(); i++) {
+            const Player* player = tournamentTable->table.getPlayer(i);
+            alive.push_back({player->getChips(), {player->getPlayerId(), player->getName(), 0}});
+        }
+    }
+    std::sort(alive.begin(), alive.end(), [](const std::pair<int, TournamentFinish>& a,
+                                             const std::pair<int, TournamentFinish>& b) {
+        return a.first != b.first ? a.first > b.first : a.second.playerId < b.second.playerId;
+    });
+    
+    std::vector<TournamentFinish> standings;
+    for (size_t i = 0; i < alive.size(); i++) {
+        standings.push_back(alive[i].second);
+        standings.back().place = static_cast<int>(i) + 1;
+    }
+    for (auto it = finishes.rbegin(); it != finishes.rend(); ++it) {
+        standings.push_back(*it);
+    }
+    return standings;
+}
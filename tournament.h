@@ -0,0 +1,154 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "table.h"
+#include "poker_game.h"
+#include "thread_pool.h"
+#include "icm.h"
+#include "opponent_stats.h"
+#include "hand_archive.h"
+#include <vector>
+#include <queue>
+#include <memory>
+#include <random>
+#include <string>
+
+// One level of the blind schedule. BOARD games post smallBlind/bigBlind;
+// STUD uses smallBlind as the bring-in and bigBlind as the small bet.
+struct BlindLevel {
+    int smallBlind;
+    int bigBlind;
+    int ante;
+};
+
+struct TournamentConfig {
+    VariantInfo variant;
+    int entrants;
+    int startingChips;
+    int seatsPerTable;
+    std::vector<BlindLevel> levels; // Past the last level the blinds keep doubling
+    int handsPerLevel;              // Rounds (one hand on every table) per level
+    unsigned seed;
+    int threads;                    // 0 = one per hardware core
+    std::vector<double> payouts;    // Prize per place, first place first; empty = no ICM
+    int icmMaxPlayers = IcmCalculator::DEFAULT_EXACT_PLAYERS; // Field size at which ICM pressure starts
+    std::string archivePath;        // Hand histories appended here; empty = not archived
+    int runItTimes = 1;             // Boards dealt for an all-in pot in board games
+};
+
+struct IcmSnapshot {
+    int playerId;
+    int chips;
+    double equity; // Expected prize, or prize equity change for per-round swings
+};
+
+struct TournamentFinish {
+    int playerId;
+    std::string name;
+    int place;
+};
+
+// Multi-table tournament: random seat draw, blind levels, and table
+// balancing/breaking as the field shrinks. Every table plays one hand per
+// round in parallel; seat changes happen between rounds on the calling thread.
+//
+// Table sizes sit in a max-heap and a min-heap with lazy invalidation (each
+// size change pushes a fresh entry and bumps the table's version), so picking
+// the tables to break or balance is O(log tables).
+class Tournament {
+private:
+    struct TournamentTable {
+        int id;
+        Table table;
+        std::unique_ptr<PokerGame> game;
+        std::mt19937 rng;      // Deck seeds for this table
+        int version;           // Bumped whenever the table's size changes
+        bool broken;
+        std::vector<std::pair<int, int>> startingStacks; // (playerId, chips) before the current hand
+        OpponentStats roundStats; // This round's counters, merged into opponentStats afterwards
+    };
+    
+    struct SizeEntry {
+        int size;
+        int tableId;
+        int version;
+    };
+    struct LargerFirst {
+        bool operator()(const SizeEntry& a, const SizeEntry& b) const {
+            return a.size != b.size ? a.size < b.size : a.tableId > b.tableId;
+        }
+    };
+    struct SmallerFirst {
+        bool operator()(const SizeEntry& a, const SizeEntry& b) const {
+            return a.size != b.size ? a.size > b.size : a.tableId > b.tableId;
+        }
+    };
+    
+    TournamentConfig config;
+    std::vector<std::unique_ptr<TournamentTable>> tables;
+    std::priority_queue<SizeEntry, std::vector<SizeEntry>, LargerFirst> largestTables;
+    std::priority_queue<SizeEntry, std::vector<SizeEntry>, SmallerFirst> smallestTables;
+    std::vector<TournamentFinish> finishes; // In order of elimination
+    ThreadPool pool;
+    int activeTables;
+    int playersRemaining;
+    int roundsPlayed;
+    long long handsPlayed;
+    int playerMoves;
+    int tablesBroken;
+    std::vector<IcmSnapshot> lastRoundIcmChanges;
+    OpponentStats opponentStats; // Every table's counters; only read while a round plays
+    HandArchive archive;          // One ring per table, drained by the archive's writer thread
+    
+    void seatDraw();
+    void snapshotStacks(TournamentTable& tournamentTable);
+    void playTableHand(TournamentTable& tournamentTable, const BlindLevel& level);
+    void processEliminations();
+    void breakTables();
+    void balanceTables();
+    void movePlayer(TournamentTable& from, TournamentTable& to);
+    void tableSizeChanged(TournamentTable& tournamentTable);
+    bool isCurrent(const SizeEntry& entry) const;
+    TournamentTable* largestTable();
+    TournamentTable* smallestTable(int excludeTableId = -1);
+    void compactHeaps();
+    std::vector<int> betSizesFor(const BlindLevel& level) const;
+    bool isIcmActive() const;
+    void applyIcmPressure();
+    void recordIcmChanges();
+
+public:
+    explicit Tournament(const TournamentConfig& tournamentConfig);
+    
+    // Plays one hand on every table, then eliminates, breaks and balances.
+    // Returns false once a winner is decided.
+    bool playRound();
+    void run();
+    
+    BlindLevel getCurrentLevel() const;
+    int getLevelIndex() const { return roundsPlayed / (config.handsPerLevel > 0 ? config.handsPerLevel : 1); }
+    int getPlayersRemaining() const { return playersRemaining; }
+    int getActiveTables() const { return activeTables; }
+    int getRoundsPlayed() const { return roundsPlayed; }
+    long long getHandsPlayed() const { return handsPlayed; }
+    int getPlayerMoves() const { return playerMoves; }
+    int getTablesBroken() const { return tablesBroken; }
+    int getThreadCount() const { return pool.getThreadCount(); }
+    const OpponentStats& getOpponentStats() const { return opponentStats; }
+    HandArchive& getArchive() { return archive; }
+    long long getTotalChips() const;
+    
+    // Finishing places, winner first (complete once run() returns)
+    std::vector<TournamentFinish> getStandings() const;
+    
+    // Prize equity of every player still in, and how last round's hands moved it
+    // (the latter only once ICM is active)
+    std::vector<IcmSnapshot> getIcmEquities();
+    const std::vector<IcmSnapshot>& getLastRoundIcmChanges() const { return lastRoundIcmChanges; }
+    
+    static std::vector<BlindLevel> defaultSchedule();
+    // Top eighth of the field paid, sliding down from first place
+    static std::vector<double> defaultPayouts(int entrants, double prizePool);
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "trace_writer.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace {
+    struct TraceEvent {
+        const char* name;
+        uint64_t startNs;
+        uint64_t durationNs;
+        int tableId;
+    };
+
+    struct ThreadTrace {
+        std::vector<TraceEvent> events;
+        std::string name;
+        size_t dropped = 0;
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadTrace>> threads; // Kept after their thread exits
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    std::atomic<int64_t> epochNs(0);
+    thread_local ThreadTrace* localTrace = nullptr;
+
+    int64_t clockNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ThreadTrace& threadTrace() {
+        if (!localTrace) {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.threads.emplace_back(new ThreadTrace());
+            localTrace = shared.threads.back().get();
+        }
+        return *localTrace;
+    }
+
+    std::string escaped(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') result += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) result += c;
+        }
+        return result;
+    }
+
+    // Chrome trace timestamps are microseconds
+    void writeMicros(std::ostream& out, uint64_t ns) {
+        out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+    }
+}
+
+namespace Trace {
+    std::atomic<bool> enabled(false);
+
+    void start() {
+        Registry& shared = registry();
+        {
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            for (const auto& thread : shared.threads) {
+                thread->events.clear();
+                thread->dropped = 0;
+            }
+        }
+        epochNs.store(clockNs(), std::memory_order_relaxed);
+        enabled.store(true, std::memory_order_release);
+    }
+
+    void stop() {
+        enabled.store(false, std::memory_order_release);
+    }
+
+    uint64_t now() {
+        if (!isEnabled()) return NOT_STARTED;
+        int64_t elapsed = clockNs() - epochNs.load(std::memory_order_relaxed);
+        return elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+    }
+
+    void complete(const char* name, int tableId, uint64_t startNs) {
+        if (startNs == NOT_STARTED) return;
+        uint64_t endNs = now();
+        if (endNs == NOT_STARTED) return; // Stopped while the span was open
+
+        ThreadTrace& trace = threadTrace();
+        if (trace.events.size() >= MAX_EVENTS_PER_THREAD) {
+            trace.dropped++;
+            return;
+        }
+        trace.events.push_back({name, startNs, endNs > startNs ? endNs - startNs : 0, tableId});
+    }
+
+    void nameThread(const std::string& name) {
+        ThreadTrace& trace = threadTrace();
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        trace.name = name;
+    }
+
+    bool write(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) return false;
+
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&]() {
+            out << (first ? "\n" : ",\n");
+            first = false;
+        };
+
+        for (size_t t = 0; t < shared.threads.size(); t++) {
+            const ThreadTrace& thread = *shared.threads[t];
+            if (thread.events.empty()) continue;
+            size_t pid = t + 1;
+            std::string threadName = thread.name.empty() ? "thread " + std::to_string(pid) : thread.name;
+
+            separator();
+            out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"name\":\""
+                << escaped(threadName) << "\"}}";
+            separator();
+            out << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"sort_index\":"
+                << pid << "}}";
+
+            // Table -1 is the thread's own work and takes tid 0
+            std::set<int> tables;
+            for (const TraceEvent& event : thread.events) tables.insert(event.tableId);
+            for (int table : tables) {
+                separator();
+                out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << table + 1
+                    << ",\"args\":{\"name\":\""
+                    << (table < 0 ? escaped(threadName) : "table " + std::to_string(table)) << "\"}}";
+            }
+
+            for (const TraceEvent& event : thread.events) {
+                separator();
+                out << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":"
+                    << event.tableId + 1 << ",\"ts\":";
+                writeMicros(out, event.startNs);
+                out << ",\"dur\":";
+                writeMicros(out, event.durationNs);
+                out << "}";
+            }
+        }
+        out << "\n]}\n";
+        return static_cast<bool>(out);
+    }
+
+    size_t getEventCount() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        size_t count = 0;
+        for (const auto& thread : shared.threads) count += thread->events.size();
+        return count;
+    }
+
+    size_t getDropped() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        size_t dropped = 0;
+        for (const auto& thread : shared.threads) dropped += thread->dropped;
+        return dropped;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef TRACE_WRITER_H
+#define TRACE_WRITER_H
+
+#include <atomic>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Timeline tracing for simulations, written as a Chrome JSON trace that
+// chrome://tracing and ui.perfetto.dev both load. Off until start(); while
+// off a span costs one relaxed load. While on, each thread appends complete
+// events to its own buffer, and write() emits every buffer once at the end.
+//
+// Threads appear as processes and tables as threads within them, so a
+// thread's track shows which tables it ran and for how long; spans that
+// belong to no table (rounds, archive writes) sit on the thread's own track.
+namespace Trace {
+    const uint64_t NOT_STARTED = ~0ULL;
+    const size_t MAX_EVENTS_PER_THREAD = 1 << 22; // Later events are counted as dropped
+
+    extern std::atomic<bool> enabled;
+    inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    void start(); // Clears any earlier events and restarts the clock
+    void stop();
+
+    // Nanoseconds since start(), or NOT_STARTED while tracing is off
+    uint64_t now();
+    // A span from startNs until now; name must outlive the trace (a literal).
+    // Ignored when startNs is NOT_STARTED.
+    void complete(const char* name, int tableId, uint64_t startNs);
+
+    void nameThread(const std::string& name); // Label for this thread's process row
+
+    // Every thread's events; call while they are idle
+    bool write(const std::string& path);
+    size_t getEventCount();
+    size_t getDropped();
+}
+
+class TraceSpan {
+public:
+    TraceSpan(const char* spanName, int spanTableId)
+        : name(spanName), tableId(spanTableId), start(Trace::now()) {}
+    ~TraceSpan() { Trace::complete(name, tableId, start); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    int tableId;
+    uint64_t start;
+};
+
+#endif
@@ -69,6 +69,13 @@ struct VariantInfo
     PotResolution potResolution;
 };
 
+// Whether pots are split high/low. Only the must-qualify A-5 split has award
+// rules; any other resolution is dealt and awarded high-only.
+inline bool isHiLoSplit(const VariantInfo& variant)
+{
+    return variant.potResolution == POTRESOLUTION_HILO_A5_MUSTQUALIFY;
+}
+
 // Predefined variant configurations
 namespace PokerVariants {
     const VariantInfo TEXAS_HOLDEM = {
@@ -81,6 +88,16 @@ namespace PokerVariants {
         POTRESOLUTION_HIONLY
     };
     
+    const VariantInfo LIMIT_HOLDEM = {
+        "Limit Hold'em",
+        GAMESTRUCTURE_BOARD,
+        NUMHOLECARDS_TWO,
+        {10, 20, 20, 40}, // smallBlind, bigBlind, smallBet, bigBet
+        BETTINGSTRUCTURE_LIMIT,
+        BESTHANDRESOLUTION_ANYFIVE,
+        POTRESOLUTION_HIONLY
+    };
+    
     const VariantInfo SEVEN_CARD_STUD = {
         "Seven Card Stud",
         GAMESTRUCTURE_STUD,